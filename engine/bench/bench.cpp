@@ -0,0 +1,125 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// Measures processing graph executor performance on synthetic graphs, the
+// audio fan-in summing kernel on its own, and how graph compile time grows
+// with node count, and writes the results as JSON so they can be compared
+// between builds.
+//
+// Usage:
+//   AnthemBench [--blocks=N] [--block-size=N] [--node-cost-ns=N]
+//               [--max-nodes=N] [--output=FILE]
+//
+// Each topology is run at 10, 100, 1,000 and 10,000 nodes (up to --max-nodes)
+// on the audio thread alone, then with each threaded scheduler. The summing
+// kernel is compared against a plain loop over the sources at 2 to 512
+// sources, using the same block size and block count. Compile time is
+// measured for chains and layered graphs of 1,000 to 50,000 nodes.
+
+#include "compile_bench.h"
+#include "executor_bench.h"
+#include "summing_bench.h"
+
+#include <iostream>
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+
+namespace {
+
+constexpr int benchNodeCounts[] = {10, 100, 1000, 10000};
+
+int getIntOption(const juce::ArgumentList& arguments, const juce::String& option, int fallback) {
+  if (!arguments.containsOption(option)) {
+    return fallback;
+  }
+
+  return arguments.getValueForOption(option).getIntValue();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  juce::ScopedJuceInitialiser_GUI juceInitialiser;
+  const juce::ArgumentList arguments(argc, argv);
+
+  anthem::executor_bench::BenchOptions options;
+  options.blockCount = getIntOption(arguments, "--blocks", options.blockCount);
+  options.blockSize = getIntOption(arguments, "--block-size", options.blockSize);
+  options.nodeCostNanoseconds =
+      getIntOption(arguments, "--node-cost-ns", static_cast<int>(options.nodeCostNanoseconds));
+  const auto maxNodeCount = getIntOption(arguments, "--max-nodes", 10000);
+
+  if (options.blockCount <= 0 || options.blockSize <= 0 || options.nodeCostNanoseconds < 0) {
+    std::cerr << "--blocks and --block-size must be positive, and --node-cost-ns must not be "
+                 "negative.\n";
+    return 1;
+  }
+
+  juce::Array<juce::var> results;
+
+  for (const auto topology : anthem::executor_bench::allTopologies) {
+    for (const auto nodeCount : benchNodeCounts) {
+      if (nodeCount > maxNodeCount) {
+        continue;
+      }
+
+      for (const auto& executorConfig : anthem::executor_bench::getExecutorConfigs()) {
+        std::cerr << anthem::executor_bench::getTopologyName(topology) << ", " << nodeCount
+                  << " nodes, " << executorConfig.name << "...\n";
+
+        results.add(anthem::executor_bench::runBenchmark(
+            topology, nodeCount, executorConfig, options));
+      }
+    }
+  }
+
+  juce::Array<juce::var> summingResults;
+
+  for (const auto sourceCount : anthem::summing_bench::sourceCounts) {
+    std::cerr << "summing, " << sourceCount << " sources...\n";
+
+    summingResults.add(anthem::summing_bench::runBenchmark(
+        sourceCount, options.blockSize, options.blockCount));
+  }
+
+  std::cerr << "compile...\n";
+  const auto compileResults = anthem::compile_bench::runBenchmarks(options);
+
+  auto* report = new juce::DynamicObject();
+  report->setProperty("blockSize", options.blockSize);
+  report->setProperty("nodeCostNs", static_cast<juce::int64>(options.nodeCostNanoseconds));
+  report->setProperty("results", results);
+  report->setProperty("summing", summingResults);
+  report->setProperty("compile", compileResults);
+
+  const auto json = juce::JSON::toString(juce::var(report));
+
+  if (arguments.containsOption("--output")) {
+    const auto outputFile = arguments.getFileForOption("--output");
+
+    if (!outputFile.replaceWithText(json)) {
+      std::cerr << "Could not write " << outputFile.getFullPathName() << "\n";
+      return 1;
+    }
+  } else {
+    std::cout << json << "\n";
+  }
+
+  return 0;
+}
@@ -0,0 +1,127 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "executor_bench.h"
+
+#include "modules/processing_graph/model/runtime_graph.h"
+#include "modules/processing_graph/runtime/graph_runtime_services.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <juce_core/juce_core.h>
+#include <limits>
+#include <memory>
+
+namespace anthem {
+
+namespace compile_bench {
+
+inline constexpr int nodeCounts[] = {1000, 10000, 50000};
+
+// Graph widths to compile. A width of 1 is a single chain. Wider graphs are
+// layers of that many nodes, with every node connected to every node in the
+// next layer, which is where per-path work would show up.
+inline constexpr int layerWidths[] = {1, 4};
+
+inline std::shared_ptr<ProcessingGraphModel> buildLayeredGraph(int nodeCount, int layerWidth) {
+  executor_bench::BenchGraphBuilder builder;
+
+  for (int node = 0; node < nodeCount; ++node) {
+    const auto nodeId = builder.addNode();
+    const auto layerStart = node / layerWidth * layerWidth;
+
+    if (layerStart == 0) {
+      continue;
+    }
+
+    // Node IDs start at 1 and follow the loop index.
+    for (auto source = layerStart - layerWidth; source < layerStart; ++source) {
+      builder.connect(source + 1, nodeId);
+    }
+  }
+
+  return builder.model;
+}
+
+// Compiles the graph a few times and returns the fastest, in milliseconds.
+inline double measureCompileMilliseconds(
+    ProcessingGraphModel& model, const executor_bench::BenchOptions& options) {
+  constexpr int attemptCount = 5;
+  double fastestMilliseconds = std::numeric_limits<double>::max();
+
+  for (int attempt = 0; attempt < attemptCount; ++attempt) {
+    GraphRuntimeServices rtServices;
+
+    const auto start = std::chrono::steady_clock::now();
+    auto runtimeGraph = RuntimeGraph::fromProcessingGraph(model,
+        rtServices,
+        GraphBufferLayout{
+            .numAudioChannels = 2,
+            .blockSize = options.blockSize,
+        },
+        options.sampleRate);
+    const auto end = std::chrono::steady_clock::now();
+
+    fastestMilliseconds = std::min(fastestMilliseconds,
+        std::chrono::duration<double, std::milli>(end - start).count());
+  }
+
+  return fastestMilliseconds;
+}
+
+// Times compiling each shape at each size, and returns the results as JSON
+// objects. perNodeRatio compares the cost per node with the smallest graph of
+// the same shape, so a ratio that grows with the node count means compiling
+// is not linear.
+inline juce::Array<juce::var> runBenchmarks(const executor_bench::BenchOptions& options) {
+  juce::Array<juce::var> results;
+
+  for (const auto layerWidth : layerWidths) {
+    double smallestPerNodeMilliseconds = 0.0;
+
+    for (const auto nodeCount : nodeCounts) {
+      auto model = buildLayeredGraph(nodeCount, layerWidth);
+      const auto compileMilliseconds = measureCompileMilliseconds(*model, options);
+      const auto perNodeMilliseconds = compileMilliseconds / static_cast<double>(nodeCount);
+
+      if (smallestPerNodeMilliseconds == 0.0) {
+        smallestPerNodeMilliseconds = perNodeMilliseconds;
+      }
+
+      auto* result = new juce::DynamicObject();
+      result->setProperty("nodeCount", nodeCount);
+      result->setProperty("layerWidth", layerWidth);
+      result->setProperty("compileMs", compileMilliseconds);
+      result->setProperty("perNodeUs", perNodeMilliseconds * 1000.0);
+      result->setProperty("perNodeRatio",
+          smallestPerNodeMilliseconds > 0.0 ? perNodeMilliseconds / smallestPerNodeMilliseconds
+                                            : 1.0);
+      results.add(juce::var(result));
+    }
+  }
+
+  return results;
+}
+
+} // namespace compile_bench
+
+} // namespace anthem
@@ -0,0 +1,407 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "modules/processing_graph/executor/graph_executor.h"
+#include "modules/processing_graph/graph_test_helpers.h"
+#include "modules/processing_graph/model/runtime_graph.h"
+#include "modules/processing_graph/processor/processor.h"
+#include "modules/processing_graph/runtime/graph_runtime_services.h"
+#include "modules/processing_graph/runtime/node_process_context.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <juce_core/juce_core.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace anthem {
+
+namespace executor_bench {
+
+enum class Topology {
+  // One source feeding every other node, which all feed one sink.
+  wideFanOut,
+
+  // Every node in a single line.
+  deepChain,
+
+  // Diamonds in series, each one splitting into two branches and joining back.
+  diamonds,
+
+  // Tracks of four devices, each sending to every bus as well as the master
+  // node. Buses also feed the master node.
+  sendBuses,
+
+  // Each node takes input from one to three random nodes among the 64 before
+  // it. The generator is seeded, so the graph is the same on every run.
+  randomDag,
+};
+
+inline const char* getTopologyName(Topology topology) {
+  switch (topology) {
+    case Topology::wideFanOut:
+      return "wide-fan-out";
+    case Topology::deepChain:
+      return "deep-chain";
+    case Topology::diamonds:
+      return "diamonds";
+    case Topology::sendBuses:
+      return "send-buses";
+    case Topology::randomDag:
+      return "random-dag";
+  }
+
+  jassertfalse;
+  return "unknown";
+}
+
+inline constexpr Topology allTopologies[] = {
+    Topology::wideFanOut,
+    Topology::deepChain,
+    Topology::diamonds,
+    Topology::sendBuses,
+    Topology::randomDag,
+};
+
+inline int64_t inputPortId(int64_t nodeId) {
+  return nodeId * 10 + 1;
+}
+
+inline int64_t outputPortId(int64_t nodeId) {
+  return nodeId * 10 + 2;
+}
+
+// Copies its input to its output, then spins until it has used up its cost.
+// Spinning on the clock rather than doing a fixed amount of arithmetic keeps
+// the cost the same across machines, so results reflect the scheduler.
+class StubProcessor : public Processor {
+public:
+  StubProcessor(int64_t nodeId, int64_t costNanoseconds)
+    : Processor("StubProcessor"), nodeId(nodeId), costNanoseconds(costNanoseconds) {}
+
+  void prepareToProcess() override {}
+
+  void process(NodeProcessContext& context, int numSamples) override {
+    const auto start = std::chrono::steady_clock::now();
+
+    const auto& input = context.getInputAudioBuffer(inputPortId(nodeId));
+    auto& output = context.getOutputAudioBuffer(outputPortId(nodeId));
+
+    for (int channel = 0; channel < output.getNumChannels(); ++channel) {
+      output.copyFrom(channel, 0, input, channel, 0, numSamples);
+      output.applyGain(channel, 0, numSamples, 0.5f);
+    }
+
+    const auto end = start + std::chrono::nanoseconds(costNanoseconds);
+
+    while (std::chrono::steady_clock::now() < end) {
+    }
+  }
+private:
+  int64_t nodeId;
+  int64_t costNanoseconds;
+};
+
+class BenchGraphBuilder {
+public:
+  BenchGraphBuilder() : model(graph_test_helpers::makeProcessingGraph()) {}
+
+  int64_t addNode() {
+    const auto nodeId = nextNodeId++;
+    auto node = graph_test_helpers::makeNode(nodeId);
+
+    node->audioInputPorts()->push_back(
+        graph_test_helpers::makePort(inputPortId(nodeId), nodeId, NodePortDataType::audio));
+    node->audioOutputPorts()->push_back(
+        graph_test_helpers::makePort(outputPortId(nodeId), nodeId, NodePortDataType::audio));
+
+    model->nodes()->insert_or_assign(nodeId, node);
+    return nodeId;
+  }
+
+  void connect(int64_t sourceNodeId, int64_t destinationNodeId) {
+    auto& nodes = *model->nodes();
+    const auto connectionId = nextConnectionId++;
+
+    auto connection = graph_test_helpers::makeConnection(connectionId,
+        sourceNodeId,
+        outputPortId(sourceNodeId),
+        destinationNodeId,
+        inputPortId(destinationNodeId));
+
+    nodes.at(sourceNodeId)->audioOutputPorts()->at(0)->connections()->push_back(connectionId);
+    nodes.at(destinationNodeId)->audioInputPorts()->at(0)->connections()->push_back(connectionId);
+
+    model->connections()->insert_or_assign(connectionId, connection);
+  }
+
+  std::shared_ptr<ProcessingGraphModel> model;
+private:
+  int64_t nextNodeId = 1;
+  int64_t nextConnectionId = 1;
+};
+
+// Builds a graph of roughly nodeCount nodes. Some topologies round the count
+// to fit their shape.
+inline std::shared_ptr<ProcessingGraphModel> buildTopology(Topology topology, int nodeCount) {
+  BenchGraphBuilder builder;
+  nodeCount = std::max(nodeCount, 4);
+
+  switch (topology) {
+    case Topology::wideFanOut: {
+      const auto source = builder.addNode();
+      const auto sink = builder.addNode();
+
+      for (int node = 2; node < nodeCount; ++node) {
+        const auto nodeId = builder.addNode();
+        builder.connect(source, nodeId);
+        builder.connect(nodeId, sink);
+      }
+
+      break;
+    }
+    case Topology::deepChain: {
+      auto previous = builder.addNode();
+
+      for (int node = 1; node < nodeCount; ++node) {
+        const auto nodeId = builder.addNode();
+        builder.connect(previous, nodeId);
+        previous = nodeId;
+      }
+
+      break;
+    }
+    case Topology::diamonds: {
+      auto previous = builder.addNode();
+
+      for (int node = 1; node + 3 <= nodeCount; node += 3) {
+        const auto left = builder.addNode();
+        const auto right = builder.addNode();
+        const auto join = builder.addNode();
+        builder.connect(previous, left);
+        builder.connect(previous, right);
+        builder.connect(left, join);
+        builder.connect(right, join);
+        previous = join;
+      }
+
+      break;
+    }
+    case Topology::sendBuses: {
+      constexpr int devicesPerTrack = 4;
+
+      const auto master = builder.addNode();
+      const auto busCount = std::max(1, nodeCount / 50);
+      const auto trackCount = std::max(1, (nodeCount - busCount - 1) / devicesPerTrack);
+
+      std::vector<int64_t> buses;
+
+      for (int bus = 0; bus < busCount; ++bus) {
+        buses.push_back(builder.addNode());
+        builder.connect(buses.back(), master);
+      }
+
+      for (int track = 0; track < trackCount; ++track) {
+        auto previous = builder.addNode();
+
+        for (int device = 1; device < devicesPerTrack; ++device) {
+          const auto nodeId = builder.addNode();
+          builder.connect(previous, nodeId);
+          previous = nodeId;
+        }
+
+        builder.connect(previous, master);
+
+        for (const auto bus : buses) {
+          builder.connect(previous, bus);
+        }
+      }
+
+      break;
+    }
+    case Topology::randomDag: {
+      constexpr int window = 64;
+
+      std::mt19937 random(1234);
+      std::vector<int64_t> nodes;
+      nodes.push_back(builder.addNode());
+
+      for (int node = 1; node < nodeCount; ++node) {
+        const auto nodeId = builder.addNode();
+        const auto upstreamCount = 1 + static_cast<int>(random() % 3);
+        const auto windowStart = std::max(0, node - window);
+
+        for (int upstream = 0; upstream < upstreamCount; ++upstream) {
+          const auto upstreamIndex =
+              windowStart + static_cast<int>(random() % static_cast<uint32_t>(node - windowStart));
+          builder.connect(nodes[static_cast<size_t>(upstreamIndex)], nodeId);
+        }
+
+        nodes.push_back(nodeId);
+      }
+
+      break;
+    }
+  }
+
+  return builder.model;
+}
+
+struct ExecutorConfig {
+  juce::String name;
+  GraphExecutor::ThreadConfig threadConfig;
+};
+
+inline std::vector<ExecutorConfig> getExecutorConfigs() {
+  return {
+      {"single-threaded", GraphExecutor::ThreadConfig{.audioThreadOnly = true}},
+      {"gated",
+          GraphExecutor::ThreadConfig{
+              .schedulerType = GraphExecutor::SchedulerType::gatedPriorityQueue}},
+      {"work-stealing",
+          GraphExecutor::ThreadConfig{.schedulerType = GraphExecutor::SchedulerType::workStealing}},
+      {"multi-queue",
+          GraphExecutor::ThreadConfig{
+              .schedulerType = GraphExecutor::SchedulerType::relaxedPriorityMultiQueue}},
+  };
+}
+
+struct BenchOptions {
+  int blockCount = 2000;
+  int warmupBlockCount = 50;
+  int blockSize = 256;
+  double sampleRate = 48000.0;
+  int64_t nodeCostNanoseconds = 500;
+};
+
+inline double getPercentileMicroseconds(const std::vector<int64_t>& sortedNanoseconds, double p) {
+  if (sortedNanoseconds.empty()) {
+    return 0.0;
+  }
+
+  const auto rank = static_cast<size_t>(std::ceil(p * static_cast<double>(sortedNanoseconds.size())));
+  const auto index = std::min(sortedNanoseconds.size() - 1, rank > 0 ? rank - 1 : 0);
+  return static_cast<double>(sortedNanoseconds[index]) / 1000.0;
+}
+
+// Runs one executor configuration over one graph and returns the results as a
+// JSON object.
+inline juce::var runBenchmark(Topology topology,
+    int nodeCount,
+    const ExecutorConfig& executorConfig,
+    const BenchOptions& options) {
+  auto model = buildTopology(topology, nodeCount);
+
+  GraphRuntimeServices rtServices;
+  auto runtimeGraph = RuntimeGraph::fromProcessingGraph(*model,
+      rtServices,
+      GraphBufferLayout{
+          .numAudioChannels = 2,
+          .blockSize = options.blockSize,
+      },
+      options.sampleRate);
+
+  std::vector<std::unique_ptr<StubProcessor>> processors;
+  processors.reserve(runtimeGraph->nodes.size());
+
+  for (auto& runtimeNode : runtimeGraph->nodes) {
+    processors.push_back(
+        std::make_unique<StubProcessor>(runtimeNode.id, options.nodeCostNanoseconds));
+    runtimeNode.processor = processors.back().get();
+  }
+
+  auto threadConfig = executorConfig.threadConfig;
+  threadConfig.audioBlockSize = options.blockSize;
+  threadConfig.sampleRate = options.sampleRate;
+
+  GraphExecutor executor;
+  executor.prepare(threadConfig);
+  auto runtimeState = executor.createRuntimeStateForGraph(*runtimeGraph);
+
+  for (int block = 0; block < options.warmupBlockCount; ++block) {
+    executor.rt_processBlock(*runtimeGraph, *runtimeState, options.blockSize);
+  }
+
+  executor.resetExecutionStats();
+  executor.setExecutionStatsEnabled(true);
+
+  std::vector<int64_t> blockNanoseconds;
+  blockNanoseconds.reserve(static_cast<size_t>(options.blockCount));
+
+  for (int block = 0; block < options.blockCount; ++block) {
+    const auto start = std::chrono::steady_clock::now();
+    executor.rt_processBlock(*runtimeGraph, *runtimeState, options.blockSize);
+    const auto end = std::chrono::steady_clock::now();
+
+    blockNanoseconds.push_back(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+  }
+
+  executor.setExecutionStatsEnabled(false);
+  const auto stats = executor.getExecutionStats();
+
+  int64_t totalBlockNanoseconds = 0;
+
+  for (const auto duration : blockNanoseconds) {
+    totalBlockNanoseconds += duration;
+  }
+
+  std::sort(blockNanoseconds.begin(), blockNanoseconds.end());
+
+  // How much of the workers' available time went into processing nodes.
+  const auto workerCapacityNanoseconds =
+      static_cast<double>(totalBlockNanoseconds) * static_cast<double>(stats.activeWorkerThreadCount);
+  const auto workerUtilisation =
+      workerCapacityNanoseconds > 0.0
+          ? static_cast<double>(stats.workerTaskNanoseconds) / workerCapacityNanoseconds
+          : 0.0;
+
+  const auto blockCount = std::max<uint64_t>(1, stats.blockCount);
+
+  auto* result = new juce::DynamicObject();
+  result->setProperty("topology", getTopologyName(topology));
+  result->setProperty("nodeCount", static_cast<int>(runtimeGraph->nodes.size()));
+  result->setProperty("taskCount", static_cast<int>(runtimeGraph->taskCount));
+  result->setProperty("audioBufferCount",
+      static_cast<int>(runtimeGraph->graphProcessContext->getAudioBufferCount()));
+  result->setProperty(
+      "unpooledAudioBufferCount", static_cast<int>(runtimeGraph->unpooledAudioBufferCount));
+  result->setProperty("executor", executorConfig.name);
+  result->setProperty("workerThreads", static_cast<int>(stats.activeWorkerThreadCount));
+  result->setProperty("blocks", options.blockCount);
+  result->setProperty("p50Us", getPercentileMicroseconds(blockNanoseconds, 0.5));
+  result->setProperty("p99Us", getPercentileMicroseconds(blockNanoseconds, 0.99));
+  result->setProperty("p999Us", getPercentileMicroseconds(blockNanoseconds, 0.999));
+  result->setProperty("maxUs", getPercentileMicroseconds(blockNanoseconds, 1.0));
+  result->setProperty("audioThreadSpinUsPerBlock",
+      static_cast<double>(stats.audioThreadSpinNanoseconds) / static_cast<double>(blockCount) /
+          1000.0);
+  result->setProperty("workerUtilisation", workerUtilisation);
+
+  return juce::var(result);
+}
+
+} // namespace executor_bench
+
+} // namespace anthem
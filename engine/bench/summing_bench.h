@@ -0,0 +1,143 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "modules/util/audio_summing.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+#include <vector>
+
+namespace anthem {
+
+namespace summing_bench {
+
+inline constexpr int sourceCounts[] = {2, 8, 32, 128, 512};
+
+// Sums the sources the way audio fan-in did before rt_sumAudioBuffers(): the
+// first source is copied into the destination, and each of the others is
+// added to the whole block in turn.
+inline void sumWithSequentialLoop(juce::AudioSampleBuffer& destination,
+    const std::vector<juce::AudioSampleBuffer>& sources,
+    int numSamples) {
+  bool hasAudibleSource = false;
+
+  for (const auto& source : sources) {
+    for (int channel = 0; channel < destination.getNumChannels(); ++channel) {
+      if (hasAudibleSource) {
+        destination.addFrom(channel, 0, source, channel, 0, numSamples);
+      } else {
+        destination.copyFrom(channel, 0, source, channel, 0, numSamples);
+      }
+    }
+
+    hasAudibleSource = true;
+  }
+}
+
+inline void sumWithKernel(juce::AudioSampleBuffer& destination,
+    const std::vector<juce::AudioSampleBuffer>& sources,
+    std::vector<const float*>& sourceChannelPointers,
+    int numSamples) {
+  for (int channel = 0; channel < destination.getNumChannels(); ++channel) {
+    for (size_t sourceIndex = 0; sourceIndex < sources.size(); ++sourceIndex) {
+      sourceChannelPointers[sourceIndex] = sources[sourceIndex].getReadPointer(channel);
+    }
+
+    rt_sumAudioBuffers(destination.getWritePointer(channel), sourceChannelPointers, numSamples);
+  }
+}
+
+template <typename SumFunction>
+double measureNanosecondsPerBlock(int blockCount, SumFunction&& sum) {
+  // One untimed pass warms the caches and the branch predictor.
+  sum();
+
+  const auto start = std::chrono::steady_clock::now();
+
+  for (int block = 0; block < blockCount; ++block) {
+    sum();
+  }
+
+  const auto end = std::chrono::steady_clock::now();
+
+  return static_cast<double>(
+             std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) /
+         static_cast<double>(blockCount);
+}
+
+// Times one fan-in size with both implementations and returns the results as
+// a JSON object.
+inline juce::var runBenchmark(int sourceCount, int blockSize, int blockCount) {
+  constexpr int channelCount = 2;
+
+  juce::Random random(sourceCount);
+  std::vector<juce::AudioSampleBuffer> sources;
+  sources.reserve(static_cast<size_t>(sourceCount));
+
+  for (int sourceIndex = 0; sourceIndex < sourceCount; ++sourceIndex) {
+    auto& source = sources.emplace_back(channelCount, blockSize);
+
+    for (int channel = 0; channel < channelCount; ++channel) {
+      for (int sample = 0; sample < blockSize; ++sample) {
+        source.setSample(channel, sample, random.nextFloat() * 2.0f - 1.0f);
+      }
+    }
+  }
+
+  juce::AudioSampleBuffer loopDestination(channelCount, blockSize);
+  juce::AudioSampleBuffer kernelDestination(channelCount, blockSize);
+  std::vector<const float*> sourceChannelPointers(static_cast<size_t>(sourceCount));
+
+  const auto loopNanoseconds = measureNanosecondsPerBlock(
+      blockCount, [&]() { sumWithSequentialLoop(loopDestination, sources, blockSize); });
+  const auto kernelNanoseconds = measureNanosecondsPerBlock(blockCount, [&]() {
+    sumWithKernel(kernelDestination, sources, sourceChannelPointers, blockSize);
+  });
+
+  // Keeps both results in use, and shows the difference in rounding between
+  // the two orders of summation.
+  float maxDifference = 0.0f;
+
+  for (int channel = 0; channel < channelCount; ++channel) {
+    for (int sample = 0; sample < blockSize; ++sample) {
+      maxDifference = std::max(maxDifference,
+          std::abs(loopDestination.getSample(channel, sample) -
+                   kernelDestination.getSample(channel, sample)));
+    }
+  }
+
+  auto* result = new juce::DynamicObject();
+  result->setProperty("sources", sourceCount);
+  result->setProperty("loopNsPerBlock", loopNanoseconds);
+  result->setProperty("kernelNsPerBlock", kernelNanoseconds);
+  result->setProperty(
+      "speedup", kernelNanoseconds > 0.0 ? loopNanoseconds / kernelNanoseconds : 0.0);
+  result->setProperty("maxDifference", static_cast<double>(maxDifference));
+
+  return juce::var(result);
+}
+
+} // namespace summing_bench
+
+} // namespace anthem
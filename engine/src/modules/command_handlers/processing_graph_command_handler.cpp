@@ -61,21 +61,28 @@ std::optional<Response> handleProcessingGraphCommand(Request& request) {
           .responseBase = ResponseBase{.id = compileProcessingGraphRequest.requestBase.get().id}});
     }
 
-    try {
-      engine.compileProcessingGraph();
-    } catch (std::runtime_error& e) {
-      juce::Logger::writeToLog("Error compiling: " + std::string(e.what()));
-
-      return std::optional(CompileProcessingGraphResponse{.success = false,
-          .error = std::string(e.what()),
-          .responseBase = ResponseBase{.id = compileProcessingGraphRequest.requestBase.get().id}});
-    }
+    // The graph is compiled on a background thread, so the response is sent
+    // once the compiled graph has been handed to the audio thread.
+    const auto requestId = compileProcessingGraphRequest.requestBase.get().id;
+
+    engine.compileProcessingGraph([requestId](const GraphCompiler::Result& result) {
+      if (result.success) {
+        juce::Logger::writeToLog("Finished compiling in " +
+                                 juce::String(result.compileDurationMicroseconds) + " us.");
+      } else {
+        juce::Logger::writeToLog("Error compiling: " + result.error.value_or(""));
+      }
+
+      std::optional<Response> response = std::optional(CompileProcessingGraphResponse{
+          .success = result.success,
+          .error = result.error,
+          .compileDurationMicroseconds = result.compileDurationMicroseconds,
+          .responseBase = ResponseBase{.id = requestId}});
+
+      Engine::getInstance().comms.send(rfl::json::write(response.value()));
+    });
 
-    juce::Logger::writeToLog("Finished compiling.");
-
-    return std::optional(CompileProcessingGraphResponse{.success = true,
-        .error = std::nullopt,
-        .responseBase = ResponseBase{.id = compileProcessingGraphRequest.requestBase.get().id}});
+    return std::nullopt;
   } else if (rfl::holds_alternative<GetPluginStateRequest>(request.variant())) {
     juce::Logger::writeToLog("Handling GetPluginStateRequest...");
 
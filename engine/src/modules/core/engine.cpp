@@ -20,8 +20,10 @@
 #include "modules/core/engine.h"
 
 #include "modules/core/adapters/transport_adapters.h"
-#include "modules/processing_graph/model/runtime_graph.h"
 #include "modules/processors/db_meter.h"
+#include "modules/util/simd/cpu_features.h"
+
+#include <utility>
 
 namespace anthem {
 
@@ -48,6 +50,7 @@ Engine::Engine() {
 
 void Engine::initialize() {
   this->graphProcessor = std::make_unique<GraphProcessor>();
+  this->graphCompiler = std::make_unique<GraphCompiler>(*graphProcessor);
   this->sequenceStore = std::make_unique<RuntimeSequenceStore>();
   transport = std::make_unique<Transport>(
       createTransportProjectView(*this), createTransportClock(audioDeviceManager));
@@ -141,6 +144,7 @@ std::shared_ptr<EngineAudioConfig> Engine::startAudioCallback() {
   juce::Logger::writeToLog("Selected audio device: " + device->getName());
   juce::Logger::writeToLog("Sample rate: " + juce::String(device->getCurrentSampleRate()));
   juce::Logger::writeToLog("Buffer size: " + juce::String(device->getCurrentBufferSizeSamples()));
+  juce::Logger::writeToLog("SIMD level: " + juce::String(simd::getSimdLevelName()));
   juce::Logger::writeToLog("Active output channels: " +
                            juce::String(device->getActiveOutputChannels().countNumberOfSetBits()));
 
@@ -171,48 +175,24 @@ std::shared_ptr<EngineAudioConfig> Engine::getCurrentAudioConfig() const {
   return buildAudioConfig(audioDeviceManager.getCurrentAudioDevice());
 }
 
-void Engine::compileProcessingGraph() {
+void Engine::compileProcessingGraph(GraphCompiler::CompletionCallback onComplete) {
   auto* currentDevice = audioDeviceManager.getCurrentAudioDevice();
   jassert(currentDevice != nullptr);
   if (currentDevice == nullptr) {
+    onComplete(GraphCompiler::Result{
+        .success = false,
+        .error = std::string("No audio device is active."),
+    });
     return;
   }
 
-  auto& processingGraph = *project->processingGraph();
-
-  auto runtimeGraph = RuntimeGraph::fromProcessingGraph(processingGraph,
-      graphProcessor->getRtServices(),
+  graphCompiler->requestCompile(*project->processingGraph(),
       GraphBufferLayout{
           .numAudioChannels = currentDevice->getActiveOutputChannels().countNumberOfSetBits(),
           .blockSize = currentDevice->getCurrentBufferSizeSamples(),
       },
-      currentDevice->getCurrentSampleRate());
-
-  // Make sure all nodes have been prepared for processing
-  for (auto& pair : *processingGraph.nodes()) {
-    auto& node = *pair.second;
-
-    auto& procVariant = node.processor();
-    if (!procVariant.has_value()) {
-      continue;
-    }
-
-    rfl::visit(
-        [&](const auto& field) {
-          // 'field' is the rfl::Field<Name, Type> wrapper.
-          // We get the actual std::shared_ptr with .value().
-          const auto& sharedPtr = field.value();
-          Processor* baseProcessor = sharedPtr.get();
-
-          if (!baseProcessor->isPrepared) {
-            baseProcessor->prepareToProcess();
-            baseProcessor->isPrepared = true;
-          }
-        },
-        procVariant.value());
-  }
-
-  graphProcessor->setRuntimeGraphFromMainThread(runtimeGraph.release());
+      currentDevice->getCurrentSampleRate(),
+      std::move(onComplete));
 }
 
 } // namespace anthem
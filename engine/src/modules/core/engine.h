@@ -32,6 +32,7 @@
 #include "modules/core/audio_callback.h"
 #include "modules/core/command_handler.h"
 #include "modules/core/visualization/global_visualization_sources.h"
+#include "modules/processing_graph/graph_compiler.h"
 #include "modules/processing_graph/graph_processor.h"
 #include "modules/sequencer/runtime/runtime_sequence_store.h"
 #include "modules/sequencer/runtime/transport.h"
@@ -67,6 +68,12 @@ public:
   // Executes the processing graph on the audio thread.
   std::unique_ptr<GraphProcessor> graphProcessor;
 
+  // Compiles the processing graph for graphProcessor on a background thread.
+  //
+  // This is declared after graphProcessor so that the compiler thread is
+  // stopped before the graph processor is destroyed.
+  std::unique_ptr<GraphCompiler> graphCompiler;
+
   // JUCE class for managing audio devices.
   //
   // This is declared before transport so the audio device manager outlives the
@@ -129,7 +136,10 @@ public:
 
   std::shared_ptr<EngineAudioConfig> getCurrentAudioConfig() const;
 
-  void compileProcessingGraph();
+  // Starts compiling the processing graph for the current audio device.
+  // onComplete is called on the message thread once the compiled graph has
+  // been handed to the audio thread, or once compiling has failed.
+  void compileProcessingGraph(GraphCompiler::CompletionCallback onComplete);
 };
 
 } // namespace anthem
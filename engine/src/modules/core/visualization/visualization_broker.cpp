@@ -32,8 +32,8 @@ template <typename T> using RemoveCvRef = std::remove_cv_t<std::remove_reference
 }
 
 VisualizationBroker::VisualizationBroker() {
-  this->updateIntervalMs = 15.0;
-  this->startTimerHz(static_cast<int>(1000.0 / this->updateIntervalMs));
+  this->updateIntervalMs.store(15.0, std::memory_order_relaxed);
+  this->startTimerHz(static_cast<int>(1000.0 / this->getUpdateIntervalMs()));
 }
 
 void VisualizationBroker::setSubscriptions(
@@ -42,10 +42,10 @@ void VisualizationBroker::setSubscriptions(
 }
 
 void VisualizationBroker::setUpdateInterval(double newUpdateIntervalMs) {
-  this->updateIntervalMs = newUpdateIntervalMs;
+  this->updateIntervalMs.store(newUpdateIntervalMs, std::memory_order_relaxed);
 
   this->stopTimer();
-  this->startTimerHz(static_cast<int>(1000.0 / this->updateIntervalMs));
+  this->startTimerHz(static_cast<int>(1000.0 / newUpdateIntervalMs));
 }
 
 void VisualizationBroker::timerCallback() {
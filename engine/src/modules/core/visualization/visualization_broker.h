@@ -22,6 +22,7 @@
 #include "juce_events/juce_events.h"
 #include "visualization_provider.h"
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -71,7 +72,9 @@ private:
   //
   // Defaults to just faster than 60 FPS (16.67ms). If the UI has a faster
   // refresh rate, this will be set to a lower value.
-  double updateIntervalMs;
+  //
+  // Written on the message thread, and read from any thread.
+  std::atomic<double> updateIntervalMs;
 
   void timerCallback() override;
 public:
@@ -83,6 +86,12 @@ public:
   void setSubscriptions(
       const std::vector<std::shared_ptr<VisualizationSubscriptionSpec>>& newSubscriptions);
   void setUpdateInterval(double updateIntervalMs);
+
+  // Any thread.
+  double getUpdateIntervalMs() const {
+    return updateIntervalMs.load(std::memory_order_relaxed);
+  }
+
   void registerDataProvider(
       const std::string& name, std::shared_ptr<VisualizationDataProvider> provider) {
     dataProviders[name] = provider;
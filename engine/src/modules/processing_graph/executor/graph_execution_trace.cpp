@@ -0,0 +1,300 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "graph_execution_trace.h"
+
+#include <chrono>
+#include <limits>
+
+namespace anthem {
+
+namespace {
+
+constexpr int drainIntervalMs = 50;
+constexpr int drainThreadStopTimeoutMs = 5000;
+constexpr int traceSlotStopPollIntervalMs = 1;
+
+juce::String formatMicroseconds(int64_t nanoseconds) {
+  return juce::String(static_cast<double>(nanoseconds) / 1000.0, 3);
+}
+
+juce::String getThreadName(size_t threadIndex) {
+  if (threadIndex == 0) {
+    return "Audio thread";
+  }
+
+  return "Graph worker " + juce::String(static_cast<int64_t>(threadIndex - 1));
+}
+
+} // namespace
+
+GraphExecutionTraceRing::GraphExecutionTraceRing(size_t capacity)
+  : fifo(static_cast<int>(capacity + 1)), buffer(capacity + 1) {
+  jassert(capacity < static_cast<size_t>(std::numeric_limits<int>::max()));
+}
+
+void GraphExecutionTraceRing::rt_add(const GraphExecutionTraceEvent& event) {
+  int start1 = 0;
+  int size1 = 0;
+  int start2 = 0;
+  int size2 = 0;
+  fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+  if (size1 <= 0) {
+    droppedEventCount.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  buffer[static_cast<size_t>(start1)] = event;
+  fifo.finishedWrite(1);
+}
+
+void GraphExecutionTraceRing::drainInto(std::vector<GraphExecutionTraceEvent>& target) {
+  const auto readyCount = fifo.getNumReady();
+
+  if (readyCount <= 0) {
+    return;
+  }
+
+  int start1 = 0;
+  int size1 = 0;
+  int start2 = 0;
+  int size2 = 0;
+  fifo.prepareToRead(readyCount, start1, size1, start2, size2);
+
+  target.insert(target.end(), buffer.begin() + start1, buffer.begin() + start1 + size1);
+  target.insert(target.end(), buffer.begin() + start2, buffer.begin() + start2 + size2);
+
+  fifo.finishedRead(size1 + size2);
+}
+
+uint64_t GraphExecutionTraceRing::getDroppedEventCount() const {
+  return droppedEventCount.load(std::memory_order_relaxed);
+}
+
+class GraphExecutionTracer::DrainThread final : public juce::Thread {
+public:
+  explicit DrainThread(GraphExecutionTracer& owner)
+    : juce::Thread("Anthem Graph Trace Drain"), owner(owner) {}
+
+  ~DrainThread() override {
+    stopThread(drainThreadStopTimeoutMs);
+  }
+
+  void run() override {
+    while (!threadShouldExit()) {
+      owner.drainToFile();
+      wait(drainIntervalMs);
+    }
+  }
+private:
+  GraphExecutionTracer& owner;
+};
+
+GraphExecutionTracer::GraphExecutionTracer(
+    size_t threadCount, const juce::File& outputFile, size_t eventCapacityPerThread)
+  : startTimestampNanoseconds(rt_getTimestampNanoseconds()) {
+  rings.reserve(threadCount);
+
+  for (size_t threadIndex = 0; threadIndex < threadCount; ++threadIndex) {
+    rings.push_back(std::make_unique<GraphExecutionTraceRing>(eventCapacityPerThread));
+  }
+
+  drainScratch.reserve(eventCapacityPerThread);
+
+  if (outputFile.exists()) {
+    outputFile.deleteFile();
+  }
+
+  outputStream = std::make_unique<juce::FileOutputStream>(outputFile);
+
+  if (outputStream->failedToOpen()) {
+    juce::Logger::writeToLog("Could not open graph execution trace file: " +
+                             outputFile.getFullPathName() + " (" +
+                             outputStream->getStatus().getErrorMessage() + ")");
+    outputStream.reset();
+  }
+
+  writeHeader();
+
+  drainThread = std::make_unique<DrainThread>(*this);
+  drainThread->startThread(juce::Thread::Priority::low);
+}
+
+GraphExecutionTracer::~GraphExecutionTracer() {
+  drainThread.reset();
+  drainToFile();
+  writeFooter();
+}
+
+int64_t GraphExecutionTracer::rt_getTimestampNanoseconds() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void GraphExecutionTracer::rt_record(
+    size_t threadIndex, GraphExecutionTraceEventType type, int64_t value) {
+  if (threadIndex >= rings.size()) {
+    return;
+  }
+
+  rings[threadIndex]->rt_add(GraphExecutionTraceEvent{
+      .type = type,
+      .timestampNanoseconds = rt_getTimestampNanoseconds(),
+      .value = value,
+  });
+}
+
+juce::String GraphExecutionTracer::formatEvent(const GraphExecutionTraceEvent& event,
+    size_t threadIndex,
+    int64_t startTimestampNanoseconds) {
+  const auto relativeTimestamp = event.timestampNanoseconds - startTimestampNanoseconds;
+  const auto common = ",\"pid\":1,\"tid\":" + juce::String(static_cast<int64_t>(threadIndex)) +
+                      ",\"ts\":" + formatMicroseconds(relativeTimestamp);
+
+  switch (event.type) {
+    case GraphExecutionTraceEventType::blockBegin:
+      return "{\"name\":\"Block\",\"cat\":\"block\",\"ph\":\"B\"" + common +
+             ",\"args\":{\"samples\":" + juce::String(event.value) + "}}";
+    case GraphExecutionTraceEventType::blockEnd:
+      return "{\"name\":\"Block\",\"cat\":\"block\",\"ph\":\"E\"" + common + "}";
+    case GraphExecutionTraceEventType::nodeBegin:
+      return "{\"name\":\"Node " + juce::String(event.value) + "\",\"cat\":\"node\",\"ph\":\"B\"" +
+             common + "}";
+    case GraphExecutionTraceEventType::nodeEnd:
+      return "{\"name\":\"Node " + juce::String(event.value) + "\",\"cat\":\"node\",\"ph\":\"E\"" +
+             common + "}";
+    case GraphExecutionTraceEventType::gateAcquire:
+      // Drawn as a span covering the time spent spinning for the gate.
+      return "{\"name\":\"Gate wait\",\"cat\":\"scheduler\",\"ph\":\"X\",\"pid\":1,\"tid\":" +
+             juce::String(static_cast<int64_t>(threadIndex)) +
+             ",\"ts\":" + formatMicroseconds(relativeTimestamp - event.value) +
+             ",\"dur\":" + formatMicroseconds(event.value) + "}";
+    case GraphExecutionTraceEventType::gateFail:
+      return "{\"name\":\"Gate fail\",\"cat\":\"scheduler\",\"ph\":\"i\",\"s\":\"t\"" + common +
+             "}";
+    case GraphExecutionTraceEventType::wake:
+      return "{\"name\":\"Wake\",\"cat\":\"worker\",\"ph\":\"i\",\"s\":\"t\"" + common + "}";
+    case GraphExecutionTraceEventType::sleep:
+      return "{\"name\":\"Sleep\",\"cat\":\"worker\",\"ph\":\"i\",\"s\":\"t\"" + common + "}";
+  }
+
+  jassertfalse;
+  return {};
+}
+
+void GraphExecutionTracer::drainToFile() {
+  const juce::ScopedLock lock(drainLock);
+
+  for (size_t threadIndex = 0; threadIndex < rings.size(); ++threadIndex) {
+    drainScratch.clear();
+    rings[threadIndex]->drainInto(drainScratch);
+
+    if (outputStream == nullptr) {
+      continue;
+    }
+
+    for (const auto& event : drainScratch) {
+      // The header always writes at least one event, so every event written
+      // here follows another one.
+      *outputStream << ",\n" << formatEvent(event, threadIndex, startTimestampNanoseconds);
+    }
+  }
+
+  if (outputStream != nullptr) {
+    outputStream->flush();
+  }
+}
+
+void GraphExecutionTracer::writeHeader() {
+  if (outputStream == nullptr) {
+    return;
+  }
+
+  *outputStream << "{\"traceEvents\":[\n"
+                << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+                << "\"args\":{\"name\":\"Anthem graph executor\"}}";
+
+  for (size_t threadIndex = 0; threadIndex < rings.size(); ++threadIndex) {
+    *outputStream << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+                  << juce::String(static_cast<int64_t>(threadIndex))
+                  << ",\"args\":{\"name\":\"" << getThreadName(threadIndex) << "\"}}";
+  }
+}
+
+void GraphExecutionTracer::writeFooter() {
+  if (outputStream == nullptr) {
+    return;
+  }
+
+  uint64_t droppedEventCount = 0;
+
+  for (auto& ring : rings) {
+    droppedEventCount += ring->getDroppedEventCount();
+  }
+
+  if (droppedEventCount > 0) {
+    juce::Logger::writeToLog("Graph execution trace dropped " +
+                             juce::String(static_cast<juce::int64>(droppedEventCount)) +
+                             " events because the drain thread fell behind.");
+  }
+
+  *outputStream << "\n],\"otherData\":{\"droppedEvents\":"
+                << juce::String(static_cast<juce::int64>(droppedEventCount)) << "}}\n";
+  outputStream->flush();
+}
+
+GraphExecutionTraceSlot::~GraphExecutionTraceSlot() {
+  stop();
+}
+
+void GraphExecutionTraceSlot::start(std::unique_ptr<GraphExecutionTracer> newTracer) {
+  stop();
+
+  tracer = std::move(newTracer);
+  rt_tracer.store(tracer.get(), std::memory_order_seq_cst);
+}
+
+void GraphExecutionTraceSlot::stop() {
+  if (tracer == nullptr) {
+    return;
+  }
+
+  rt_tracer.store(nullptr, std::memory_order_seq_cst);
+
+  // A block that picked up the tracer before it was cleared may still be
+  // recording into it.
+  while (rt_userCount.load(std::memory_order_seq_cst) > 0) {
+    juce::Thread::sleep(traceSlotStopPollIntervalMs);
+  }
+
+  tracer.reset();
+}
+
+GraphExecutionTracer* GraphExecutionTraceSlot::rt_acquire() {
+  rt_userCount.fetch_add(1, std::memory_order_seq_cst);
+  return rt_tracer.load(std::memory_order_seq_cst);
+}
+
+void GraphExecutionTraceSlot::rt_release() {
+  rt_userCount.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+} // namespace anthem
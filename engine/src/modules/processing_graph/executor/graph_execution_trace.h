@@ -0,0 +1,168 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <juce_core/juce_core.h>
+#include <memory>
+#include <vector>
+
+namespace anthem {
+
+enum class GraphExecutionTraceEventType : uint8_t {
+  // The audio thread started or finished processing a block. The value is the
+  // block size in samples.
+  blockBegin,
+  blockEnd,
+
+  // A thread started or finished processing a node. The value is the node ID.
+  nodeBegin,
+  nodeEnd,
+
+  // A thread acquired the scheduler gate. The value is how long it spun for,
+  // in nanoseconds.
+  gateAcquire,
+
+  // A worker gave up trying to acquire the scheduler gate.
+  gateFail,
+
+  // A worker woke up to help with a block, or went back to sleep.
+  wake,
+  sleep,
+};
+
+struct GraphExecutionTraceEvent {
+  GraphExecutionTraceEventType type = GraphExecutionTraceEventType::blockBegin;
+
+  // Nanoseconds on the steady clock.
+  int64_t timestampNanoseconds = 0;
+
+  // Meaning depends on the event type.
+  int64_t value = 0;
+};
+
+// A preallocated single-producer, single-consumer queue of trace events. Each
+// executor thread writes to its own ring, and the drain thread reads them all.
+//
+// If the drain thread falls behind and a ring fills up, new events are dropped
+// and counted rather than blocking the producer.
+class GraphExecutionTraceRing {
+public:
+  explicit GraphExecutionTraceRing(size_t capacity);
+
+  GraphExecutionTraceRing(const GraphExecutionTraceRing&) = delete;
+  GraphExecutionTraceRing& operator=(const GraphExecutionTraceRing&) = delete;
+
+  GraphExecutionTraceRing(GraphExecutionTraceRing&&) = delete;
+  GraphExecutionTraceRing& operator=(GraphExecutionTraceRing&&) = delete;
+
+  // Producer only.
+  void rt_add(const GraphExecutionTraceEvent& event);
+
+  // Consumer only. Appends everything currently in the ring to target.
+  void drainInto(std::vector<GraphExecutionTraceEvent>& target);
+
+  uint64_t getDroppedEventCount() const;
+private:
+  juce::AbstractFifo fifo;
+  std::vector<GraphExecutionTraceEvent> buffer;
+  std::atomic<uint64_t> droppedEventCount = 0;
+};
+
+// Records what each executor thread is doing, and streams it to a Chrome
+// trace-event JSON file that can be opened in Perfetto or chrome://tracing.
+//
+// Thread index 0 is the audio thread, and worker N is thread index N + 1, the
+// same as the executor's ready-queue indices.
+class GraphExecutionTracer {
+public:
+  GraphExecutionTracer(
+      size_t threadCount, const juce::File& outputFile, size_t eventCapacityPerThread = 1 << 16);
+  ~GraphExecutionTracer();
+
+  GraphExecutionTracer(const GraphExecutionTracer&) = delete;
+  GraphExecutionTracer& operator=(const GraphExecutionTracer&) = delete;
+
+  GraphExecutionTracer(GraphExecutionTracer&&) = delete;
+  GraphExecutionTracer& operator=(GraphExecutionTracer&&) = delete;
+
+  static int64_t rt_getTimestampNanoseconds();
+
+  void rt_record(size_t threadIndex, GraphExecutionTraceEventType type, int64_t value = 0);
+
+  // Formats one event as a Chrome trace-event JSON object. Timestamps are
+  // written relative to startTimestampNanoseconds.
+  static juce::String formatEvent(const GraphExecutionTraceEvent& event,
+      size_t threadIndex,
+      int64_t startTimestampNanoseconds);
+
+  // Moves all recorded events to the output file. This is called
+  // periodically by the drain thread, and once more on destruction.
+  void drainToFile();
+private:
+  class DrainThread;
+
+  void writeHeader();
+  void writeFooter();
+
+  int64_t startTimestampNanoseconds;
+  std::vector<std::unique_ptr<GraphExecutionTraceRing>> rings;
+  std::unique_ptr<juce::FileOutputStream> outputStream;
+  std::vector<GraphExecutionTraceEvent> drainScratch;
+  juce::CriticalSection drainLock;
+  std::unique_ptr<DrainThread> drainThread;
+};
+
+// Hands a tracer to the real-time threads, and makes sure it isn't destroyed
+// while a block that picked it up is still running.
+//
+// When no tracer is set, the only cost on the audio thread is two atomic
+// operations per block, and executor threads skip recording entirely.
+class GraphExecutionTraceSlot {
+public:
+  GraphExecutionTraceSlot() = default;
+  ~GraphExecutionTraceSlot();
+
+  GraphExecutionTraceSlot(const GraphExecutionTraceSlot&) = delete;
+  GraphExecutionTraceSlot& operator=(const GraphExecutionTraceSlot&) = delete;
+
+  GraphExecutionTraceSlot(GraphExecutionTraceSlot&&) = delete;
+  GraphExecutionTraceSlot& operator=(GraphExecutionTraceSlot&&) = delete;
+
+  // Main thread only. Replaces any current tracer.
+  void start(std::unique_ptr<GraphExecutionTracer> tracer);
+
+  // Main thread only. Waits for the current block to stop using the tracer,
+  // then flushes and destroys it.
+  void stop();
+
+  // Audio thread only. Each call to rt_acquire() must be paired with a call to
+  // rt_release() once the block, including any worker threads, is finished.
+  GraphExecutionTracer* rt_acquire();
+  void rt_release();
+private:
+  std::unique_ptr<GraphExecutionTracer> tracer;
+  std::atomic<GraphExecutionTracer*> rt_tracer = nullptr;
+  std::atomic<int> rt_userCount = 0;
+};
+
+} // namespace anthem
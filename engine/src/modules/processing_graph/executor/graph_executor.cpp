@@ -32,8 +32,9 @@
 
 namespace anthem {
 
-GraphExecutor::RuntimeState::RuntimeState(size_t readyNodeQueueCount, size_t readyNodeQueueCapacity)
-  : impl(std::make_unique<Impl>(readyNodeQueueCount, readyNodeQueueCapacity)) {}
+GraphExecutor::RuntimeState::RuntimeState(
+    size_t readyNodeQueueCount, size_t readyNodeQueueCapacity, SchedulerType schedulerType)
+  : impl(std::make_unique<Impl>(readyNodeQueueCount, readyNodeQueueCapacity, schedulerType)) {}
 
 GraphExecutor::RuntimeState::~RuntimeState() = default;
 
@@ -53,8 +54,42 @@ std::unique_ptr<GraphExecutor::RuntimeState> GraphExecutor::createRuntimeStateFo
     RuntimeGraph& runtimeGraph) {
   // Ready-node queues are pre-sized to the graph's node count, so this state
   // must be rebuilt whenever a new runtime graph may have a different shape.
-  return std::unique_ptr<RuntimeState>(
-      new RuntimeState(impl->getReadyNodeQueueCount(), runtimeGraph.nodes.size()));
+  return std::unique_ptr<RuntimeState>(new RuntimeState(
+      impl->getReadyNodeQueueCount(), runtimeGraph.nodes.size(), impl->getSchedulerType()));
+}
+
+void GraphExecutor::startTracing(const juce::File& outputFile) {
+  impl->traceSlot.start(
+      std::make_unique<GraphExecutionTracer>(impl->getReadyNodeQueueCount(), outputFile));
+}
+
+void GraphExecutor::stopTracing() {
+  impl->traceSlot.stop();
+}
+
+GraphExecutor::WorkerParkingStats GraphExecutor::getWorkerParkingStats() const {
+  return impl->getWorkerParkingStats();
+}
+
+void GraphExecutor::setExecutionStatsEnabled(bool enabled) {
+  impl->executionStats.enabled.store(enabled, std::memory_order_relaxed);
+}
+
+GraphExecutor::ExecutionStats GraphExecutor::getExecutionStats() const {
+  const auto& counters = impl->executionStats;
+
+  return ExecutionStats{
+      .activeWorkerThreadCount = impl->getActiveWorkerThreadCount(),
+      .blockCount = counters.blockCount.load(std::memory_order_relaxed),
+      .audioThreadSpinNanoseconds = counters.audioThreadSpinNanoseconds.load(std::memory_order_relaxed),
+      .audioThreadTaskNanoseconds = counters.audioThreadTaskNanoseconds.load(std::memory_order_relaxed),
+      .workerTaskNanoseconds = counters.workerTaskNanoseconds.load(std::memory_order_relaxed),
+      .skippedNodeCount = counters.skippedNodeCount.load(std::memory_order_relaxed),
+  };
+}
+
+void GraphExecutor::resetExecutionStats() {
+  impl->executionStats.reset();
 }
 
 void GraphExecutor::rt_processBlock(
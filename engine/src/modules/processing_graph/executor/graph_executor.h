@@ -20,6 +20,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <juce_core/juce_core.h>
 #include <memory>
 
@@ -35,10 +36,36 @@ class GraphExecutor {
 private:
   class Impl;
 public:
+  // Strategies the threaded executor can use to hand ready nodes to threads.
+  // See native/graph_executor_schedulers.ipp for details. The single-threaded
+  // executor ignores this.
+  enum class SchedulerType {
+    // One priority queue guarded by an atomic gate. This is the default.
+    gatedPriorityQueue,
+
+    // Per-thread Chase-Lev deques with stealing. Ignores node priority.
+    workStealing,
+
+    // Several small locked priority queues, popped with best-of-two random
+    // choice.
+    relaxedPriorityMultiQueue,
+  };
+
   struct ThreadConfig {
     int audioBlockSize = 0;
     double sampleRate = 0.0;
     size_t maxActiveWorkerThreadCount = 0;
+    SchedulerType schedulerType = SchedulerType::gatedPriorityQueue;
+
+    // Runs every node on the audio thread and leaves the worker threads idle.
+    // This is mainly for comparing threaded and single-threaded performance.
+    bool audioThreadOnly = false;
+
+    // Bounds for how long an idle worker spins before it sleeps. Between
+    // these, the spin time adapts to how soon the worker has recently been
+    // woken.
+    int64_t workerMinSpinNanoseconds = 2'000;
+    int64_t workerMaxSpinNanoseconds = 250'000;
 
     // Filled by GraphExecutor::prepare(). These are exposed here so the
     // platform-specific worker startup scopes can stay self-contained.
@@ -50,6 +77,49 @@ public:
 #endif
   };
 
+  // How worker threads have waited for work, summed over all workers since
+  // they were last started by prepare().
+  struct WorkerParkingStats {
+    // Wakes that found the worker still spinning. These cost no syscall.
+    uint64_t spinWakeCount = 0;
+
+    // Times a worker ran out of spin budget and went to sleep, and times a
+    // sleeping worker was woken.
+    uint64_t parkCount = 0;
+    uint64_t parkedWakeCount = 0;
+
+    // Total time spent spinning.
+    uint64_t spinNanoseconds = 0;
+
+    // Time from a wake being requested to the worker noticing it.
+    uint64_t totalWakeLatencyNanoseconds = 0;
+    int64_t maxWakeLatencyNanoseconds = 0;
+
+    uint64_t getWakeCount() const {
+      return spinWakeCount + parkedWakeCount;
+    }
+  };
+
+  // Timing totals, mainly for benchmarking. These are only collected while
+  // enabled with setExecutionStatsEnabled(), since they cost extra clock
+  // reads on the real-time threads.
+  struct ExecutionStats {
+    size_t activeWorkerThreadCount = 0;
+    uint64_t blockCount = 0;
+
+    // Time the audio thread spent spinning because no node was ready.
+    uint64_t audioThreadSpinNanoseconds = 0;
+
+    // Time spent processing nodes on the audio thread, and summed over all
+    // worker threads.
+    uint64_t audioThreadTaskNanoseconds = 0;
+    uint64_t workerTaskNanoseconds = 0;
+
+    // Node runs skipped because the node's inputs had been silent for longer
+    // than its processor's tail. See Processor::getTailLengthSamples().
+    uint64_t skippedNodeCount = 0;
+  };
+
   class RuntimeState {
   public:
     ~RuntimeState();
@@ -62,7 +132,9 @@ public:
   private:
     class Impl;
 
-    RuntimeState(size_t readyNodeQueueCount, size_t readyNodeQueueCapacity);
+    RuntimeState(size_t readyNodeQueueCount,
+        size_t readyNodeQueueCapacity,
+        SchedulerType schedulerType);
 
     friend class GraphExecutor::Impl;
     friend class GraphExecutor;
@@ -83,6 +155,28 @@ public:
   void prepare(const ThreadConfig& threadConfig);
   std::unique_ptr<RuntimeState> createRuntimeStateForGraph(RuntimeGraph& runtimeGraph);
   void rt_processBlock(RuntimeGraph& runtimeGraph, RuntimeState& runtimeState, int numSamples);
+
+  // Starts recording what each executor thread does into a Chrome
+  // trace-event JSON file, which can be opened in Perfetto or
+  // chrome://tracing. Tracing is off by default and costs nothing until this
+  // is called.
+  //
+  // Tracing covers the threads that exist when this is called, so it should
+  // be restarted after prepare() changes the worker count.
+  //
+  // Must be called from the main thread.
+  void startTracing(const juce::File& outputFile);
+
+  // Stops tracing and finishes writing the trace file. Must be called from the
+  // main thread.
+  void stopTracing();
+
+  WorkerParkingStats getWorkerParkingStats() const;
+
+  // Must be called from the main thread.
+  void setExecutionStatsEnabled(bool enabled);
+  ExecutionStats getExecutionStats() const;
+  void resetExecutionStats();
 private:
   std::unique_ptr<Impl> impl;
 };
@@ -23,9 +23,13 @@
 #include "modules/processing_graph/processor/event_buffer.h"
 #include "modules/processing_graph/processor/processor.h"
 #include "modules/processing_graph/runtime/node_process_context.h"
+#include "modules/util/audio_summing.h"
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <juce_core/juce_core.h>
+#include <span>
 
 namespace anthem {
 
@@ -33,30 +37,134 @@ GraphExecutorState::GraphExecutorState(RuntimeGraph& runtimeGraph) : runtimeGrap
 
 namespace {
 
+// Weight of the newest measurement in each node's moving-average cost.
+constexpr float processCostSmoothing = 0.125f;
+
+// Node costs are timed on one block in this many. Priorities are only
+// recomputed from them every few hundred milliseconds, so timing every node
+// on every block would cost two clock reads per node for no benefit.
+constexpr uint64_t processCostSampleIntervalBlocks = 16;
+
+void rt_recordProcessCost(
+    RuntimeNodeState& nodeState, std::chrono::steady_clock::duration elapsed) {
+  const auto elapsedNanoseconds = static_cast<float>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+  const auto previousAverage =
+      nodeState.rt_averageProcessNanoseconds.load(std::memory_order_relaxed);
+
+  // Each node is processed by one thread per block, and blocks are ordered by
+  // the executor, so a plain load and store is enough here.
+  const auto nextAverage =
+      previousAverage == 0.0f
+          ? elapsedNanoseconds
+          : previousAverage + (elapsedNanoseconds - previousAverage) * processCostSmoothing;
+
+  nodeState.rt_averageProcessNanoseconds.store(nextAverage, std::memory_order_relaxed);
+}
+
+// Writes a block for a parameter with change events in it. The smoother runs
+// up to each event's sample offset, and then ramps toward that event's value
+// from there, so each change lands on the sample it was scheduled for.
+void rt_writeScheduledParameterChangesToControlInput(
+    NodeProcessContext::InputParameterBinding& parameter,
+    std::span<const NodeProcessContext::ScheduledParameterChange> changes,
+    float secondsPerSample,
+    int numSamples) {
+  auto& smoother = parameter.rt_smoother;
+  auto* samples = parameter.rt_buffer->getWritePointer(0);
+  int position = 0;
+
+  for (const auto& change : changes) {
+    const auto changeOffset = std::clamp(change.sampleOffset, position, numSamples);
+
+    smoother.processBlock(secondsPerSample, samples + position, changeOffset - position);
+    smoother.setTargetValue(change.value);
+    position = changeOffset;
+  }
+
+  smoother.processBlock(secondsPerSample, samples + position, numSamples - position);
+  *parameter.rt_bufferShape = ControlBufferShape{};
+}
+
+// Writes this block's samples for one parameter to its control buffer.
+// Returns false once the parameter has settled and its buffer holds the
+// settled value, after which it doesn't need writing until it changes.
+bool rt_writeParameterToControlInput(NodeProcessContext::InputParameterBinding& parameter,
+    std::span<const NodeProcessContext::ScheduledParameterChange> scheduledChanges,
+    float secondsPerSample,
+    int numSamples) {
+  auto& smoother = parameter.rt_smoother;
+  auto& controlBuffer = *parameter.rt_buffer;
+  auto& bufferShape = *parameter.rt_bufferShape;
+
+  // The buffer is marked arbitrary here, so the settled case below rewrites
+  // it on the next block.
+  if (!scheduledChanges.empty()) {
+    rt_writeScheduledParameterChangesToControlInput(
+        parameter, scheduledChanges, secondsPerSample, numSamples);
+    return true;
+  }
+
+  // Nothing else writes to this buffer, so a settled value only needs to be
+  // written once. The whole buffer is filled, since later blocks may be
+  // longer than this one.
+  if (smoother.isSettled()) {
+    const auto currentValue = smoother.getCurrentValue();
+
+    if (!bufferShape.isConstant() || bufferShape.startValue != currentValue) {
+      juce::FloatVectorOperations::fill(
+          controlBuffer.getWritePointer(0), currentValue, controlBuffer.getNumSamples());
+      bufferShape = ControlBufferShape::constant(currentValue);
+    }
+
+    return false;
+  }
+
+  auto* samples = controlBuffer.getWritePointer(0);
+  const auto isLinear = smoother.processBlock(secondsPerSample, samples, numSamples);
+  jassert(juce::jlimit(0.0f, 1.0f, smoother.getCurrentValue()) == smoother.getCurrentValue());
+
+  if (!isLinear || numSamples <= 0) {
+    bufferShape = ControlBufferShape{};
+  } else if (samples[0] == samples[numSamples - 1]) {
+    // The rest of the buffer is filled too, for the settled case above.
+    juce::FloatVectorOperations::fill(
+        samples + numSamples, samples[0], controlBuffer.getNumSamples() - numSamples);
+    bufferShape = ControlBufferShape::constant(samples[0]);
+  } else {
+    bufferShape = ControlBufferShape::linearRamp(
+        samples[0], (samples[numSamples - 1] - samples[0]) / static_cast<float>(numSamples - 1));
+  }
+
+  return true;
+}
+
+// Only parameters that changed recently are visited. See
+// NodeProcessContext::rt_getActiveParameterIndices().
 void rt_writeParametersToControlInputs(
     NodeProcessContext& context, float sampleRate, int numSamples) {
   jassert(sampleRate > 0.0f);
   const auto secondsPerSample = sampleRate > 0.0f ? 1.0f / sampleRate : 0.0f;
 
-  for (auto& parameter : context.rt_getInputParameterBindings()) {
-    if (!parameter.rt_shouldWriteToBuffer) {
-      continue;
-    }
+  context.rt_takeParameterChanges();
 
-    auto value = parameter.value->load();
-    jassert(juce::jlimit(0.0f, 1.0f, value) == value);
+  auto& parameters = context.rt_getInputParameterBindings();
+  auto& activeParameterIndices = context.rt_getActiveParameterIndices();
 
-    if (parameter.rt_smoother->getTargetValue() != value) {
-      parameter.rt_smoother->setTargetValue(value);
-    }
+  for (size_t activeIndex = 0; activeIndex < activeParameterIndices.size();) {
+    const auto parameterIndex = activeParameterIndices[activeIndex];
+    auto& parameter = parameters[parameterIndex];
+    const auto scheduledChanges = context.rt_getScheduledParameterChanges(parameterIndex);
 
-    auto& controlBuffer = *parameter.rt_buffer;
-    for (int sample = 0; sample < numSamples; ++sample) {
-      parameter.rt_smoother->process(secondsPerSample);
-      auto currentValue = parameter.rt_smoother->getCurrentValue();
-      jassert(juce::jlimit(0.0f, 1.0f, currentValue) == currentValue);
-      controlBuffer.setSample(0, sample, currentValue);
+    if (rt_writeParameterToControlInput(
+            parameter, scheduledChanges, secondsPerSample, numSamples)) {
+      ++activeIndex;
+      continue;
     }
+
+    parameter.rt_isActive = false;
+    activeParameterIndices[activeIndex] = activeParameterIndices.back();
+    activeParameterIndices.pop_back();
   }
 }
 
@@ -74,22 +182,71 @@ void rt_applyControlConnectionTransfer(const RuntimeConnectionTransferAction& ac
   for (int channel = 0; channel < source.getNumChannels(); ++channel) {
     destination.copyFrom(channel, 0, source, channel, 0, numSamples);
   }
+
+  graphProcessContext.rt_getControlBufferShape(action.destinationBufferIndex) =
+      graphProcessContext.rt_getControlBufferShape(action.sourceBufferIndices.back());
 }
 
+// Merges the sources into the destination by sample offset, keeping each
+// source's own order. See EventBuffer for how events on the same sample from
+// different sources are ordered. Where those tie too, earlier sources go
+// first.
+//
+// Fan-in usually has only a few sources, so the next event is found by
+// scanning each source's next event rather than with a heap.
 void rt_applyEventConnectionTransfer(
     const RuntimeConnectionTransferAction& action, GraphProcessContext& graphProcessContext) {
   jassert(!action.sourceBufferIndices.empty());
+  jassert(action.rt_sourceCursors.size() == action.sourceBufferIndices.size());
 
   auto* destination = graphProcessContext.getEventBuffer(action.destinationBufferIndex).get();
   jassert(destination != nullptr);
 
-  for (const auto sourceBufferIndex : action.sourceBufferIndices) {
-    const auto* source = graphProcessContext.getEventBuffer(sourceBufferIndex).get();
+  size_t mergedEventCount = destination->getNumEvents();
+
+  for (size_t sourceIndex = 0; sourceIndex < action.sourceBufferIndices.size(); ++sourceIndex) {
+    const auto* source =
+        graphProcessContext.getEventBuffer(action.sourceBufferIndices[sourceIndex]).get();
     jassert(source != nullptr);
+    jassert(source->isSorted());
+
+    mergedEventCount += source->getNumEvents();
+    action.rt_sourceCursors[sourceIndex] = 0;
+  }
 
-    for (size_t eventIndex = 0; eventIndex < source->getNumEvents(); ++eventIndex) {
-      destination->addEvent(source->getEvent(eventIndex));
+  // The destination is sized when the graph is compiled to hold all of its
+  // sources at once, and keeps the larger buffer when state carries over. See
+  // NodeProcessContext::rt_adoptStateFrom(). Merging should never grow it.
+  jassert(mergedEventCount <= destination->getSize());
+  juce::ignoreUnused(mergedEventCount);
+
+  while (true) {
+    const LiveEvent* nextEvent = nullptr;
+    size_t nextSourceIndex = 0;
+
+    for (size_t sourceIndex = 0; sourceIndex < action.sourceBufferIndices.size(); ++sourceIndex) {
+      const auto* source =
+          graphProcessContext.getEventBuffer(action.sourceBufferIndices[sourceIndex]).get();
+      const auto cursor = action.rt_sourceCursors[sourceIndex];
+
+      if (cursor == source->getNumEvents()) {
+        continue;
+      }
+
+      const auto& event = source->getEvent(cursor);
+
+      if (nextEvent == nullptr || EventBuffer::comesBefore(event, *nextEvent)) {
+        nextEvent = &event;
+        nextSourceIndex = sourceIndex;
+      }
+    }
+
+    if (nextEvent == nullptr) {
+      break;
     }
+
+    destination->addEvent(*nextEvent);
+    ++action.rt_sourceCursors[nextSourceIndex];
   }
 }
 
@@ -109,19 +266,35 @@ void rt_applyAudioConnectionTransfer(const RuntimeConnectionTransferAction& acti
   }
 #endif
 
-  for (int channel = 0; channel < destination.getNumChannels(); ++channel) {
-    auto* destinationSamples = destination.getWritePointer(channel);
+  // Silent sources add nothing, so they are left out of the sum. If every
+  // source is silent, the destination is silenced as well, which carries the
+  // silence on to the node that reads it.
+  //
+  // The audible sources' pointers for each channel are gathered once, and the
+  // summing kernel then reads each of them a tile at a time.
+  auto sourceChannelPointers = action.rt_sourceChannelPointers;
+  jassert(sourceChannelPointers.size() == action.sourceBufferIndices.size());
 
-    for (int sample = 0; sample < numSamples; ++sample) {
-      float sum = 0.0f;
+  for (int channel = 0; channel < destination.getNumChannels(); ++channel) {
+    size_t audibleSourceCount = 0;
 
-      for (const auto sourceBufferIndex : action.sourceBufferIndices) {
-        const auto& source = graphProcessContext.getAudioBuffer(sourceBufferIndex);
-        sum += source.getReadPointer(channel)[sample];
+    for (const auto sourceBufferIndex : action.sourceBufferIndices) {
+      if (graphProcessContext.rt_isAudioBufferSilent(sourceBufferIndex)) {
+        continue;
       }
 
-      destinationSamples[sample] = sum;
+      sourceChannelPointers[audibleSourceCount++] =
+          graphProcessContext.getAudioBuffer(sourceBufferIndex).getReadPointer(channel);
+    }
+
+    if (audibleSourceCount == 0) {
+      graphProcessContext.rt_silenceAudioBuffer(action.destinationBufferIndex);
+      return;
     }
+
+    rt_sumAudioBuffers(destination.getWritePointer(channel),
+        sourceChannelPointers.first(audibleSourceCount),
+        numSamples);
   }
 }
 
@@ -141,13 +314,35 @@ void rt_applyConnectionTransfer(const RuntimeConnectionTransferAction& action,
   }
 }
 
-} // namespace
+// Returns true if the node's inputs have been silent for longer than its
+// processor's tail, in which case processing it would only produce silence.
+bool rt_shouldSkipSilentNode(RuntimeNode& node, int numSamples) {
+  if (node.processor == nullptr) {
+    return false;
+  }
 
-void rt_prepareGraphForBlock(GraphExecutorState& state) {
-  for (auto& [_, runtimeNode] : state.runtimeGraph.nodes) {
-    runtimeNode.rt_state.rt_remainingUpstreamNodes.store(
-        runtimeNode.upstreamNodeCount, std::memory_order_relaxed);
+  const auto tailLengthSamples = node.processor->getTailLengthSamples();
+
+  if (tailLengthSamples < 0 || !node.nodeProcessContext->rt_areInputsSilent()) {
+    node.rt_state.rt_silentInputSampleCount = 0;
+    return false;
   }
+
+  // The output of this block depends on at most tailLengthSamples samples of
+  // input from before it, so it is silent once that much input was silent.
+  const auto silentSamplesBeforeBlock = node.rt_state.rt_silentInputSampleCount;
+  node.rt_state.rt_silentInputSampleCount += numSamples;
+
+  return silentSamplesBeforeBlock >= tailLengthSamples;
+}
+
+} // namespace
+
+void rt_prepareGraphForBlock(GraphExecutorState& state, uint64_t blockIndex) {
+  state.runtimeGraph.rt_applyStagedPriorities();
+  state.runtimeGraph.rt_resetRemainingUpstreamNodeCounts();
+
+  state.rt_measureNodeCosts = blockIndex % processCostSampleIntervalBlocks == 0;
 }
 
 void rt_processNode(GraphExecutorState& state, RuntimeNode& node, int numSamples) {
@@ -158,23 +353,76 @@ void rt_processNode(GraphExecutorState& state, RuntimeNode& node, int numSamples
     return;
   }
 
+  const auto startTime = state.rt_measureNodeCosts ? std::chrono::steady_clock::now()
+                                                    : std::chrono::steady_clock::time_point();
+
   node.nodeProcessContext->clearBuffers();
-  rt_writeParametersToControlInputs(
-      *node.nodeProcessContext, state.runtimeGraph.sampleRate, numSamples);
 
   for (const auto& connectionTransferAction : node.connectionTransferActions) {
     rt_applyConnectionTransfer(
         connectionTransferAction, *state.runtimeGraph.graphProcessContext, numSamples);
   }
 
+  // Parameters are written even for nodes that are about to be skipped, so
+  // queued changes and smoothing keep moving while the input is silent rather
+  // than jumping once audio returns.
+  rt_writeParametersToControlInputs(
+      *node.nodeProcessContext, state.runtimeGraph.sampleRate, numSamples);
+
+  if (rt_shouldSkipSilentNode(node, numSamples)) {
+    node.nodeProcessContext->rt_silenceOutputs();
+
+    if (state.rt_executionStats != nullptr) {
+      state.rt_executionStats->skippedNodeCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return;
+  }
+
   if (node.processor != nullptr) {
     node.processor->process(*node.nodeProcessContext, numSamples);
+  } else {
+    node.nodeProcessContext->rt_silenceReusedOutputAudioBuffers();
+  }
+
+  if (state.rt_measureNodeCosts) {
+    rt_recordProcessCost(node.rt_state, std::chrono::steady_clock::now() - startTime);
   }
 }
 
+RuntimeNode& rt_processTask(
+    GraphExecutorState& state, RuntimeNode& taskHead, size_t threadIndex, int numSamples) {
+  jassert(!taskHead.isFusedIntoChain);
+
+  const auto taskStartNanoseconds =
+      state.rt_executionStats != nullptr ? rt_getSteadyClockNanoseconds() : 0;
+
+  rt_recordTraceEvent(state, threadIndex, GraphExecutionTraceEventType::nodeBegin, taskHead.id);
+  rt_processNode(state, taskHead, numSamples);
+  rt_recordTraceEvent(state, threadIndex, GraphExecutionTraceEventType::nodeEnd, taskHead.id);
+
+  for (auto* fusedNode : taskHead.fusedChainNodes) {
+    rt_recordTraceEvent(state, threadIndex, GraphExecutionTraceEventType::nodeBegin, fusedNode->id);
+    rt_processNode(state, *fusedNode, numSamples);
+    rt_recordTraceEvent(state, threadIndex, GraphExecutionTraceEventType::nodeEnd, fusedNode->id);
+  }
+
+  if (state.rt_executionStats != nullptr) {
+    const auto taskNanoseconds =
+        static_cast<uint64_t>(rt_getSteadyClockNanoseconds() - taskStartNanoseconds);
+    auto& counter = threadIndex == 0 ? state.rt_executionStats->audioThreadTaskNanoseconds
+                                     : state.rt_executionStats->workerTaskNanoseconds;
+    counter.fetch_add(taskNanoseconds, std::memory_order_relaxed);
+  }
+
+  return taskHead.getTaskTail();
+}
+
 bool rt_decrementRemainingUpstreamNodes(RuntimeNode& node) {
+  jassert(node.rt_state.rt_remainingUpstreamNodes != nullptr);
+
   const auto previousRemainingUpstreamNodeCount =
-      node.rt_state.rt_remainingUpstreamNodes.fetch_sub(1, std::memory_order_acq_rel);
+      node.rt_state.rt_remainingUpstreamNodes->fetch_sub(1, std::memory_order_acq_rel);
   jassert(previousRemainingUpstreamNodeCount > 0);
 
   return previousRemainingUpstreamNodeCount == 1;
@@ -19,24 +19,100 @@
 
 #pragma once
 
+#include "graph_execution_trace.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
 namespace anthem {
 
 class RuntimeGraph;
 struct RuntimeNode;
 
+inline int64_t rt_getSteadyClockNanoseconds() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Backs GraphExecutor::ExecutionStats.
+struct GraphExecutionStatsCounters {
+  std::atomic<bool> enabled{false};
+  std::atomic<uint64_t> blockCount{0};
+  std::atomic<uint64_t> audioThreadSpinNanoseconds{0};
+  std::atomic<uint64_t> audioThreadTaskNanoseconds{0};
+  std::atomic<uint64_t> workerTaskNanoseconds{0};
+  std::atomic<uint64_t> skippedNodeCount{0};
+
+  void reset() {
+    blockCount.store(0, std::memory_order_relaxed);
+    audioThreadSpinNanoseconds.store(0, std::memory_order_relaxed);
+    audioThreadTaskNanoseconds.store(0, std::memory_order_relaxed);
+    workerTaskNanoseconds.store(0, std::memory_order_relaxed);
+    skippedNodeCount.store(0, std::memory_order_relaxed);
+  }
+};
+
 struct GraphExecutorState {
   explicit GraphExecutorState(RuntimeGraph& runtimeGraph);
 
   RuntimeGraph& runtimeGraph;
+
+  // Set for the duration of a block when tracing is enabled.
+  GraphExecutionTracer* rt_tracer = nullptr;
+
+  // Set for the duration of a block when execution stats are enabled.
+  GraphExecutionStatsCounters* rt_executionStats = nullptr;
+
+  // Set by rt_prepareGraphForBlock() on blocks where node costs are timed.
+  bool rt_measureNodeCosts = false;
 };
 
-// Resets per-block runtime counters before scheduling starts.
-void rt_prepareGraphForBlock(GraphExecutorState& state);
+// Picks up the executor's stats counters for this block, if they are enabled.
+inline void rt_beginExecutionStatsForBlock(
+    GraphExecutorState& state, GraphExecutionStatsCounters& executionStats) {
+  if (!executionStats.enabled.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  state.rt_executionStats = &executionStats;
+  executionStats.blockCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void rt_recordTraceEvent(GraphExecutorState& state,
+    size_t threadIndex,
+    GraphExecutionTraceEventType type,
+    int64_t value = 0) {
+  if (state.rt_tracer != nullptr) {
+    state.rt_tracer->rt_record(threadIndex, type, value);
+  }
+}
+
+// Resets per-block runtime counters and applies any newly staged node
+// priorities before scheduling starts. Also decides whether node costs are
+// timed this block, from blockIndex, which the executor counts across blocks.
+void rt_prepareGraphForBlock(GraphExecutorState& state, uint64_t blockIndex);
 
 // Merges/copies this node's incoming connection data, updates parameter input
-// buffers, then invokes the node's processor if it has one.
+// buffers, then invokes the node's processor if it has one. A node without a
+// processor silences any output buffers it took over from earlier nodes.
+// On blocks where node costs are being timed, the time this takes is folded
+// into the node's moving-average cost.
+//
+// If the node's inputs have been silent for longer than its processor's tail,
+// the processor is skipped and the node's outputs are silenced instead. Its
+// parameters are still updated.
 void rt_processNode(GraphExecutorState& state, RuntimeNode& node, int numSamples);
 
+// Processes a scheduled node, then any nodes fused into its chain, recording
+// trace events and execution stats against the given thread index. Thread
+// index 0 is the audio thread. Returns the last node
+// processed, whose outgoing connections are the ones this task unlocks.
+RuntimeNode& rt_processTask(
+    GraphExecutorState& state, RuntimeNode& taskHead, size_t threadIndex, int numSamples);
+
 // Marks one upstream node as processed and returns true if this node is now
 // ready to run.
 bool rt_decrementRemainingUpstreamNodes(RuntimeNode& node);
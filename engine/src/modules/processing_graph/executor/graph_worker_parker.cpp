@@ -0,0 +1,225 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "graph_worker_parker.h"
+
+#include <juce_core/juce_core.h>
+
+// The threaded executor, and so this parker, only runs on desktop platforms.
+// See graph_executor.cpp.
+#if JUCE_WINDOWS || JUCE_MAC || JUCE_LINUX
+
+#include "graph_executor_shared.h"
+#include "spin_pause.h"
+
+#include <algorithm>
+
+#if JUCE_LINUX
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace anthem {
+
+namespace {
+
+constexpr int workerParkerSpinsPerClockCheck = 64;
+constexpr double workerParkerWaitAverageAlpha = 0.25;
+constexpr double workerParkerSpinBudgetHeadroom = 1.25;
+
+#if JUCE_LINUX
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+// The parking word doubles as a private futex, so a parked worker can be woken
+// with a single FUTEX_WAKE, and a worker that is still spinning can be woken
+// with no syscall at all.
+void rt_waitOnParkingWord(std::atomic<uint32_t>& word, uint32_t expectedValue) {
+  // Returns immediately if the word no longer holds expectedValue. Spurious
+  // returns and EINTR are handled by the caller re-checking the word.
+  syscall(SYS_futex,
+      reinterpret_cast<uint32_t*>(&word),
+      FUTEX_WAIT_PRIVATE,
+      expectedValue,
+      nullptr,
+      nullptr,
+      0);
+}
+
+void rt_wakeParkingWord(std::atomic<uint32_t>& word) {
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+}
+#else
+// C++20 atomic waits map to the platform's address-based wait where one
+// exists.
+void rt_waitOnParkingWord(std::atomic<uint32_t>& word, uint32_t expectedValue) {
+  word.wait(expectedValue, std::memory_order_acquire);
+}
+
+void rt_wakeParkingWord(std::atomic<uint32_t>& word) {
+  word.notify_one();
+}
+#endif
+
+} // namespace
+
+GraphWorkerParker::GraphWorkerParker(int64_t minSpinNanoseconds, int64_t maxSpinNanoseconds)
+  : minSpinNanoseconds(std::max<int64_t>(0, minSpinNanoseconds)),
+    maxSpinNanoseconds(std::max(this->minSpinNanoseconds, maxSpinNanoseconds)),
+    spinBudgetNanoseconds(this->minSpinNanoseconds) {}
+
+void GraphWorkerParker::park() {
+  uint32_t expectedState = busy;
+
+  // The only other state a busy worker can be in is woken, which means
+  // wakeForExit() was called while it was working.
+  if (!state.compare_exchange_strong(
+          expectedState, spinning, std::memory_order_acq_rel, std::memory_order_acquire)) {
+    state.store(busy, std::memory_order_relaxed);
+    return;
+  }
+
+  const auto parkStartNanoseconds = rt_getSteadyClockNanoseconds();
+
+  if (!rt_spinUntilWoken(parkStartNanoseconds)) {
+    rt_sleepUntilWoken();
+  }
+
+  const auto wokenNanoseconds = rt_getSteadyClockNanoseconds();
+  const auto wakeRequestNanoseconds =
+      wakeRequestTimestampNanoseconds.load(std::memory_order_relaxed);
+
+  if (wakeRequestNanoseconds > 0) {
+    const auto wakeLatencyNanoseconds =
+        std::max<int64_t>(0, wokenNanoseconds - wakeRequestNanoseconds);
+    totalWakeLatencyNanoseconds.fetch_add(
+        static_cast<uint64_t>(wakeLatencyNanoseconds), std::memory_order_relaxed);
+
+    if (wakeLatencyNanoseconds > maxWakeLatencyNanoseconds.load(std::memory_order_relaxed)) {
+      maxWakeLatencyNanoseconds.store(wakeLatencyNanoseconds, std::memory_order_relaxed);
+    }
+  }
+
+  updateSpinBudget(wokenNanoseconds - parkStartNanoseconds);
+  state.store(busy, std::memory_order_relaxed);
+}
+
+bool GraphWorkerParker::rt_tryWake() {
+  auto currentState = state.load(std::memory_order_acquire);
+
+  if (currentState != spinning && currentState != parked) {
+    return false;
+  }
+
+  wakeRequestTimestampNanoseconds.store(rt_getSteadyClockNanoseconds(), std::memory_order_relaxed);
+
+  if (!state.compare_exchange_strong(
+          currentState, woken, std::memory_order_acq_rel, std::memory_order_acquire)) {
+    return false;
+  }
+
+  if (currentState == parked) {
+    rt_wakeParkingWord(state);
+  }
+
+  return true;
+}
+
+void GraphWorkerParker::wakeForExit() {
+  wakeRequestTimestampNanoseconds.store(0, std::memory_order_relaxed);
+  state.store(woken, std::memory_order_release);
+  rt_wakeParkingWord(state);
+}
+
+void GraphWorkerParker::addStatsTo(GraphExecutor::WorkerParkingStats& stats) const {
+  stats.spinWakeCount += spinWakeCount.load(std::memory_order_relaxed);
+  stats.parkCount += parkCount.load(std::memory_order_relaxed);
+  stats.parkedWakeCount += parkedWakeCount.load(std::memory_order_relaxed);
+  stats.spinNanoseconds += spinNanoseconds.load(std::memory_order_relaxed);
+  stats.totalWakeLatencyNanoseconds += totalWakeLatencyNanoseconds.load(std::memory_order_relaxed);
+  stats.maxWakeLatencyNanoseconds = std::max(
+      stats.maxWakeLatencyNanoseconds, maxWakeLatencyNanoseconds.load(std::memory_order_relaxed));
+}
+
+bool GraphWorkerParker::rt_spinUntilWoken(int64_t parkStartNanoseconds) {
+  int64_t spinEndNanoseconds = 0;
+
+  while (true) {
+    for (int spin = 0; spin < workerParkerSpinsPerClockCheck; ++spin) {
+      if (state.load(std::memory_order_acquire) == woken) {
+        spinNanoseconds.fetch_add(
+            static_cast<uint64_t>(rt_getSteadyClockNanoseconds() - parkStartNanoseconds),
+            std::memory_order_relaxed);
+        spinWakeCount.fetch_add(1, std::memory_order_relaxed);
+        return true;
+      }
+
+      spin_pause();
+    }
+
+    spinEndNanoseconds = rt_getSteadyClockNanoseconds();
+
+    if (spinEndNanoseconds - parkStartNanoseconds >= spinBudgetNanoseconds) {
+      break;
+    }
+  }
+
+  spinNanoseconds.fetch_add(
+      static_cast<uint64_t>(spinEndNanoseconds - parkStartNanoseconds), std::memory_order_relaxed);
+
+  uint32_t expectedState = spinning;
+
+  if (!state.compare_exchange_strong(
+          expectedState, parked, std::memory_order_acq_rel, std::memory_order_acquire)) {
+    // Woken just as the budget ran out.
+    spinWakeCount.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  return false;
+}
+
+void GraphWorkerParker::rt_sleepUntilWoken() {
+  parkCount.fetch_add(1, std::memory_order_relaxed);
+
+  // The wait can return spuriously, so the word is checked each time.
+  while (state.load(std::memory_order_acquire) == parked) {
+    rt_waitOnParkingWord(state, parked);
+  }
+
+  parkedWakeCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void GraphWorkerParker::updateSpinBudget(int64_t waitNanoseconds) {
+  averageWaitNanoseconds +=
+      (static_cast<double>(waitNanoseconds) - averageWaitNanoseconds) *
+      workerParkerWaitAverageAlpha;
+
+  const auto targetSpinNanoseconds =
+      static_cast<int64_t>(averageWaitNanoseconds * workerParkerSpinBudgetHeadroom);
+
+  spinBudgetNanoseconds = targetSpinNanoseconds <= maxSpinNanoseconds
+                              ? std::max(minSpinNanoseconds, targetSpinNanoseconds)
+                              : minSpinNanoseconds;
+}
+
+} // namespace anthem
+
+#endif
@@ -0,0 +1,102 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "graph_executor.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace anthem {
+
+// Holds an idle worker thread until another thread has work for it.
+//
+// The worker spins first, so a wake that arrives soon costs the waker a single
+// compare-and-swap. If nothing arrives within the spin budget, the worker
+// sleeps on the parking word, and waking it costs one syscall.
+//
+// The spin budget follows how long this worker has recently waited. If wakes
+// tend to arrive within the maximum budget, for example because blocks are
+// short, the worker spins a little longer than the typical wait so it is
+// still spinning when the next block starts. Otherwise spinning would only
+// burn a core, so it spins for the minimum budget.
+//
+// This is only used by the threaded executor, so it is only built on the
+// platforms that executor runs on.
+class GraphWorkerParker {
+public:
+  GraphWorkerParker(int64_t minSpinNanoseconds, int64_t maxSpinNanoseconds);
+
+  GraphWorkerParker(const GraphWorkerParker&) = delete;
+  GraphWorkerParker& operator=(const GraphWorkerParker&) = delete;
+
+  GraphWorkerParker(GraphWorkerParker&&) = delete;
+  GraphWorkerParker& operator=(GraphWorkerParker&&) = delete;
+
+  // Worker thread only. Returns once rt_tryWake() or wakeForExit() is called.
+  void park();
+
+  // Any thread. Wakes the worker if it is spinning or parked. Returns false if
+  // it is busy or another thread already woke it.
+  bool rt_tryWake();
+
+  // Main thread only. Wakes the worker whatever it is doing, so that it can
+  // see that it should exit.
+  void wakeForExit();
+
+  void addStatsTo(GraphExecutor::WorkerParkingStats& stats) const;
+
+  // How long the next park() will spin before sleeping. Only valid on the
+  // worker thread, or once the worker thread has stopped.
+  int64_t getSpinBudgetNanoseconds() const {
+    return spinBudgetNanoseconds;
+  }
+private:
+  enum ParkingState : uint32_t {
+    busy,
+    spinning,
+    parked,
+    woken,
+  };
+
+  // Returns true if the worker was woken while spinning.
+  bool rt_spinUntilWoken(int64_t parkStartNanoseconds);
+
+  void rt_sleepUntilWoken();
+  void updateSpinBudget(int64_t waitNanoseconds);
+
+  std::atomic<uint32_t> state{busy};
+  std::atomic<int64_t> wakeRequestTimestampNanoseconds{0};
+
+  // Only touched by the worker thread.
+  int64_t minSpinNanoseconds;
+  int64_t maxSpinNanoseconds;
+  int64_t spinBudgetNanoseconds;
+  double averageWaitNanoseconds = 0.0;
+
+  std::atomic<uint64_t> spinWakeCount{0};
+  std::atomic<uint64_t> parkCount{0};
+  std::atomic<uint64_t> parkedWakeCount{0};
+  std::atomic<uint64_t> spinNanoseconds{0};
+  std::atomic<uint64_t> totalWakeLatencyNanoseconds{0};
+  std::atomic<int64_t> maxWakeLatencyNanoseconds{0};
+};
+
+} // namespace anthem
@@ -0,0 +1,735 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// Scheduler strategies for the threaded graph executor.
+//
+// Each scheduler owns the ready-node storage for one runtime graph, and is
+// driven by GraphExecutor::Impl through the same small interface:
+//
+// - rt_prepareForBlock() runs on the audio thread before any worker is
+//   allowed to run, and seeds the scheduler with the graph's input nodes.
+// - rt_popNextNode() returns the next node the calling thread should process,
+//   or nullptr if there is nothing for it to do right now. Worker threads only
+//   take work if at least two nodes are ready, so the audio thread, which
+//   cannot sleep, is not left waiting on a worker that picked up the last
+//   ready node.
+//   Schedulers with a lock record gate events to the tracer, if one is set.
+// - rt_pushReadyNode() publishes a node whose upstream nodes have all been
+//   processed.
+//
+// Schedulers are selected through GraphExecutor::ThreadConfig::schedulerType,
+// and are dispatched once per call to rt_doWork(), so the per-node calls are
+// not virtual.
+
+#include <cstdint>
+#include <variant>
+
+namespace anthem {
+
+namespace {
+
+// The original scheduler, described in
+// docs/design/multithreaded_audio_processing.md. One global priority queue is
+// guarded by an atomic gate, and each thread publishes newly ready nodes
+// through its own SPSC ring, which is drained into the priority queue by
+// whichever thread holds the gate.
+class GatedPriorityQueueScheduler {
+public:
+  GatedPriorityQueueScheduler(size_t threadCount, size_t nodeCapacity) {
+    readyNodeQueues.reserve(threadCount);
+
+    for (size_t queueIndex = 0; queueIndex < threadCount; ++queueIndex) {
+      readyNodeQueues.push_back(std::make_unique<RuntimeReadyNodeQueue>(nodeCapacity));
+    }
+  }
+
+  GatedPriorityQueueScheduler(const GatedPriorityQueueScheduler&) = delete;
+  GatedPriorityQueueScheduler& operator=(const GatedPriorityQueueScheduler&) = delete;
+
+  GatedPriorityQueueScheduler(GatedPriorityQueueScheduler&&) = delete;
+  GatedPriorityQueueScheduler& operator=(GatedPriorityQueueScheduler&&) = delete;
+
+  size_t getThreadCount() const {
+    return readyNodeQueues.size();
+  }
+
+  void rt_prepareForBlock(RuntimeGraph& runtimeGraph) {
+    jassert(runtimeGraph.availableTasks.empty());
+
+    for (auto& readyNodeQueue : readyNodeQueues) {
+      readyNodeQueue->clear();
+    }
+
+    if (readyNodeQueues.empty()) {
+      return;
+    }
+
+    for (auto* inputNode : runtimeGraph.inputNodes) {
+      if (!readyNodeQueues[audioThreadReadyQueueIndex]->add(inputNode)) {
+        jassertfalse;
+      }
+    }
+  }
+
+  template <typename WakeWorker>
+  RuntimeNode* rt_popNextNode(RuntimeGraph& runtimeGraph,
+      ExecutorThreadRole role,
+      size_t readyQueueIndex,
+      GraphExecutionTracer* tracer,
+      WakeWorker&& wakeWorker) {
+    const auto gateWaitStart =
+        tracer != nullptr ? GraphExecutionTracer::rt_getTimestampNanoseconds() : 0;
+
+    if (!rt_acquireSchedulerGate(role)) {
+      if (tracer != nullptr) {
+        tracer->rt_record(readyQueueIndex, GraphExecutionTraceEventType::gateFail);
+      }
+
+      return nullptr;
+    }
+
+    if (tracer != nullptr) {
+      tracer->rt_record(readyQueueIndex,
+          GraphExecutionTraceEventType::gateAcquire,
+          GraphExecutionTracer::rt_getTimestampNanoseconds() - gateWaitStart);
+    }
+
+    rt_drainReadyNodeQueues(runtimeGraph);
+    auto* nextNode = rt_popNextAvailableNode(runtimeGraph, role);
+
+    if (runtimeGraph.availableTasks.size() >= 2) {
+      wakeWorker();
+    }
+
+    rt_releaseSchedulerGate();
+
+    return nextNode;
+  }
+
+  void rt_pushReadyNode(RuntimeNode* runtimeNode, size_t readyQueueIndex) {
+    jassert(readyQueueIndex < readyNodeQueues.size());
+
+    if (readyQueueIndex >= readyNodeQueues.size()) {
+      return;
+    }
+
+    if (!readyNodeQueues[readyQueueIndex]->add(runtimeNode)) {
+      jassertfalse;
+    }
+  }
+private:
+  bool rt_acquireSchedulerGate(ExecutorThreadRole role) {
+    if (role == ExecutorThreadRole::audioThread) {
+      audioThreadWaitingForSchedulerGate.store(true, std::memory_order_release);
+
+      while (true) {
+        bool expected = false;
+
+        if (schedulerGate.compare_exchange_weak(
+                expected, true, std::memory_order_acq_rel, std::memory_order_acquire)) {
+          audioThreadWaitingForSchedulerGate.store(false, std::memory_order_release);
+          return true;
+        }
+
+        spin_pause();
+      }
+    }
+
+    for (int attempt = 0; attempt < workerGateSpinAttempts; ++attempt) {
+      if (audioThreadWaitingForSchedulerGate.load(std::memory_order_acquire)) {
+        spin_pause();
+        continue;
+      }
+
+      bool expected = false;
+
+      if (schedulerGate.compare_exchange_weak(
+              expected, true, std::memory_order_acq_rel, std::memory_order_acquire)) {
+        return true;
+      }
+
+      spin_pause();
+    }
+
+    return false;
+  }
+
+  void rt_releaseSchedulerGate() {
+    schedulerGate.store(false, std::memory_order_release);
+  }
+
+  // As worker threads complete tasks, they may unlock downstream nodes for
+  // processing. Each thread has a ring buffer that it pushes node pointers to
+  // when they are unlocked.
+  //
+  // This method pulls from these buffers and adds to the main task queue.
+  //
+  // Reading from these ring buffers and reading/writing from/to the main task
+  // queue are NOT inherently thread-safe operations, and must be gated by
+  // schedulerGate.
+  void rt_drainReadyNodeQueues(RuntimeGraph& runtimeGraph) {
+    for (auto& readyNodeQueue : readyNodeQueues) {
+      while (auto readyNode = readyNodeQueue->read()) {
+        if (readyNode.value() != nullptr) {
+          runtimeGraph.availableTasks.push(readyNode.value());
+        }
+      }
+    }
+  }
+
+  RuntimeNode* rt_popNextAvailableNode(RuntimeGraph& runtimeGraph, ExecutorThreadRole role) {
+    if (runtimeGraph.availableTasks.empty()) {
+      return nullptr;
+    }
+
+    auto* nextNode = runtimeGraph.availableTasks.top();
+
+    if (role == ExecutorThreadRole::workerThread) {
+      if (runtimeGraph.availableTasks.size() < 2) {
+        return nullptr;
+      }
+    }
+
+    runtimeGraph.availableTasks.pop();
+    return nextNode;
+  }
+
+  std::vector<std::unique_ptr<RuntimeReadyNodeQueue>> readyNodeQueues;
+  std::atomic<bool> schedulerGate{false};
+  std::atomic<bool> audioThreadWaitingForSchedulerGate{false};
+};
+
+// A fixed-capacity Chase-Lev work-stealing deque.
+//
+// The owning thread pushes and takes from the bottom, and other threads steal
+// from the top. Each node is pushed at most once per block and the indices are
+// reset before every block, so the buffer is sized to the node count and never
+// needs to wrap or grow.
+//
+// See Lê, Pop, Cohen and Zappa Nardelli, "Correct and Efficient Work-Stealing
+// for Weak Memory Models" (PPoPP 2013) for the memory ordering used here.
+class WorkStealingDeque {
+public:
+  explicit WorkStealingDeque(size_t capacity) : buffer(std::max<size_t>(capacity, 1)) {}
+
+  WorkStealingDeque(const WorkStealingDeque&) = delete;
+  WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+  WorkStealingDeque(WorkStealingDeque&&) = delete;
+  WorkStealingDeque& operator=(WorkStealingDeque&&) = delete;
+
+  // Must only be called while no other thread can access this deque.
+  void rt_reset() {
+    top.store(0, std::memory_order_relaxed);
+    bottom.store(0, std::memory_order_relaxed);
+  }
+
+  // Owner only.
+  bool rt_push(RuntimeNode* runtimeNode) {
+    const auto currentBottom = bottom.load(std::memory_order_relaxed);
+
+    if (currentBottom >= static_cast<int64_t>(buffer.size())) {
+      return false;
+    }
+
+    buffer[static_cast<size_t>(currentBottom)].store(runtimeNode, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(currentBottom + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Owner only.
+  RuntimeNode* rt_take() {
+    const auto newBottom = bottom.load(std::memory_order_relaxed) - 1;
+    bottom.store(newBottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto currentTop = top.load(std::memory_order_relaxed);
+
+    if (currentTop > newBottom) {
+      bottom.store(newBottom + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+
+    auto* runtimeNode = buffer[static_cast<size_t>(newBottom)].load(std::memory_order_relaxed);
+
+    if (currentTop == newBottom) {
+      // This is the last item, so we race against any thieves for it.
+      if (!top.compare_exchange_strong(currentTop,
+              currentTop + 1,
+              std::memory_order_seq_cst,
+              std::memory_order_relaxed)) {
+        runtimeNode = nullptr;
+      }
+
+      bottom.store(newBottom + 1, std::memory_order_relaxed);
+    }
+
+    return runtimeNode;
+  }
+
+  // Any thread.
+  RuntimeNode* rt_steal() {
+    auto currentTop = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const auto currentBottom = bottom.load(std::memory_order_acquire);
+
+    if (currentTop >= currentBottom) {
+      return nullptr;
+    }
+
+    auto* runtimeNode = buffer[static_cast<size_t>(currentTop)].load(std::memory_order_relaxed);
+
+    if (!top.compare_exchange_strong(
+            currentTop, currentTop + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      return nullptr;
+    }
+
+    return runtimeNode;
+  }
+
+  // Any thread. This is only a hint, since other threads may be pushing or
+  // taking at the same time.
+  size_t rt_getApproximateSize() const {
+    const auto currentTop = top.load(std::memory_order_relaxed);
+    const auto currentBottom = bottom.load(std::memory_order_relaxed);
+    return currentBottom > currentTop ? static_cast<size_t>(currentBottom - currentTop) : 0;
+  }
+private:
+  alignas(64) std::atomic<int64_t> top{0};
+  alignas(64) std::atomic<int64_t> bottom{0};
+  std::vector<std::atomic<RuntimeNode*>> buffer;
+};
+
+// Each thread pushes the nodes it unlocks onto its own deque and keeps working
+// from it, which keeps a chain of nodes on the thread that already has that
+// chain's buffers in cache. Idle threads steal from the other end of other
+// threads' deques. There is no shared lock, but node priority is not used at
+// all, so this trades critical-path ordering for lower scheduling overhead.
+class WorkStealingScheduler {
+public:
+  WorkStealingScheduler(size_t threadCount, size_t nodeCapacity) {
+    deques.reserve(threadCount);
+
+    for (size_t dequeIndex = 0; dequeIndex < threadCount; ++dequeIndex) {
+      deques.push_back(std::make_unique<WorkStealingDeque>(nodeCapacity));
+    }
+  }
+
+  WorkStealingScheduler(const WorkStealingScheduler&) = delete;
+  WorkStealingScheduler& operator=(const WorkStealingScheduler&) = delete;
+
+  WorkStealingScheduler(WorkStealingScheduler&&) = delete;
+  WorkStealingScheduler& operator=(WorkStealingScheduler&&) = delete;
+
+  size_t getThreadCount() const {
+    return deques.size();
+  }
+
+  void rt_prepareForBlock(RuntimeGraph& runtimeGraph) {
+    for (auto& deque : deques) {
+      deque->rt_reset();
+    }
+
+    if (deques.empty()) {
+      return;
+    }
+
+    auto& audioThreadDeque = *deques[audioThreadReadyQueueIndex];
+
+    for (auto* inputNode : runtimeGraph.inputNodes) {
+      if (!audioThreadDeque.rt_push(inputNode)) {
+        jassertfalse;
+      }
+    }
+  }
+
+  template <typename WakeWorker>
+  RuntimeNode* rt_popNextNode(RuntimeGraph& runtimeGraph,
+      ExecutorThreadRole role,
+      size_t readyQueueIndex,
+      GraphExecutionTracer* tracer,
+      WakeWorker&& wakeWorker) {
+    juce::ignoreUnused(runtimeGraph, tracer);
+    jassert(readyQueueIndex < deques.size());
+
+    if (readyQueueIndex >= deques.size()) {
+      return nullptr;
+    }
+
+    auto* nextNode = deques[readyQueueIndex]->rt_take();
+
+    if (nextNode == nullptr) {
+      nextNode = rt_stealNode(role, readyQueueIndex);
+    }
+
+    if (nextNode != nullptr && rt_getApproximateReadyNodeCount() >= 2) {
+      wakeWorker();
+    }
+
+    return nextNode;
+  }
+
+  void rt_pushReadyNode(RuntimeNode* runtimeNode, size_t readyQueueIndex) {
+    jassert(readyQueueIndex < deques.size());
+
+    if (readyQueueIndex >= deques.size()) {
+      return;
+    }
+
+    if (!deques[readyQueueIndex]->rt_push(runtimeNode)) {
+      jassertfalse;
+    }
+  }
+private:
+  RuntimeNode* rt_stealNode(ExecutorThreadRole role, size_t readyQueueIndex) {
+    if (role == ExecutorThreadRole::workerThread && rt_getApproximateReadyNodeCount() < 2) {
+      return nullptr;
+    }
+
+    for (size_t offset = 1; offset < deques.size(); ++offset) {
+      const auto victimIndex = (readyQueueIndex + offset) % deques.size();
+
+      if (auto* stolenNode = deques[victimIndex]->rt_steal()) {
+        return stolenNode;
+      }
+    }
+
+    return nullptr;
+  }
+
+  size_t rt_getApproximateReadyNodeCount() const {
+    size_t count = 0;
+
+    for (auto& deque : deques) {
+      count += deque->rt_getApproximateSize();
+    }
+
+    return count;
+  }
+
+  std::vector<std::unique_ptr<WorkStealingDeque>> deques;
+};
+
+// One of the queues in RelaxedPriorityMultiQueueScheduler. The heap is only
+// touched while the queue is locked, but the size and top priority are
+// mirrored into atomics so other threads can compare queues without locking.
+class RelaxedPriorityQueue {
+public:
+  explicit RelaxedPriorityQueue(size_t capacity) {
+    heap.reserve(capacity);
+  }
+
+  RelaxedPriorityQueue(const RelaxedPriorityQueue&) = delete;
+  RelaxedPriorityQueue& operator=(const RelaxedPriorityQueue&) = delete;
+
+  RelaxedPriorityQueue(RelaxedPriorityQueue&&) = delete;
+  RelaxedPriorityQueue& operator=(RelaxedPriorityQueue&&) = delete;
+
+  bool rt_tryLock() {
+    if (locked.load(std::memory_order_relaxed)) {
+      return false;
+    }
+
+    bool expected = false;
+    return locked.compare_exchange_strong(
+        expected, true, std::memory_order_acquire, std::memory_order_relaxed);
+  }
+
+  // Waits for the lock. Holders only ever do one heap operation, so the wait
+  // is short.
+  void rt_lock() {
+    while (!rt_tryLock()) {
+      spin_pause();
+    }
+  }
+
+  void rt_unlock() {
+    locked.store(false, std::memory_order_release);
+  }
+
+  // Must only be called while no other thread can access this queue.
+  void rt_clear() {
+    heap.clear();
+    rt_publishTop();
+  }
+
+  // Must be called with the queue locked.
+  bool rt_push(RuntimeNode* runtimeNode) {
+    // The heap is reserved to the node count and each node is pushed once per
+    // block, so this can't allocate.
+    if (heap.size() >= heap.capacity()) {
+      return false;
+    }
+
+    heap.push_back(runtimeNode);
+    std::push_heap(heap.begin(), heap.end(), RuntimeNodePriorityComparator());
+    rt_publishTop();
+    return true;
+  }
+
+  // Must be called with the queue locked.
+  RuntimeNode* rt_pop() {
+    if (heap.empty()) {
+      return nullptr;
+    }
+
+    std::pop_heap(heap.begin(), heap.end(), RuntimeNodePriorityComparator());
+    auto* runtimeNode = heap.back();
+    heap.pop_back();
+    rt_publishTop();
+    return runtimeNode;
+  }
+
+  size_t rt_getApproximateSize() const {
+    return size.load(std::memory_order_relaxed);
+  }
+
+  size_t rt_getApproximateTopPriority() const {
+    return topPriority.load(std::memory_order_relaxed);
+  }
+private:
+  void rt_publishTop() {
+    size.store(heap.size(), std::memory_order_relaxed);
+    topPriority.store(heap.empty() ? 0 : heap.front()->priority, std::memory_order_relaxed);
+  }
+
+  alignas(64) std::atomic<bool> locked{false};
+  std::atomic<size_t> size{0};
+  std::atomic<size_t> topPriority{0};
+  std::vector<RuntimeNode*> heap;
+};
+
+// A relaxed priority scheduler, after Rihani, Sanders and Dementiev,
+// "MultiQueues: Simple Relaxed Concurrent Priority Queues" (SPAA 2015).
+//
+// Ready nodes are spread across several small locked heaps. A thread pops by
+// looking at the tops of two randomly chosen heaps and locking the better one,
+// so threads rarely contend on the same lock, and the node taken is usually
+// close to the globally highest priority node.
+class RelaxedPriorityMultiQueueScheduler {
+public:
+  RelaxedPriorityMultiQueueScheduler(size_t threadCount, size_t nodeCapacity)
+    : randomStates(threadCount) {
+    const auto queueCount = std::max<size_t>(threadCount * queuesPerThread, 1);
+    queues.reserve(queueCount);
+
+    for (size_t queueIndex = 0; queueIndex < queueCount; ++queueIndex) {
+      queues.push_back(std::make_unique<RelaxedPriorityQueue>(nodeCapacity));
+    }
+
+    for (size_t threadIndex = 0; threadIndex < randomStates.size(); ++threadIndex) {
+      // Any non-zero seed works for xorshift. These just need to differ per
+      // thread.
+      randomStates[threadIndex].state = 0x9E3779B97F4A7C15ull * (threadIndex + 1);
+    }
+  }
+
+  RelaxedPriorityMultiQueueScheduler(const RelaxedPriorityMultiQueueScheduler&) = delete;
+  RelaxedPriorityMultiQueueScheduler& operator=(const RelaxedPriorityMultiQueueScheduler&) =
+      delete;
+
+  RelaxedPriorityMultiQueueScheduler(RelaxedPriorityMultiQueueScheduler&&) = delete;
+  RelaxedPriorityMultiQueueScheduler& operator=(RelaxedPriorityMultiQueueScheduler&&) = delete;
+
+  size_t getThreadCount() const {
+    return randomStates.size();
+  }
+
+  void rt_prepareForBlock(RuntimeGraph& runtimeGraph) {
+    for (auto& queue : queues) {
+      queue->rt_clear();
+    }
+
+    size_t nextQueueIndex = 0;
+
+    for (auto* inputNode : runtimeGraph.inputNodes) {
+      if (!queues[nextQueueIndex]->rt_push(inputNode)) {
+        jassertfalse;
+      }
+
+      nextQueueIndex = (nextQueueIndex + 1) % queues.size();
+    }
+  }
+
+  template <typename WakeWorker>
+  RuntimeNode* rt_popNextNode(RuntimeGraph& runtimeGraph,
+      ExecutorThreadRole role,
+      size_t readyQueueIndex,
+      GraphExecutionTracer* tracer,
+      WakeWorker&& wakeWorker) {
+    juce::ignoreUnused(runtimeGraph, tracer);
+
+    const auto readyNodeCount = rt_getApproximateReadyNodeCount();
+
+    if (readyNodeCount == 0) {
+      return nullptr;
+    }
+
+    if (role == ExecutorThreadRole::workerThread && readyNodeCount < 2) {
+      return nullptr;
+    }
+
+    auto* nextNode = rt_popFromBestOfTwo(readyQueueIndex);
+
+    if (nextNode == nullptr) {
+      nextNode = rt_popFromAnyQueue(readyQueueIndex);
+    }
+
+    if (nextNode != nullptr && rt_getApproximateReadyNodeCount() >= 2) {
+      wakeWorker();
+    }
+
+    return nextNode;
+  }
+
+  void rt_pushReadyNode(RuntimeNode* runtimeNode, size_t readyQueueIndex) {
+    for (int attempt = 0; attempt < randomPushAttempts; ++attempt) {
+      auto& queue = *queues[rt_getRandomQueueIndex(readyQueueIndex)];
+
+      if (queue.rt_tryLock()) {
+        rt_pushLocked(queue, runtimeNode);
+        return;
+      }
+    }
+
+    // Random picks keep landing on locked queues, so stop retrying and wait
+    // for this thread's own queue. This bounds the time spent here.
+    auto& ownQueue = *queues[(readyQueueIndex * queuesPerThread) % queues.size()];
+    ownQueue.rt_lock();
+    rt_pushLocked(ownQueue, runtimeNode);
+  }
+private:
+  static constexpr size_t queuesPerThread = 2;
+  static constexpr int bestOfTwoAttempts = 8;
+  static constexpr int randomPushAttempts = 4;
+
+  struct alignas(64) RandomState {
+    uint64_t state = 1;
+  };
+
+  size_t rt_getRandomQueueIndex(size_t readyQueueIndex) {
+    jassert(readyQueueIndex < randomStates.size());
+
+    // xorshift64
+    auto& state = randomStates[readyQueueIndex % randomStates.size()].state;
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    return static_cast<size_t>(state % queues.size());
+  }
+
+  // Pushes to a queue the caller has locked, then unlocks it.
+  static void rt_pushLocked(RelaxedPriorityQueue& queue, RuntimeNode* runtimeNode) {
+    const auto pushed = queue.rt_push(runtimeNode);
+    queue.rt_unlock();
+
+    if (!pushed) {
+      jassertfalse;
+    }
+  }
+
+  RuntimeNode* rt_popFromBestOfTwo(size_t readyQueueIndex) {
+    for (int attempt = 0; attempt < bestOfTwoAttempts; ++attempt) {
+      auto& first = *queues[rt_getRandomQueueIndex(readyQueueIndex)];
+      auto& second = *queues[rt_getRandomQueueIndex(readyQueueIndex)];
+
+      auto* best = &first;
+
+      if (first.rt_getApproximateSize() == 0 ||
+          (second.rt_getApproximateSize() > 0 &&
+              second.rt_getApproximateTopPriority() > first.rt_getApproximateTopPriority())) {
+        best = &second;
+      }
+
+      if (best->rt_getApproximateSize() == 0 || !best->rt_tryLock()) {
+        continue;
+      }
+
+      auto* runtimeNode = best->rt_pop();
+      best->rt_unlock();
+
+      if (runtimeNode != nullptr) {
+        return runtimeNode;
+      }
+    }
+
+    return nullptr;
+  }
+
+  // If random picks keep missing, for example because only one queue has
+  // anything in it, fall back to a scan so a ready node is never overlooked.
+  RuntimeNode* rt_popFromAnyQueue(size_t readyQueueIndex) {
+    const auto startIndex = rt_getRandomQueueIndex(readyQueueIndex);
+
+    for (size_t offset = 0; offset < queues.size(); ++offset) {
+      auto& queue = *queues[(startIndex + offset) % queues.size()];
+
+      if (queue.rt_getApproximateSize() == 0 || !queue.rt_tryLock()) {
+        continue;
+      }
+
+      auto* runtimeNode = queue.rt_pop();
+      queue.rt_unlock();
+
+      if (runtimeNode != nullptr) {
+        return runtimeNode;
+      }
+    }
+
+    return nullptr;
+  }
+
+  size_t rt_getApproximateReadyNodeCount() const {
+    size_t count = 0;
+
+    for (auto& queue : queues) {
+      count += queue->rt_getApproximateSize();
+    }
+
+    return count;
+  }
+
+  std::vector<std::unique_ptr<RelaxedPriorityQueue>> queues;
+  std::vector<RandomState> randomStates;
+};
+
+using GraphScheduler = std::variant<GatedPriorityQueueScheduler,
+    WorkStealingScheduler,
+    RelaxedPriorityMultiQueueScheduler>;
+
+GraphScheduler createGraphScheduler(
+    GraphExecutor::SchedulerType schedulerType, size_t threadCount, size_t nodeCapacity) {
+  switch (schedulerType) {
+    case GraphExecutor::SchedulerType::workStealing:
+      return GraphScheduler(std::in_place_type<WorkStealingScheduler>, threadCount, nodeCapacity);
+    case GraphExecutor::SchedulerType::relaxedPriorityMultiQueue:
+      return GraphScheduler(
+          std::in_place_type<RelaxedPriorityMultiQueueScheduler>, threadCount, nodeCapacity);
+    case GraphExecutor::SchedulerType::gatedPriorityQueue:
+      break;
+  }
+
+  return GraphScheduler(
+      std::in_place_type<GatedPriorityQueueScheduler>, threadCount, nodeCapacity);
+}
+
+} // namespace
+
+} // namespace anthem
@@ -21,13 +21,17 @@ namespace anthem {
 
 class GraphExecutor::RuntimeState::Impl final {
 public:
-  Impl(size_t readyNodeQueueCount, size_t readyNodeQueueCapacity) {
-    juce::ignoreUnused(readyNodeQueueCount, readyNodeQueueCapacity);
+  Impl(size_t readyNodeQueueCount,
+      size_t readyNodeQueueCapacity,
+      GraphExecutor::SchedulerType schedulerType) {
+    juce::ignoreUnused(readyNodeQueueCount, readyNodeQueueCapacity, schedulerType);
   }
 };
 
 namespace {
 
+constexpr size_t audioThreadTraceIndex = 0;
+
 void rt_processSingleThreaded(GraphExecutorState& state, int numSamples) {
   auto& runtimeGraph = state.runtimeGraph;
 
@@ -41,9 +45,9 @@ void rt_processSingleThreaded(GraphExecutorState& state, int numSamples) {
     auto* runtimeNode = runtimeGraph.availableTasks.top();
     runtimeGraph.availableTasks.pop();
 
-    rt_processNode(state, *runtimeNode, numSamples);
+    auto& taskTail = rt_processTask(state, *runtimeNode, audioThreadTraceIndex, numSamples);
 
-    for (auto* downstreamNode : runtimeNode->outgoingConnections) {
+    for (auto* downstreamNode : taskTail.outgoingConnections) {
       if (rt_decrementRemainingUpstreamNodes(*downstreamNode)) {
         runtimeGraph.availableTasks.push(downstreamNode);
       }
@@ -65,13 +69,40 @@ public:
     return 1;
   }
 
+  size_t getActiveWorkerThreadCount() const {
+    return 0;
+  }
+
+  GraphExecutor::WorkerParkingStats getWorkerParkingStats() const {
+    return {};
+  }
+
+  GraphExecutor::SchedulerType getSchedulerType() const {
+    return GraphExecutor::SchedulerType::gatedPriorityQueue;
+  }
+
   void rt_processBlock(RuntimeGraph& runtimeGraph, RuntimeState& runtimeState, int numSamples) {
     juce::ignoreUnused(runtimeState);
 
     GraphExecutorState state(runtimeGraph);
-    rt_prepareGraphForBlock(state);
+    state.rt_tracer = traceSlot.rt_acquire();
+    rt_beginExecutionStatsForBlock(state, executionStats);
+    rt_recordTraceEvent(
+        state, audioThreadTraceIndex, GraphExecutionTraceEventType::blockBegin, numSamples);
+
+    rt_prepareGraphForBlock(state, rt_blockCount++);
     rt_processSingleThreaded(state, numSamples);
+
+    rt_recordTraceEvent(
+        state, audioThreadTraceIndex, GraphExecutionTraceEventType::blockEnd, numSamples);
+    traceSlot.rt_release();
   }
+
+  GraphExecutionTraceSlot traceSlot;
+  GraphExecutionStatsCounters executionStats;
+
+  // Blocks processed so far. Only touched by the audio thread.
+  uint64_t rt_blockCount = 0;
 };
 
 } // namespace anthem
@@ -17,17 +17,18 @@
   along with Anthem. If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include "modules/processing_graph/executor/graph_worker_parker.h"
+#include "modules/processing_graph/executor/spin_pause.h"
+
 #include <algorithm>
 #include <atomic>
+#include <cstdint>
 #include <limits>
 #include <memory>
 #include <optional>
+#include <variant>
 #include <vector>
 
-#if defined(_MSC_VER)
-#include <intrin.h>
-#endif
-
 #if JUCE_WINDOWS
 #include "graph_executor_thread_platform_windows.ipp"
 #elif JUCE_LINUX
@@ -52,24 +53,6 @@ enum class ExecutorThreadRole {
   workerThread,
 };
 
-inline void spin_pause() noexcept {
-#if (defined(__i386__) || defined(__x86_64__)) && (defined(__GNUC__) || defined(__clang__))
-  __builtin_ia32_pause();
-
-#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
-  _mm_pause();
-
-#elif (defined(__aarch64__) || defined(__arm__)) && (defined(__GNUC__) || defined(__clang__))
-  __asm__ __volatile__("yield" ::: "memory");
-
-#elif defined(_MSC_VER) && (defined(_M_ARM) || defined(_M_ARM64))
-  __yield();
-
-#else
-#error "The threaded processing graph executor needs a hardware spin pause implementation."
-#endif
-}
-
 int getAvailableCoreCount() {
   return std::max(minimumCoreCount, juce::SystemStats::getNumPhysicalCpus());
 }
@@ -80,6 +63,10 @@ int getWorkerThreadCountForCoreCount(int coreCount) {
 }
 
 size_t getActiveWorkerThreadCount(int workerThreadCount, const GraphExecutor::ThreadConfig& config) {
+  if (config.audioThreadOnly) {
+    return 0;
+  }
+
   const auto availableWorkerThreadCount = static_cast<size_t>(std::max(0, workerThreadCount));
 
   if (config.maxActiveWorkerThreadCount > 0) {
@@ -110,7 +97,10 @@ bool threadConfigsMatch(
   auto matches = a.audioBlockSize == b.audioBlockSize && a.sampleRate == b.sampleRate &&
                  a.maxActiveWorkerThreadCount == b.maxActiveWorkerThreadCount &&
                  a.activeWorkerThreadCount == b.activeWorkerThreadCount &&
-                 a.platformRealtimeWorkerThreadCount == b.platformRealtimeWorkerThreadCount;
+                 a.platformRealtimeWorkerThreadCount == b.platformRealtimeWorkerThreadCount &&
+                 a.schedulerType == b.schedulerType && a.audioThreadOnly == b.audioThreadOnly &&
+                 a.workerMinSpinNanoseconds == b.workerMinSpinNanoseconds &&
+                 a.workerMaxSpinNanoseconds == b.workerMaxSpinNanoseconds;
 
 #if JUCE_MAC
   matches = matches && a.macAudioWorkgroup == b.macAudioWorkgroup;
@@ -177,17 +167,18 @@ private:
 
 } // namespace
 
+} // namespace anthem
+
+#include "graph_executor_schedulers.ipp"
+
+namespace anthem {
+
 class GraphExecutor::RuntimeState::Impl final {
 public:
-  Impl(size_t queueCount, size_t queueCapacity) {
-    readyNodeQueues.reserve(queueCount);
-
-    for (size_t queueIndex = 0; queueIndex < queueCount; ++queueIndex) {
-      readyNodeQueues.push_back(std::make_unique<RuntimeReadyNodeQueue>(queueCapacity));
-    }
-  }
+  Impl(size_t queueCount, size_t queueCapacity, GraphExecutor::SchedulerType schedulerType)
+    : scheduler(createGraphScheduler(schedulerType, queueCount, queueCapacity)) {}
 
-  std::vector<std::unique_ptr<RuntimeReadyNodeQueue>> readyNodeQueues;
+  GraphScheduler scheduler;
 };
 
 class GraphExecutor::Impl final {
@@ -228,17 +219,47 @@ public:
     return workerThreads.size() + 1;
   }
 
+  GraphExecutor::SchedulerType getSchedulerType() const {
+    return currentThreadConfig.schedulerType;
+  }
+
+  size_t getActiveWorkerThreadCount() const {
+    return std::min(currentThreadConfig.activeWorkerThreadCount, workerThreads.size());
+  }
+
+  GraphExecutor::WorkerParkingStats getWorkerParkingStats() const {
+    GraphExecutor::WorkerParkingStats stats;
+
+    for (auto& workerThread : workerThreads) {
+      workerThread->addParkingStatsTo(stats);
+    }
+
+    return stats;
+  }
+
   void rt_processBlock(RuntimeGraph& runtimeGraph, RuntimeState& runtimeState, int numSamples) {
     GraphExecutorState state(runtimeGraph);
-    rt_prepareGraphForBlock(state);
-
-    if (runtimeGraph.nodes.empty()) {
+    state.rt_tracer = traceSlot.rt_acquire();
+    rt_beginExecutionStatsForBlock(state, executionStats);
+    const juce::ScopeGuard traceScope{[this, &state, numSamples]() {
+      rt_recordTraceEvent(state,
+          audioThreadReadyQueueIndex,
+          GraphExecutionTraceEventType::blockEnd,
+          numSamples);
+      traceSlot.rt_release();
+    }};
+
+    rt_recordTraceEvent(
+        state, audioThreadReadyQueueIndex, GraphExecutionTraceEventType::blockBegin, numSamples);
+    rt_prepareGraphForBlock(state, rt_blockCount++);
+
+    if (runtimeGraph.taskCount == 0) {
       rt_remainingNodeCount.store(0, std::memory_order_release);
       return;
     }
 
-    rt_remainingNodeCount.store(runtimeGraph.nodes.size(), std::memory_order_release);
-    rt_prepareQueuesForBlock(runtimeGraph, runtimeState);
+    rt_remainingNodeCount.store(runtimeGraph.taskCount, std::memory_order_release);
+    rt_prepareSchedulerForBlock(runtimeGraph, runtimeState);
 
     rt_currentState.store(&state, std::memory_order_release);
     rt_currentRuntimeState.store(&runtimeState, std::memory_order_release);
@@ -257,6 +278,9 @@ public:
 
     rt_waitForActiveWorkerThreadsToFinish();
   }
+
+  GraphExecutionTraceSlot traceSlot;
+  GraphExecutionStatsCounters executionStats;
 private:
   class GraphWorkerThread final : public juce::Thread {
   public:
@@ -265,7 +289,8 @@ private:
         const GraphExecutor::ThreadConfig& threadConfig)
       : juce::Thread("Anthem Graph Worker " + juce::String(workerIndex)), owner(owner),
         threadConfig(threadConfig), index(workerIndex),
-        readyQueueIndex(static_cast<size_t>(workerIndex) + 1) {}
+        readyQueueIndex(static_cast<size_t>(workerIndex) + 1),
+        parker(threadConfig.workerMinSpinNanoseconds, threadConfig.workerMaxSpinNanoseconds) {}
 
     ~GraphWorkerThread() override {
       stop();
@@ -277,20 +302,16 @@ private:
 
     void stop() {
       signalThreadShouldExit();
-      notify();
+      parker.wakeForExit();
       stopThread(threadStopTimeoutMs);
     }
 
     bool tryWake() {
-      bool expected = true;
-
-      if (!isSleeping.compare_exchange_strong(
-              expected, false, std::memory_order_acq_rel, std::memory_order_acquire)) {
-        return false;
-      }
+      return parker.rt_tryWake();
+    }
 
-      notify();
-      return true;
+    void addParkingStatsTo(GraphExecutor::WorkerParkingStats& stats) const {
+      parker.addStatsTo(stats);
     }
 
     void run() override {
@@ -298,9 +319,7 @@ private:
           index, getThreadName(), threadConfig);
 
       while (!threadShouldExit()) {
-        isSleeping.store(true, std::memory_order_release);
-        wait(-1.0);
-        isSleeping.store(false, std::memory_order_release);
+        parker.park();
 
         if (threadShouldExit()) {
           break;
@@ -314,7 +333,7 @@ private:
     GraphExecutor::ThreadConfig threadConfig;
     int index;
     size_t readyQueueIndex;
-    std::atomic<bool> isSleeping{false};
+    GraphWorkerParker parker;
   };
 
   void stopWorkerThreads() {
@@ -325,25 +344,13 @@ private:
     workerThreads.clear();
   }
 
-  void rt_prepareQueuesForBlock(RuntimeGraph& runtimeGraph, RuntimeState& runtimeState) {
-    auto& readyNodeQueues = runtimeState.impl->readyNodeQueues;
-
-    jassert(readyNodeQueues.size() == getReadyNodeQueueCount());
-    jassert(runtimeGraph.availableTasks.empty());
-
-    for (auto& readyNodeQueue : readyNodeQueues) {
-      readyNodeQueue->clear();
-    }
-
-    if (readyNodeQueues.empty()) {
-      return;
-    }
-
-    for (auto* inputNode : runtimeGraph.inputNodes) {
-      if (!readyNodeQueues[audioThreadReadyQueueIndex]->add(inputNode)) {
-        jassertfalse;
-      }
-    }
+  void rt_prepareSchedulerForBlock(RuntimeGraph& runtimeGraph, RuntimeState& runtimeState) {
+    std::visit(
+        [&](auto& scheduler) {
+          jassert(scheduler.getThreadCount() == getReadyNodeQueueCount());
+          scheduler.rt_prepareForBlock(runtimeGraph);
+        },
+        runtimeState.impl->scheduler);
   }
 
   bool rt_isWorkerThreadActive(int workerIndex) const {
@@ -372,7 +379,9 @@ private:
     }
 
     const auto numSamples = rt_currentNumSamples.load(std::memory_order_acquire);
+    rt_recordTraceEvent(*state, readyQueueIndex, GraphExecutionTraceEventType::wake);
     rt_doWork(*state, *runtimeState, ExecutorThreadRole::workerThread, readyQueueIndex, numSamples);
+    rt_recordTraceEvent(*state, readyQueueIndex, GraphExecutionTraceEventType::sleep);
   }
 
   void rt_waitForActiveWorkerThreadsToFinish() {
@@ -388,11 +397,39 @@ private:
       ExecutorThreadRole role,
       size_t readyQueueIndex,
       int numSamples) {
+    std::visit(
+        [&](auto& scheduler) { rt_doWork(state, scheduler, role, readyQueueIndex, numSamples); },
+        runtimeState.impl->scheduler);
+  }
+
+  template <typename Scheduler>
+  void rt_doWork(GraphExecutorState& state,
+      Scheduler& scheduler,
+      ExecutorThreadRole role,
+      size_t readyQueueIndex,
+      int numSamples) {
+    const auto wakeWorker = [this]() { rt_wakeSleepingWorker(); };
+
+    // Only the audio thread spins, and only while stats are enabled.
+    int64_t spinStartNanoseconds = 0;
+    const auto rt_finishSpin = [&state, &spinStartNanoseconds]() {
+      if (spinStartNanoseconds == 0) {
+        return;
+      }
+
+      state.rt_executionStats->audioThreadSpinNanoseconds.fetch_add(
+          static_cast<uint64_t>(rt_getSteadyClockNanoseconds() - spinStartNanoseconds),
+          std::memory_order_relaxed);
+      spinStartNanoseconds = 0;
+    };
+
     while (true) {
-      auto* runtimeNode = rt_getNextNodeToProcess(state.runtimeGraph, runtimeState, role);
+      auto* runtimeNode = scheduler.rt_popNextNode(
+          state.runtimeGraph, role, readyQueueIndex, state.rt_tracer, wakeWorker);
 
       if (runtimeNode == nullptr) {
         if (rt_hasFinishedBlock()) {
+          rt_finishSpin();
           return;
         }
 
@@ -400,126 +437,25 @@ private:
           return;
         }
 
-        spin_pause();
-        continue;
-      }
-
-      rt_processNode(state, *runtimeNode, numSamples);
-      rt_enqueueReadyDownstreamNodes(*runtimeNode, runtimeState, readyQueueIndex);
-      rt_markNodeProcessed();
-    }
-  }
-
-  RuntimeNode* rt_getNextNodeToProcess(
-      RuntimeGraph& runtimeGraph, RuntimeState& runtimeState, ExecutorThreadRole role) {
-    if (!rt_acquireSchedulerGate(role)) {
-      return nullptr;
-    }
-
-    rt_drainReadyNodeQueues(runtimeGraph, runtimeState);
-    auto* nextNode = rt_popNextAvailableNode(runtimeGraph, role);
-    rt_wakeWorkerBeforeReleasingSchedulerGate(runtimeGraph);
-    rt_releaseSchedulerGate();
-
-    return nextNode;
-  }
-
-  bool rt_acquireSchedulerGate(ExecutorThreadRole role) {
-    if (role == ExecutorThreadRole::audioThread) {
-      audioThreadWaitingForSchedulerGate.store(true, std::memory_order_release);
-
-      while (true) {
-        bool expected = false;
-
-        if (schedulerGate.compare_exchange_weak(
-                expected, true, std::memory_order_acq_rel, std::memory_order_acquire)) {
-          audioThreadWaitingForSchedulerGate.store(false, std::memory_order_release);
-          return true;
+        if (state.rt_executionStats != nullptr && spinStartNanoseconds == 0) {
+          spinStartNanoseconds = rt_getSteadyClockNanoseconds();
         }
 
         spin_pause();
-      }
-    }
-
-    for (int attempt = 0; attempt < workerGateSpinAttempts; ++attempt) {
-      if (audioThreadWaitingForSchedulerGate.load(std::memory_order_acquire)) {
-        spin_pause();
         continue;
       }
 
-      bool expected = false;
+      rt_finishSpin();
 
-      if (schedulerGate.compare_exchange_weak(
-              expected, true, std::memory_order_acq_rel, std::memory_order_acquire)) {
-        return true;
-      }
-
-      spin_pause();
-    }
+      auto& taskTail = rt_processTask(state, *runtimeNode, readyQueueIndex, numSamples);
 
-    return false;
-  }
-
-  void rt_releaseSchedulerGate() {
-    schedulerGate.store(false, std::memory_order_release);
-  }
-
-  // As worker threads complete tasks, they may unlock downstream nodes for
-  // processing. Each thread has a ring buffer that it pushes node pointers to
-  // when they are unlocked.
-  //
-  // This method pulls from these buffers and adds to the main task queue.
-  //
-  // Reading from these ring buffers and reading/writing from/to the main task
-  // queue are NOT inherently thread-safe operations, and must be gated by
-  // schedulerGate.
-  void rt_drainReadyNodeQueues(RuntimeGraph& runtimeGraph, RuntimeState& runtimeState) {
-    for (auto& readyNodeQueue : runtimeState.impl->readyNodeQueues) {
-      while (auto readyNode = readyNodeQueue->read()) {
-        if (readyNode.value() != nullptr) {
-          runtimeGraph.availableTasks.push(readyNode.value());
+      for (auto* downstreamNode : taskTail.outgoingConnections) {
+        if (rt_decrementRemainingUpstreamNodes(*downstreamNode)) {
+          scheduler.rt_pushReadyNode(downstreamNode, readyQueueIndex);
         }
       }
-    }
-  }
-
-  RuntimeNode* rt_popNextAvailableNode(RuntimeGraph& runtimeGraph, ExecutorThreadRole role) {
-    if (runtimeGraph.availableTasks.empty()) {
-      return nullptr;
-    }
-
-    auto* nextNode = runtimeGraph.availableTasks.top();
-
-    if (role == ExecutorThreadRole::workerThread) {
-      if (runtimeGraph.availableTasks.size() < 2) {
-        return nullptr;
-      }
-    }
-
-    runtimeGraph.availableTasks.pop();
-    return nextNode;
-  }
 
-  void rt_enqueueReadyDownstreamNodes(
-      RuntimeNode& runtimeNode, RuntimeState& runtimeState, size_t readyQueueIndex) {
-    auto& readyNodeQueues = runtimeState.impl->readyNodeQueues;
-
-    jassert(readyQueueIndex < readyNodeQueues.size());
-
-    if (readyQueueIndex >= readyNodeQueues.size()) {
-      return;
-    }
-
-    auto& readyNodeQueue = *readyNodeQueues[readyQueueIndex];
-
-    for (auto* downstreamNode : runtimeNode.outgoingConnections) {
-      if (!rt_decrementRemainingUpstreamNodes(*downstreamNode)) {
-        continue;
-      }
-
-      if (!readyNodeQueue.add(downstreamNode)) {
-        jassertfalse;
-      }
+      rt_markNodeProcessed();
     }
   }
 
@@ -533,11 +469,7 @@ private:
     jassert(previousRemainingNodeCount > 0);
   }
 
-  void rt_wakeWorkerBeforeReleasingSchedulerGate(RuntimeGraph& runtimeGraph) {
-    if (runtimeGraph.availableTasks.size() < 2) {
-      return;
-    }
-
+  void rt_wakeSleepingWorker() {
     for (size_t workerIndex = 0; workerIndex < currentThreadConfig.activeWorkerThreadCount &&
                                  workerIndex < workerThreads.size();
          ++workerIndex) {
@@ -552,14 +484,15 @@ private:
   int availableCoreCount = minimumCoreCount;
   GraphExecutor::ThreadConfig currentThreadConfig;
   std::vector<std::unique_ptr<GraphWorkerThread>> workerThreads;
-  std::atomic<bool> schedulerGate{false};
-  std::atomic<bool> audioThreadWaitingForSchedulerGate{false};
   std::atomic<GraphExecutorState*> rt_currentState{nullptr};
   std::atomic<RuntimeState*> rt_currentRuntimeState{nullptr};
   std::atomic<int> rt_currentNumSamples{0};
   std::atomic<bool> rt_workerThreadsMayRun{false};
   std::atomic<int> rt_activeWorkerThreadCount{0};
   std::atomic<size_t> rt_remainingNodeCount{0};
+
+  // Blocks processed so far. Only touched by the audio thread.
+  uint64_t rt_blockCount = 0;
 };
 
 } // namespace anthem
@@ -0,0 +1,49 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace anthem {
+
+// Tells the CPU that this thread is busy-waiting, so it can yield pipeline
+// resources to the other hyperthread and save power. Only the threaded graph
+// executor uses this, so it is only defined for the platforms it runs on.
+inline void spin_pause() noexcept {
+#if (defined(__i386__) || defined(__x86_64__)) && (defined(__GNUC__) || defined(__clang__))
+  __builtin_ia32_pause();
+
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+  _mm_pause();
+
+#elif (defined(__aarch64__) || defined(__arm__)) && (defined(__GNUC__) || defined(__clang__))
+  __asm__ __volatile__("yield" ::: "memory");
+
+#elif defined(_MSC_VER) && (defined(_M_ARM) || defined(_M_ARM64))
+  __yield();
+
+#else
+#error "The threaded processing graph executor needs a hardware spin pause implementation."
+#endif
+}
+
+} // namespace anthem
@@ -0,0 +1,231 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "graph_compiler.h"
+
+#include "modules/processing_graph/graph_processor.h"
+#include "modules/processing_graph/model/node.h"
+#include "modules/processing_graph/model/processing_graph_snapshot.h"
+#include "modules/processing_graph/model/runtime_graph.h"
+#include "modules/processing_graph/processor/processor.h"
+
+#include <chrono>
+#include <exception>
+#include <juce_events/juce_events.h>
+#include <utility>
+
+// Other platforms have no compiler thread, and compile on the message thread
+// as before. This matches the graph executor, which only runs worker threads
+// on these platforms.
+#if JUCE_WINDOWS || JUCE_MAC || JUCE_LINUX
+#define ANTHEM_GRAPH_COMPILER_THREAD 1
+#else
+#define ANTHEM_GRAPH_COMPILER_THREAD 0
+#endif
+
+namespace anthem {
+
+namespace {
+
+constexpr int compilerThreadStopTimeoutMs = 10000;
+
+int64_t getSteadyClockMicroseconds() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Processors are prepared on the message thread, just before the graph that
+// first uses them is handed to the audio thread.
+void prepareProcessors(const ProcessingGraphSnapshot::ModelNodeMap& modelNodes) {
+  for (auto& [_, node] : modelNodes) {
+    auto& procVariant = node->processor();
+    if (!procVariant.has_value()) {
+      continue;
+    }
+
+    rfl::visit(
+        [&](const auto& field) {
+          // 'field' is the rfl::Field<Name, Type> wrapper.
+          // We get the actual std::shared_ptr with .value().
+          const auto& sharedPtr = field.value();
+          Processor* baseProcessor = sharedPtr.get();
+
+          if (!baseProcessor->isPrepared) {
+            baseProcessor->prepareToProcess();
+            baseProcessor->isPrepared = true;
+          }
+        },
+        procVariant.value());
+  }
+}
+
+} // namespace
+
+struct GraphCompiler::CompileJob {
+  uint64_t generation = 0;
+  juce::WeakReference<GraphCompiler> compiler;
+
+  std::unique_ptr<ProcessingGraphSnapshot> snapshot;
+  GraphRuntimeServices* rtServices = nullptr;
+  GraphBufferLayout bufferLayout;
+  double sampleRate = 0.0;
+
+  std::unique_ptr<RuntimeGraph> runtimeGraph;
+  Result result;
+};
+
+class GraphCompiler::CompilerThread final : public juce::Thread {
+public:
+  explicit CompilerThread(GraphCompiler& owner)
+    : juce::Thread("Anthem Graph Compiler"), owner(owner) {}
+
+  ~CompilerThread() override {
+    stopThread(compilerThreadStopTimeoutMs);
+  }
+
+  void run() override {
+    while (!threadShouldExit()) {
+      auto job = owner.takePendingJob();
+
+      if (job == nullptr) {
+        wait(-1);
+        continue;
+      }
+
+      compile(*job);
+
+      juce::MessageManager::callAsync([job]() {
+        if (auto* compiler = job->compiler.get()) {
+          compiler->finishJob(*job);
+        }
+      });
+    }
+  }
+private:
+  GraphCompiler& owner;
+};
+
+GraphCompiler::GraphCompiler(GraphProcessor& graphProcessor) : GraphCompiler(graphProcessor, true) {}
+
+GraphCompiler::GraphCompiler(GraphProcessor& graphProcessor, bool startCompilerThread)
+  : graphProcessor(graphProcessor) {
+#if ANTHEM_GRAPH_COMPILER_THREAD
+  if (startCompilerThread) {
+    compilerThread = std::make_unique<CompilerThread>(*this);
+    compilerThread->startThread(juce::Thread::Priority::normal);
+  }
+#else
+  juce::ignoreUnused(startCompilerThread);
+#endif
+}
+
+GraphCompiler::~GraphCompiler() {
+  compilerThread.reset();
+}
+
+void GraphCompiler::requestCompile(ProcessingGraphModel& processingGraph,
+    const GraphBufferLayout& bufferLayout,
+    double sampleRate,
+    CompletionCallback onComplete) {
+  waitingCallbacks.push_back(std::move(onComplete));
+
+  auto job = std::make_shared<CompileJob>();
+  job->generation = ++latestJobGeneration;
+  job->compiler = this;
+  job->rtServices = &graphProcessor.getRtServices();
+  job->bufferLayout = bufferLayout;
+  job->sampleRate = sampleRate;
+
+  try {
+    job->snapshot = std::make_unique<ProcessingGraphSnapshot>(processingGraph);
+  } catch (const std::exception& e) {
+    job->result.error = std::string(e.what());
+    finishJob(*job);
+    return;
+  }
+
+#if ANTHEM_GRAPH_COMPILER_THREAD
+  {
+    // A job that the thread hasn't started yet is replaced outright. Its
+    // requests are still waiting, and complete with this one.
+    const juce::ScopedLock lock(pendingJobLock);
+    pendingJob = std::move(job);
+  }
+
+  if (compilerThread != nullptr) {
+    compilerThread->notify();
+  }
+#else
+  compile(*job);
+  finishJob(*job);
+#endif
+}
+
+std::shared_ptr<GraphCompiler::CompileJob> GraphCompiler::takePendingJob() {
+  const juce::ScopedLock lock(pendingJobLock);
+  return std::move(pendingJob);
+}
+
+void GraphCompiler::compile(CompileJob& job) {
+  const auto startMicroseconds = getSteadyClockMicroseconds();
+
+  try {
+    job.runtimeGraph = RuntimeGraph::compile(
+        job.snapshot->getGraph(), *job.rtServices, job.bufferLayout, job.sampleRate);
+    job.result.success = true;
+  } catch (const std::exception& e) {
+    job.runtimeGraph.reset();
+    job.result.error = std::string(e.what());
+  }
+
+  job.result.compileDurationMicroseconds = getSteadyClockMicroseconds() - startMicroseconds;
+}
+
+void GraphCompiler::finishJob(CompileJob& job) {
+  // A newer request has been made since this job's snapshot was captured. Its
+  // snapshot includes everything this one did, so this result is dropped and
+  // the waiting requests complete with the newer one.
+  if (job.generation != latestJobGeneration) {
+    return;
+  }
+
+  auto result = job.result;
+
+  if (job.runtimeGraph != nullptr) {
+    try {
+      job.runtimeGraph->attachToModel(
+          graphProcessor.getLatestRuntimeGraphFromMainThread(), &job.snapshot->getModelNodes());
+      prepareProcessors(job.snapshot->getModelNodes());
+      graphProcessor.setRuntimeGraphFromMainThread(job.runtimeGraph.release());
+    } catch (const std::exception& e) {
+      result.success = false;
+      result.error = std::string(e.what());
+    }
+  }
+
+  auto callbacks = std::move(waitingCallbacks);
+  waitingCallbacks.clear();
+
+  for (auto& callback : callbacks) {
+    callback(result);
+  }
+}
+
+} // namespace anthem
@@ -0,0 +1,115 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "modules/processing_graph/runtime/graph_process_context.h"
+
+#include <cstdint>
+#include <functional>
+#include <juce_core/juce_core.h>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace anthem {
+
+class GraphProcessor;
+class ProcessingGraphModel;
+
+// Compiles runtime graphs on a background thread, so that compiling a large
+// graph doesn't hold up command handling on the message thread.
+//
+// Each request captures a ProcessingGraphSnapshot on the message thread, and
+// the compiler thread builds a runtime graph from it. The result comes back to
+// the message thread, where it is attached to the model and handed to the
+// graph processor.
+//
+// A request that arrives while an earlier one is queued or compiling
+// supersedes it. Only the newest snapshot's graph is handed to the audio
+// thread, and every request that was waiting completes with its result.
+class GraphCompiler {
+public:
+  struct Result {
+    bool success = false;
+    std::optional<std::string> error;
+
+    // Time spent building the runtime graph on the compiler thread.
+    int64_t compileDurationMicroseconds = 0;
+  };
+
+  using CompletionCallback = std::function<void(const Result& result)>;
+
+  explicit GraphCompiler(GraphProcessor& graphProcessor);
+  ~GraphCompiler();
+
+  GraphCompiler(const GraphCompiler&) = delete;
+  GraphCompiler& operator=(const GraphCompiler&) = delete;
+
+  GraphCompiler(GraphCompiler&&) = delete;
+  GraphCompiler& operator=(GraphCompiler&&) = delete;
+
+  // Queues a compile of the processing graph. onComplete is called on the
+  // message thread once a graph that includes the model's current state has
+  // been handed to the audio thread, or once compiling it has failed.
+  //
+  // Message thread only.
+  void requestCompile(ProcessingGraphModel& processingGraph,
+      const GraphBufferLayout& bufferLayout,
+      double sampleRate,
+      CompletionCallback onComplete);
+private:
+  friend class GraphCompilerTest;
+
+  struct CompileJob;
+  class CompilerThread;
+
+  // Tests construct the compiler without its thread, and run queued jobs
+  // themselves with takePendingJob(), compile() and finishJob().
+  GraphCompiler(GraphProcessor& graphProcessor, bool startCompilerThread);
+
+  // Takes the newest job that hasn't been started, or returns nullptr if there
+  // isn't one.
+  std::shared_ptr<CompileJob> takePendingJob();
+
+  // Builds the job's runtime graph. Called on the compiler thread, or on the
+  // message thread on platforms without one.
+  static void compile(CompileJob& job);
+
+  // Hands the job's graph to the audio thread if no newer request has been
+  // made since, and completes the waiting requests. Message thread only.
+  void finishJob(CompileJob& job);
+
+  GraphProcessor& graphProcessor;
+
+  // Message thread only.
+  uint64_t latestJobGeneration = 0;
+  std::vector<CompletionCallback> waitingCallbacks;
+
+  // The newest job that the compiler thread hasn't picked up yet.
+  juce::CriticalSection pendingJobLock;
+  std::shared_ptr<CompileJob> pendingJob;
+
+  std::unique_ptr<CompilerThread> compilerThread;
+
+  JUCE_DECLARE_WEAK_REFERENCEABLE(GraphCompiler)
+};
+
+} // namespace anthem
@@ -27,6 +27,38 @@
 
 namespace anthem {
 
+namespace {
+
+// Lets us compare scheduler strategies on real sessions without a rebuild, by
+// setting ANTHEM_GRAPH_SCHEDULER to "gated", "work-stealing" or "multi-queue".
+GraphExecutor::SchedulerType getSchedulerTypeFromEnvironment() {
+  const auto schedulerName =
+      juce::SystemStats::getEnvironmentVariable("ANTHEM_GRAPH_SCHEDULER", {}).trim();
+
+  if (schedulerName.equalsIgnoreCase("work-stealing")) {
+    return GraphExecutor::SchedulerType::workStealing;
+  }
+
+  if (schedulerName.equalsIgnoreCase("multi-queue")) {
+    return GraphExecutor::SchedulerType::relaxedPriorityMultiQueue;
+  }
+
+  if (schedulerName.isNotEmpty() && !schedulerName.equalsIgnoreCase("gated")) {
+    juce::Logger::writeToLog(
+        "Unknown ANTHEM_GRAPH_SCHEDULER value \"" + schedulerName + "\", using \"gated\".");
+  }
+
+  return GraphExecutor::SchedulerType::gatedPriorityQueue;
+}
+
+// If ANTHEM_GRAPH_TRACE is set to a file path, the executor writes a Chrome
+// trace-event file there. See GraphExecutor::startTracing().
+juce::String getTraceFilePathFromEnvironment() {
+  return juce::SystemStats::getEnvironmentVariable("ANTHEM_GRAPH_TRACE", {}).trim();
+}
+
+} // namespace
+
 struct GraphProcessor::RuntimeGraphHandoff {
   RuntimeGraphHandoff(
       RuntimeGraph* runtimeGraph, std::unique_ptr<GraphExecutor::RuntimeState> executorState)
@@ -40,13 +72,18 @@ GraphProcessor::GraphProcessor()
   : executor(std::make_unique<GraphExecutor>()),
     rt_services(std::make_unique<GraphRuntimeServices>()),
     clearDeletionQueueTimedCallback(
-        juce::TimedCallback([this]() { this->clearDeletionQueueFromMainThread(); })) {
+        juce::TimedCallback([this]() { this->clearDeletionQueueFromMainThread(); })),
+    refreshNodePrioritiesTimedCallback(
+        juce::TimedCallback([this]() { this->refreshNodePrioritiesFromMainThread(); })) {
   executor->prepare();
   clearDeletionQueueTimedCallback.startTimer(2000);
+  refreshNodePrioritiesTimedCallback.startTimer(500);
 }
 
 GraphProcessor::~GraphProcessor() {
   clearDeletionQueueTimedCallback.stopTimer();
+  refreshNodePrioritiesTimedCallback.stopTimer();
+  latestRuntimeGraph = nullptr;
 
   while (auto nextHandoff = pendingRuntimeGraphHandoffsQueue.read()) {
     delete nextHandoff.value();
@@ -60,6 +97,7 @@ GraphProcessor::~GraphProcessor() {
 
 void GraphProcessor::prepareForAudioDevice(juce::AudioIODevice* device) {
   GraphExecutor::ThreadConfig threadConfig;
+  threadConfig.schedulerType = getSchedulerTypeFromEnvironment();
 
   if (device != nullptr) {
     threadConfig.audioBlockSize = device->getCurrentBufferSizeSamples();
@@ -76,6 +114,13 @@ void GraphProcessor::prepareForAudioDevice(juce::AudioIODevice* device) {
   }
 
   executor->prepare(threadConfig);
+
+  // Tracing covers the worker threads that exist when it starts, so it is
+  // restarted whenever the executor is prepared.
+  if (const auto traceFilePath = getTraceFilePathFromEnvironment(); traceFilePath.isNotEmpty()) {
+    executor->startTracing(juce::File::getCurrentWorkingDirectory().getChildFile(traceFilePath));
+  }
+
   resetRtServices();
 }
 
@@ -92,6 +137,12 @@ void GraphProcessor::setRuntimeGraphFromMainThread(RuntimeGraph* runtimeGraph) {
     delete handoff;
     return;
   }
+
+  latestRuntimeGraph = runtimeGraph;
+}
+
+const RuntimeGraph* GraphProcessor::getLatestRuntimeGraphFromMainThread() const {
+  return latestRuntimeGraph;
 }
 
 void GraphProcessor::rt_processGraphUpdates() {
@@ -99,6 +150,9 @@ void GraphProcessor::rt_processGraphUpdates() {
 
   while (nextHandoff) {
     if (rt_activeRuntimeGraphHandoff != nullptr) {
+      nextHandoff.value()->runtimeGraph->rt_adoptStateFrom(
+          *rt_activeRuntimeGraphHandoff->runtimeGraph);
+
       if (!retiredRuntimeGraphHandoffsQueue.add(rt_activeRuntimeGraphHandoff)) {
         // If the handoff queue overflows, preserve real-time safety and leak
         // the retired graph instead of deleting it on the audio thread.
@@ -144,6 +198,14 @@ void GraphProcessor::resetRtServices() {
   }
 }
 
+void GraphProcessor::refreshNodePrioritiesFromMainThread() {
+  if (latestRuntimeGraph == nullptr) {
+    return;
+  }
+
+  latestRuntimeGraph->stageMeasuredCostPriorities();
+}
+
 void GraphProcessor::clearDeletionQueueFromMainThread() {
   auto nextHandoff = retiredRuntimeGraphHandoffsQueue.read();
 
@@ -49,9 +49,18 @@ private:
   // shared_ptr references and executor state are released off the audio thread.
   RingBuffer<RuntimeGraphHandoff*, 512> retiredRuntimeGraphHandoffsQueue;
 
+  // The most recent runtime graph handed to the audio thread. Graphs are only
+  // deleted on the main thread after they are retired, and the latest graph
+  // can't be retired until a newer one is set, so this stays valid for as long
+  // as it is the latest.
+  //
+  // Main thread only.
+  RuntimeGraph* latestRuntimeGraph = nullptr;
+
   std::unique_ptr<GraphExecutor> executor;
   std::unique_ptr<GraphRuntimeServices> rt_services;
   juce::TimedCallback clearDeletionQueueTimedCallback;
+  juce::TimedCallback refreshNodePrioritiesTimedCallback;
 public:
   GraphProcessor();
   ~GraphProcessor();
@@ -62,6 +71,13 @@ public:
   // the audio thread.
   void setRuntimeGraphFromMainThread(RuntimeGraph* runtimeGraph);
 
+  // The most recent runtime graph passed to setRuntimeGraphFromMainThread(),
+  // or nullptr if there isn't one. The next graph should be compiled against
+  // this one so that it can take over its runtime state.
+  //
+  // Main thread only.
+  const RuntimeGraph* getLatestRuntimeGraphFromMainThread() const;
+
   // Picks up graph updates on the audio thread. This does not process audio
   // yet; it only keeps the runtime graph in sync.
   void rt_processGraphUpdates();
@@ -74,6 +90,10 @@ public:
 
   // Destroys retired runtime graphs on the main thread.
   void clearDeletionQueueFromMainThread();
+
+  // Recalculates the latest runtime graph's node priorities from measured
+  // processing costs and hands them to the audio thread.
+  void refreshNodePrioritiesFromMainThread();
 };
 
 } // namespace anthem
@@ -0,0 +1,108 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "processing_graph_snapshot.h"
+
+#include "generated/lib/model/processing_graph/processing_graph.h"
+#include "modules/processing_graph/model/node.h"
+#include "modules/processing_graph/model/node_connection.h"
+#include "modules/processing_graph/model/node_port.h"
+
+#include <stdexcept>
+#include <string>
+
+namespace anthem {
+
+namespace {
+
+using PortList = ModelVector<std::shared_ptr<NodePort>>;
+
+std::shared_ptr<PortList> copyPorts(const PortList& ports) {
+  auto portsCopy = std::make_shared<PortList>();
+
+  for (auto& port : ports) {
+    portsCopy->push_back(std::make_shared<NodePort>(NodePortModelImpl{
+        .id = port->id(),
+        .nodeId = port->nodeId(),
+        .config = port->config(),
+        .connections = std::make_shared<ModelVector<int64_t>>(*port->connections()),
+        .parameterValue = port->parameterValue(),
+    }));
+  }
+
+  return portsCopy;
+}
+
+} // namespace
+
+ProcessingGraphSnapshot::ProcessingGraphSnapshot(ProcessingGraphModel& processingGraph) {
+  auto& graphNodes = *processingGraph.nodes();
+  auto& graphConnections = *processingGraph.connections();
+
+  auto nodesCopy = std::make_shared<ModelUnorderedMap<int64_t, std::shared_ptr<Node>>>();
+  auto connectionsCopy =
+      std::make_shared<ModelUnorderedMap<int64_t, std::shared_ptr<NodeConnection>>>();
+
+  modelNodesById.reserve(graphNodes.size());
+
+  for (auto& [nodeId, graphNode] : graphNodes) {
+    if (graphNode == nullptr) {
+      throw std::runtime_error("Processing graph cannot snapshot a null graph node.");
+    }
+
+    modelNodesById.emplace(nodeId, graphNode);
+
+    nodesCopy->insert_or_assign(nodeId,
+        std::make_shared<Node>(NodeModelImpl{
+            .id = graphNode->id(),
+            .audioInputPorts = copyPorts(*graphNode->audioInputPorts()),
+            .eventInputPorts = copyPorts(*graphNode->eventInputPorts()),
+            .controlInputPorts = copyPorts(*graphNode->controlInputPorts()),
+            .audioOutputPorts = copyPorts(*graphNode->audioOutputPorts()),
+            .eventOutputPorts = copyPorts(*graphNode->eventOutputPorts()),
+            .controlOutputPorts = copyPorts(*graphNode->controlOutputPorts()),
+            .isThirdPartyPlugin = graphNode->isThirdPartyPlugin(),
+            .processor = graphNode->processor(),
+        }));
+  }
+
+  for (auto& [connectionId, connection] : graphConnections) {
+    if (connection == nullptr) {
+      throw std::runtime_error(
+          "Processing graph cannot snapshot a null connection: " + std::to_string(connectionId));
+    }
+
+    connectionsCopy->insert_or_assign(connectionId,
+        std::make_shared<NodeConnection>(NodeConnectionModelImpl{
+            .id = connection->id(),
+            .sourceNodeId = connection->sourceNodeId(),
+            .sourcePortId = connection->sourcePortId(),
+            .destinationNodeId = connection->destinationNodeId(),
+            .destinationPortId = connection->destinationPortId(),
+        }));
+  }
+
+  graph = std::make_shared<ProcessingGraphModel>(ProcessingGraphModelImpl{
+      .nodes = std::move(nodesCopy),
+      .connections = std::move(connectionsCopy),
+      .masterOutputNodeId = processingGraph.masterOutputNodeId(),
+  });
+}
+
+} // namespace anthem
@@ -0,0 +1,65 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+namespace anthem {
+
+class Node;
+class ProcessingGraphModel;
+
+// A copy of the processing graph model's nodes, ports and connections, for
+// compiling runtime graphs away from the message thread.
+//
+// The model is synced from the UI on the message thread, so it can't be read
+// from another thread while it might be changing. A snapshot is captured on
+// the message thread and can be read from any thread afterward. Processors and
+// port configs are shared with the model rather than copied, since neither
+// changes once its node has been created.
+class ProcessingGraphSnapshot {
+public:
+  using ModelNodeMap = std::unordered_map<int64_t, std::shared_ptr<Node>>;
+
+  // Message thread only.
+  explicit ProcessingGraphSnapshot(ProcessingGraphModel& processingGraph);
+
+  ProcessingGraphSnapshot(const ProcessingGraphSnapshot&) = delete;
+  ProcessingGraphSnapshot& operator=(const ProcessingGraphSnapshot&) = delete;
+
+  // The copied graph. Runtime graphs compiled from it refer to the copied
+  // nodes until RuntimeGraph::attachToModel() moves them onto the model nodes
+  // below.
+  ProcessingGraphModel& getGraph() {
+    return *graph;
+  }
+
+  // The model nodes the snapshot was captured from, by ID.
+  const ModelNodeMap& getModelNodes() const {
+    return modelNodesById;
+  }
+private:
+  std::shared_ptr<ProcessingGraphModel> graph;
+  ModelNodeMap modelNodesById;
+};
+
+} // namespace anthem
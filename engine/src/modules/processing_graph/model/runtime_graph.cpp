@@ -26,9 +26,13 @@
 #include "modules/processing_graph/model/node_port.h"
 #include "modules/processing_graph/runtime/node_process_context.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <optional>
 #include <stdexcept>
 #include <string>
-#include <unordered_set>
 #include <utility>
 
 namespace anthem {
@@ -44,17 +48,163 @@ bool RuntimeNodePriorityComparator::operator()(
 
 namespace {
 
-enum class DfsState : uint8_t {
-  unvisited = 0,
-  visiting,
-  visited,
+using GraphConnectionMap = ModelUnorderedMap<int64_t, std::shared_ptr<anthem::NodeConnection>>;
+using BufferBindingsByNodeIndex = std::vector<NodeProcessContext::BufferBindings>;
+
+struct PendingTransferAction {
+  RuntimeConnectionDataType dataType;
+  size_t destinationBufferIndex = 0;
+  std::vector<size_t> sourceBufferIndices;
 };
 
-using UniqueDestinationMap =
-    std::unordered_map<RuntimeNode::Id, std::unordered_set<RuntimeNode::Id>>;
-using GraphConnectionMap = ModelUnorderedMap<int64_t, std::shared_ptr<anthem::NodeConnection>>;
-using BufferBindingsByNodeId =
-    std::unordered_map<RuntimeNode::Id, NodeProcessContext::BufferBindings>;
+// A graph-owned audio buffer as the compiler sees it while binding ports,
+// before it has been given a physical buffer. See assignPooledAudioBuffers().
+struct PendingAudioBuffer {
+  size_t writerNodeIndex = 0;
+  std::vector<size_t> readerNodeIndices;
+
+  // Set on an in-place output that shares another slot's buffer. This is
+  // always a slot with a buffer of its own. See aliasInPlaceAudioPorts().
+  std::optional<size_t> inPlaceOwnerSlot;
+
+  // On a slot with a buffer of its own, the last in-place output written
+  // into that buffer, if any.
+  std::optional<size_t> latestInPlaceSlot;
+};
+
+// Free physical audio buffers, and releases of buffers that are still waiting
+// on some of their readers, handed from each node to the next. See
+// assignPooledAudioBuffers().
+struct AudioBufferPool {
+  // Released reader counts for a buffer with more than one reader, some of
+  // which have not released it in this pool yet.
+  struct PendingRelease {
+    size_t slot;
+    size_t releasedReaderCount;
+  };
+
+  std::vector<size_t> freeBufferIndices;
+
+  // Only buffers read from several parallel branches wait here, so this
+  // stays short and is searched linearly.
+  std::vector<PendingRelease> pendingReleases;
+
+  bool empty() const {
+    return freeBufferIndices.empty() && pendingReleases.empty();
+  }
+
+  // Keeps the capacity for the next node or the next compile.
+  void clear() {
+    freeBufferIndices.clear();
+    pendingReleases.clear();
+  }
+};
+
+// Stands in for the shared silent buffer in audio bindings until physical
+// buffers are assigned. It is never pooled, since nothing writes to it.
+constexpr size_t sharedSilentAudioBufferSlot = std::numeric_limits<size_t>::max();
+
+// Marks a source node that has no edge to the node whose inputs are being
+// bound. See RuntimeGraphCompileState::lastDestinationIndexBySource.
+constexpr size_t noDestinationIndex = std::numeric_limits<size_t>::max();
+
+// Edges and transfer actions collected per node while the graph is built.
+// These are packed into the RuntimeGraph's flat storage once every connection
+// has been seen. See packRuntimeGraphEdges() and packTransferActions().
+//
+// Audio buffer indices in bindings and transfer actions refer to
+// audioBuffers below until assignPooledAudioBuffers() replaces them.
+//
+// Everything here is indexed by node index or audio buffer slot rather than
+// node ID. One compile state is kept per thread and reset for each compile,
+// so recompiling a large graph reuses the storage from the last compile
+// instead of reallocating it.
+struct RuntimeGraphCompileState {
+  void reset(size_t nodeCount) {
+    // The inner vectors are cleared rather than destroyed so they keep their
+    // capacity.
+    for (auto& nodeIndices : outgoingNodeIndices) {
+      nodeIndices.clear();
+    }
+
+    for (auto& nodeTransferActions : transferActions) {
+      nodeTransferActions.clear();
+    }
+
+    for (auto& audioBuffer : audioBuffers) {
+      audioBuffer.readerNodeIndices.clear();
+    }
+
+    for (auto& nodeIndices : readerNodeIndicesBySlot) {
+      nodeIndices.clear();
+    }
+
+    for (auto& slots : writtenSlotsByNode) {
+      slots.clear();
+    }
+
+    for (auto& slots : readSlotsByNode) {
+      slots.clear();
+    }
+
+    for (auto& pool : audioBufferPools) {
+      pool.clear();
+    }
+
+    outgoingNodeIndices.resize(nodeCount);
+    transferActions.resize(nodeCount);
+    audioBufferCount = 0;
+    lastDestinationIndexBySource.assign(nodeCount, noDestinationIndex);
+    remainingUpstreamNodeCounts.clear();
+    writtenSlotsByNode.resize(nodeCount);
+    readSlotsByNode.resize(nodeCount);
+    audioBufferPools.resize(nodeCount);
+  }
+
+  size_t allocateAudioBuffer(size_t writerNodeIndex) {
+    if (audioBufferCount == audioBuffers.size()) {
+      audioBuffers.emplace_back();
+    }
+
+    auto& audioBuffer = audioBuffers[audioBufferCount];
+    audioBuffer.writerNodeIndex = writerNodeIndex;
+    audioBuffer.inPlaceOwnerSlot.reset();
+    audioBuffer.latestInPlaceSlot.reset();
+
+    return audioBufferCount++;
+  }
+
+  void addAudioBufferReader(size_t slot, size_t readerNodeIndex) {
+    if (slot != sharedSilentAudioBufferSlot) {
+      audioBuffers[slot].readerNodeIndices.push_back(readerNodeIndex);
+    }
+  }
+
+  std::vector<std::vector<size_t>> outgoingNodeIndices;
+  std::vector<std::vector<PendingTransferAction>> transferActions;
+
+  // Only the first audioBufferCount entries are in use. The rest are kept
+  // from earlier compiles for their reader lists' capacity.
+  std::vector<PendingAudioBuffer> audioBuffers;
+  size_t audioBufferCount = 0;
+
+  // The last node that an edge from each source node was added to. A node's
+  // inputs are all bound together, so a connection whose source already has
+  // an edge to that node duplicates the edge. See addConnectionToRuntimeGraph().
+  std::vector<size_t> lastDestinationIndexBySource;
+
+  // Scratch for buildTopologicalOrder().
+  std::vector<size_t> remainingUpstreamNodeCounts;
+
+  // Scratch for assignPooledAudioBuffers(). The first two are indexed by
+  // audio buffer slot, and the rest by node index.
+  std::vector<std::vector<size_t>> readerNodeIndicesBySlot;
+  std::vector<size_t> bufferIndicesBySlot;
+  std::vector<bool> isReusedBySlot;
+  std::vector<std::vector<size_t>> writtenSlotsByNode;
+  std::vector<std::vector<size_t>> readSlotsByNode;
+  std::vector<AudioBufferPool> audioBufferPools;
+};
 
 RuntimeConnectionDataType toRuntimeConnectionDataType(NodePortDataType dataType) {
   switch (dataType) {
@@ -102,13 +252,16 @@ anthem::NodeConnection& getGraphConnection(
   return *connectionIter->second;
 }
 
-void reserveRuntimeGraphStorage(RuntimeGraph& runtimeGraph,
-    ModelUnorderedMap<int64_t, std::shared_ptr<anthem::Node>>& graphNodes) {
+void reserveRuntimeGraphStorage(
+    RuntimeGraph& runtimeGraph, RuntimeGraphCompileState& compileState) {
   size_t totalAudioBufferCount = 0;
   size_t totalControlBufferCount = 0;
   size_t totalEventBufferCount = 0;
+  size_t totalParameterCount = 0;
+
+  for (auto& runtimeNode : runtimeGraph.nodes) {
+    auto& graphNode = runtimeNode.sourceNode;
 
-  for (auto& [nodeId, graphNode] : graphNodes) {
     totalAudioBufferCount +=
         graphNode->audioInputPorts()->size() + graphNode->audioOutputPorts()->size();
     totalControlBufferCount +=
@@ -124,37 +277,34 @@ void reserveRuntimeGraphStorage(RuntimeGraph& runtimeGraph,
 
     for (auto& port : *graphNode->controlInputPorts()) {
       incomingConnectionCount += port->connections()->size();
+
+      if (port->config()->parameterConfig().has_value()) {
+        ++totalParameterCount;
+      }
     }
 
     for (auto& port : *graphNode->eventInputPorts()) {
       incomingConnectionCount += port->connections()->size();
     }
 
-    runtimeGraph.nodes.at(nodeId).connectionTransferActions.reserve(incomingConnectionCount);
+    compileState.transferActions[runtimeNode.index].reserve(incomingConnectionCount);
   }
 
-  runtimeGraph.graphProcessContext->reserve(
-      graphNodes.size(), totalAudioBufferCount, totalControlBufferCount, totalEventBufferCount);
+  runtimeGraph.graphProcessContext->reserve(runtimeGraph.nodes.size(),
+      totalAudioBufferCount,
+      totalControlBufferCount,
+      totalEventBufferCount);
+  runtimeGraph.graphProcessContext->getParameterBank().reserve(totalParameterCount);
 }
 
 void createNodeProcessContexts(
-    RuntimeGraph& runtimeGraph, BufferBindingsByNodeId& bufferBindingsByNodeId) {
+    RuntimeGraph& runtimeGraph, BufferBindingsByNodeIndex& bufferBindingsByNodeIndex) {
   jassert(runtimeGraph.graphProcessContext != nullptr);
+  jassert(bufferBindingsByNodeIndex.size() == runtimeGraph.nodes.size());
 
-  for (auto& [_, runtimeNode] : runtimeGraph.nodes) {
-    if (runtimeNode.sourceNode == nullptr) {
-      throw std::runtime_error("Processing graph cannot create a context for a null graph node.");
-    }
-
-    auto bufferBindingsIter = bufferBindingsByNodeId.find(runtimeNode.id);
-    if (bufferBindingsIter == bufferBindingsByNodeId.end()) {
-      throw std::runtime_error(
-          "Processing graph cannot create a context without buffer bindings for node: " +
-          std::to_string(runtimeNode.id));
-    }
-
+  for (auto& runtimeNode : runtimeGraph.nodes) {
     auto& nodeProcessContext = runtimeGraph.graphProcessContext->createNodeProcessContext(
-        runtimeNode.sourceNode, std::move(bufferBindingsIter->second));
+        runtimeNode.sourceNode, std::move(bufferBindingsByNodeIndex[runtimeNode.index]));
     runtimeNode.nodeProcessContext = &nodeProcessContext;
 
     auto processor = runtimeNode.sourceNode->getProcessor();
@@ -164,73 +314,71 @@ void createNodeProcessContexts(
   }
 }
 
+void moveToModelNodes(
+    RuntimeGraph& runtimeGraph, const ProcessingGraphSnapshot::ModelNodeMap& modelNodes) {
+  for (auto& runtimeNode : runtimeGraph.nodes) {
+    auto modelNodeIter = modelNodes.find(runtimeNode.id);
+    if (modelNodeIter == modelNodes.end() || modelNodeIter->second == nullptr) {
+      throw std::runtime_error(
+          "Processing graph cannot find the model node for compiled node: " +
+          std::to_string(runtimeNode.id));
+    }
+
+    runtimeNode.sourceNode = modelNodeIter->second;
+    runtimeNode.nodeProcessContext->rebindGraphNode(runtimeNode.sourceNode);
+  }
+}
+
 void publishRuntimeContexts(RuntimeGraph& runtimeGraph) {
-  for (auto& [_, runtimeNode] : runtimeGraph.nodes) {
+  for (auto& runtimeNode : runtimeGraph.nodes) {
     runtimeNode.sourceNode->runtimeContext = runtimeNode.nodeProcessContext;
   }
 }
 
+// Adds the edge for a connection into destinationNode, unless there already
+// is one from the same source, and returns the connection's source node.
 RuntimeNode& addConnectionToRuntimeGraph(RuntimeGraph& runtimeGraph,
-    UniqueDestinationMap& uniqueDestinationIdsBySource,
-    RuntimeNode::Id inputPortNodeId,
+    RuntimeGraphCompileState& compileState,
+    RuntimeNode& destinationNode,
     anthem::NodeConnection& connection) {
   auto sourceNodeId = connection.sourceNodeId();
-  auto destinationNodeId = connection.destinationNodeId();
 
-  if (destinationNodeId != inputPortNodeId) {
+  if (connection.destinationNodeId() != destinationNode.id) {
     throw std::runtime_error("Processing graph connection destination does not match input port "
                              "owner node: " +
                              std::to_string(connection.id()));
   }
 
-  auto sourceNodeIter = runtimeGraph.nodes.find(sourceNodeId);
-  if (sourceNodeIter == runtimeGraph.nodes.end()) {
+  auto* sourceNode = runtimeGraph.findNode(sourceNodeId);
+  if (sourceNode == nullptr) {
     throw std::runtime_error(
         "Processing graph source node ID not found: " + std::to_string(sourceNodeId));
   }
 
-  auto destinationNodeIter = runtimeGraph.nodes.find(destinationNodeId);
-  if (destinationNodeIter == runtimeGraph.nodes.end()) {
-    throw std::runtime_error(
-        "Processing graph destination node ID not found: " + std::to_string(destinationNodeId));
-  }
-
-  auto& sourceNode = sourceNodeIter->second;
-  auto& destinationNode = destinationNodeIter->second;
-
-  auto uniqueDestinationIdsIter = uniqueDestinationIdsBySource.find(sourceNodeId);
-  if (uniqueDestinationIdsIter == uniqueDestinationIdsBySource.end()) {
-    auto [insertedIter, _] =
-        uniqueDestinationIdsBySource.emplace(sourceNodeId, std::unordered_set<RuntimeNode::Id>{});
-    uniqueDestinationIdsIter = insertedIter;
-  }
-
-  auto& uniqueDestinationIds = uniqueDestinationIdsIter->second;
-  auto [_, wasInserted] = uniqueDestinationIds.insert(destinationNodeId);
+  auto& lastDestinationIndex = compileState.lastDestinationIndexBySource[sourceNode->index];
 
-  if (!wasInserted) {
-    return destinationNode;
+  if (lastDestinationIndex == destinationNode.index) {
+    return *sourceNode;
   }
 
-  sourceNode.outgoingConnections.push_back(&destinationNode);
+  lastDestinationIndex = destinationNode.index;
+  compileState.outgoingNodeIndices[sourceNode->index].push_back(destinationNode.index);
   destinationNode.upstreamNodeCount++;
 
-  return destinationNode;
+  return *sourceNode;
 }
 
-void addConnectionSourceToTransferAction(RuntimeConnectionTransferAction& action,
-    RuntimeNode*& destinationRuntimeNode,
+void addConnectionSourceToTransferAction(PendingTransferAction& action,
     RuntimeGraph& runtimeGraph,
-    UniqueDestinationMap& uniqueDestinationIdsBySource,
+    RuntimeGraphCompileState& compileState,
     anthem::NodeConnection& connection,
     NodePortDataType dataType,
-    RuntimeNode::Id inputPortNodeId,
-    BufferBindingsByNodeId& bufferBindingsByNodeId) {
-  auto& destinationNode = addConnectionToRuntimeGraph(
-      runtimeGraph, uniqueDestinationIdsBySource, inputPortNodeId, connection);
-  destinationRuntimeNode = &destinationNode;
+    RuntimeNode& destinationNode,
+    BufferBindingsByNodeIndex& bufferBindingsByNodeIndex) {
+  auto& sourceNode =
+      addConnectionToRuntimeGraph(runtimeGraph, compileState, destinationNode, connection);
 
-  auto sourceBufferIndex = getBufferIndex(bufferBindingsByNodeId.at(connection.sourceNodeId()),
+  auto sourceBufferIndex = getBufferIndex(bufferBindingsByNodeIndex[sourceNode.index],
       dataType,
       NodeProcessContext::BufferDirection::output,
       connection.sourcePortId());
@@ -251,13 +399,14 @@ void reserveBufferBindingStorage(
 }
 
 void bindOutputPortBuffers(RuntimeGraph& runtimeGraph,
+    RuntimeGraphCompileState& compileState,
+    size_t nodeIndex,
     anthem::Node& graphNode,
     NodeProcessContext::BufferBindings& bindings) {
   jassert(runtimeGraph.graphProcessContext != nullptr);
 
   for (auto& port : *graphNode.audioOutputPorts()) {
-    bindings.outputAudioBuffers.emplace(
-        port->id(), runtimeGraph.graphProcessContext->allocateAudioBuffer());
+    bindings.outputAudioBuffers.emplace(port->id(), compileState.allocateAudioBuffer(nodeIndex));
   }
 
   for (auto& port : *graphNode.controlOutputPorts()) {
@@ -266,8 +415,9 @@ void bindOutputPortBuffers(RuntimeGraph& runtimeGraph,
   }
 
   for (auto& port : *graphNode.eventOutputPorts()) {
-    // TODO: Seed initial capacities from persisted per-port runtime hints once
-    // graph recompilation can preserve processing state across compiles.
+    // This starts at the default capacity. If this graph replaces one with
+    // the same node, rt_adoptStateFrom() swaps in that node's buffer, so any
+    // capacity it has grown into carries over.
     auto bufferIndex =
         runtimeGraph.graphProcessContext->allocateEventBuffer(DEFAULT_EVENT_BUFFER_SIZE);
     bindings.outputEventBuffers.emplace(port->id(), bufferIndex);
@@ -277,9 +427,9 @@ void bindOutputPortBuffers(RuntimeGraph& runtimeGraph,
 
 void bindAudioInputPort(RuntimeGraph& runtimeGraph,
     GraphConnectionMap& graphConnections,
-    UniqueDestinationMap& uniqueDestinationIdsBySource,
-    BufferBindingsByNodeId& bufferBindingsByNodeId,
-    RuntimeNode::Id inputPortNodeId,
+    RuntimeGraphCompileState& compileState,
+    BufferBindingsByNodeIndex& bufferBindingsByNodeIndex,
+    RuntimeNode& destinationNode,
     NodePort& inputPort,
     NodeProcessContext::BufferBindings& bindings) {
   jassert(runtimeGraph.graphProcessContext != nullptr);
@@ -289,8 +439,7 @@ void bindAudioInputPort(RuntimeGraph& runtimeGraph,
   // If there are no inputs, we will only read silence. There is a shared
   // silence buffer for this, which should hopefully be more cache-friendly.
   if (connectionCount == 0) {
-    bindings.inputAudioBuffers.emplace(
-        inputPort.id(), runtimeGraph.graphProcessContext->getSharedSilentAudioBufferIndex());
+    bindings.inputAudioBuffers.emplace(inputPort.id(), sharedSilentAudioBufferSlot);
     return;
   }
 
@@ -299,14 +448,15 @@ void bindAudioInputPort(RuntimeGraph& runtimeGraph,
   // directly from the output port's buffer.
   if (connectionCount == 1) {
     auto& connection = getGraphConnection(graphConnections, inputPort.connections()->at(0));
-    addConnectionToRuntimeGraph(
-        runtimeGraph, uniqueDestinationIdsBySource, inputPortNodeId, connection);
+    auto& sourceNode =
+        addConnectionToRuntimeGraph(runtimeGraph, compileState, destinationNode, connection);
 
-    auto sourceBufferIndex = getBufferIndex(bufferBindingsByNodeId.at(connection.sourceNodeId()),
+    auto sourceBufferIndex = getBufferIndex(bufferBindingsByNodeIndex[sourceNode.index],
         NodePortDataType::audio,
         NodeProcessContext::BufferDirection::output,
         connection.sourcePortId());
     bindings.inputAudioBuffers.emplace(inputPort.id(), sourceBufferIndex);
+    compileState.addAudioBufferReader(sourceBufferIndex, destinationNode.index);
     return;
   }
 
@@ -314,38 +464,41 @@ void bindAudioInputPort(RuntimeGraph& runtimeGraph,
   // input port has multiple incoming connections. In this case, we sum all the
   // connected output buffers into the input buffer.
 
-  auto destinationBufferIndex = runtimeGraph.graphProcessContext->allocateAudioBuffer();
+  // The destination buffer is written and read by its own node, during the
+  // transfer and then the node's processing.
+  const auto destinationNodeIndex = destinationNode.index;
+  auto destinationBufferIndex = compileState.allocateAudioBuffer(destinationNodeIndex);
+  compileState.addAudioBufferReader(destinationBufferIndex, destinationNodeIndex);
   bindings.inputAudioBuffers.emplace(inputPort.id(), destinationBufferIndex);
 
-  RuntimeConnectionTransferAction action;
+  PendingTransferAction action;
   action.dataType = RuntimeConnectionDataType::audio;
   action.destinationBufferIndex = destinationBufferIndex;
   action.sourceBufferIndices.reserve(connectionCount);
-  RuntimeNode* destinationRuntimeNode = nullptr;
 
   for (auto connectionId : *inputPort.connections()) {
     auto& connection = getGraphConnection(graphConnections, connectionId);
     addConnectionSourceToTransferAction(action,
-        destinationRuntimeNode,
         runtimeGraph,
-        uniqueDestinationIdsBySource,
+        compileState,
         connection,
         NodePortDataType::audio,
-        inputPortNodeId,
-        bufferBindingsByNodeId);
+        destinationNode,
+        bufferBindingsByNodeIndex);
   }
 
-  jassert(destinationRuntimeNode != nullptr);
-  if (destinationRuntimeNode != nullptr) {
-    destinationRuntimeNode->connectionTransferActions.push_back(std::move(action));
+  for (auto sourceBufferIndex : action.sourceBufferIndices) {
+    compileState.addAudioBufferReader(sourceBufferIndex, destinationNodeIndex);
   }
+
+  compileState.transferActions[destinationNode.index].push_back(std::move(action));
 }
 
 void bindControlInputPort(RuntimeGraph& runtimeGraph,
     GraphConnectionMap& graphConnections,
-    UniqueDestinationMap& uniqueDestinationIdsBySource,
-    BufferBindingsByNodeId& bufferBindingsByNodeId,
-    RuntimeNode::Id inputPortNodeId,
+    RuntimeGraphCompileState& compileState,
+    BufferBindingsByNodeIndex& bufferBindingsByNodeIndex,
+    RuntimeNode& destinationNode,
     NodePort& inputPort,
     NodeProcessContext::BufferBindings& bindings) {
   // The logic here for zero-, one- and multi-input ports is similar to audio
@@ -369,12 +522,12 @@ void bindControlInputPort(RuntimeGraph& runtimeGraph,
 
   if (connectionCount == 1) {
     auto& connection = getGraphConnection(graphConnections, inputPort.connections()->at(0));
-    addConnectionToRuntimeGraph(
-        runtimeGraph, uniqueDestinationIdsBySource, inputPortNodeId, connection);
+    auto& sourceNode =
+        addConnectionToRuntimeGraph(runtimeGraph, compileState, destinationNode, connection);
 
     // A single-source input can read directly from the source output. Fan-in
     // inputs below get a dedicated destination buffer and transfer action.
-    auto sourceBufferIndex = getBufferIndex(bufferBindingsByNodeId.at(connection.sourceNodeId()),
+    auto sourceBufferIndex = getBufferIndex(bufferBindingsByNodeIndex[sourceNode.index],
         NodePortDataType::control,
         NodeProcessContext::BufferDirection::output,
         connection.sourcePortId());
@@ -385,35 +538,30 @@ void bindControlInputPort(RuntimeGraph& runtimeGraph,
   auto destinationBufferIndex = runtimeGraph.graphProcessContext->allocateControlBuffer();
   bindings.inputControlBuffers.emplace(inputPort.id(), destinationBufferIndex);
 
-  RuntimeConnectionTransferAction action;
+  PendingTransferAction action;
   action.dataType = RuntimeConnectionDataType::control;
   action.destinationBufferIndex = destinationBufferIndex;
   action.sourceBufferIndices.reserve(connectionCount);
-  RuntimeNode* destinationRuntimeNode = nullptr;
 
   for (auto connectionId : *inputPort.connections()) {
     auto& connection = getGraphConnection(graphConnections, connectionId);
     addConnectionSourceToTransferAction(action,
-        destinationRuntimeNode,
         runtimeGraph,
-        uniqueDestinationIdsBySource,
+        compileState,
         connection,
         NodePortDataType::control,
-        inputPortNodeId,
-        bufferBindingsByNodeId);
+        destinationNode,
+        bufferBindingsByNodeIndex);
   }
 
-  jassert(destinationRuntimeNode != nullptr);
-  if (destinationRuntimeNode != nullptr) {
-    destinationRuntimeNode->connectionTransferActions.push_back(std::move(action));
-  }
+  compileState.transferActions[destinationNode.index].push_back(std::move(action));
 }
 
 void bindEventInputPort(RuntimeGraph& runtimeGraph,
     GraphConnectionMap& graphConnections,
-    UniqueDestinationMap& uniqueDestinationIdsBySource,
-    BufferBindingsByNodeId& bufferBindingsByNodeId,
-    RuntimeNode::Id inputPortNodeId,
+    RuntimeGraphCompileState& compileState,
+    BufferBindingsByNodeIndex& bufferBindingsByNodeIndex,
+    RuntimeNode& destinationNode,
     NodePort& inputPort,
     NodeProcessContext::BufferBindings& bindings) {
   // The logic here for zero-, one- and multi-input ports is similar to audio
@@ -431,12 +579,12 @@ void bindEventInputPort(RuntimeGraph& runtimeGraph,
 
   if (connectionCount == 1) {
     auto& connection = getGraphConnection(graphConnections, inputPort.connections()->at(0));
-    addConnectionToRuntimeGraph(
-        runtimeGraph, uniqueDestinationIdsBySource, inputPortNodeId, connection);
+    auto& sourceNode =
+        addConnectionToRuntimeGraph(runtimeGraph, compileState, destinationNode, connection);
 
     // A single-source input can read directly from the source output. Fan-in
     // inputs below get a dedicated destination buffer and transfer action.
-    auto sourceBufferIndex = getBufferIndex(bufferBindingsByNodeId.at(connection.sourceNodeId()),
+    auto sourceBufferIndex = getBufferIndex(bufferBindingsByNodeIndex[sourceNode.index],
         NodePortDataType::event,
         NodeProcessContext::BufferDirection::output,
         connection.sourcePortId());
@@ -444,49 +592,56 @@ void bindEventInputPort(RuntimeGraph& runtimeGraph,
     return;
   }
 
-  // TODO: Seed initial capacities from persisted per-port runtime hints once
-  // graph recompilation can preserve processing state across compiles.
-  auto destinationBufferIndex =
-      runtimeGraph.graphProcessContext->allocateEventBuffer(DEFAULT_EVENT_BUFFER_SIZE);
-  bindings.inputEventBuffers.emplace(inputPort.id(), destinationBufferIndex);
-  bindings.rt_eventBuffersToClear.push_back(destinationBufferIndex);
-
-  RuntimeConnectionTransferAction action;
+  PendingTransferAction action;
   action.dataType = RuntimeConnectionDataType::event;
-  action.destinationBufferIndex = destinationBufferIndex;
   action.sourceBufferIndices.reserve(connectionCount);
-  RuntimeNode* destinationRuntimeNode = nullptr;
 
   for (auto connectionId : *inputPort.connections()) {
     auto& connection = getGraphConnection(graphConnections, connectionId);
     addConnectionSourceToTransferAction(action,
-        destinationRuntimeNode,
         runtimeGraph,
-        uniqueDestinationIdsBySource,
+        compileState,
         connection,
         NodePortDataType::event,
-        inputPortNodeId,
-        bufferBindingsByNodeId);
+        destinationNode,
+        bufferBindingsByNodeIndex);
   }
 
-  jassert(destinationRuntimeNode != nullptr);
-  if (destinationRuntimeNode != nullptr) {
-    destinationRuntimeNode->connectionTransferActions.push_back(std::move(action));
+  // The merge runs on the audio thread and must not grow the destination, so
+  // it is sized here to take every source at its full capacity at once.
+  size_t mergedCapacity = 0;
+
+  for (auto sourceBufferIndex : action.sourceBufferIndices) {
+    mergedCapacity +=
+        runtimeGraph.graphProcessContext->getEventBuffer(sourceBufferIndex)->getSize();
   }
+
+  // Like output event buffers, this is swapped for the previous graph's
+  // buffer for the same port by rt_adoptStateFrom(), unless this one is
+  // larger, so it keeps its capacity.
+  auto destinationBufferIndex = runtimeGraph.graphProcessContext->allocateEventBuffer(
+      std::max(mergedCapacity, static_cast<size_t>(DEFAULT_EVENT_BUFFER_SIZE)));
+  bindings.inputEventBuffers.emplace(inputPort.id(), destinationBufferIndex);
+  bindings.rt_eventBuffersToClear.push_back(destinationBufferIndex);
+  action.destinationBufferIndex = destinationBufferIndex;
+
+  compileState.transferActions[destinationNode.index].push_back(std::move(action));
 }
 
 void bindInputPortBuffers(RuntimeGraph& runtimeGraph,
     GraphConnectionMap& graphConnections,
-    UniqueDestinationMap& uniqueDestinationIdsBySource,
-    BufferBindingsByNodeId& bufferBindingsByNodeId,
-    anthem::Node& graphNode,
+    RuntimeGraphCompileState& compileState,
+    BufferBindingsByNodeIndex& bufferBindingsByNodeIndex,
+    RuntimeNode& runtimeNode,
     NodeProcessContext::BufferBindings& bindings) {
+  auto& graphNode = *runtimeNode.sourceNode;
+
   for (auto& inputPort : *graphNode.audioInputPorts()) {
     bindAudioInputPort(runtimeGraph,
         graphConnections,
-        uniqueDestinationIdsBySource,
-        bufferBindingsByNodeId,
-        graphNode.id(),
+        compileState,
+        bufferBindingsByNodeIndex,
+        runtimeNode,
         *inputPort,
         bindings);
   }
@@ -494,9 +649,9 @@ void bindInputPortBuffers(RuntimeGraph& runtimeGraph,
   for (auto& inputPort : *graphNode.controlInputPorts()) {
     bindControlInputPort(runtimeGraph,
         graphConnections,
-        uniqueDestinationIdsBySource,
-        bufferBindingsByNodeId,
-        graphNode.id(),
+        compileState,
+        bufferBindingsByNodeIndex,
+        runtimeNode,
         *inputPort,
         bindings);
   }
@@ -504,97 +659,616 @@ void bindInputPortBuffers(RuntimeGraph& runtimeGraph,
   for (auto& inputPort : *graphNode.eventInputPorts()) {
     bindEventInputPort(runtimeGraph,
         graphConnections,
-        uniqueDestinationIdsBySource,
-        bufferBindingsByNodeId,
-        graphNode.id(),
+        compileState,
+        bufferBindingsByNodeIndex,
+        runtimeNode,
         *inputPort,
         bindings);
   }
 }
 
-BufferBindingsByNodeId createBufferBindingsAndConnections(RuntimeGraph& runtimeGraph,
-    ModelUnorderedMap<int64_t, std::shared_ptr<anthem::Node>>& graphNodes,
+BufferBindingsByNodeIndex createBufferBindingsAndConnections(RuntimeGraph& runtimeGraph,
+    RuntimeGraphCompileState& compileState,
     GraphConnectionMap& graphConnections) {
-  BufferBindingsByNodeId bufferBindingsByNodeId;
-  bufferBindingsByNodeId.reserve(runtimeGraph.nodes.size());
+  BufferBindingsByNodeIndex bufferBindingsByNodeIndex(runtimeGraph.nodes.size());
 
-  for (auto& [nodeId, graphNode] : graphNodes) {
-    auto [bindingsIter, _] =
-        bufferBindingsByNodeId.emplace(nodeId, NodeProcessContext::BufferBindings{});
-    auto& bindings = bindingsIter->second;
+  for (auto& runtimeNode : runtimeGraph.nodes) {
+    auto& bindings = bufferBindingsByNodeIndex[runtimeNode.index];
 
-    reserveBufferBindingStorage(bindings, *graphNode);
-    bindOutputPortBuffers(runtimeGraph, *graphNode, bindings);
+    reserveBufferBindingStorage(bindings, *runtimeNode.sourceNode);
+    bindOutputPortBuffers(
+        runtimeGraph, compileState, runtimeNode.index, *runtimeNode.sourceNode, bindings);
   }
 
-  UniqueDestinationMap uniqueDestinationIdsBySource;
-  uniqueDestinationIdsBySource.reserve(graphNodes.size());
+  for (auto& runtimeNode : runtimeGraph.nodes) {
+    bindInputPortBuffers(runtimeGraph,
+        graphConnections,
+        compileState,
+        bufferBindingsByNodeIndex,
+        runtimeNode,
+        bufferBindingsByNodeIndex[runtimeNode.index]);
+  }
 
-  for (auto& [nodeId, graphNode] : graphNodes) {
-    auto bindingsIter = bufferBindingsByNodeId.find(nodeId);
-    if (bindingsIter == bufferBindingsByNodeId.end()) {
-      throw std::runtime_error(
-          "Processing graph buffer bindings missing for node: " + std::to_string(nodeId));
+  return bufferBindingsByNodeIndex;
+}
+
+// Copies the per-node edges collected while building the graph into the
+// RuntimeGraph's flat storage, points each node's outgoingConnections at its
+// slice, and sets up the per-block upstream counters. The storage is sized
+// exactly before it is filled, so the spans stay valid for the life of the
+// graph.
+void packRuntimeGraphEdges(RuntimeGraph& runtimeGraph, RuntimeGraphCompileState& compileState) {
+  auto& nodes = runtimeGraph.nodes;
+
+  size_t downstreamNodeCount = 0;
+
+  for (size_t nodeIndex = 0; nodeIndex < nodes.size(); ++nodeIndex) {
+    downstreamNodeCount += compileState.outgoingNodeIndices[nodeIndex].size();
+  }
+
+  auto& downstreamNodeStorage = runtimeGraph.downstreamNodeStorage;
+  downstreamNodeStorage.reserve(downstreamNodeCount);
+
+  for (auto& runtimeNode : nodes) {
+    const auto downstreamStart = downstreamNodeStorage.size();
+
+    for (auto downstreamIndex : compileState.outgoingNodeIndices[runtimeNode.index]) {
+      downstreamNodeStorage.push_back(&nodes[downstreamIndex]);
     }
 
-    bindInputPortBuffers(runtimeGraph,
-        graphConnections,
-        uniqueDestinationIdsBySource,
-        bufferBindingsByNodeId,
-        *graphNode,
-        bindingsIter->second);
+    runtimeNode.outgoingConnections = std::span<RuntimeNode* const>(
+        downstreamNodeStorage.data() + downstreamStart,
+        downstreamNodeStorage.size() - downstreamStart);
   }
 
-  return bufferBindingsByNodeId;
+  jassert(downstreamNodeStorage.size() == downstreamNodeCount);
+
+  runtimeGraph.upstreamNodeCounts.resize(nodes.size());
+  runtimeGraph.rt_remainingUpstreamNodeCounts =
+      std::make_unique<std::atomic<size_t>[]>(nodes.size());
+
+  for (auto& runtimeNode : nodes) {
+    runtimeGraph.upstreamNodeCounts[runtimeNode.index] = runtimeNode.upstreamNodeCount;
+    runtimeNode.rt_state.rt_remainingUpstreamNodes =
+        &runtimeGraph.rt_remainingUpstreamNodeCounts[runtimeNode.index];
+  }
 }
 
-void assertAcyclicFromNode(
-    RuntimeNode& node, std::unordered_map<RuntimeNode::Id, DfsState>& dfsStates) {
-  auto dfsStateIter = dfsStates.find(node.id);
-  if (dfsStateIter == dfsStates.end()) {
-    auto [insertedIter, _] = dfsStates.emplace(node.id, DfsState::unvisited);
-    dfsStateIter = insertedIter;
+// Copies the per-node transfer actions collected while building the graph
+// into the RuntimeGraph's flat storage, and points each node's
+// connectionTransferActions at its slice. As above, the storage is sized
+// exactly before it is filled.
+void packTransferActions(RuntimeGraph& runtimeGraph, RuntimeGraphCompileState& compileState) {
+  auto& nodes = runtimeGraph.nodes;
+
+  size_t transferActionCount = 0;
+  size_t transferSourceCount = 0;
+
+  for (size_t nodeIndex = 0; nodeIndex < nodes.size(); ++nodeIndex) {
+    transferActionCount += compileState.transferActions[nodeIndex].size();
+
+    for (auto& action : compileState.transferActions[nodeIndex]) {
+      transferSourceCount += action.sourceBufferIndices.size();
+    }
   }
 
-  auto& state = dfsStateIter->second;
+  auto& transferActionStorage = runtimeGraph.transferActionStorage;
+  auto& transferSourceBufferIndexStorage = runtimeGraph.transferSourceBufferIndexStorage;
+
+  transferActionStorage.reserve(transferActionCount);
+  transferSourceBufferIndexStorage.reserve(transferSourceCount);
+  runtimeGraph.rt_transferSourceCursorStorage.assign(transferSourceCount, 0);
+  runtimeGraph.rt_transferSourcePointerStorage.assign(transferSourceCount, nullptr);
+
+  for (auto& runtimeNode : nodes) {
+    const auto transferActionStart = transferActionStorage.size();
+
+    for (auto& pendingAction : compileState.transferActions[runtimeNode.index]) {
+      const auto sourceStart = transferSourceBufferIndexStorage.size();
+      transferSourceBufferIndexStorage.insert(transferSourceBufferIndexStorage.end(),
+          pendingAction.sourceBufferIndices.begin(),
+          pendingAction.sourceBufferIndices.end());
+
+      transferActionStorage.push_back(RuntimeConnectionTransferAction{
+          .dataType = pendingAction.dataType,
+          .destinationBufferIndex = pendingAction.destinationBufferIndex,
+          .sourceBufferIndices = std::span<const size_t>(
+              transferSourceBufferIndexStorage.data() + sourceStart,
+              pendingAction.sourceBufferIndices.size()),
+          .rt_sourceCursors = std::span<size_t>(
+              runtimeGraph.rt_transferSourceCursorStorage.data() + sourceStart,
+              pendingAction.sourceBufferIndices.size()),
+          .rt_sourceChannelPointers = std::span<const float*>(
+              runtimeGraph.rt_transferSourcePointerStorage.data() + sourceStart,
+              pendingAction.sourceBufferIndices.size()),
+      });
+    }
 
-  if (state == DfsState::visiting) {
-    throw std::runtime_error(
-        "Cycle detected in processing graph at node: " + std::to_string(node.id));
+    runtimeNode.connectionTransferActions = std::span<const RuntimeConnectionTransferAction>(
+        transferActionStorage.data() + transferActionStart,
+        transferActionStorage.size() - transferActionStart);
   }
 
-  if (state == DfsState::visited) {
+  jassert(transferActionStorage.size() == transferActionCount);
+  jassert(transferSourceBufferIndexStorage.size() == transferSourceCount);
+}
+
+size_t addSaturating(size_t left, size_t right) {
+  return right > std::numeric_limits<size_t>::max() - left ? std::numeric_limits<size_t>::max()
+                                                             : left + right;
+}
+
+// Orders nodes so that each node comes before all of its downstream nodes,
+// using Kahn's algorithm. Nodes on a cycle never run out of upstream nodes,
+// so they are left out of the order, which is how cycles are detected.
+void buildTopologicalOrder(RuntimeGraph& runtimeGraph, RuntimeGraphCompileState& compileState) {
+  auto& remainingUpstreamNodeCounts = compileState.remainingUpstreamNodeCounts;
+  remainingUpstreamNodeCounts.assign(
+      runtimeGraph.upstreamNodeCounts.begin(), runtimeGraph.upstreamNodeCounts.end());
+
+  auto& topologicalOrder = runtimeGraph.topologicalOrder;
+  topologicalOrder.clear();
+  topologicalOrder.reserve(runtimeGraph.nodes.size());
+  topologicalOrder.insert(
+      topologicalOrder.end(), runtimeGraph.inputNodes.begin(), runtimeGraph.inputNodes.end());
+
+  for (size_t nodeIndex = 0; nodeIndex < topologicalOrder.size(); ++nodeIndex) {
+    for (auto* downstreamNode : topologicalOrder[nodeIndex]->outgoingConnections) {
+      if (--remainingUpstreamNodeCounts[downstreamNode->index] == 0) {
+        topologicalOrder.push_back(downstreamNode);
+      }
+    }
+  }
+
+  if (topologicalOrder.size() == runtimeGraph.nodes.size()) {
     return;
   }
 
-  state = DfsState::visiting;
+  for (auto& runtimeNode : runtimeGraph.nodes) {
+    if (remainingUpstreamNodeCounts[runtimeNode.index] != 0) {
+      throw std::runtime_error("Cycle detected in processing graph at or downstream of node: " +
+                               std::to_string(runtimeNode.id));
+    }
+  }
+
+  jassertfalse;
+}
+
+// Sets each node's priority to the number of paths from it to a node with no
+// downstream nodes, so that the nodes that most of the graph waits on are
+// started first. The counts grow exponentially with the depth of densely
+// connected graphs, so they saturate instead of wrapping.
+void calculatePriorities(RuntimeGraph& runtimeGraph) {
+  for (auto nodeIter = runtimeGraph.topologicalOrder.rbegin();
+       nodeIter != runtimeGraph.topologicalOrder.rend();
+       ++nodeIter) {
+    auto& runtimeNode = **nodeIter;
+    size_t priority = 1;
+
+    for (auto* downstreamNode : runtimeNode.outgoingConnections) {
+      priority = addSaturating(priority, downstreamNode->priority);
+    }
+
+    runtimeNode.priority = priority;
+  }
+}
+
+// Collapses maximal runs of nodes where each link is the only output of one
+// node and the only input of the next, such as the devices on a track. Each
+// run is scheduled as a single task that processes its nodes back to back on
+// one thread, which saves a trip through the scheduler per link.
+//
+// This only groups nodes for scheduling. Edges, transfer actions and buffer
+// bindings are left exactly as they were.
+void fuseLinearChains(RuntimeGraph& runtimeGraph) {
+  runtimeGraph.taskCount = 0;
+
+  // A node belongs to at most one chain, so this never reallocates and the
+  // spans set below stay valid.
+  auto& fusedChainNodeStorage = runtimeGraph.fusedChainNodeStorage;
+  fusedChainNodeStorage.clear();
+  fusedChainNodeStorage.reserve(runtimeGraph.nodes.size());
+
+  // Walking in topological order means a chain is always found from its head.
+  for (auto* runtimeNode : runtimeGraph.topologicalOrder) {
+    if (runtimeNode->isFusedIntoChain) {
+      continue;
+    }
+
+    ++runtimeGraph.taskCount;
+
+    auto* chainTail = runtimeNode;
+    const auto chainStart = fusedChainNodeStorage.size();
+
+    while (chainTail->outgoingConnections.size() == 1) {
+      auto* nextNode = chainTail->outgoingConnections.front();
+
+      if (nextNode->upstreamNodeCount != 1) {
+        break;
+      }
+
+      jassert(!nextNode->isFusedIntoChain);
+
+      nextNode->isFusedIntoChain = true;
+      fusedChainNodeStorage.push_back(nextNode);
+      chainTail = nextNode;
+    }
+
+    runtimeNode->fusedChainNodes = std::span<RuntimeNode* const>(
+        fusedChainNodeStorage.data() + chainStart, fusedChainNodeStorage.size() - chainStart);
+  }
+}
+
+// Binds the output of each in-place port pair to its input's buffer where
+// nothing else needs the input's value. See
+// Processor::getInPlaceAudioPortPairs().
+//
+// Walking in topological order lets a run of in-place nodes, such as the
+// effects on a track, share one buffer from the run's source to its end.
+void aliasInPlaceAudioPorts(RuntimeGraph& runtimeGraph,
+    RuntimeGraphCompileState& compileState,
+    BufferBindingsByNodeIndex& bufferBindingsByNodeIndex) {
+  auto& pendingBuffers = compileState.audioBuffers;
+
+  for (auto* runtimeNode : runtimeGraph.topologicalOrder) {
+    auto processor = runtimeNode->sourceNode->getProcessor();
+    if (!processor.has_value()) {
+      continue;
+    }
+
+    auto& bindings = bufferBindingsByNodeIndex[runtimeNode->index];
+
+    for (auto [inputPortId, outputPortId] : processor.value()->getInPlaceAudioPortPairs()) {
+      auto inputSlotIter = bindings.inputAudioBuffers.find(inputPortId);
+      auto outputSlotIter = bindings.outputAudioBuffers.find(outputPortId);
+
+      if (inputSlotIter == bindings.inputAudioBuffers.end() ||
+          outputSlotIter == bindings.outputAudioBuffers.end()) {
+        continue;
+      }
+
+      const auto inputSlot = inputSlotIter->second;
+      const auto outputSlot = outputSlotIter->second;
+
+      // Disconnected inputs read the shared silent buffer, and fan-in inputs
+      // are summed into a buffer written by this node.
+      if (inputSlot == sharedSilentAudioBufferSlot ||
+          pendingBuffers[inputSlot].writerNodeIndex == runtimeNode->index) {
+        continue;
+      }
+
+      // This port must be the only reader of the source's value.
+      if (pendingBuffers[inputSlot].readerNodeIndices.size() != 1) {
+        continue;
+      }
+
+      jassert(pendingBuffers[inputSlot].readerNodeIndices.front() == runtimeNode->index);
+
+      const auto ownerSlot = pendingBuffers[inputSlot].inPlaceOwnerSlot.value_or(inputSlot);
+      auto& owner = pendingBuffers[ownerSlot];
+
+      // Another pair on this node may already have overwritten the input.
+      if (owner.latestInPlaceSlot.value_or(ownerSlot) != inputSlot ||
+          pendingBuffers[outputSlot].inPlaceOwnerSlot.has_value()) {
+        continue;
+      }
+
+      pendingBuffers[outputSlot].inPlaceOwnerSlot = ownerSlot;
+      owner.latestInPlaceSlot = outputSlot;
+    }
+  }
+}
+
+void releaseAudioBufferToPool(AudioBufferPool& pool,
+    const std::vector<std::vector<size_t>>& readerNodeIndicesBySlot,
+    const std::vector<size_t>& bufferIndicesBySlot,
+    size_t slot,
+    size_t releasedReaderCount) {
+  const auto readerCount = readerNodeIndicesBySlot[slot].size();
+
+  if (readerCount > 1) {
+    auto pendingRelease = std::find_if(pool.pendingReleases.begin(),
+        pool.pendingReleases.end(),
+        [slot](const AudioBufferPool::PendingRelease& release) { return release.slot == slot; });
+
+    if (pendingRelease == pool.pendingReleases.end()) {
+      pendingRelease = pool.pendingReleases.insert(pool.pendingReleases.end(),
+          AudioBufferPool::PendingRelease{.slot = slot, .releasedReaderCount = 0});
+    }
+
+    pendingRelease->releasedReaderCount += releasedReaderCount;
 
-  for (auto* downstreamNode : node.outgoingConnections) {
-    assertAcyclicFromNode(*downstreamNode, dfsStates);
+    if (pendingRelease->releasedReaderCount < readerCount) {
+      return;
+    }
+
+    // Order doesn't matter here, so the last entry can fill the gap.
+    *pendingRelease = pool.pendingReleases.back();
+    pool.pendingReleases.pop_back();
   }
 
-  state = DfsState::visited;
+  pool.freeBufferIndices.push_back(bufferIndicesBySlot[slot]);
 }
 
-size_t getAndSetPriority(RuntimeNode& node) {
-  if (node.priority != 0) {
-    return node.priority;
+// Gives each audio buffer slot from port binding a physical buffer in the
+// GraphProcessContext, reusing physical buffers once they are dead, much like
+// register allocation. In-place outputs get their owner slot's buffer.
+// Bindings and transfer actions are rewritten to refer to the physical
+// buffers.
+//
+// Nodes on parallel branches may run at the same time on different threads,
+// so a buffer can only be reused by a node that the graph's edges force to
+// run after the buffer's writer and all of its readers. To guarantee this, a
+// pool is passed along edges in topological order, from each node to its
+// first downstream node. A node takes buffers for the ports it writes from
+// the pool it received, then adds the buffers it has finished with. A buffer
+// with several readers is only freed once the pool has collected a release
+// from each of them, which means the pool has passed through every one.
+//
+// Pools that reach a node with no downstream nodes are dropped, and releases
+// that never meet in one pool are never completed. Both only cost memory.
+void assignPooledAudioBuffers(RuntimeGraph& runtimeGraph,
+    RuntimeGraphCompileState& compileState,
+    BufferBindingsByNodeIndex& bufferBindingsByNodeIndex) {
+  jassert(runtimeGraph.graphProcessContext != nullptr);
+
+  auto& graphProcessContext = *runtimeGraph.graphProcessContext;
+  auto& pendingBuffers = compileState.audioBuffers;
+  const auto slotCount = compileState.audioBufferCount;
+  auto& readerNodeIndicesBySlot = compileState.readerNodeIndicesBySlot;
+  auto& bufferIndicesBySlot = compileState.bufferIndicesBySlot;
+  auto& isReusedBySlot = compileState.isReusedBySlot;
+  auto& writtenSlotsByNode = compileState.writtenSlotsByNode;
+  auto& readSlotsByNode = compileState.readSlotsByNode;
+  auto& pools = compileState.audioBufferPools;
+
+  auto getOwnerSlot = [&](size_t slot) {
+    return pendingBuffers[slot].inPlaceOwnerSlot.value_or(slot);
+  };
+
+  // The readers of a buffer shared by in-place outputs are the readers of
+  // every slot in it. Each in-place node also reads its own input, so it is
+  // already counted as a reader of the slot before it.
+  readerNodeIndicesBySlot.resize(slotCount);
+
+  for (size_t slot = 0; slot < slotCount; ++slot) {
+    auto& readerNodeIndices = readerNodeIndicesBySlot[getOwnerSlot(slot)];
+    readerNodeIndices.insert(readerNodeIndices.end(),
+        pendingBuffers[slot].readerNodeIndices.begin(),
+        pendingBuffers[slot].readerNodeIndices.end());
+
+    if (!pendingBuffers[slot].inPlaceOwnerSlot.has_value()) {
+      writtenSlotsByNode[pendingBuffers[slot].writerNodeIndex].push_back(slot);
+    }
+  }
+
+  for (size_t slot = 0; slot < slotCount; ++slot) {
+    auto& readerNodeIndices = readerNodeIndicesBySlot[slot];
+
+    // A node may read the same buffer through more than one port.
+    std::sort(readerNodeIndices.begin(), readerNodeIndices.end());
+    readerNodeIndices.erase(
+        std::unique(readerNodeIndices.begin(), readerNodeIndices.end()), readerNodeIndices.end());
+
+    for (auto readerNodeIndex : readerNodeIndices) {
+      readSlotsByNode[readerNodeIndex].push_back(slot);
+    }
+  }
+
+  bufferIndicesBySlot.assign(slotCount, 0);
+  isReusedBySlot.assign(slotCount, false);
+  size_t allocatedBufferCount = 0;
+
+  for (auto* runtimeNode : runtimeGraph.topologicalOrder) {
+    auto& pool = pools[runtimeNode->index];
+
+    for (auto slot : writtenSlotsByNode[runtimeNode->index]) {
+      if (pool.freeBufferIndices.empty()) {
+        bufferIndicesBySlot[slot] = graphProcessContext.allocateAudioBuffer();
+        ++allocatedBufferCount;
+      } else {
+        bufferIndicesBySlot[slot] = pool.freeBufferIndices.back();
+        pool.freeBufferIndices.pop_back();
+        isReusedBySlot[slot] = true;
+      }
+    }
+
+    for (auto slot : readSlotsByNode[runtimeNode->index]) {
+      releaseAudioBufferToPool(pool, readerNodeIndicesBySlot, bufferIndicesBySlot, slot, 1);
+    }
+
+    // Nothing reads these, so they are dead as soon as this node finishes.
+    for (auto slot : writtenSlotsByNode[runtimeNode->index]) {
+      if (readerNodeIndicesBySlot[slot].empty()) {
+        releaseAudioBufferToPool(pool, readerNodeIndicesBySlot, bufferIndicesBySlot, slot, 1);
+      }
+    }
+
+    if (runtimeNode->outgoingConnections.empty()) {
+      pool.clear();
+      continue;
+    }
+
+    auto& nextPool = pools[runtimeNode->outgoingConnections.front()->index];
+
+    if (nextPool.empty()) {
+      // Swapping rather than moving leaves this node's pool with the next
+      // one's storage, so neither gives up its capacity.
+      std::swap(nextPool, pool);
+    } else {
+      nextPool.freeBufferIndices.insert(nextPool.freeBufferIndices.end(),
+          pool.freeBufferIndices.begin(),
+          pool.freeBufferIndices.end());
+
+      for (auto [slot, releasedReaderCount] : pool.pendingReleases) {
+        releaseAudioBufferToPool(
+            nextPool, readerNodeIndicesBySlot, bufferIndicesBySlot, slot, releasedReaderCount);
+      }
+    }
+
+    pool.clear();
+  }
+
+  auto toBufferIndex = [&](size_t slot) {
+    return slot == sharedSilentAudioBufferSlot
+               ? graphProcessContext.getSharedSilentAudioBufferIndex()
+               : bufferIndicesBySlot[getOwnerSlot(slot)];
+  };
+
+  for (auto& bindings : bufferBindingsByNodeIndex) {
+    for (auto& [portId, bufferIndex] : bindings.inputAudioBuffers) {
+      bufferIndex = toBufferIndex(bufferIndex);
+    }
+
+    for (auto& [portId, bufferIndex] : bindings.outputAudioBuffers) {
+      const auto slot = bufferIndex;
+      bufferIndex = toBufferIndex(slot);
+
+      // Before pooling, a node that never writes its outputs, such as one
+      // with no processor, left them silent. A reused buffer would instead
+      // pass an earlier node's audio on to this node's readers, so these are
+      // recorded for rt_processNode() to silence. Nothing can hear an output
+      // with no readers.
+      if (isReusedBySlot[slot] && !readerNodeIndicesBySlot[slot].empty()) {
+        bindings.rt_reusedOutputAudioBuffers.push_back(bufferIndex);
+      }
+    }
+  }
+
+  for (auto& nodeTransferActions : compileState.transferActions) {
+    for (auto& action : nodeTransferActions) {
+      if (action.dataType != RuntimeConnectionDataType::audio) {
+        continue;
+      }
+
+      action.destinationBufferIndex = toBufferIndex(action.destinationBufferIndex);
+
+      for (auto& sourceBufferIndex : action.sourceBufferIndices) {
+        sourceBufferIndex = toBufferIndex(sourceBufferIndex);
+      }
+    }
+  }
+
+  runtimeGraph.unpooledAudioBufferCount =
+      graphProcessContext.getAudioBufferCount() - allocatedBufferCount + slotCount;
+}
+
+// Moves the graph's audio and control buffers into one arena, laid out in
+// the order nodes are processed, so the buffers each node touches sit
+// together and a chain's buffers follow one another.
+void packBuffersInScheduleOrder(
+    RuntimeGraph& runtimeGraph, BufferBindingsByNodeIndex& bufferBindingsByNodeIndex) {
+  jassert(runtimeGraph.graphProcessContext != nullptr);
+
+  std::vector<GraphProcessContext::BufferReference> bufferOrder;
+
+  for (auto* runtimeNode : runtimeGraph.topologicalOrder) {
+    auto& bindings = bufferBindingsByNodeIndex[runtimeNode->index];
+
+    for (auto [portId, bufferIndex] : bindings.inputAudioBuffers) {
+      bufferOrder.emplace_back(NodePortDataType::audio, bufferIndex);
+    }
+
+    for (auto [portId, bufferIndex] : bindings.inputControlBuffers) {
+      bufferOrder.emplace_back(NodePortDataType::control, bufferIndex);
+    }
+
+    for (auto [portId, bufferIndex] : bindings.outputAudioBuffers) {
+      bufferOrder.emplace_back(NodePortDataType::audio, bufferIndex);
+    }
+
+    for (auto [portId, bufferIndex] : bindings.outputControlBuffers) {
+      bufferOrder.emplace_back(NodePortDataType::control, bufferIndex);
+    }
   }
 
-  size_t priority = 1;
+  runtimeGraph.graphProcessContext->packBuffers(bufferOrder);
+}
 
-  for (auto* downstreamNode : node.outgoingConnections) {
-    priority += getAndSetPriority(*downstreamNode);
+// Pairs each node with the node for the same model node in the previous
+// graph, if there is one. The model node object is replaced whenever the node
+// itself is replaced, so an identical pointer means the processor and its
+// state carry over too. Each pair's parameters and event buffers are matched
+// up here too, so the audio thread doesn't have to search for them during the
+// swap.
+void pairWithPreviousGraph(RuntimeGraph& runtimeGraph, const RuntimeGraph& previousGraph) {
+  runtimeGraph.compiledFromGraph = &previousGraph;
+  runtimeGraph.nodeStateTransfers.reserve(runtimeGraph.nodes.size());
+
+  auto& parameterStorage = runtimeGraph.parameterStateTransferStorage;
+  auto& eventBufferStorage = runtimeGraph.eventBufferStateTransferStorage;
+
+  // Where each transfer's entries are in the storage above. The spans are
+  // filled in once the storage has stopped growing.
+  struct StorageRange {
+    size_t parameterStart = 0;
+    size_t parameterEnd = 0;
+    size_t eventBufferStart = 0;
+    size_t eventBufferEnd = 0;
+  };
+
+  std::vector<StorageRange> storageRanges;
+  storageRanges.reserve(runtimeGraph.nodes.size());
+
+  for (auto& runtimeNode : runtimeGraph.nodes) {
+    auto previousNodeIndexIter = previousGraph.nodeIndicesById.find(runtimeNode.id);
+    if (previousNodeIndexIter == previousGraph.nodeIndicesById.end()) {
+      continue;
+    }
+
+    const auto& previousNode = previousGraph.nodes[previousNodeIndexIter->second];
+    if (previousNode.sourceNode != runtimeNode.sourceNode) {
+      continue;
+    }
+
+    StorageRange storageRange{
+        .parameterStart = parameterStorage.size(),
+        .eventBufferStart = eventBufferStorage.size(),
+    };
+
+    if (runtimeNode.nodeProcessContext != nullptr && previousNode.nodeProcessContext != nullptr) {
+      runtimeNode.nodeProcessContext->findStateTransfersFrom(
+          *previousNode.nodeProcessContext, parameterStorage, eventBufferStorage);
+    }
+
+    storageRange.parameterEnd = parameterStorage.size();
+    storageRange.eventBufferEnd = eventBufferStorage.size();
+    storageRanges.push_back(storageRange);
+
+    runtimeGraph.nodeStateTransfers.push_back(RuntimeGraph::NodeStateTransfer{
+        .nodeIndex = runtimeNode.index,
+        .previousNodeIndex = previousNode.index,
+    });
   }
 
-  node.priority = priority;
-  return priority;
+  for (size_t transferIndex = 0; transferIndex < runtimeGraph.nodeStateTransfers.size();
+       ++transferIndex) {
+    auto& transfer = runtimeGraph.nodeStateTransfers[transferIndex];
+    const auto& storageRange = storageRanges[transferIndex];
+
+    transfer.parameters = std::span<const NodeProcessContext::ParameterStateTransfer>(
+        parameterStorage.data() + storageRange.parameterStart,
+        storageRange.parameterEnd - storageRange.parameterStart);
+    transfer.eventBuffers = std::span<const NodeProcessContext::EventBufferStateTransfer>(
+        eventBufferStorage.data() + storageRange.eventBufferStart,
+        storageRange.eventBufferEnd - storageRange.eventBufferStart);
+  }
 }
 
 } // namespace
 
 std::unique_ptr<RuntimeGraph> RuntimeGraph::fromProcessingGraph(
     ProcessingGraphModel& processingGraph,
+    GraphRuntimeServices& rtServices,
+    const GraphBufferLayout& bufferLayout,
+    double sampleRate,
+    const RuntimeGraph* previousGraph) {
+  auto runtimeGraph = compile(processingGraph, rtServices, bufferLayout, sampleRate);
+  runtimeGraph->attachToModel(previousGraph);
+  return runtimeGraph;
+}
+
+std::unique_ptr<RuntimeGraph> RuntimeGraph::compile(ProcessingGraphModel& processingGraph,
     GraphRuntimeServices& rtServices,
     const GraphBufferLayout& bufferLayout,
     double sampleRate) {
@@ -608,6 +1282,7 @@ std::unique_ptr<RuntimeGraph> RuntimeGraph::fromProcessingGraph(
   runtimeGraph.graphProcessContext =
       std::make_unique<GraphProcessContext>(rtServices, bufferLayout);
   runtimeGraph.nodes.reserve(graphNodes.size());
+  runtimeGraph.nodeIndicesById.reserve(graphNodes.size());
 
   for (auto& [nodeId, graphNode] : graphNodes) {
     if (graphNode == nullptr) {
@@ -619,46 +1294,56 @@ std::unique_ptr<RuntimeGraph> RuntimeGraph::fromProcessingGraph(
           "Processing graph node map key does not match node ID: " + std::to_string(nodeId));
     }
 
-    runtimeGraph.nodes.emplace(nodeId, RuntimeNode(nodeId, graphNode));
+    auto& runtimeNode = runtimeGraph.nodes.emplace_back(nodeId, graphNode);
+    runtimeNode.index = runtimeGraph.nodes.size() - 1;
+    runtimeGraph.nodeIndicesById.emplace(nodeId, runtimeNode.index);
   }
 
-  reserveRuntimeGraphStorage(runtimeGraph, graphNodes);
-  auto bufferBindingsByNodeId =
-      createBufferBindingsAndConnections(runtimeGraph, graphNodes, graphConnections);
-  createNodeProcessContexts(runtimeGraph, bufferBindingsByNodeId);
+  // Compiles on the same thread reuse the scratch storage from the last one.
+  thread_local RuntimeGraphCompileState compileState;
+  compileState.reset(runtimeGraph.nodes.size());
+
+  reserveRuntimeGraphStorage(runtimeGraph, compileState);
+  auto bufferBindingsByNodeIndex =
+      createBufferBindingsAndConnections(runtimeGraph, compileState, graphConnections);
+  packRuntimeGraphEdges(runtimeGraph, compileState);
 
-  for (auto& [_, runtimeNode] : runtimeGraph.nodes) {
+  for (auto& runtimeNode : runtimeGraph.nodes) {
     if (runtimeNode.upstreamNodeCount == 0) {
       runtimeGraph.inputNodes.push_back(&runtimeNode);
     }
   }
 
-  std::unordered_map<RuntimeNode::Id, DfsState> dfsStates;
-  dfsStates.reserve(runtimeGraph.nodes.size());
+  // This throws if the graph has a cycle, so everything after it can assume
+  // that the graph is acyclic.
+  buildTopologicalOrder(runtimeGraph, compileState);
+  calculatePriorities(runtimeGraph);
+  fuseLinearChains(runtimeGraph);
 
-  // We do input nodes first, because in all correctly-formed graphs, this will
-  // cover all nodes
-  for (auto* inputNode : runtimeGraph.inputNodes) {
-    assertAcyclicFromNode(*inputNode, dfsStates);
-  }
+  // Buffers can only be pooled and laid out once the order nodes run in is
+  // known, so contexts and transfer actions are created last.
+  aliasInPlaceAudioPorts(runtimeGraph, compileState, bufferBindingsByNodeIndex);
+  assignPooledAudioBuffers(runtimeGraph, compileState, bufferBindingsByNodeIndex);
+  packBuffersInScheduleOrder(runtimeGraph, bufferBindingsByNodeIndex);
+  packTransferActions(runtimeGraph, compileState);
+  createNodeProcessContexts(runtimeGraph, bufferBindingsByNodeIndex);
 
-  // A graph that is entirely cyclic has no input nodes, so input-rooted DFS is
-  // not sufficient on its own.
-  for (auto& [_, runtimeNode] : runtimeGraph.nodes) {
-    assertAcyclicFromNode(runtimeNode, dfsStates);
-  }
+  return runtimeGraphStorage;
+}
 
-  for (auto* inputNode : runtimeGraph.inputNodes) {
-    getAndSetPriority(*inputNode);
+void RuntimeGraph::attachToModel(
+    const RuntimeGraph* previousGraph, const ProcessingGraphSnapshot::ModelNodeMap* modelNodes) {
+  // Pairing compares model nodes, so the graph must be on the model nodes
+  // before it is paired.
+  if (modelNodes != nullptr) {
+    moveToModelNodes(*this, *modelNodes);
   }
 
-  for (auto& [_, runtimeNode] : runtimeGraph.nodes) {
-    getAndSetPriority(runtimeNode);
+  if (previousGraph != nullptr) {
+    pairWithPreviousGraph(*this, *previousGraph);
   }
 
-  publishRuntimeContexts(runtimeGraph);
-
-  return runtimeGraphStorage;
+  publishRuntimeContexts(*this);
 }
 
 RuntimeGraph::RuntimeGraph() : RuntimeGraph(0) {}
@@ -675,7 +1360,7 @@ void RuntimeGraph::cleanup() {
     return;
   }
 
-  for (auto& [_, runtimeNode] : nodes) {
+  for (auto& runtimeNode : nodes) {
     if (runtimeNode.sourceNode == nullptr || !runtimeNode.sourceNode->runtimeContext.has_value()) {
       continue;
     }
@@ -692,6 +1377,103 @@ void RuntimeGraph::cleanup() {
   hasCleanedUp = true;
 }
 
+bool RuntimeGraph::stageMeasuredCostPriorities() {
+  // The audio thread may still be reading stagedPriority.
+  if (rt_hasStagedPriorities.load(std::memory_order_acquire)) {
+    return false;
+  }
+
+  bool hasMeasuredCost = false;
+
+  for (auto nodeIter = topologicalOrder.rbegin(); nodeIter != topologicalOrder.rend();
+       ++nodeIter) {
+    auto& runtimeNode = **nodeIter;
+    const auto averageProcessNanoseconds =
+        runtimeNode.rt_state.rt_averageProcessNanoseconds.load(std::memory_order_relaxed);
+    hasMeasuredCost = hasMeasuredCost || averageProcessNanoseconds > 0.0f;
+
+    // Every node costs at least 1, so that among otherwise free nodes, longer
+    // chains still come first.
+    const auto cost =
+        std::max<size_t>(1, static_cast<size_t>(std::llround(averageProcessNanoseconds)));
+
+    size_t longestDownstreamPath = 0;
+
+    for (auto* downstreamNode : runtimeNode.outgoingConnections) {
+      longestDownstreamPath = std::max(longestDownstreamPath, downstreamNode->stagedPriority);
+    }
+
+    runtimeNode.stagedPriority = cost + longestDownstreamPath;
+  }
+
+  if (!hasMeasuredCost) {
+    return false;
+  }
+
+  rt_hasStagedPriorities.store(true, std::memory_order_release);
+  return true;
+}
+
+RuntimeNode& RuntimeGraph::getNode(RuntimeNode::Id id) {
+  return nodes[nodeIndicesById.at(id)];
+}
+
+RuntimeNode* RuntimeGraph::findNode(RuntimeNode::Id id) {
+  auto nodeIndexIter = nodeIndicesById.find(id);
+  if (nodeIndexIter == nodeIndicesById.end()) {
+    return nullptr;
+  }
+
+  return &nodes[nodeIndexIter->second];
+}
+
+void RuntimeGraph::rt_resetRemainingUpstreamNodeCounts() {
+  static_assert(sizeof(std::atomic<size_t>) == sizeof(size_t));
+  static_assert(std::atomic<size_t>::is_always_lock_free);
+
+  if (nodes.empty()) {
+    return;
+  }
+
+  // No other thread is touching the counters here, so they can be reset with
+  // one copy instead of an atomic store per node.
+  std::memcpy(static_cast<void*>(rt_remainingUpstreamNodeCounts.get()),
+      upstreamNodeCounts.data(),
+      nodes.size() * sizeof(size_t));
+}
+
+void RuntimeGraph::rt_adoptStateFrom(RuntimeGraph& previousGraph) {
+  if (compiledFromGraph != &previousGraph) {
+    return;
+  }
+
+  for (const auto& transfer : nodeStateTransfers) {
+    auto& runtimeNode = nodes[transfer.nodeIndex];
+    auto& previousNode = previousGraph.nodes[transfer.previousNodeIndex];
+
+    runtimeNode.rt_state.rt_averageProcessNanoseconds.store(
+        previousNode.rt_state.rt_averageProcessNanoseconds.load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
+
+    if (runtimeNode.nodeProcessContext != nullptr && previousNode.nodeProcessContext != nullptr) {
+      runtimeNode.nodeProcessContext->rt_adoptStateFrom(
+          *previousNode.nodeProcessContext, transfer.parameters, transfer.eventBuffers);
+    }
+  }
+}
+
+void RuntimeGraph::rt_applyStagedPriorities() {
+  if (!rt_hasStagedPriorities.load(std::memory_order_acquire)) {
+    return;
+  }
+
+  for (auto* runtimeNode : topologicalOrder) {
+    runtimeNode->priority = runtimeNode->stagedPriority;
+  }
+
+  rt_hasStagedPriorities.store(false, std::memory_order_release);
+}
+
 RuntimeGraph::AvailableTaskQueue RuntimeGraph::createAvailableTaskQueue(size_t nodeCapacity) {
   std::vector<RuntimeNode*> taskStorage;
   taskStorage.reserve(nodeCapacity);
@@ -19,12 +19,15 @@
 
 #pragma once
 
+#include "modules/processing_graph/model/processing_graph_snapshot.h"
 #include "modules/processing_graph/model/runtime_node.h"
 #include "modules/processing_graph/runtime/graph_process_context.h"
 
+#include <atomic>
 #include <cstddef>
 #include <memory>
 #include <queue>
+#include <span>
 #include <unordered_map>
 #include <vector>
 
@@ -53,21 +56,160 @@ public:
   RuntimeGraph(RuntimeGraph&&) = delete;
   RuntimeGraph& operator=(RuntimeGraph&&) = delete;
 
+  // Compiles the processing graph model into a runtime graph, then attaches
+  // it to the model. See compile() and attachToModel().
   static std::unique_ptr<RuntimeGraph> fromProcessingGraph(ProcessingGraphModel& processingGraph,
+      GraphRuntimeServices& rtServices,
+      const GraphBufferLayout& bufferLayout,
+      double sampleRate,
+      const RuntimeGraph* previousGraph = nullptr);
+
+  // Compiles the processing graph model into a runtime graph. This only reads
+  // the model and writes nothing outside the new graph, so it can run on any
+  // thread that owns the model it is given, such as the graph in a
+  // ProcessingGraphSnapshot.
+  //
+  // The result can't be handed to the audio thread until attachToModel() has
+  // been called on it.
+  static std::unique_ptr<RuntimeGraph> compile(ProcessingGraphModel& processingGraph,
       GraphRuntimeServices& rtServices,
       const GraphBufferLayout& bufferLayout,
       double sampleRate);
 
+  // Points each node's context at its model node, so that parameter changes
+  // from the model reach this graph.
+  //
+  // If modelNodes is given, the graph was compiled from a snapshot, and each
+  // node is first moved onto the model node with its ID there, picking up any
+  // parameter values that have changed since.
+  //
+  // If previousGraph is given, it should be the graph that this one will
+  // replace on the audio thread. Nodes whose model node is unchanged are
+  // paired with their counterparts there, along with their parameters and
+  // event buffers, so that rt_adoptStateFrom() can carry their runtime state
+  // across the swap without searching. previousGraph is only read here; it
+  // can keep processing on the audio thread while this runs.
+  //
+  // Must be called from the main thread.
+  void attachToModel(const RuntimeGraph* previousGraph,
+      const ProcessingGraphSnapshot::ModelNodeMap* modelNodes = nullptr);
+
   void cleanup();
 
-  std::unordered_map<RuntimeNode::Id, RuntimeNode> nodes;
+  // Recalculates node priorities from measured processing costs, and stages
+  // them to be picked up by the audio thread at the start of the next block.
+  //
+  // The compile-time priority of a node counts the paths below it, which
+  // can't tell an expensive instrument from a cheap gain node. Once nodes have
+  // been processed a few times, this replaces it with the cost-weighted
+  // longest path from the node to a sink, so the scheduler starts the most
+  // expensive chains first.
+  //
+  // Returns false if nothing was staged, either because no node has been
+  // measured yet or because the audio thread has not applied the previously
+  // staged priorities.
+  //
+  // Must be called from the main thread.
+  bool stageMeasuredCostPriorities();
+
+  // Copies priorities staged by stageMeasuredCostPriorities() into the nodes.
+  //
+  // Must be called on the audio thread before scheduling starts for a block,
+  // while no other thread is reading node priorities.
+  void rt_applyStagedPriorities();
+
+  // Looks up a node by its model ID. These use a hash map, so they are for
+  // graph building and tests, not for real-time threads. getNode() throws
+  // std::out_of_range if there is no such node.
+  RuntimeNode& getNode(RuntimeNode::Id id);
+  RuntimeNode* findNode(RuntimeNode::Id id);
+
+  // Resets every node's remaining upstream counter for a new block.
+  //
+  // Must be called on the audio thread before scheduling starts for a block,
+  // while no other thread is touching the counters.
+  void rt_resetRemainingUpstreamNodeCounts();
+
+  // Carries runtime state over from the graph this one was compiled against,
+  // for every node that is unchanged between them: measured processing costs,
+  // parameter smoother positions and grown event buffers. This only walks the
+  // pairs found by attachToModel(). Does nothing if previousGraph is not the
+  // graph this one was compiled against.
+  //
+  // The rest of this graph, including the contexts and buffers of unchanged
+  // nodes, was compiled in full. Only their state carries over.
+  //
+  // Must be called on the audio thread when swapping from previousGraph to
+  // this graph, before either is processed again. previousGraph is left
+  // unusable for processing afterward.
+  void rt_adoptStateFrom(RuntimeGraph& previousGraph);
+
+  // Every node, indexed by RuntimeNode::index. This is sized once when the
+  // graph is built and never resized afterward, so pointers into it are
+  // stable.
+  std::vector<RuntimeNode> nodes;
+  std::unordered_map<RuntimeNode::Id, size_t> nodeIndicesById;
+
   std::vector<RuntimeNode*> inputNodes;
+
+  // Flat storage behind each node's outgoingConnections, fusedChainNodes and
+  // connectionTransferActions spans. Each node's entries are contiguous.
+  std::vector<RuntimeNode*> downstreamNodeStorage;
+  std::vector<RuntimeNode*> fusedChainNodeStorage;
+  std::vector<RuntimeConnectionTransferAction> transferActionStorage;
+  std::vector<size_t> transferSourceBufferIndexStorage;
+  std::vector<size_t> rt_transferSourceCursorStorage;
+  std::vector<const float*> rt_transferSourcePointerStorage;
+
+  // The upstream node count for each node by index, and the counters that are
+  // reset from it each block.
+  std::vector<size_t> upstreamNodeCounts;
+  std::unique_ptr<std::atomic<size_t>[]> rt_remainingUpstreamNodeCounts;
+
+  // Every node, ordered so that each node comes before all of its downstream
+  // nodes.
+  std::vector<RuntimeNode*> topologicalOrder;
+
+  // The number of nodes the executor schedules per block. Nodes fused into
+  // another node's chain are not counted.
+  size_t taskCount = 0;
+
+  // The number of audio buffers the graph would need if none were reused
+  // between ports. Compare with graphProcessContext->getAudioBufferCount().
+  size_t unpooledAudioBufferCount = 0;
+
+  // A node that is unchanged from the previous graph, with the parameters
+  // and event buffers to carry over from its counterpart there. These are
+  // all matched up by attachToModel(), so the audio thread only has to walk
+  // them.
+  struct NodeStateTransfer {
+    size_t nodeIndex = 0;
+    size_t previousNodeIndex = 0;
+    std::span<const NodeProcessContext::ParameterStateTransfer> parameters;
+    std::span<const NodeProcessContext::EventBufferStateTransfer> eventBuffers;
+  };
+
+  // The graph this one was compiled against, and the nodes that are unchanged
+  // between the two. The pointer is only compared against, never followed,
+  // since the previous graph may have been deleted since. See
+  // rt_adoptStateFrom().
+  const RuntimeGraph* compiledFromGraph = nullptr;
+  std::vector<NodeStateTransfer> nodeStateTransfers;
+
+  // Flat storage behind each NodeStateTransfer's spans.
+  std::vector<NodeProcessContext::ParameterStateTransfer> parameterStateTransferStorage;
+  std::vector<NodeProcessContext::EventBufferStateTransfer> eventBufferStateTransferStorage;
+
   AvailableTaskQueue availableTasks;
   std::unique_ptr<GraphProcessContext> graphProcessContext;
   float sampleRate = 0.0f;
 private:
   bool hasCleanedUp = false;
 
+  // Set by the main thread once stagedPriority has been written for every
+  // node, and cleared by the audio thread once it has copied them.
+  std::atomic<bool> rt_hasStagedPriorities = false;
+
   static AvailableTaskQueue createAvailableTaskQueue(size_t nodeCapacity);
 };
 
@@ -23,15 +23,21 @@
 
 namespace anthem {
 
-RuntimeNodeState::RuntimeNodeState(RuntimeNodeState&& other) noexcept {
-  rt_remainingUpstreamNodes.store(
-      other.rt_remainingUpstreamNodes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+RuntimeNodeState::RuntimeNodeState(RuntimeNodeState&& other) noexcept
+  : rt_remainingUpstreamNodes(other.rt_remainingUpstreamNodes),
+    rt_silentInputSampleCount(other.rt_silentInputSampleCount) {
+  rt_averageProcessNanoseconds.store(
+      other.rt_averageProcessNanoseconds.load(std::memory_order_relaxed),
+      std::memory_order_relaxed);
 }
 
 RuntimeNodeState& RuntimeNodeState::operator=(RuntimeNodeState&& other) noexcept {
   if (this != &other) {
-    rt_remainingUpstreamNodes.store(
-        other.rt_remainingUpstreamNodes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    rt_remainingUpstreamNodes = other.rt_remainingUpstreamNodes;
+    rt_silentInputSampleCount = other.rt_silentInputSampleCount;
+    rt_averageProcessNanoseconds.store(
+        other.rt_averageProcessNanoseconds.load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
   }
 
   return *this;
@@ -41,23 +47,29 @@ RuntimeNode::RuntimeNode(Id id, std::shared_ptr<anthem::Node> sourceNode)
   : id(id), sourceNode(std::move(sourceNode)) {}
 
 RuntimeNode::RuntimeNode(RuntimeNode&& other) noexcept
-  : id(other.id), sourceNode(std::move(other.sourceNode)), priority(other.priority),
+  : id(other.id), index(other.index), sourceNode(std::move(other.sourceNode)),
+    priority(other.priority), stagedPriority(other.stagedPriority),
     upstreamNodeCount(other.upstreamNodeCount), nodeProcessContext(other.nodeProcessContext),
     processor(other.processor), rt_state(std::move(other.rt_state)),
-    connectionTransferActions(std::move(other.connectionTransferActions)),
-    outgoingConnections(std::move(other.outgoingConnections)) {}
+    connectionTransferActions(other.connectionTransferActions),
+    outgoingConnections(other.outgoingConnections), fusedChainNodes(other.fusedChainNodes),
+    isFusedIntoChain(other.isFusedIntoChain) {}
 
 RuntimeNode& RuntimeNode::operator=(RuntimeNode&& other) noexcept {
   if (this != &other) {
     id = other.id;
+    index = other.index;
     sourceNode = std::move(other.sourceNode);
     priority = other.priority;
+    stagedPriority = other.stagedPriority;
     upstreamNodeCount = other.upstreamNodeCount;
     nodeProcessContext = other.nodeProcessContext;
     processor = other.processor;
     rt_state = std::move(other.rt_state);
-    connectionTransferActions = std::move(other.connectionTransferActions);
-    outgoingConnections = std::move(other.outgoingConnections);
+    connectionTransferActions = other.connectionTransferActions;
+    outgoingConnections = other.outgoingConnections;
+    fusedChainNodes = other.fusedChainNodes;
+    isFusedIntoChain = other.isFusedIntoChain;
   }
 
   return *this;
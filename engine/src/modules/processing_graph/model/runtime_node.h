@@ -23,7 +23,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
-#include <vector>
+#include <span>
 
 namespace anthem {
 
@@ -39,10 +39,20 @@ enum class RuntimeConnectionDataType : uint8_t {
 
 struct RuntimeConnectionTransferAction {
   // Precomputed graph-owned buffer indices for a multi-source input. The data
-  // type determines whether sources are summed, copied, or appended.
+  // type determines whether sources are summed, copied, or merged.
   RuntimeConnectionDataType dataType;
   size_t destinationBufferIndex = 0;
-  std::vector<size_t> sourceBufferIndices;
+
+  // Points into RuntimeGraph::transferSourceBufferIndexStorage.
+  std::span<const size_t> sourceBufferIndices;
+
+  // One read position per source, used while merging event sources. Points
+  // into RuntimeGraph::rt_transferSourceCursorStorage.
+  std::span<size_t> rt_sourceCursors;
+
+  // Room for one channel pointer per source, used while summing audio
+  // sources. Points into RuntimeGraph::rt_transferSourcePointerStorage.
+  std::span<const float*> rt_sourceChannelPointers;
 };
 
 struct RuntimeNodeState {
@@ -53,7 +63,21 @@ struct RuntimeNodeState {
   RuntimeNodeState(RuntimeNodeState&& other) noexcept;
   RuntimeNodeState& operator=(RuntimeNodeState&& other) noexcept;
 
-  std::atomic<size_t> rt_remainingUpstreamNodes = 0;
+  // Points at this node's slot in RuntimeGraph::rt_remainingUpstreamNodeCounts.
+  // The counters for the whole graph sit next to each other so they can be
+  // reset together at the start of each block.
+  std::atomic<size_t>* rt_remainingUpstreamNodes = nullptr;
+
+  // Moving average of how long this node takes to process, in nanoseconds.
+  // This is written only by the thread that processes the node, and is read
+  // by the main thread when it recalculates priorities. It is zero until the
+  // node has been processed at least once.
+  std::atomic<float> rt_averageProcessNanoseconds = 0.0f;
+
+  // How many samples in a row this node's inputs have been silent for. Once
+  // this passes the processor's tail length, the node is skipped. This is
+  // only touched by the thread that processes the node.
+  int64_t rt_silentInputSampleCount = 0;
 };
 
 struct RuntimeNode {
@@ -71,6 +95,9 @@ struct RuntimeNode {
   // This matches the ID from the project model's processing graph node.
   Id id;
 
+  // Position of this node in RuntimeGraph::nodes.
+  size_t index = 0;
+
   // Keeps the source graph node alive while this runtime graph is active.
   //
   // Note that this cannot be accessed from real-time threads, since shared_ptr
@@ -80,6 +107,11 @@ struct RuntimeNode {
   // Higher values should be processed first when this node is ready.
   size_t priority = 0;
 
+  // Priority calculated from measured processing costs on the main thread,
+  // waiting to be copied into priority by the audio thread. See
+  // RuntimeGraph::stageMeasuredCostPriorities().
+  size_t stagedPriority = 0;
+
   // Number of unique nodes that must finish before this node can process.
   size_t upstreamNodeCount = 0;
 
@@ -92,12 +124,30 @@ struct RuntimeNode {
   // Mutable state that is reset for each processing block.
   RuntimeNodeState rt_state;
 
+  // The spans below point into flat arrays owned by the RuntimeGraph, so that
+  // walking the graph doesn't chase a separate heap allocation per node.
+
   // Connection-derived buffer operations that must run before this node
   // processes.
-  std::vector<RuntimeConnectionTransferAction> connectionTransferActions;
+  std::span<const RuntimeConnectionTransferAction> connectionTransferActions;
 
   // Non-owning pointers to nodes owned by the RuntimeGraph.
-  std::vector<RuntimeNode*> outgoingConnections;
+  std::span<RuntimeNode* const> outgoingConnections;
+
+  // If this node is the head of a fused chain, these are the nodes that run
+  // straight after it on the same thread, in order. See
+  // RuntimeGraph::fromProcessingGraph().
+  std::span<RuntimeNode* const> fusedChainNodes;
+
+  // True if this node runs as part of another node's fused chain. These nodes
+  // are never scheduled on their own.
+  bool isFusedIntoChain = false;
+
+  // The last node that runs in this node's task. Its outgoing connections are
+  // the ones the task unlocks when it finishes.
+  RuntimeNode& getTaskTail() {
+    return fusedChainNodes.empty() ? *this : *fusedChainNodes.back();
+  }
 };
 
 } // namespace anthem
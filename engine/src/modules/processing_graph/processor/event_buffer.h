@@ -29,6 +29,16 @@
 
 namespace anthem {
 
+// A block's worth of events for one port.
+//
+// Events in a buffer are in sampleOffset order, and processors must write
+// their output events in that order. Events on the same sample are in the
+// order they should take effect.
+//
+// Fan-in connections merge their sources so that this still holds. Events
+// on the same sample from different sources are ordered by EventType, so
+// that for example a NoteOff comes before a NoteOn. This means a processor
+// can read its inputs in a single pass.
 class EventBuffer {
 private:
   JUCE_LEAK_DETECTOR(EventBuffer)
@@ -89,15 +99,20 @@ private:
   }
 
   bool grow() {
-    if (capacity >= static_cast<size_t>(MAX_EVENT_BUFFER_SIZE)) {
-      return false;
-    }
-
     size_t newCapacity = capacity * 2;
     if (newCapacity <= capacity) {
       newCapacity = static_cast<size_t>(MAX_EVENT_BUFFER_SIZE);
     }
 
+    return growTo(newCapacity);
+  }
+
+  bool growTo(size_t requestedCapacity) {
+    if (capacity >= static_cast<size_t>(MAX_EVENT_BUFFER_SIZE)) {
+      return false;
+    }
+
+    auto newCapacity = requestedCapacity;
     if (newCapacity > static_cast<size_t>(MAX_EVENT_BUFFER_SIZE)) {
       newCapacity = static_cast<size_t>(MAX_EVENT_BUFFER_SIZE);
     }
@@ -163,6 +178,15 @@ public:
     return true;
   }
 
+  // Grows the buffer, if needed, so that it can hold at least
+  // minimumCapacity events without growing again. The capacity is still
+  // limited to MAX_EVENT_BUFFER_SIZE.
+  void reserve(size_t minimumCapacity) {
+    if (minimumCapacity > capacity) {
+      growTo(minimumCapacity);
+    }
+  }
+
   void clear() {
     numEvents = 0;
     overflowedThisBlock = false;
@@ -196,6 +220,27 @@ public:
   size_t getTimesGrown() const {
     return timesGrown;
   }
+
+  // Returns true if a should come before b when merging events from
+  // different buffers.
+  static bool comesBefore(const LiveEvent& a, const LiveEvent& b) {
+    if (a.sampleOffset != b.sampleOffset) {
+      return a.sampleOffset < b.sampleOffset;
+    }
+
+    return a.event.type < b.event.type;
+  }
+
+  // Returns true if the events are in sampleOffset order.
+  bool isSorted() const {
+    for (size_t i = 1; i < numEvents; i++) {
+      if (buffer[i].sampleOffset < buffer[i - 1].sampleOffset) {
+        return false;
+      }
+    }
+
+    return true;
+  }
 };
 
 } // namespace anthem
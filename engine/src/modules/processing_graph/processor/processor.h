@@ -19,9 +19,11 @@
 
 #pragma once
 
+#include <cstdint>
 #include <juce_core/juce_core.h>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace anthem {
 
@@ -56,6 +58,43 @@ public:
   // control data. It is called once per processing block.
   virtual void process(NodeProcessContext& context, int numSamples) = 0;
 
+  // Returned by getTailLengthSamples() for processors that must run every
+  // block.
+  static constexpr int64_t infiniteTailLength = -1;
+
+  // The number of samples this processor can keep producing output for after
+  // its audio and event inputs go silent, for example the decay of a reverb.
+  //
+  // Once the inputs have been silent for longer than this, the processing
+  // graph stops calling process() and holds the outputs at silence until an
+  // input becomes audible again. Control inputs are not considered.
+  //
+  // The default is infiniteTailLength, which is correct for anything that
+  // generates output on its own or has side effects, such as a sequencer or
+  // a meter. This is called on the audio thread before each block.
+  virtual int64_t getTailLengthSamples() const {
+    return infiniteTailLength;
+  }
+
+  // An audio input port and audio output port that process() can work on in
+  // a single shared buffer.
+  struct InPlaceAudioPortPair {
+    int64_t inputPortId;
+    int64_t outputPortId;
+  };
+
+  // The audio port pairs this processor can process in place. For each pair,
+  // process() must read each sample of the input before writing the same
+  // sample of the output, and must not read any sample after writing it.
+  //
+  // When the input in a pair has exactly one source and nothing else reads
+  // that source, the processing graph binds the output to the input's buffer
+  // instead of giving it a buffer of its own. This is called on the main
+  // thread when the graph is compiled.
+  virtual std::vector<InPlaceAudioPortPair> getInPlaceAudioPortPairs() const {
+    return {};
+  }
+
   // Gets the state of the processor
   virtual void getState(juce::MemoryBlock& /*target*/) {}
 
@@ -0,0 +1,64 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+namespace anthem {
+
+// Describes the samples in a control buffer for the current block, so that
+// readers can skip per-sample work for controls that are not moving.
+//
+// The samples are always written as well, so a reader can ignore the shape
+// and read them directly.
+struct ControlBufferShape {
+  enum class Kind : uint8_t {
+    // Nothing is known about the samples.
+    arbitrary,
+
+    // Every sample is startValue.
+    constant,
+
+    // Sample i is startValue + i * increment, to within rounding.
+    linearRamp,
+  };
+
+  Kind kind = Kind::arbitrary;
+  float startValue = 0.0f;
+  float increment = 0.0f;
+
+  static ControlBufferShape constant(float value) {
+    return ControlBufferShape{.kind = Kind::constant, .startValue = value};
+  }
+
+  static ControlBufferShape linearRamp(float startValue, float increment) {
+    return ControlBufferShape{
+        .kind = Kind::linearRamp,
+        .startValue = startValue,
+        .increment = increment,
+    };
+  }
+
+  bool isConstant() const {
+    return kind == Kind::constant;
+  }
+};
+
+} // namespace anthem
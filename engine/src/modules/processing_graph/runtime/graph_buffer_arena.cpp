@@ -0,0 +1,50 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "graph_buffer_arena.h"
+
+#include <new>
+
+namespace anthem {
+
+GraphBufferArena::GraphBufferArena(size_t capacitySamples) : capacity(capacitySamples) {
+  if (capacity == 0) {
+    return;
+  }
+
+  samples.reset(static_cast<float*>(
+      ::operator new(capacity * sizeof(float), std::align_val_t{alignmentBytes})));
+}
+
+float* GraphBufferArena::allocate(size_t sampleCount) {
+  if (sampleCount > getRemainingCapacity()) {
+    return nullptr;
+  }
+
+  auto* slice = samples.get() + used;
+  used += sampleCount;
+
+  return slice;
+}
+
+void GraphBufferArena::AlignedDeleter::operator()(float* samples) const {
+  ::operator delete(samples, std::align_val_t{alignmentBytes});
+}
+
+} // namespace anthem
@@ -0,0 +1,77 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+namespace anthem {
+
+// A single block of sample memory that graph-owned audio and control buffers
+// refer into. The block starts on a 64-byte boundary, and every channel
+// handed out is padded to a multiple of 64 bytes, so every channel starts on
+// a cache line and can be read with aligned SIMD loads.
+//
+// Slices are handed out front to back and are never moved or freed
+// individually. The memory is freed with the arena.
+class GraphBufferArena {
+public:
+  static constexpr size_t alignmentBytes = 64;
+
+  // The number of samples a channel of numSamples takes up in the arena,
+  // including padding.
+  static constexpr size_t getPaddedChannelSize(int numSamples) {
+    constexpr auto samplesPerAlignment = alignmentBytes / sizeof(float);
+    const auto sampleCount = static_cast<size_t>(numSamples);
+
+    return (sampleCount + samplesPerAlignment - 1) / samplesPerAlignment * samplesPerAlignment;
+  }
+
+  explicit GraphBufferArena(size_t capacitySamples);
+
+  GraphBufferArena(const GraphBufferArena&) = delete;
+  GraphBufferArena& operator=(const GraphBufferArena&) = delete;
+
+  GraphBufferArena(GraphBufferArena&&) noexcept = default;
+  GraphBufferArena& operator=(GraphBufferArena&&) noexcept = default;
+
+  // Returns the next sampleCount samples, or nullptr if there isn't room.
+  // sampleCount should come from getPaddedChannelSize() to keep the next
+  // slice aligned.
+  float* allocate(size_t sampleCount);
+
+  size_t getCapacity() const {
+    return capacity;
+  }
+
+  size_t getRemainingCapacity() const {
+    return capacity - used;
+  }
+private:
+  struct AlignedDeleter {
+    void operator()(float* samples) const;
+  };
+
+  std::unique_ptr<float[], AlignedDeleter> samples;
+  size_t capacity = 0;
+  size_t used = 0;
+};
+
+} // namespace anthem
@@ -0,0 +1,85 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "graph_parameter_bank.h"
+
+#include <algorithm>
+
+namespace anthem {
+
+void GraphParameterBank::reserve(size_t count) {
+  if (count > capacity) {
+    grow(count);
+  }
+}
+
+size_t GraphParameterBank::add(float initialValue) {
+  if (parameterCount == capacity) {
+    grow(std::max<size_t>(bitsPerWord, capacity * 2));
+  }
+
+  values[parameterCount].store(initialValue, std::memory_order_relaxed);
+  return parameterCount++;
+}
+
+float GraphParameterBank::getValue(size_t index) const {
+  jassert(index < parameterCount);
+  return values[index].load(std::memory_order_relaxed);
+}
+
+void GraphParameterBank::setValue(size_t index, float value) {
+  jassert(index < parameterCount);
+
+  // The release pairs with the acquire in rt_takeChanges(), so the audio
+  // thread sees this value once it sees the flag.
+  values[index].store(value, std::memory_order_relaxed);
+  dirtyWords[index / bitsPerWord].fetch_or(
+      uint64_t{1} << (index % bitsPerWord), std::memory_order_release);
+}
+
+void GraphParameterBank::setValueWithoutNotifying(size_t index, float value) {
+  jassert(index < parameterCount);
+  values[index].store(value, std::memory_order_relaxed);
+}
+
+void GraphParameterBank::grow(size_t newCapacity) {
+  // Nothing else can be using the bank while it is being built, so the
+  // values can be copied over without any synchronization.
+  auto newValues = std::make_unique<std::atomic<float>[]>(newCapacity);
+  const auto wordCount = (newCapacity + bitsPerWord - 1) / bitsPerWord;
+  auto newDirtyWords = std::make_unique<std::atomic<uint64_t>[]>(wordCount);
+
+  for (size_t index = 0; index < parameterCount; ++index) {
+    newValues[index].store(
+        values[index].load(std::memory_order_relaxed), std::memory_order_relaxed);
+  }
+
+  const auto previousWordCount = (capacity + bitsPerWord - 1) / bitsPerWord;
+
+  for (size_t wordIndex = 0; wordIndex < previousWordCount; ++wordIndex) {
+    newDirtyWords[wordIndex].store(
+        dirtyWords[wordIndex].load(std::memory_order_relaxed), std::memory_order_relaxed);
+  }
+
+  values = std::move(newValues);
+  dirtyWords = std::move(newDirtyWords);
+  capacity = newCapacity;
+}
+
+} // namespace anthem
@@ -0,0 +1,111 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <juce_core/juce_core.h>
+#include <memory>
+
+namespace anthem {
+
+// Holds the current value of every parameter in a compiled graph in one
+// contiguous array, with a dirty flag per parameter.
+//
+// The message thread writes values through setValue(), which also raises the
+// parameter's flag. Each block, the audio thread takes the flags for a node's
+// parameters with rt_takeChanges() and only looks at the values that changed.
+// A node's parameters are added together, so its flags usually share one
+// word.
+class GraphParameterBank {
+public:
+  GraphParameterBank() = default;
+
+  GraphParameterBank(const GraphParameterBank&) = delete;
+  GraphParameterBank& operator=(const GraphParameterBank&) = delete;
+
+  // Compile time only. Makes room for at least count parameters.
+  void reserve(size_t count);
+
+  // Compile time only. Adds a parameter and returns its index. New
+  // parameters start out clean.
+  size_t add(float initialValue);
+
+  size_t size() const {
+    return parameterCount;
+  }
+
+  // Any thread.
+  float getValue(size_t index) const;
+
+  // Any thread. Sets the value and marks the parameter as changed.
+  void setValue(size_t index, float value);
+
+  // Sets the value without marking the parameter as changed. For use before
+  // the graph is handed to the audio thread.
+  void setValueWithoutNotifying(size_t index, float value);
+
+  // Audio thread only. Clears the changed flags of the parameters in
+  // [firstIndex, firstIndex + count), and calls onChange(index) for each one
+  // that was set.
+  template <typename Callback>
+  void rt_takeChanges(size_t firstIndex, size_t count, Callback&& onChange) {
+    const auto endIndex = firstIndex + count;
+    jassert(endIndex <= parameterCount);
+
+    for (auto index = firstIndex; index < endIndex;) {
+      const auto wordIndex = index / bitsPerWord;
+      const auto firstBit = index % bitsPerWord;
+      const auto bitCount = std::min(bitsPerWord - firstBit, endIndex - index);
+      const auto mask = (bitCount == bitsPerWord ? ~uint64_t{0}
+                                                 : ((uint64_t{1} << bitCount) - 1)) << firstBit;
+
+      auto& word = dirtyWords[wordIndex];
+
+      // Most blocks change nothing, so the word is only written if one of
+      // these flags is set.
+      if ((word.load(std::memory_order_relaxed) & mask) != 0) {
+        auto changedBits = word.fetch_and(~mask, std::memory_order_acquire) & mask;
+
+        while (changedBits != 0) {
+          const auto bit = static_cast<size_t>(std::countr_zero(changedBits));
+          onChange(wordIndex * bitsPerWord + bit);
+          changedBits &= changedBits - 1;
+        }
+      }
+
+      index += bitCount;
+    }
+  }
+private:
+  static constexpr size_t bitsPerWord = 64;
+
+  void grow(size_t newCapacity);
+
+  std::unique_ptr<std::atomic<float>[]> values;
+  std::unique_ptr<std::atomic<uint64_t>[]> dirtyWords;
+  size_t parameterCount = 0;
+  size_t capacity = 0;
+};
+
+} // namespace anthem
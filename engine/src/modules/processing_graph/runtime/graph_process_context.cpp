@@ -24,6 +24,8 @@
 #include "modules/processing_graph/runtime/graph_runtime_services.h"
 #include "modules/processing_graph/runtime/node_process_context.h"
 
+#include <algorithm>
+
 namespace anthem {
 
 GraphProcessContext::GraphProcessContext(
@@ -42,16 +44,57 @@ void GraphProcessContext::reserve(size_t nodeProcessContextCount,
   nodeProcessContexts.reserve(nodeProcessContextCount);
   audioBuffers.reserve(audioBufferCount);
   controlBuffers.reserve(controlBufferCount);
+  controlBufferShapes.reserve(controlBufferCount);
   eventBuffers.reserve(eventBufferCount);
+
+  const auto channelSize = GraphBufferArena::getPaddedChannelSize(blockSize);
+  const auto sampleCount =
+      (audioBufferCount * static_cast<size_t>(numAudioChannels) + controlBufferCount) *
+      channelSize;
+
+  if (sampleCount > 0 && sampleArenas.empty()) {
+    sampleArenas.emplace_back(sampleCount);
+  }
+}
+
+float* GraphProcessContext::allocateSamples(size_t sampleCount) {
+  if (sampleArenas.empty() || sampleArenas.back().getRemainingCapacity() < sampleCount) {
+    // Grow geometrically, so that allocating buffers one at a time without
+    // reserving doesn't mean one arena per buffer.
+    const auto previousCapacity = sampleArenas.empty() ? 0 : sampleArenas.back().getCapacity();
+    sampleArenas.emplace_back(std::max(sampleCount, previousCapacity * 2));
+  }
+
+  return sampleArenas.back().allocate(sampleCount);
+}
+
+void GraphProcessContext::referToSamples(
+    juce::AudioSampleBuffer& buffer, float* samples, int numChannels) {
+  const auto channelSize = GraphBufferArena::getPaddedChannelSize(blockSize);
+  std::vector<float*> channels(static_cast<size_t>(numChannels));
+
+  for (size_t channel = 0; channel < channels.size(); ++channel) {
+    channels[channel] = samples + channel * channelSize;
+  }
+
+  buffer.setDataToReferTo(channels.data(), numChannels, blockSize);
 }
 
 size_t GraphProcessContext::allocateAudioBuffer() {
-  audioBuffers.emplace_back(numAudioChannels, blockSize);
+  auto& buffer = audioBuffers.emplace_back();
+  referToSamples(buffer,
+      allocateSamples(static_cast<size_t>(numAudioChannels) *
+                      GraphBufferArena::getPaddedChannelSize(blockSize)),
+      numAudioChannels);
+
   return audioBuffers.size() - 1;
 }
 
 size_t GraphProcessContext::allocateControlBuffer() {
-  controlBuffers.emplace_back(1, blockSize);
+  auto& buffer = controlBuffers.emplace_back();
+  referToSamples(buffer, allocateSamples(GraphBufferArena::getPaddedChannelSize(blockSize)), 1);
+  controlBufferShapes.emplace_back();
+
   return controlBuffers.size() - 1;
 }
 
@@ -84,6 +127,69 @@ size_t GraphProcessContext::getSharedEmptyEventBufferIndex() {
   return bufferIndex;
 }
 
+size_t GraphProcessContext::getAudioBufferCount() const {
+  return audioBuffers.size();
+}
+
+void GraphProcessContext::packBuffers(std::span<const BufferReference> bufferOrder) {
+  const auto channelSize = GraphBufferArena::getPaddedChannelSize(blockSize);
+  GraphBufferArena packedArena(
+      (audioBuffers.size() * static_cast<size_t>(numAudioChannels) + controlBuffers.size()) *
+      channelSize);
+
+  std::vector<bool> isAudioBufferPacked(audioBuffers.size(), false);
+  std::vector<bool> isControlBufferPacked(controlBuffers.size(), false);
+
+  auto packBuffer = [&](juce::AudioSampleBuffer& buffer) {
+    const auto numChannels = buffer.getNumChannels();
+    const auto wasCleared = buffer.hasBeenCleared();
+    auto* samples = packedArena.allocate(static_cast<size_t>(numChannels) * channelSize);
+    jassert(samples != nullptr);
+
+    for (int channel = 0; channel < numChannels; ++channel) {
+      std::copy_n(buffer.getReadPointer(channel),
+          blockSize,
+          samples + static_cast<size_t>(channel) * channelSize);
+    }
+
+    referToSamples(buffer, samples, numChannels);
+
+    // Pointing the buffer at new samples resets its silence flag.
+    if (wasCleared) {
+      buffer.clear();
+    }
+  };
+
+  for (auto [dataType, index] : bufferOrder) {
+    if (dataType == NodePortDataType::audio && index < audioBuffers.size() &&
+        !isAudioBufferPacked[index]) {
+      packBuffer(audioBuffers[index]);
+      isAudioBufferPacked[index] = true;
+    } else if (dataType == NodePortDataType::control && index < controlBuffers.size() &&
+               !isControlBufferPacked[index]) {
+      packBuffer(controlBuffers[index]);
+      isControlBufferPacked[index] = true;
+    }
+  }
+
+  for (size_t index = 0; index < audioBuffers.size(); ++index) {
+    if (!isAudioBufferPacked[index]) {
+      packBuffer(audioBuffers[index]);
+    }
+  }
+
+  for (size_t index = 0; index < controlBuffers.size(); ++index) {
+    if (!isControlBufferPacked[index]) {
+      packBuffer(controlBuffers[index]);
+    }
+  }
+
+  jassert(packedArena.getRemainingCapacity() == 0);
+
+  sampleArenas.clear();
+  sampleArenas.push_back(std::move(packedArena));
+}
+
 NodeProcessContext& GraphProcessContext::createNodeProcessContext(
     std::shared_ptr<Node>& graphNode, NodeProcessContext::BufferBindings bufferBindings) {
   auto context = std::make_unique<NodeProcessContext>(graphNode, *this, std::move(bufferBindings));
@@ -103,11 +209,25 @@ juce::AudioSampleBuffer& GraphProcessContext::getControlBuffer(size_t index) {
   return controlBuffers[index];
 }
 
+ControlBufferShape& GraphProcessContext::rt_getControlBufferShape(size_t index) {
+  jassert(index < controlBufferShapes.size());
+  return controlBufferShapes[index];
+}
+
 std::unique_ptr<EventBuffer>& GraphProcessContext::getEventBuffer(size_t index) {
   jassert(index < eventBuffers.size());
   return eventBuffers[index];
 }
 
+bool GraphProcessContext::rt_isAudioBufferSilent(size_t index) {
+  return getAudioBuffer(index).hasBeenCleared();
+}
+
+void GraphProcessContext::rt_silenceAudioBuffer(size_t index) {
+  // This is a no-op if the buffer is already silent.
+  getAudioBuffer(index).clear();
+}
+
 LiveNoteId GraphProcessContext::rt_allocateLiveNoteId() {
   jassert(rt_services != nullptr);
   if (rt_services == nullptr) {
@@ -20,6 +20,9 @@
 #pragma once
 
 #include "modules/processing_graph/processor/event_buffer.h"
+#include "modules/processing_graph/runtime/control_buffer_shape.h"
+#include "modules/processing_graph/runtime/graph_buffer_arena.h"
+#include "modules/processing_graph/runtime/graph_parameter_bank.h"
 #include "modules/processing_graph/runtime/node_process_context.h"
 #include "modules/sequencer/events/note_instance_id.h"
 
@@ -28,6 +31,8 @@
 #include <juce_core/juce_core.h>
 #include <memory>
 #include <optional>
+#include <span>
+#include <utility>
 #include <vector>
 
 namespace anthem {
@@ -58,16 +63,30 @@ private:
   int numAudioChannels = 0;
   int blockSize = 0;
 
-  // Backing storage for graph-owned per-port buffers.
+  // Backing storage for graph-owned per-port buffers. Audio and control
+  // buffers refer into sampleArenas rather than owning their samples.
+  // Arenas are added as buffers are allocated, until packBuffers() moves
+  // everything into one. Event buffers grow on their own, so they keep
+  // separate allocations.
+  std::vector<GraphBufferArena> sampleArenas;
   std::vector<juce::AudioSampleBuffer> audioBuffers;
   std::vector<juce::AudioSampleBuffer> controlBuffers;
   std::vector<std::unique_ptr<EventBuffer>> eventBuffers;
 
+  // The shape of each control buffer's samples, by control buffer index.
+  std::vector<ControlBufferShape> controlBufferShapes;
+
+  // Parameter values for every node context in this graph.
+  GraphParameterBank parameterBank;
+
   std::optional<size_t> sharedSilentAudioBufferIndex;
   std::optional<size_t> sharedEmptyEventBufferIndex;
 
   // Owns all node-scoped views into the graph-owned runtime storage above.
   std::vector<std::unique_ptr<NodeProcessContext>> nodeProcessContexts;
+
+  float* allocateSamples(size_t sampleCount);
+  void referToSamples(juce::AudioSampleBuffer& buffer, float* samples, int numChannels);
 public:
   explicit GraphProcessContext(
       GraphRuntimeServices& rtServices, const GraphBufferLayout& bufferLayout);
@@ -75,7 +94,8 @@ public:
 
   // Reserves capacity for all graph-owned runtime objects before node contexts
   // are created. This keeps the backing arrays stable while compilation builds
-  // buffer bindings into node contexts.
+  // buffer bindings into node contexts, and sizes the first sample arena so
+  // the reserved buffers share one allocation.
   void reserve(size_t nodeProcessContextCount,
       size_t audioBufferCount,
       size_t controlBufferCount,
@@ -89,6 +109,20 @@ public:
   size_t getSharedSilentAudioBufferIndex();
   size_t getSharedEmptyEventBufferIndex();
 
+  size_t getAudioBufferCount() const;
+
+  // A graph-owned buffer, as passed to packBuffers().
+  using BufferReference = std::pair<NodePortDataType, size_t>;
+
+  // Moves the samples of every audio and control buffer into a single new
+  // arena, so that the graph's sample memory is one allocation. Buffers are
+  // laid out in the given order, followed by any that were not listed, so
+  // that buffers used together can sit next to each other. Indices, contents
+  // and silence flags are unchanged. Event buffers in the order are ignored.
+  //
+  // Must not be called while the graph is processing.
+  void packBuffers(std::span<const BufferReference> bufferOrder);
+
   // Creates a node-scoped view into this graph-owned storage.
   NodeProcessContext& createNodeProcessContext(
       std::shared_ptr<Node>& graphNode, NodeProcessContext::BufferBindings bufferBindings);
@@ -98,6 +132,21 @@ public:
   juce::AudioSampleBuffer& getControlBuffer(size_t index);
   std::unique_ptr<EventBuffer>& getEventBuffer(size_t index);
 
+  // Whoever writes a control buffer also sets its shape. See
+  // ControlBufferShape.
+  ControlBufferShape& rt_getControlBufferShape(size_t index);
+
+  GraphParameterBank& getParameterBank() {
+    return parameterBank;
+  }
+
+  // Silence tracking for graph-owned audio buffers. This uses the buffer's
+  // own clear flag, which JUCE resets whenever a write pointer is taken, so
+  // a buffer reads as silent only if nothing has written to it since it was
+  // last silenced.
+  bool rt_isAudioBufferSilent(size_t index);
+  void rt_silenceAudioBuffer(size_t index);
+
   // Allocates a live note ID using the shared runtime service layer.
   LiveNoteId rt_allocateLiveNoteId();
 
@@ -19,15 +19,64 @@
 
 #include "node_process_context.h"
 
+#include "modules/core/constants.h"
 #include "modules/processing_graph/model/node.h"
 #include "modules/processing_graph/model/node_port.h"
 #include "modules/processing_graph/runtime/graph_process_context.h"
 
 #include <algorithm>
+#include <limits>
 #include <utility>
 
 namespace anthem {
 
+namespace {
+
+// Marks a slot in a dense port table that has no port bound to it.
+constexpr size_t emptyPortSlot = std::numeric_limits<size_t>::max();
+
+// Ports with IDs from zero up to this get a slot in the dense port tables.
+// Generated port IDs are far below it.
+constexpr int64_t maxPortSlotCount = 64;
+
+std::vector<size_t> createPortSlotTable(
+    const NodeProcessContext::PortBufferIndexMap& bufferIndicesByPortId) {
+  int64_t slotCount = 0;
+
+  for (const auto& [portId, _] : bufferIndicesByPortId) {
+    if (portId >= 0 && portId < maxPortSlotCount) {
+      slotCount = std::max(slotCount, portId + 1);
+    }
+  }
+
+  std::vector<size_t> bufferIndicesBySlot(static_cast<size_t>(slotCount), emptyPortSlot);
+
+  for (const auto& [portId, bufferIndex] : bufferIndicesByPortId) {
+    if (portId >= 0 && portId < slotCount) {
+      bufferIndicesBySlot[static_cast<size_t>(portId)] = bufferIndex;
+    }
+  }
+
+  return bufferIndicesBySlot;
+}
+
+// Throws std::out_of_range if the port doesn't exist, like the maps do.
+size_t findPortBufferIndex(const std::vector<size_t>& bufferIndicesBySlot,
+    const NodeProcessContext::PortBufferIndexMap& bufferIndicesByPortId,
+    int64_t id) {
+  if (id >= 0 && static_cast<uint64_t>(id) < bufferIndicesBySlot.size()) {
+    const auto bufferIndex = bufferIndicesBySlot[static_cast<size_t>(id)];
+
+    if (bufferIndex != emptyPortSlot) {
+      return bufferIndex;
+    }
+  }
+
+  return bufferIndicesByPortId.at(id);
+}
+
+} // namespace
+
 NodeProcessContext::NodeProcessContext(std::shared_ptr<Node>& graphNode,
     GraphProcessContext& graphProcessContext,
     BufferBindings bufferBindings)
@@ -41,8 +90,34 @@ NodeProcessContext::NodeProcessContext(std::shared_ptr<Node>& graphNode,
   inputEventBuffers = std::move(bufferBindings.inputEventBuffers);
   outputEventBuffers = std::move(bufferBindings.outputEventBuffers);
   rt_eventBuffersToClear = std::move(bufferBindings.rt_eventBuffersToClear);
+  rt_reusedOutputAudioBuffers = std::move(bufferBindings.rt_reusedOutputAudioBuffers);
+
+  inputAudioBufferSlots = createPortSlotTable(inputAudioBuffers);
+  outputAudioBufferSlots = createPortSlotTable(outputAudioBuffers);
+  inputControlBufferSlots = createPortSlotTable(inputControlBuffers);
+  outputControlBufferSlots = createPortSlotTable(outputControlBuffers);
+  inputEventBufferSlots = createPortSlotTable(inputEventBuffers);
+  outputEventBufferSlots = createPortSlotTable(outputEventBuffers);
+
+  auto copyBufferIndices = [](const PortBufferIndexMap& bufferIndicesByPortId,
+                               std::vector<size_t>& bufferIndices) {
+    bufferIndices.reserve(bufferIndicesByPortId.size());
+
+    for (const auto& [_, bufferIndex] : bufferIndicesByPortId) {
+      bufferIndices.push_back(bufferIndex);
+    }
+  };
+
+  copyBufferIndices(inputAudioBuffers, rt_inputAudioBufferIndices);
+  copyBufferIndices(inputEventBuffers, rt_inputEventBufferIndices);
+  copyBufferIndices(outputAudioBuffers, rt_outputAudioBufferIndices);
+  copyBufferIndices(outputControlBuffers, rt_outputControlBufferIndices);
 
   inputParameters.reserve(graphNode->controlInputPorts()->size());
+  rt_activeParameterIndices.reserve(graphNode->controlInputPorts()->size());
+
+  auto& parameterBank = graphProcessContext.getParameterBank();
+  firstParameterValueIndex = parameterBank.size();
 
   for (auto& port : *graphNode->controlInputPorts()) {
     const auto controlBufferIndex = inputControlBuffers.at(port->id());
@@ -54,15 +129,23 @@ NodeProcessContext::NodeProcessContext(std::shared_ptr<Node>& graphNode,
       continue;
     }
 
-    InputParameterBinding state;
-    state.portId = port->id();
-    state.rt_buffer = &inputControlBuffer;
-    state.rt_shouldWriteToBuffer =
-        parameterInputPortsToWrite.find(port->id()) != parameterInputPortsToWrite.end();
-    state.value = std::make_unique<std::atomic<float>>(parameterValue);
-    state.rt_smoother = std::make_unique<LinearParameterSmoother>(
-        parameterValue, static_cast<float>((*parameterConfig)->smoothingDurationSeconds()));
-    inputParameters.push_back(std::move(state));
+    inputParameters.push_back(InputParameterBinding{
+        .portId = port->id(),
+        .rt_buffer = &inputControlBuffer,
+        .rt_bufferShape = &graphProcessContext.rt_getControlBufferShape(controlBufferIndex),
+        .rt_shouldWriteToBuffer =
+            parameterInputPortsToWrite.find(port->id()) != parameterInputPortsToWrite.end(),
+        .valueIndex = parameterBank.add(parameterValue),
+        .rt_smoother = LinearParameterSmoother(
+            parameterValue, static_cast<float>((*parameterConfig)->smoothingDurationSeconds())),
+    });
+
+    // Nothing has been written to the control buffer yet.
+    rt_activateParameter(inputParameters.size() - 1);
+  }
+
+  if (!inputParameters.empty() && !inputEventBuffers.empty()) {
+    rt_scheduledParameterChanges.reserve(DEFAULT_EVENT_BUFFER_SIZE);
   }
 }
 
@@ -101,6 +184,38 @@ const NodeProcessContext::InputParameterBinding& NodeProcessContext::findInputPa
   return *it;
 }
 
+void NodeProcessContext::rebindGraphNode(std::shared_ptr<Node>& graphNode) {
+  this->graphNode = graphNode;
+
+  auto& parameterBank = graphProcessContext->getParameterBank();
+
+  // Parameter values may have changed between the snapshot and now. Those
+  // changes were sent to the previous graph's contexts, so they are picked up
+  // again here.
+  for (auto& port : *graphNode->controlInputPorts()) {
+    auto& parameterConfig = port->config()->parameterConfig();
+
+    if (!parameterConfig.has_value()) {
+      continue;
+    }
+
+    auto it = std::find_if(inputParameters.begin(),
+        inputParameters.end(),
+        [&port](const InputParameterBinding& inputParameter) {
+          return inputParameter.portId == port->id();
+        });
+
+    if (it == inputParameters.end()) {
+      continue;
+    }
+
+    auto parameterValue = static_cast<float>(port->parameterValue().value_or(0.0));
+    parameterBank.setValueWithoutNotifying(it->valueIndex, parameterValue);
+    it->rt_smoother = LinearParameterSmoother(
+        parameterValue, static_cast<float>((*parameterConfig)->smoothingDurationSeconds()));
+  }
+}
+
 void NodeProcessContext::setParameterValue(int64_t id, float value) {
   // Throw if not on the JUCE message thread
   if (!juce::MessageManager::getInstance()->isThisTheMessageThread()) {
@@ -108,11 +223,136 @@ void NodeProcessContext::setParameterValue(int64_t id, float value) {
         "AnthemNodeProcessContext::setParameterValue() must be called on the JUCE message thread.");
   }
 
-  findInputParameterBinding(id).value->store(value);
+  graphProcessContext->getParameterBank().setValue(findInputParameterBinding(id).valueIndex, value);
 }
 
 float NodeProcessContext::getParameterValue(int64_t id) {
-  return findInputParameterBinding(id).value->load();
+  return graphProcessContext->getParameterBank().getValue(findInputParameterBinding(id).valueIndex);
+}
+
+void NodeProcessContext::rt_activateParameter(size_t parameterIndex) {
+  auto& parameter = inputParameters[parameterIndex];
+
+  if (parameter.rt_isActive || !parameter.rt_shouldWriteToBuffer) {
+    return;
+  }
+
+  jassert(rt_activeParameterIndices.size() < rt_activeParameterIndices.capacity());
+
+  parameter.rt_isActive = true;
+  rt_activeParameterIndices.push_back(parameterIndex);
+}
+
+void NodeProcessContext::rt_takeParameterChanges() {
+  jassert(graphProcessContext != nullptr);
+
+  auto& parameterBank = graphProcessContext->getParameterBank();
+
+  parameterBank.rt_takeChanges(
+      firstParameterValueIndex, inputParameters.size(), [&](size_t valueIndex) {
+        const auto parameterIndex = valueIndex - firstParameterValueIndex;
+        auto& parameter = inputParameters[parameterIndex];
+        const auto value = parameterBank.getValue(valueIndex);
+        jassert(juce::jlimit(0.0f, 1.0f, value) == value);
+
+        if (parameter.rt_smoother.getTargetValue() != value) {
+          parameter.rt_smoother.setTargetValue(value);
+        }
+
+        rt_activateParameter(parameterIndex);
+      });
+
+  rt_takeParameterChangeEvents();
+}
+
+void NodeProcessContext::rt_takeParameterChangeEvents() {
+  rt_scheduledParameterChanges.clear();
+
+  if (rt_scheduledParameterChanges.capacity() == 0) {
+    return;
+  }
+
+  // Event buffers can grow past the capacity reserved here, so this can fill
+  // up. Events past that point are dropped, but the ones collected so far
+  // still need sorting below.
+  bool isFull = false;
+
+  for (const auto bufferIndex : rt_inputEventBufferIndices) {
+    if (isFull) {
+      break;
+    }
+
+    const auto& eventBuffer = *graphProcessContext->getEventBuffer(bufferIndex);
+
+    for (size_t eventIndex = 0; eventIndex < eventBuffer.getNumEvents(); ++eventIndex) {
+      const auto& liveEvent = eventBuffer.getEvent(eventIndex);
+
+      if (liveEvent.event.type != EventType::ParameterChange) {
+        continue;
+      }
+
+      const auto& parameterChange = liveEvent.event.parameterChange;
+      auto parameterIter = std::find_if(inputParameters.begin(),
+          inputParameters.end(),
+          [&](const InputParameterBinding& parameter) {
+            return parameter.portId == parameterChange.parameterId;
+          });
+
+      // Parameters with a connected control input take their values from the
+      // connection instead.
+      if (parameterIter == inputParameters.end() || !parameterIter->rt_shouldWriteToBuffer) {
+        continue;
+      }
+
+      if (rt_scheduledParameterChanges.size() == rt_scheduledParameterChanges.capacity()) {
+        isFull = true;
+        break;
+      }
+
+      const auto parameterIndex =
+          static_cast<size_t>(std::distance(inputParameters.begin(), parameterIter));
+
+      rt_scheduledParameterChanges.push_back(ScheduledParameterChange{
+          .parameterIndex = parameterIndex,
+          .sampleOffset = liveEvent.sampleOffset,
+          .value = juce::jlimit(0.0f, 1.0f, parameterChange.value),
+      });
+
+      rt_activateParameter(parameterIndex);
+    }
+  }
+
+  // An insertion sort keeps events at the same offset in the order they
+  // arrived, doesn't allocate, and is quick for the handful of events a block
+  // usually has, which mostly arrive in order already.
+  for (size_t i = 1; i < rt_scheduledParameterChanges.size(); ++i) {
+    const auto change = rt_scheduledParameterChanges[i];
+    auto j = i;
+
+    for (; j > 0; --j) {
+      const auto& previous = rt_scheduledParameterChanges[j - 1];
+
+      if (previous.parameterIndex < change.parameterIndex ||
+          (previous.parameterIndex == change.parameterIndex &&
+              previous.sampleOffset <= change.sampleOffset)) {
+        break;
+      }
+
+      rt_scheduledParameterChanges[j] = previous;
+    }
+
+    rt_scheduledParameterChanges[j] = change;
+  }
+}
+
+std::span<const NodeProcessContext::ScheduledParameterChange>
+NodeProcessContext::rt_getScheduledParameterChanges(size_t parameterIndex) const {
+  const auto changes = std::ranges::equal_range(rt_scheduledParameterChanges,
+      parameterIndex,
+      {},
+      &ScheduledParameterChange::parameterIndex);
+
+  return {changes.begin(), changes.end()};
 }
 
 void NodeProcessContext::clearBuffers() {
@@ -121,20 +361,168 @@ void NodeProcessContext::clearBuffers() {
   for (const auto bufferIndex : rt_eventBuffersToClear) {
     graphProcessContext->getEventBuffer(bufferIndex)->clear();
   }
+
+  for (const auto bufferIndex : rt_outputControlBufferIndices) {
+    graphProcessContext->rt_getControlBufferShape(bufferIndex) = ControlBufferShape{};
+  }
+}
+
+void NodeProcessContext::findStateTransfersFrom(const NodeProcessContext& previousContext,
+    std::vector<ParameterStateTransfer>& parameterTransfers,
+    std::vector<EventBufferStateTransfer>& eventBufferTransfers) const {
+  std::unordered_map<int64_t, size_t> previousParameterIndicesByPortId;
+  previousParameterIndicesByPortId.reserve(previousContext.inputParameters.size());
+
+  for (size_t parameterIndex = 0; parameterIndex < previousContext.inputParameters.size();
+       ++parameterIndex) {
+    previousParameterIndicesByPortId.emplace(
+        previousContext.inputParameters[parameterIndex].portId, parameterIndex);
+  }
+
+  for (size_t parameterIndex = 0; parameterIndex < inputParameters.size(); ++parameterIndex) {
+    auto previousParameterIndexIter =
+        previousParameterIndicesByPortId.find(inputParameters[parameterIndex].portId);
+    if (previousParameterIndexIter == previousParameterIndicesByPortId.end()) {
+      continue;
+    }
+
+    parameterTransfers.push_back(ParameterStateTransfer{
+        .parameterIndex = parameterIndex,
+        .previousParameterIndex = previousParameterIndexIter->second,
+    });
+  }
+
+  // Other nodes read output event buffers through the buffer index, not the
+  // pointer, so swapping the pointers is enough.
+  for (const auto& [portId, bufferIndex] : outputEventBuffers) {
+    auto previousBufferIndexIter = previousContext.outputEventBuffers.find(portId);
+    if (previousBufferIndexIter == previousContext.outputEventBuffers.end()) {
+      continue;
+    }
+
+    eventBufferTransfers.push_back(EventBufferStateTransfer{
+        .bufferIndex = bufferIndex,
+        .previousBufferIndex = previousBufferIndexIter->second,
+        .keepLargerBuffer = false,
+    });
+  }
+
+  // Fan-in inputs have buffers of their own, which this node clears. Other
+  // event inputs read another node's output buffer, which that node swaps.
+  auto ownsBuffer = [](const NodeProcessContext& context, size_t bufferIndex) {
+    return std::find(context.rt_eventBuffersToClear.begin(),
+               context.rt_eventBuffersToClear.end(),
+               bufferIndex) != context.rt_eventBuffersToClear.end();
+  };
+
+  for (const auto& [portId, bufferIndex] : inputEventBuffers) {
+    auto previousBufferIndexIter = previousContext.inputEventBuffers.find(portId);
+    if (previousBufferIndexIter == previousContext.inputEventBuffers.end() ||
+        !ownsBuffer(*this, bufferIndex) ||
+        !ownsBuffer(previousContext, previousBufferIndexIter->second)) {
+      continue;
+    }
+
+    eventBufferTransfers.push_back(EventBufferStateTransfer{
+        .bufferIndex = bufferIndex,
+        .previousBufferIndex = previousBufferIndexIter->second,
+        .keepLargerBuffer = true,
+    });
+  }
+}
+
+void NodeProcessContext::rt_adoptStateFrom(NodeProcessContext& previousContext,
+    std::span<const ParameterStateTransfer> parameterTransfers,
+    std::span<const EventBufferStateTransfer> eventBufferTransfers) {
+  jassert(graphProcessContext != nullptr);
+  jassert(previousContext.graphProcessContext != nullptr);
+
+  auto& parameterBank = graphProcessContext->getParameterBank();
+
+  for (const auto& transfer : parameterTransfers) {
+    auto& parameter = inputParameters[transfer.parameterIndex];
+    parameter.rt_smoother.continueFrom(
+        previousContext.inputParameters[transfer.previousParameterIndex].rt_smoother);
+
+    // rebindGraphNode() put the latest value in this bank without marking it
+    // as changed. If it was set after the previous graph's last block, the
+    // smoother taken from that graph is still heading for the old value.
+    const auto value = parameterBank.getValue(parameter.valueIndex);
+    if (parameter.rt_smoother.getTargetValue() != value) {
+      parameter.rt_smoother.setTargetValue(value);
+    }
+
+    rt_activateParameter(transfer.parameterIndex);
+  }
+
+  for (const auto& transfer : eventBufferTransfers) {
+    auto& buffer = graphProcessContext->getEventBuffer(transfer.bufferIndex);
+    auto& previousBuffer =
+        previousContext.graphProcessContext->getEventBuffer(transfer.previousBufferIndex);
+
+    // The previous fan-in buffer may have grown past the size this one was
+    // compiled with. It is kept unless the new one is larger, since this
+    // can't allocate.
+    if (!transfer.keepLargerBuffer || previousBuffer->getSize() >= buffer->getSize()) {
+      std::swap(buffer, previousBuffer);
+    }
+  }
+}
+
+bool NodeProcessContext::rt_areInputsSilent() const {
+  jassert(graphProcessContext != nullptr);
+
+  for (const auto bufferIndex : rt_inputAudioBufferIndices) {
+    if (!graphProcessContext->rt_isAudioBufferSilent(bufferIndex)) {
+      return false;
+    }
+  }
+
+  for (const auto bufferIndex : rt_inputEventBufferIndices) {
+    if (graphProcessContext->getEventBuffer(bufferIndex)->getNumEvents() > 0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void NodeProcessContext::rt_silenceOutputs() {
+  jassert(graphProcessContext != nullptr);
+
+  for (const auto bufferIndex : rt_outputAudioBufferIndices) {
+    graphProcessContext->rt_silenceAudioBuffer(bufferIndex);
+  }
+
+  for (const auto bufferIndex : rt_outputControlBufferIndices) {
+    graphProcessContext->getControlBuffer(bufferIndex).clear();
+    graphProcessContext->rt_getControlBufferShape(bufferIndex) = ControlBufferShape::constant(0.0f);
+  }
+}
+
+void NodeProcessContext::rt_silenceReusedOutputAudioBuffers() {
+  jassert(graphProcessContext != nullptr);
+
+  for (const auto bufferIndex : rt_reusedOutputAudioBuffers) {
+    graphProcessContext->rt_silenceAudioBuffer(bufferIndex);
+  }
 }
 
 size_t NodeProcessContext::getBufferIndex(
     NodePortDataType dataType, BufferDirection direction, int64_t id) const {
   switch (dataType) {
     case NodePortDataType::audio:
-      return direction == BufferDirection::input ? inputAudioBuffers.at(id)
-                                                 : outputAudioBuffers.at(id);
+      return direction == BufferDirection::input
+                 ? findPortBufferIndex(inputAudioBufferSlots, inputAudioBuffers, id)
+                 : findPortBufferIndex(outputAudioBufferSlots, outputAudioBuffers, id);
     case NodePortDataType::control:
-      return direction == BufferDirection::input ? inputControlBuffers.at(id)
-                                                 : outputControlBuffers.at(id);
+      return direction == BufferDirection::input
+                 ? findPortBufferIndex(inputControlBufferSlots, inputControlBuffers, id)
+                 : findPortBufferIndex(outputControlBufferSlots, outputControlBuffers, id);
     case NodePortDataType::event:
-      return direction == BufferDirection::input ? inputEventBuffers.at(id)
-                                                 : outputEventBuffers.at(id);
+      return direction == BufferDirection::input
+                 ? findPortBufferIndex(inputEventBufferSlots, inputEventBuffers, id)
+                 : findPortBufferIndex(outputEventBufferSlots, outputEventBuffers, id);
   }
 
   throw std::runtime_error("AnthemNodeProcessContext received an unsupported port data type.");
@@ -142,32 +530,50 @@ size_t NodeProcessContext::getBufferIndex(
 
 const juce::AudioSampleBuffer& NodeProcessContext::getInputAudioBuffer(int64_t id) const {
   jassert(graphProcessContext != nullptr);
-  return graphProcessContext->getAudioBuffer(inputAudioBuffers.at(id));
+  return graphProcessContext->getAudioBuffer(
+      findPortBufferIndex(inputAudioBufferSlots, inputAudioBuffers, id));
 }
 
 juce::AudioSampleBuffer& NodeProcessContext::getOutputAudioBuffer(int64_t id) {
   jassert(graphProcessContext != nullptr);
-  return graphProcessContext->getAudioBuffer(outputAudioBuffers.at(id));
+  return graphProcessContext->getAudioBuffer(
+      findPortBufferIndex(outputAudioBufferSlots, outputAudioBuffers, id));
 }
 
 const juce::AudioSampleBuffer& NodeProcessContext::getInputControlBuffer(int64_t id) const {
   jassert(graphProcessContext != nullptr);
-  return graphProcessContext->getControlBuffer(inputControlBuffers.at(id));
+  return graphProcessContext->getControlBuffer(
+      findPortBufferIndex(inputControlBufferSlots, inputControlBuffers, id));
 }
 
 juce::AudioSampleBuffer& NodeProcessContext::getOutputControlBuffer(int64_t id) {
   jassert(graphProcessContext != nullptr);
-  return graphProcessContext->getControlBuffer(outputControlBuffers.at(id));
+  return graphProcessContext->getControlBuffer(
+      findPortBufferIndex(outputControlBufferSlots, outputControlBuffers, id));
+}
+
+ControlBufferShape NodeProcessContext::getInputControlBufferShape(int64_t id) const {
+  jassert(graphProcessContext != nullptr);
+  return graphProcessContext->rt_getControlBufferShape(
+      findPortBufferIndex(inputControlBufferSlots, inputControlBuffers, id));
+}
+
+void NodeProcessContext::setOutputControlBufferShape(int64_t id, ControlBufferShape shape) {
+  jassert(graphProcessContext != nullptr);
+  graphProcessContext->rt_getControlBufferShape(
+      findPortBufferIndex(outputControlBufferSlots, outputControlBuffers, id)) = shape;
 }
 
 const EventBuffer& NodeProcessContext::getInputEventBuffer(int64_t id) const {
   jassert(graphProcessContext != nullptr);
-  return *graphProcessContext->getEventBuffer(inputEventBuffers.at(id));
+  return *graphProcessContext->getEventBuffer(
+      findPortBufferIndex(inputEventBufferSlots, inputEventBuffers, id));
 }
 
 EventBuffer& NodeProcessContext::getOutputEventBuffer(int64_t id) {
   jassert(graphProcessContext != nullptr);
-  return *graphProcessContext->getEventBuffer(outputEventBuffers.at(id));
+  return *graphProcessContext->getEventBuffer(
+      findPortBufferIndex(outputEventBufferSlots, outputEventBuffers, id));
 }
 
 LiveNoteId NodeProcessContext::rt_allocateLiveNoteId() {
@@ -21,6 +21,7 @@
 
 #include "modules/processing_graph/model/node.h"
 #include "modules/processing_graph/processor/event_buffer.h"
+#include "modules/processing_graph/runtime/control_buffer_shape.h"
 #include "modules/sequencer/events/note_instance_id.h"
 #include "modules/util/linear_parameter_smoother.h"
 
@@ -30,6 +31,7 @@
 #include <juce_core/juce_core.h>
 #include <juce_events/juce_events.h>
 #include <memory>
+#include <span>
 #include <stdexcept>
 #include <unordered_map>
 #include <unordered_set>
@@ -66,14 +68,54 @@ public:
 
     std::vector<size_t> rt_eventBuffersToClear;
     std::unordered_set<int64_t> rt_parameterInputPortsToWrite;
+
+    // Output audio buffers with readers that were taken over from an earlier
+    // node through buffer pooling, and may still hold that node's audio.
+    std::vector<size_t> rt_reusedOutputAudioBuffers;
   };
 
   struct InputParameterBinding {
     int64_t portId;
     juce::AudioSampleBuffer* rt_buffer = nullptr;
+    ControlBufferShape* rt_bufferShape = nullptr;
     bool rt_shouldWriteToBuffer = true;
-    std::unique_ptr<std::atomic<float>> value;
-    std::unique_ptr<LinearParameterSmoother> rt_smoother;
+
+    // True while this parameter is listed in rt_getActiveParameterIndices().
+    bool rt_isActive = false;
+
+    // Where this parameter's value lives in the graph's GraphParameterBank.
+    size_t valueIndex = 0;
+
+    LinearParameterSmoother rt_smoother;
+  };
+
+  // A parameter change event from one of this node's event inputs, matched
+  // to the parameter it targets.
+  struct ScheduledParameterChange {
+    // Index into rt_getInputParameterBindings().
+    size_t parameterIndex;
+    int sampleOffset;
+    float value;
+  };
+
+  // A parameter of this context paired with the same parameter in the
+  // context it takes over from. Both are indices into
+  // rt_getInputParameterBindings().
+  struct ParameterStateTransfer {
+    size_t parameterIndex;
+    size_t previousParameterIndex;
+  };
+
+  // An event buffer of this context paired with the buffer for the same port
+  // in the context it takes over from. Both are indices into their graph's
+  // GraphProcessContext.
+  struct EventBufferStateTransfer {
+    size_t bufferIndex;
+    size_t previousBufferIndex;
+
+    // Fan-in buffers are sized at compile time to hold all of their sources.
+    // These are only swapped if the previous buffer is at least as large.
+    bool keepLargerBuffer;
   };
 private:
   JUCE_LEAK_DETECTOR(NodeProcessContext)
@@ -90,10 +132,46 @@ private:
   PortBufferIndexMap inputEventBuffers;
   PortBufferIndexMap outputEventBuffers;
 
+  // The maps above as arrays indexed by port ID. The built-in processors
+  // number their ports from zero, so the getters below can find a port's
+  // buffer with an array index instead of a hash lookup. Ports with IDs past
+  // the end of a table, such as ports built by hand in tests, fall back to
+  // the maps.
+  std::vector<size_t> inputAudioBufferSlots;
+  std::vector<size_t> outputAudioBufferSlots;
+  std::vector<size_t> inputControlBufferSlots;
+  std::vector<size_t> outputControlBufferSlots;
+  std::vector<size_t> inputEventBufferSlots;
+  std::vector<size_t> outputEventBufferSlots;
+
   std::vector<size_t> rt_eventBuffersToClear;
 
+  // Flat copies of the buffer indices above, used for silence tracking.
+  std::vector<size_t> rt_inputAudioBufferIndices;
+  std::vector<size_t> rt_inputEventBufferIndices;
+  std::vector<size_t> rt_outputAudioBufferIndices;
+  std::vector<size_t> rt_outputControlBufferIndices;
+  std::vector<size_t> rt_reusedOutputAudioBuffers;
+
   std::vector<InputParameterBinding> inputParameters;
 
+  // This node's parameters take up consecutive slots in the parameter bank,
+  // starting here, in the same order as inputParameters.
+  size_t firstParameterValueIndex = 0;
+
+  // Indices into inputParameters of the parameters whose control buffers
+  // still need writing. Settled parameters leave this list until their value
+  // changes. Reserved up front, so the audio thread never allocates here.
+  std::vector<size_t> rt_activeParameterIndices;
+
+  // This block's parameter change events, ordered by parameter and then by
+  // sample offset. Reserved up front, like the list above. Events past its
+  // capacity are dropped.
+  std::vector<ScheduledParameterChange> rt_scheduledParameterChanges;
+
+  void rt_activateParameter(size_t parameterIndex);
+  void rt_takeParameterChangeEvents();
+
   std::weak_ptr<Node> graphNode;
   GraphProcessContext* graphProcessContext = nullptr;
 public:
@@ -116,10 +194,58 @@ public:
     return graphNode.lock();
   }
 
+  // Points the context at another model node with the same ports, and takes
+  // its current parameter values. This is for graphs compiled from a
+  // ProcessingGraphSnapshot, whose contexts start out on the snapshot's copy
+  // of the node.
+  //
+  // Must be called on the JUCE message thread, before the context is handed
+  // to the audio thread.
+  void rebindGraphNode(std::shared_ptr<Node>& graphNode);
+
   void setParameterValue(int64_t id, float value);
   float getParameterValue(int64_t id);
 
+  // Empties event buffers, and marks output control buffers as arbitrary
+  // until the processor says otherwise.
   void clearBuffers();
+
+  // Pairs this context's parameters, and its output and fan-in input event
+  // buffers, with the ones for the same ports in previousContext, and appends
+  // the pairs to the given lists. previousContext is this node's context in
+  // the graph that was running before this one.
+  //
+  // This only reads the parts of previousContext that don't change after it
+  // is built, so it can run while the audio thread is processing that graph.
+  // Must not be called on the audio thread, since it allocates.
+  void findStateTransfersFrom(const NodeProcessContext& previousContext,
+      std::vector<ParameterStateTransfer>& parameterTransfers,
+      std::vector<EventBufferStateTransfer>& eventBufferTransfers) const;
+
+  // Carries runtime state over from previousContext, using the pairs found by
+  // findStateTransfersFrom(): parameter smoother positions are copied, and
+  // event buffers are swapped so that any capacity they have grown into is
+  // kept. Smoothers then head for this graph's parameter values, in case a
+  // value changed after the previous graph last took its changes.
+  //
+  // Must be called on the audio thread while neither graph is processing.
+  void rt_adoptStateFrom(NodeProcessContext& previousContext,
+      std::span<const ParameterStateTransfer> parameterTransfers,
+      std::span<const EventBufferStateTransfer> eventBufferTransfers);
+
+  // Returns true if every audio input buffer is silent and every event input
+  // buffer is empty. Control inputs are not considered.
+  bool rt_areInputsSilent() const;
+
+  // Silences this node's audio and control outputs. Event outputs are
+  // emptied by clearBuffers().
+  void rt_silenceOutputs();
+
+  // Silences the audio outputs whose buffers were taken over from an earlier
+  // node. A node without a processor calls this each block, so that its
+  // outputs read as silence rather than as that node's audio.
+  void rt_silenceReusedOutputAudioBuffers();
+
   size_t getBufferIndex(NodePortDataType dataType, BufferDirection direction, int64_t id) const;
 
   const juce::AudioSampleBuffer& getInputAudioBuffer(int64_t id) const;
@@ -128,6 +254,12 @@ public:
   const juce::AudioSampleBuffer& getInputControlBuffer(int64_t id) const;
   juce::AudioSampleBuffer& getOutputControlBuffer(int64_t id);
 
+  // The shape of a control buffer's samples for this block. Processors that
+  // write a constant or ramp to an output can say so, which lets downstream
+  // nodes take faster paths.
+  ControlBufferShape getInputControlBufferShape(int64_t id) const;
+  void setOutputControlBufferShape(int64_t id, ControlBufferShape shape);
+
   const EventBuffer& getInputEventBuffer(int64_t id) const;
   EventBuffer& getOutputEventBuffer(int64_t id);
 
@@ -135,6 +267,28 @@ public:
     return inputParameters;
   }
 
+  std::vector<InputParameterBinding>& rt_getInputParameterBindings() {
+    return inputParameters;
+  }
+
+  // Picks up the parameter values set since the last block, retargets their
+  // smoothers, and marks them as active. Parameter change events on this
+  // node's event inputs are collected too, but they are left for the control
+  // buffer writer, which applies each one at its sample offset.
+  void rt_takeParameterChanges();
+
+  // The parameter change events collected by rt_takeParameterChanges() for
+  // one parameter, in sample offset order.
+  std::span<const ScheduledParameterChange> rt_getScheduledParameterChanges(
+      size_t parameterIndex) const;
+
+  // Indices into rt_getInputParameterBindings() of the parameters whose
+  // control buffers need writing this block. Whoever writes them removes
+  // parameters once they settle, and clears their rt_isActive flags.
+  std::vector<size_t>& rt_getActiveParameterIndices() {
+    return rt_activeParameterIndices;
+  }
+
   LiveNoteId rt_allocateLiveNoteId();
 };
 
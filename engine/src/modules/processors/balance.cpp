@@ -20,6 +20,7 @@
 #include "balance.h"
 
 #include "modules/processing_graph/runtime/node_process_context.h"
+#include "modules/util/simd/simd_kernels.h"
 
 #include <juce_core/juce_core.h>
 
@@ -39,27 +40,15 @@ void BalanceProcessor::process(NodeProcessContext& context, int numSamples) {
   auto& balanceControlBuffer =
       context.getInputControlBuffer(BalanceProcessorModelBase::balancePortId);
 
-  for (int sample = 0; sample < numSamples; sample++) {
-    auto normalizedValue = balanceControlBuffer.getReadPointer(0)[sample];
-    jassert(juce::jlimit(0.0f, 1.0f, normalizedValue) == normalizedValue);
-    auto pan = normalizedValue * 2.0f - 1.0f;
+  jassert(audioOutBuffer.getNumChannels() >= 2);
 
-    auto gainR = juce::jmin(1.0f - pan, 1.0f);
-    auto gainL = juce::jmin(1.0f + pan, 1.0f);
-
-    float gains[2] = {gainR, gainL};
-
-    jassert(audioOutBuffer.getNumChannels() >= 2);
-
-    for (int channel = 0; channel < 2; ++channel) {
-      auto inputSample = audioInBuffer.getReadPointer(channel)[sample];
-      float outputSample = inputSample;
-
-      outputSample *= gains[channel];
-
-      audioOutBuffer.getWritePointer(channel)[sample] = outputSample;
-    }
-  }
+  simd::rt_applyBalance(audioOutBuffer.getWritePointer(0),
+      audioOutBuffer.getWritePointer(1),
+      audioInBuffer.getReadPointer(0),
+      audioInBuffer.getReadPointer(1),
+      balanceControlBuffer.getReadPointer(0),
+      nullptr,
+      numSamples);
 }
 
 } // namespace anthem
@@ -39,6 +39,15 @@ public:
 
   void prepareToProcess() override;
   void process(NodeProcessContext& context, int numSamples) override;
+
+  int64_t getTailLengthSamples() const override {
+    return 0;
+  }
+
+  std::vector<InPlaceAudioPortPair> getInPlaceAudioPortPairs() const override {
+    return {{BalanceProcessorModelBase::audioInputPortId,
+        BalanceProcessorModelBase::audioOutputPortId}};
+  }
 };
 
 } // namespace anthem
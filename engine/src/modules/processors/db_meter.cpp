@@ -24,9 +24,34 @@
 #include "modules/processing_graph/runtime/node_process_context.h"
 
 #include <algorithm>
+#include <stdexcept>
 
 namespace anthem {
 
+namespace {
+
+// Projects saved before the mode was added don't have one, and measure peaks.
+DbMeterAccumulator::Mode toAccumulatorMode(std::optional<DbMeterMode> mode) {
+  if (!mode.has_value()) {
+    return DbMeterAccumulator::Mode::peak;
+  }
+
+  switch (*mode) {
+    case DbMeterMode::peak:
+      return DbMeterAccumulator::Mode::peak;
+    case DbMeterMode::rms:
+      return DbMeterAccumulator::Mode::rms;
+    case DbMeterMode::momentaryLoudness:
+      return DbMeterAccumulator::Mode::momentaryLoudness;
+    case DbMeterMode::shortTermLoudness:
+      return DbMeterAccumulator::Mode::shortTermLoudness;
+  }
+
+  throw std::runtime_error("Db meter received an unsupported mode.");
+}
+
+} // namespace
+
 std::optional<NumericVisualizationData> DbMeterVisualizationProvider::getTypedData() {
   return drainTimestampedVisualizationBuffer(valueBuffer);
 }
@@ -40,7 +65,9 @@ void DbMeterVisualizationProvider::rt_pushValue(double value, int64_t sampleTime
 
 DbMeterProcessor::DbMeterProcessor(const DbMeterProcessorModelImpl& _impl)
   : Processor("DbMeter"), DbMeterProcessorModelBase(_impl),
-    rt_publishEverySamples(std::make_shared<std::atomic<int64_t>>(1)) {}
+    rt_publishEverySamples(std::make_shared<std::atomic<int64_t>>(1)),
+    rt_mode(std::make_shared<std::atomic<DbMeterAccumulator::Mode>>(
+        DbMeterAccumulator::Mode::peak)) {}
 
 DbMeterProcessor::~DbMeterProcessor() {
   unregisterVisualizationProviders();
@@ -57,6 +84,12 @@ void DbMeterProcessor::initialize(
     rt_publishEverySamples->store(std::max<int64_t>(1, newValue), std::memory_order_relaxed);
   });
 
+  rt_mode->store(toAccumulatorMode(mode()), std::memory_order_relaxed);
+
+  addModeObserver([this](std::optional<DbMeterMode> newValue) {
+    rt_mode->store(toAccumulatorMode(newValue), std::memory_order_relaxed);
+  });
+
   syncVisualizationProviders();
 }
 
@@ -65,16 +98,19 @@ void DbMeterProcessor::prepareToProcess() {
   jassert(currentDevice != nullptr);
 
   size_t rt_channelCount = 0;
+  double sampleRate = 48000.0;
 
   if (currentDevice != nullptr) {
     rt_channelCount =
         static_cast<size_t>(currentDevice->getActiveOutputChannels().countNumberOfSetBits());
+    sampleRate = currentDevice->getCurrentSampleRate();
   }
 
-  rt_accumulator.rt_prepare(rt_channelCount);
+  rt_accumulator.rt_prepare(rt_channelCount, sampleRate);
 
   rt_publishEverySamples->store(
       std::max<int64_t>(1, publishEverySamples()), std::memory_order_relaxed);
+  rt_mode->store(toAccumulatorMode(mode()), std::memory_order_relaxed);
 }
 
 void DbMeterProcessor::process(NodeProcessContext& context, int numSamples) {
@@ -86,6 +122,7 @@ void DbMeterProcessor::process(NodeProcessContext& context, int numSamples) {
   const int64_t publishEverySamples =
       std::max<int64_t>(1, rt_publishEverySamples->load(std::memory_order_relaxed));
   const int64_t blockStartSample = Engine::getInstance().transport->rt_sampleCounter;
+  rt_accumulator.rt_setMode(rt_mode->load(std::memory_order_relaxed));
   rt_accumulator.rt_processBlock(audioInBuffer,
       numSamples,
       blockStartSample,
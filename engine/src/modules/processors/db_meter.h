@@ -54,6 +54,7 @@ private:
   std::vector<std::string> registeredVisualizationIds;
   DbMeterAccumulator rt_accumulator;
   std::shared_ptr<std::atomic<int64_t>> rt_publishEverySamples;
+  std::shared_ptr<std::atomic<DbMeterAccumulator::Mode>> rt_mode;
 
   void syncVisualizationProviders();
   void unregisterVisualizationProviders();
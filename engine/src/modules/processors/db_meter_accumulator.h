@@ -20,42 +20,294 @@
 #pragma once
 
 #include "bw_math.h"
+#include "modules/util/simd/simd_kernels.h"
 
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <juce_audio_basics/juce_audio_basics.h>
+#include <numbers>
 #include <vector>
 
 namespace anthem {
 
 class DbMeterAccumulator {
+public:
+  // What the published values measure.
+  enum class Mode {
+    // The largest absolute sample value in each publish window, per channel,
+    // in dBFS.
+    peak,
+
+    // The RMS level of each publish window, per channel, in dBFS. A full
+    // scale sine reads -3 dB.
+    rms,
+
+    // ITU-R BS.1770 loudness over the last 400 ms, in LUFS.
+    momentaryLoudness,
+
+    // ITU-R BS.1770 loudness over the last 3 s, in LUFS.
+    shortTermLoudness,
+  };
+
+  // Published for silence, in every mode.
+  static constexpr double silentDb = -600.0;
 private:
+  // Loudness is measured over all channels together, and the same value is
+  // published for each. Every channel is weighted equally, since the meter
+  // doesn't know the speaker layout, which matches BS.1770 for mono and
+  // stereo.
+  //
+  // The K-weighted energy is summed into hops of this length, and the
+  // loudness window is made of whole hops. This keeps the history short
+  // while still updating the value more often than most publish intervals.
+  static constexpr double loudnessHopSeconds = 0.01;
+  static constexpr int momentaryLoudnessHopCount = 40;
+  static constexpr int shortTermLoudnessHopCount = 300;
+
+  // Filter state below this is flushed to zero, so that silence doesn't
+  // leave the filters working on denormals.
+  static constexpr double filterStateFloor = 1.0e-30;
+
+  struct BiquadCoefficients {
+    double b0 = 1.0;
+    double b1 = 0.0;
+    double b2 = 0.0;
+    double a1 = 0.0;
+    double a2 = 0.0;
+  };
+
+  // Transposed direct form II state for the two K-weighting stages
+  struct KWeightingState {
+    double shelfZ1 = 0.0;
+    double shelfZ2 = 0.0;
+    double highPassZ1 = 0.0;
+    double highPassZ2 = 0.0;
+  };
+
+  Mode rt_mode = Mode::peak;
+
   std::vector<float> rt_channelPeakLinear;
+  std::vector<double> rt_channelSumOfSquares;
   int64_t rt_samplesSinceLastPublish = 0;
 
+  BiquadCoefficients rt_shelfCoefficients;
+  BiquadCoefficients rt_highPassCoefficients;
+  std::vector<KWeightingState> rt_channelFilterStates;
+
+  // The K-weighted energy of the most recent hops, as a ring buffer long
+  // enough for the short-term window.
+  std::vector<double> rt_loudnessHopEnergies;
+  size_t rt_loudnessHopWriteIndex = 0;
+  double rt_currentHopEnergy = 0.0;
+  int rt_loudnessHopLength = 1;
+  int rt_samplesInCurrentHop = 0;
+
   static double rt_peakLinearToDb(float peakLinear) {
     if (peakLinear <= 0.0f) {
-      return -600.0;
+      return silentDb;
     }
 
     return static_cast<double>(bw_lin2dBf(peakLinear));
   }
 
+  static double rt_meanSquareToDb(double meanSquare) {
+    if (!(meanSquare > 0.0)) {
+      return silentDb;
+    }
+
+    return 10.0 * std::log10(meanSquare);
+  }
+
+  // The K-weighting filter coefficients from BS.1770, worked out for any
+  // sample rate. At 48 kHz these match the coefficients in the standard.
+  static BiquadCoefficients getShelfCoefficients(double sampleRate) {
+    constexpr double centreHz = 1681.974450955533;
+    constexpr double gainDb = 3.999843853973347;
+    constexpr double q = 0.7071752369554196;
+
+    const double k = std::tan(std::numbers::pi * centreHz / sampleRate);
+    const double highGain = std::pow(10.0, gainDb / 20.0);
+    const double bandGain = std::pow(highGain, 0.4996667741545416);
+    const double a0 = 1.0 + k / q + k * k;
+
+    return BiquadCoefficients{
+        .b0 = (highGain + bandGain * k / q + k * k) / a0,
+        .b1 = 2.0 * (k * k - highGain) / a0,
+        .b2 = (highGain - bandGain * k / q + k * k) / a0,
+        .a1 = 2.0 * (k * k - 1.0) / a0,
+        .a2 = (1.0 - k / q + k * k) / a0,
+    };
+  }
+
+  static BiquadCoefficients getHighPassCoefficients(double sampleRate) {
+    constexpr double cornerHz = 38.13547087602444;
+    constexpr double q = 0.5003270373238773;
+
+    const double k = std::tan(std::numbers::pi * cornerHz / sampleRate);
+    const double a0 = 1.0 + k / q + k * k;
+
+    return BiquadCoefficients{
+        .b0 = 1.0,
+        .b1 = -2.0,
+        .b2 = 1.0,
+        .a1 = 2.0 * (k * k - 1.0) / a0,
+        .a2 = (1.0 - k / q + k * k) / a0,
+    };
+  }
+
+  static double rt_flushFilterState(double value) {
+    return std::abs(value) < filterStateFloor ? 0.0 : value;
+  }
+
+  // Runs one channel through the K-weighting filter and returns the sum of
+  // the squares of the filtered samples. The filters are recursive, so this
+  // works a sample at a time, but working a channel at a time keeps the state
+  // in registers.
+  double rt_kWeightAndSumSquares(const float* source, int numSamples, KWeightingState& state) {
+    const auto shelf = rt_shelfCoefficients;
+    const auto highPass = rt_highPassCoefficients;
+
+    double shelfZ1 = state.shelfZ1;
+    double shelfZ2 = state.shelfZ2;
+    double highPassZ1 = state.highPassZ1;
+    double highPassZ2 = state.highPassZ2;
+    double sumOfSquares = 0.0;
+
+    for (int sample = 0; sample < numSamples; ++sample) {
+      const double input = static_cast<double>(source[sample]);
+
+      const double shelved = shelf.b0 * input + shelfZ1;
+      shelfZ1 = shelf.b1 * input - shelf.a1 * shelved + shelfZ2;
+      shelfZ2 = shelf.b2 * input - shelf.a2 * shelved;
+
+      const double weighted = highPass.b0 * shelved + highPassZ1;
+      highPassZ1 = highPass.b1 * shelved - highPass.a1 * weighted + highPassZ2;
+      highPassZ2 = highPass.b2 * shelved - highPass.a2 * weighted;
+
+      sumOfSquares += weighted * weighted;
+    }
+
+    state.shelfZ1 = rt_flushFilterState(shelfZ1);
+    state.shelfZ2 = rt_flushFilterState(shelfZ2);
+    state.highPassZ1 = rt_flushFilterState(highPassZ1);
+    state.highPassZ2 = rt_flushFilterState(highPassZ2);
+
+    return sumOfSquares;
+  }
+
+  void rt_accumulateLoudness(
+      const juce::AudioBuffer<float>& audioInBuffer, int channelCount, int start, int length) {
+    while (length > 0) {
+      const int segmentLength = std::min(length, rt_loudnessHopLength - rt_samplesInCurrentHop);
+
+      for (int channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+        rt_currentHopEnergy +=
+            rt_kWeightAndSumSquares(audioInBuffer.getReadPointer(channelIndex, start),
+                segmentLength,
+                rt_channelFilterStates[static_cast<size_t>(channelIndex)]);
+      }
+
+      start += segmentLength;
+      length -= segmentLength;
+      rt_samplesInCurrentHop += segmentLength;
+
+      if (rt_samplesInCurrentHop == rt_loudnessHopLength) {
+        rt_loudnessHopEnergies[rt_loudnessHopWriteIndex] = rt_currentHopEnergy;
+        rt_loudnessHopWriteIndex = (rt_loudnessHopWriteIndex + 1) % rt_loudnessHopEnergies.size();
+        rt_currentHopEnergy = 0.0;
+        rt_samplesInCurrentHop = 0;
+      }
+    }
+  }
+
+  // Loudness over the most recent whole hops. Before the window has filled,
+  // the missing history counts as silence.
+  double rt_getLoudnessLufs() const {
+    const size_t hopCount =
+        rt_mode == Mode::momentaryLoudness ? momentaryLoudnessHopCount : shortTermLoudnessHopCount;
+    const size_t ringSize = rt_loudnessHopEnergies.size();
+    double energy = 0.0;
+
+    for (size_t hop = 1; hop <= hopCount; ++hop) {
+      energy += rt_loudnessHopEnergies[(rt_loudnessHopWriteIndex + ringSize - hop) % ringSize];
+    }
+
+    const auto meanSquare =
+        energy / (static_cast<double>(hopCount) * static_cast<double>(rt_loudnessHopLength));
+
+    if (!(meanSquare > 0.0)) {
+      return silentDb;
+    }
+
+    return -0.691 + 10.0 * std::log10(meanSquare);
+  }
+
   template <typename PublishCallback>
   void rt_publishCurrentWindow(
       int channelCount, int64_t sampleTimestamp, PublishCallback& publish) {
+    const bool isLoudness =
+        rt_mode == Mode::momentaryLoudness || rt_mode == Mode::shortTermLoudness;
+    const double loudness = isLoudness ? rt_getLoudnessLufs() : silentDb;
+
     for (size_t channelIndex = 0; channelIndex < static_cast<size_t>(channelCount);
         ++channelIndex) {
-      publish(channelIndex, rt_peakLinearToDb(rt_channelPeakLinear[channelIndex]), sampleTimestamp);
+      double value = loudness;
+
+      if (rt_mode == Mode::peak) {
+        value = rt_peakLinearToDb(rt_channelPeakLinear[channelIndex]);
+      } else if (rt_mode == Mode::rms) {
+        value = rt_meanSquareToDb(rt_channelSumOfSquares[channelIndex] /
+                                  static_cast<double>(rt_samplesSinceLastPublish));
+      }
+
+      publish(channelIndex, value, sampleTimestamp);
     }
 
     std::fill(rt_channelPeakLinear.begin(), rt_channelPeakLinear.end(), 0.0f);
+    std::fill(rt_channelSumOfSquares.begin(), rt_channelSumOfSquares.end(), 0.0);
+  }
+
+  void rt_resetMeasurements() {
+    std::fill(rt_channelPeakLinear.begin(), rt_channelPeakLinear.end(), 0.0f);
+    std::fill(rt_channelSumOfSquares.begin(), rt_channelSumOfSquares.end(), 0.0);
+    std::fill(rt_channelFilterStates.begin(), rt_channelFilterStates.end(), KWeightingState{});
+    std::fill(rt_loudnessHopEnergies.begin(), rt_loudnessHopEnergies.end(), 0.0);
+
+    rt_samplesSinceLastPublish = 0;
+    rt_loudnessHopWriteIndex = 0;
+    rt_currentHopEnergy = 0.0;
+    rt_samplesInCurrentHop = 0;
   }
 public:
-  void rt_prepare(size_t channelCount) {
+  void rt_prepare(size_t channelCount, double sampleRate) {
+    jassert(sampleRate > 0.0);
+
     rt_channelPeakLinear.assign(channelCount, 0.0f);
-    rt_samplesSinceLastPublish = 0;
+    rt_channelSumOfSquares.assign(channelCount, 0.0);
+    rt_channelFilterStates.assign(channelCount, KWeightingState{});
+    rt_loudnessHopEnergies.assign(shortTermLoudnessHopCount, 0.0);
+
+    rt_shelfCoefficients = getShelfCoefficients(sampleRate);
+    rt_highPassCoefficients = getHighPassCoefficients(sampleRate);
+    rt_loudnessHopLength =
+        std::max(1, static_cast<int>(std::lround(sampleRate * loudnessHopSeconds)));
+
+    rt_resetMeasurements();
+  }
+
+  // Switching modes starts the measurement over.
+  void rt_setMode(Mode mode) {
+    if (mode == rt_mode) {
+      return;
+    }
+
+    rt_mode = mode;
+    rt_resetMeasurements();
+  }
+
+  Mode rt_getMode() const {
+    return rt_mode;
   }
 
   template <typename PublishCallback>
@@ -81,18 +333,47 @@ public:
 
     const int64_t rt_publishEveryClamped = std::max<int64_t>(1, publishEverySamples);
 
-    for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex) {
-      for (int channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
-        const float absoluteSample = std::abs(audioInBuffer.getSample(channelIndex, sampleIndex));
-        rt_channelPeakLinear[static_cast<size_t>(channelIndex)] =
-            std::max(rt_channelPeakLinear[static_cast<size_t>(channelIndex)], absoluteSample);
+    // The block is scanned in runs that end at each publish point, so each
+    // channel's measurement for a run is made with one pass over it.
+    int runStart = 0;
+
+    while (runStart < numSamples) {
+      // The interval can shrink between blocks, so this is at least one.
+      const auto samplesUntilPublish =
+          std::max<int64_t>(1, rt_publishEveryClamped - rt_samplesSinceLastPublish);
+      const int runLength = static_cast<int>(
+          std::min<int64_t>(samplesUntilPublish, static_cast<int64_t>(numSamples - runStart)));
+
+      switch (rt_mode) {
+        case Mode::peak:
+          for (int channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+            const float runPeak =
+                simd::rt_absMax(audioInBuffer.getReadPointer(channelIndex, runStart), runLength);
+
+            // std::max keeps the current peak if runPeak is NaN, so a NaN in
+            // the input doesn't stick to the meter.
+            auto& channelPeak = rt_channelPeakLinear[static_cast<size_t>(channelIndex)];
+            channelPeak = std::max(channelPeak, runPeak);
+          }
+          break;
+        case Mode::rms:
+          for (int channelIndex = 0; channelIndex < channelCount; ++channelIndex) {
+            rt_channelSumOfSquares[static_cast<size_t>(channelIndex)] += simd::rt_sumOfSquares(
+                audioInBuffer.getReadPointer(channelIndex, runStart), runLength);
+          }
+          break;
+        case Mode::momentaryLoudness:
+        case Mode::shortTermLoudness:
+          rt_accumulateLoudness(audioInBuffer, channelCount, runStart, runLength);
+          break;
       }
 
-      rt_samplesSinceLastPublish++;
+      runStart += runLength;
+      rt_samplesSinceLastPublish += runLength;
 
       if (rt_samplesSinceLastPublish >= rt_publishEveryClamped) {
         rt_publishCurrentWindow(
-            channelCount, blockStartSample + static_cast<int64_t>(sampleIndex) + 1, publish);
+            channelCount, blockStartSample + static_cast<int64_t>(runStart), publish);
         rt_samplesSinceLastPublish = 0;
       }
     }
@@ -20,6 +20,10 @@
 #include "gain.h"
 
 #include "modules/processing_graph/runtime/node_process_context.h"
+#include "modules/processors/gain_parameter_lookup.h"
+#include "modules/util/simd/simd_kernels.h"
+
+#include <algorithm>
 
 namespace anthem {
 
@@ -35,16 +39,36 @@ void GainProcessor::process(NodeProcessContext& context, int numSamples) {
   auto& audioOutBuffer = context.getOutputAudioBuffer(GainProcessorModelBase::audioOutputPortId);
 
   auto& amplitudeControlBuffer = context.getInputControlBuffer(GainProcessorModelBase::gainPortId);
+  const auto amplitudeShape =
+      context.getInputControlBufferShape(GainProcessorModelBase::gainPortId);
 
-  for (int sample = 0; sample < numSamples; sample++) {
-    auto paramValue = amplitudeControlBuffer.getReadPointer(0)[sample];
-    float targetGain = paramValueToGainLinear(paramValue);
+  // A settled gain only needs mapping once for the whole block.
+  if (amplitudeShape.isConstant()) {
+    const auto gain = paramValueToGainLinear(amplitudeShape.startValue);
 
     for (int channel = 0; channel < audioOutBuffer.getNumChannels(); ++channel) {
-      auto inputSample = audioInBuffer.getReadPointer(channel)[sample];
-      auto outputSample = inputSample * targetGain;
+      simd::rt_multiply(audioOutBuffer.getWritePointer(channel),
+          audioInBuffer.getReadPointer(channel),
+          gain,
+          numSamples);
+    }
+
+    return;
+  }
 
-      audioOutBuffer.getWritePointer(channel)[sample] = outputSample;
+  const auto* paramValues = amplitudeControlBuffer.getReadPointer(0);
+  float gains[simd::tileSize];
+
+  for (int tileStart = 0; tileStart < numSamples; tileStart += simd::tileSize) {
+    const auto tileLength = std::min(simd::tileSize, numSamples - tileStart);
+
+    rt_gainParameterValuesToLinear(gains, paramValues + tileStart, tileLength);
+
+    for (int channel = 0; channel < audioOutBuffer.getNumChannels(); ++channel) {
+      simd::rt_multiply(audioOutBuffer.getWritePointer(channel) + tileStart,
+          audioInBuffer.getReadPointer(channel) + tileStart,
+          gains,
+          tileLength);
     }
   }
 }
@@ -46,6 +46,14 @@ public:
 
   void prepareToProcess() override;
   void process(NodeProcessContext& context, int numSamples) override;
+
+  int64_t getTailLengthSamples() const override {
+    return 0;
+  }
+
+  std::vector<InPlaceAudioPortPair> getInPlaceAudioPortPairs() const override {
+    return {{GainProcessorModelBase::audioInputPortId, GainProcessorModelBase::audioOutputPortId}};
+  }
 };
 
 } // namespace anthem
@@ -0,0 +1,175 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "gain_parameter_lookup.h"
+
+#include "modules/processors/gain_parameter_mapping.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+namespace anthem {
+
+namespace {
+
+// The curve section rises very steeply from its start, so it can't use evenly
+// spaced entries. Instead, it's looked up by the bits of the position within
+// the section, which puts 2^curveTableMantissaBits entries in each power of
+// two. The spacing then stays in proportion to the position, all the way down
+// to 2^-curveTableOctaves. Float parameter values never get closer than that
+// to the start of the section.
+constexpr int curveTableMantissaBits = 7;
+constexpr int curveTableOctaves = 30;
+constexpr int curveTableSize = (curveTableOctaves << curveTableMantissaBits) + 1;
+
+constexpr int floatMantissaBits = 23;
+constexpr int curveTableIndexShift = floatMantissaBits - curveTableMantissaBits;
+constexpr int32_t curveTableFractionMask = (1 << curveTableIndexShift) - 1;
+constexpr float curveTableFractionScale = 1.0f / static_cast<float>(1 << curveTableIndexShift);
+
+// The float bits of 2^-curveTableOctaves, the position of the first entry.
+constexpr int32_t curveTableFirstBits = (127 - curveTableOctaves) << floatMantissaBits;
+constexpr int32_t curveTableFirstIndex = curveTableFirstBits >> curveTableIndexShift;
+
+// Gain in dB is linear in the parameter value in the upper section, so the
+// linear gain is exponential and smooth enough for evenly spaced entries.
+constexpr int upperTableIntervals = 1024;
+constexpr float upperSectionStart = static_cast<float>(kGainParameterCurveSectionCeilingNormalized);
+constexpr int32_t upperSectionStartBits = std::bit_cast<int32_t>(upperSectionStart);
+constexpr float upperTableScale = static_cast<float>(
+    upperTableIntervals / (1.0 - kGainParameterCurveSectionCeilingNormalized));
+
+constexpr int32_t oneBits = std::bit_cast<int32_t>(1.0f);
+
+// gainParameterValueToDb() compares in double precision, so the curve section
+// starts at the first float that isn't below its ceiling in double.
+float getCurveSectionStart() {
+  auto start = static_cast<float>(kGainParameterLinearSectionCeilingNormalized);
+
+  if (static_cast<double>(start) < kGainParameterLinearSectionCeilingNormalized) {
+    start = std::nextafter(start, 1.0f);
+  }
+
+  return start;
+}
+
+const float curveSectionStart = getCurveSectionStart();
+const int32_t curveSectionStartBits = std::bit_cast<int32_t>(curveSectionStart);
+
+// Maps a parameter value to its position within the curve section. The
+// subtraction is done against the float start, which is exact near the start,
+// and the difference between that and the true start is added back after.
+const float curvePositionScale = static_cast<float>(
+    1.0 / (kGainParameterCurveSectionCeilingNormalized -
+              kGainParameterLinearSectionCeilingNormalized));
+const float curvePositionOffset = static_cast<float>(
+    (static_cast<double>(curveSectionStart) - kGainParameterLinearSectionCeilingNormalized) *
+    curvePositionScale);
+
+// In the linear section, the gain is the parameter value scaled so that the
+// top of the section lands on the section's ceiling in dB.
+const float linearSectionGainScale =
+    static_cast<float>(std::pow(10.0, kGainParameterLinearSectionCeilingDb / 20.0) /
+                       kGainParameterLinearSectionCeilingNormalized);
+
+const std::array<float, curveTableSize> curveTable = []() {
+  std::array<float, curveTableSize> table{};
+
+  for (size_t index = 0; index < table.size(); ++index) {
+    const auto position = std::bit_cast<float>(
+        (curveTableFirstIndex + static_cast<int32_t>(index)) << curveTableIndexShift);
+    table[index] = gainDbToLinear(gainParameterCurvePositionToDb(position));
+  }
+
+  return table;
+}();
+
+const std::array<float, upperTableIntervals + 1> upperTable = []() {
+  std::array<float, upperTableIntervals + 1> table{};
+
+  for (size_t index = 0; index < table.size(); ++index) {
+    // These land exactly on floats, so the mapping can be used as-is.
+    const auto parameterValue = static_cast<float>(
+        kGainParameterCurveSectionCeilingNormalized +
+        static_cast<double>(index) * (1.0 - kGainParameterCurveSectionCeilingNormalized) /
+            upperTableIntervals);
+    table[index] = gainParameterValueToLinear(parameterValue);
+  }
+
+  return table;
+}();
+
+} // namespace
+
+// Each sample is looked up in both tables, and the result for its section is
+// picked at the end, so that the loop has no branches and can be vectorised.
+//
+// Non-negative floats sort the same way as their bits do as integers, so the
+// clamping and section checks are done on the bits. The compiler won't
+// vectorise float comparisons here without fast-math, and for the same
+// reason, the result is picked with masks rather than a conditional.
+//
+// Unlike the kernels in modules/util/simd, this isn't multiversioned, because
+// GCC won't vectorise the table lookups in the AVX clones. The baseline build
+// still vectorises it.
+void rt_gainParameterValuesToLinear(
+    float* destination, const float* parameterValues, int numSamples) {
+  for (int sample = 0; sample < numSamples; ++sample) {
+    const int32_t valueBits =
+        std::clamp(std::bit_cast<int32_t>(parameterValues[sample]), int32_t{0}, oneBits);
+    const float value = std::bit_cast<float>(valueBits);
+
+    const float linearGain = value * linearSectionGainScale;
+
+    // Outside each table's section, its index is clamped to keep it in the
+    // table, and the result isn't used.
+    const int32_t curvePositionBits = std::bit_cast<int32_t>(
+        (value - curveSectionStart) * curvePositionScale + curvePositionOffset);
+    const auto curveIndex = static_cast<size_t>(
+        std::clamp((curvePositionBits >> curveTableIndexShift) - curveTableFirstIndex,
+            int32_t{0},
+            int32_t{curveTableSize - 2}));
+    const float curveFraction =
+        static_cast<float>(curvePositionBits & curveTableFractionMask) * curveTableFractionScale;
+    const float curveGain = curveTable[curveIndex] +
+                            (curveTable[curveIndex + 1] - curveTable[curveIndex]) * curveFraction;
+
+    const float upperPosition = (value - upperSectionStart) * upperTableScale;
+    const int upperIndex =
+        std::clamp(static_cast<int>(upperPosition), 0, upperTableIntervals - 1);
+    const float upperFraction = upperPosition - static_cast<float>(upperIndex);
+    const auto upperEntry = static_cast<size_t>(upperIndex);
+    const float upperGain = upperTable[upperEntry] +
+                            (upperTable[upperEntry + 1] - upperTable[upperEntry]) * upperFraction;
+
+    const int32_t linearMask = -static_cast<int32_t>(valueBits < curveSectionStartBits);
+    const int32_t upperMask = -static_cast<int32_t>(valueBits >= upperSectionStartBits);
+    const int32_t curveMask = ~(linearMask | upperMask);
+
+    destination[sample] =
+        std::bit_cast<float>((std::bit_cast<int32_t>(linearGain) & linearMask) |
+                             (std::bit_cast<int32_t>(curveGain) & curveMask) |
+                             (std::bit_cast<int32_t>(upperGain) & upperMask));
+  }
+}
+
+} // namespace anthem
@@ -0,0 +1,38 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+// A faster way to turn gain parameter values into linear gain, for processors
+// that do it for every sample.
+//
+// gainParameterValueToLinear() calls std::pow() for values in the curve
+// section of the mapping. These functions use precomputed tables instead, and
+// stay within 0.0003 dB of it, the tolerance the Dart integration test holds
+// the mapping to, for any value from the curve section up. Below that, in the
+// linear section, the gain is under -180 dB and is computed directly.
+
+namespace anthem {
+
+// Converts each [0.0, 1.0] gain parameter value to linear gain. destination
+// may be the same as parameterValues.
+void rt_gainParameterValuesToLinear(
+    float* destination, const float* parameterValues, int numSamples);
+
+} // namespace anthem
@@ -66,6 +66,14 @@ inline float gainDbToLinear(float db) {
   return bw_dB2linf(db);
 }
 
+// Maps a position in [0.0, 1.0) within the curve section to dB.
+inline float gainParameterCurvePositionToDb(double curvePosition) {
+  return static_cast<float>(
+      kGainParameterLinearSectionCeilingDb +
+      std::pow(curvePosition, 1.0 / kGainParameterCurveExponent) *
+          (kGainParameterCurveSectionCeilingDb - kGainParameterLinearSectionCeilingDb));
+}
+
 inline float gainParameterValueToDb(float parameterValue) {
   const double rawValue = static_cast<double>(parameterValue);
 
@@ -80,10 +88,7 @@ inline float gainParameterValueToDb(float parameterValue) {
                                    (kGainParameterCurveSectionCeilingNormalized -
                                        kGainParameterLinearSectionCeilingNormalized);
 
-    return static_cast<float>(
-        kGainParameterLinearSectionCeilingDb +
-        std::pow(normalizedValue, 1.0 / kGainParameterCurveExponent) *
-            (kGainParameterCurveSectionCeilingDb - kGainParameterLinearSectionCeilingDb));
+    return gainParameterCurvePositionToDb(normalizedValue);
   }
 
   return static_cast<float>(64.0 * (rawValue - kGainParameterZeroDbNormalized));
@@ -21,6 +21,7 @@
 
 #include "modules/core/engine.h"
 #include "modules/processing_graph/runtime/node_process_context.h"
+#include "modules/util/simd/simd_kernels.h"
 
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_core/juce_core.h>
@@ -49,8 +50,11 @@ void MasterOutputProcessor::prepareToProcess() {
 void MasterOutputProcessor::process(NodeProcessContext& context, int numSamples) {
   auto& inputBuffer = context.getInputAudioBuffer(MasterOutputProcessorModelBase::inputPortId);
 
+  // A NaN or infinity here would reach the audio device, so those samples are
+  // replaced with silence.
   for (int channel = 0; channel < buffer.getNumChannels(); channel++) {
-    this->buffer.copyFrom(channel, 0, inputBuffer, channel, 0, numSamples);
+    simd::rt_sanitiseAndCopy(
+        buffer.getWritePointer(channel), inputBuffer.getReadPointer(channel), numSamples);
   }
 }
 
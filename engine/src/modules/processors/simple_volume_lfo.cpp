@@ -20,6 +20,9 @@
 #include "simple_volume_lfo.h"
 
 #include "modules/processing_graph/runtime/node_process_context.h"
+#include "modules/util/simd/simd_kernels.h"
+
+#include <algorithm>
 
 namespace anthem {
 
@@ -54,14 +57,22 @@ void SimpleVolumeLfoProcessor::process(NodeProcessContext& context, int numSampl
   auto& outputBuffer =
       context.getOutputAudioBuffer(SimpleVolumeLfoProcessorModelBase::audioOutputPortId);
 
-  // Generate a sine wave
-  for (int sample = 0; sample < numSamples; ++sample) {
-    for (int channel = 0; channel < outputBuffer.getNumChannels(); ++channel) {
-      const float inputValue = inputBuffer.getSample(channel, sample);
-      outputBuffer.getWritePointer(channel)[sample] = inputValue * rt_state.rt_amplitude;
+  float amplitudes[simd::tileSize];
+
+  for (int tileStart = 0; tileStart < numSamples; tileStart += simd::tileSize) {
+    const auto tileLength = std::min(simd::tileSize, numSamples - tileStart);
+
+    for (int sample = 0; sample < tileLength; ++sample) {
+      amplitudes[sample] = rt_state.rt_amplitude;
+      rt_advanceState(rt_state, rt_rate);
     }
 
-    rt_advanceState(rt_state, rt_rate);
+    for (int channel = 0; channel < outputBuffer.getNumChannels(); ++channel) {
+      simd::rt_multiply(outputBuffer.getWritePointer(channel) + tileStart,
+          inputBuffer.getReadPointer(channel) + tileStart,
+          amplitudes,
+          tileLength);
+    }
   }
 }
 
@@ -49,6 +49,11 @@ public:
 
   void prepareToProcess() override;
   void process(NodeProcessContext& context, int numSamples) override;
+
+  std::vector<InPlaceAudioPortPair> getInPlaceAudioPortPairs() const override {
+    return {{SimpleVolumeLfoProcessorModelBase::audioInputPortId,
+        SimpleVolumeLfoProcessorModelBase::audioOutputPortId}};
+  }
 };
 
 } // namespace anthem
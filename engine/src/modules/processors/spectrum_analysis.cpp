@@ -0,0 +1,243 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "spectrum_analysis.h"
+
+#include "modules/util/simd/simd_kernels.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numbers>
+
+namespace anthem {
+
+SpectrumAnalyzerTap::SpectrumAnalyzerTap(int chunkCapacity)
+  : fifo(chunkCapacity + 1),
+    chunkSamples(static_cast<size_t>(chunkCapacity + 1) * static_cast<size_t>(chunkLength)),
+    chunkEndTimestamps(static_cast<size_t>(chunkCapacity + 1)) {
+  jassert(chunkCapacity > 0 &&
+          chunkCapacity < std::numeric_limits<int>::max() / chunkLength - 1);
+}
+
+void SpectrumAnalyzerTap::rt_write(
+    const float* const* channels, int numChannels, int numSamples, int64_t blockStartSample) {
+  if (!rt_isEnabled() || numChannels <= 0) {
+    rt_pendingLength = 0;
+    return;
+  }
+
+  const float channelGain = 1.0f / static_cast<float>(numChannels);
+  int position = 0;
+
+  while (position < numSamples) {
+    const int length = std::min(numSamples - position, chunkLength - rt_pendingLength);
+    auto* destination = rt_pendingChunk.data() + rt_pendingLength;
+
+    simd::rt_multiply(destination, channels[0] + position, channelGain, length);
+
+    for (int channel = 1; channel < numChannels; ++channel) {
+      simd::rt_mixAccumulate(destination, channels[channel] + position, channelGain, length);
+    }
+
+    position += length;
+    rt_pendingLength += length;
+
+    if (rt_pendingLength < chunkLength) {
+      continue;
+    }
+
+    rt_pendingLength = 0;
+
+    int start1 = 0;
+    int size1 = 0;
+    int start2 = 0;
+    int size2 = 0;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 <= 0) {
+      droppedChunkCount.fetch_add(1, std::memory_order_relaxed);
+      continue;
+    }
+
+    const auto slot = static_cast<size_t>(start1);
+    std::memcpy(chunkSamples.data() + slot * static_cast<size_t>(chunkLength),
+        rt_pendingChunk.data(),
+        sizeof(float) * static_cast<size_t>(chunkLength));
+    chunkEndTimestamps[slot] = blockStartSample + static_cast<int64_t>(position);
+
+    fifo.finishedWrite(1);
+  }
+}
+
+std::optional<int64_t> SpectrumAnalyzerTap::readChunk(float* destination) {
+  int start1 = 0;
+  int size1 = 0;
+  int start2 = 0;
+  int size2 = 0;
+  fifo.prepareToRead(1, start1, size1, start2, size2);
+
+  if (size1 <= 0) {
+    return std::nullopt;
+  }
+
+  const auto slot = static_cast<size_t>(start1);
+  std::memcpy(destination,
+      chunkSamples.data() + slot * static_cast<size_t>(chunkLength),
+      sizeof(float) * static_cast<size_t>(chunkLength));
+  const auto endTimestamp = chunkEndTimestamps[slot];
+
+  fifo.finishedRead(1);
+
+  return endTimestamp;
+}
+
+void SpectrumAnalyzerTap::discardQueued() {
+  fifo.finishedRead(fifo.getNumReady());
+}
+
+void SpectrumAnalyzerTap::setEnabled(bool newEnabled) {
+  enabled.store(newEnabled, std::memory_order_relaxed);
+}
+
+uint64_t SpectrumAnalyzerTap::getDroppedChunkCount() const {
+  return droppedChunkCount.load(std::memory_order_relaxed);
+}
+
+SpectrumAnalysisConfig SpectrumAnalysis::clampConfig(const SpectrumAnalysisConfig& config) {
+  int fftSize = minFftSize;
+
+  while (fftSize < config.fftSize && fftSize < maxFftSize) {
+    fftSize *= 2;
+  }
+
+  return SpectrumAnalysisConfig{
+      .fftSize = fftSize,
+      .overlap = std::clamp(config.overlap, 1, std::min(maxOverlap, fftSize)),
+      .binCount = std::clamp(config.binCount, 1, maxBinCount),
+  };
+}
+
+SpectrumAnalysis::SpectrumAnalysis(const SpectrumAnalysisConfig& requestedConfig, double sampleRate)
+  : config(clampConfig(requestedConfig)), hopSize(config.fftSize / config.overlap),
+    fft(config.fftSize) {
+  jassert(sampleRate > 0.0);
+
+  const auto fftSize = static_cast<size_t>(config.fftSize);
+
+  // A periodic Hann window, which overlaps evenly at every overlap setting
+  // above 1.
+  window.resize(fftSize);
+  double windowSum = 0.0;
+
+  for (size_t index = 0; index < fftSize; ++index) {
+    const double value =
+        0.5 - 0.5 * std::cos(2.0 * std::numbers::pi * static_cast<double>(index) /
+                             static_cast<double>(fftSize));
+    window[index] = static_cast<float>(value);
+    windowSum += value;
+  }
+
+  // A sine's energy is split between the positive and negative frequency
+  // bins, hence the 2.
+  magnitudeScale = static_cast<float>(2.0 / windowSum);
+
+  const double binHz = sampleRate / static_cast<double>(fftSize);
+  const double topHz = std::min(maxFrequencyHz, sampleRate * 0.5);
+  const double bottomHz = std::min(minFrequencyHz, topHz * 0.5);
+  const int lastBin = config.fftSize / 2;
+
+  bands.resize(static_cast<size_t>(config.binCount));
+
+  for (int bandIndex = 0; bandIndex < config.binCount; ++bandIndex) {
+    const double lowHz =
+        bottomHz * std::pow(topHz / bottomHz, static_cast<double>(bandIndex) / config.binCount);
+    const double highHz = bottomHz * std::pow(topHz / bottomHz,
+                                         static_cast<double>(bandIndex + 1) / config.binCount);
+
+    const int firstBin = std::clamp(static_cast<int>(std::ceil(lowHz / binHz)), 0, lastBin);
+    const int endBin = std::clamp(static_cast<int>(std::ceil(highHz / binHz)), 0, lastBin + 1);
+    auto& band = bands[static_cast<size_t>(bandIndex)];
+
+    if (endBin > firstBin) {
+      band.firstBin = firstBin;
+      band.binSpan = endBin - firstBin;
+      continue;
+    }
+
+    // No bin falls in the band, so the band reads the spectrum at its centre.
+    const double centreBin = std::sqrt(lowHz * highHz) / binHz;
+    band.firstBin = std::clamp(static_cast<int>(centreBin), 0, lastBin - 1);
+    band.binSpan = 0;
+    band.interpolation =
+        static_cast<float>(std::clamp(centreBin - static_cast<double>(band.firstBin), 0.0, 1.0));
+  }
+
+  history.assign(fftSize, 0.0f);
+  fftBuffer.resize(fftSize);
+  binMagnitudes.resize(static_cast<size_t>(lastBin + 1));
+  binsDb.assign(static_cast<size_t>(config.binCount), silentDb);
+}
+
+void SpectrumAnalysis::appendToHistory(const float* samples, int numSamples) {
+  while (numSamples > 0) {
+    const int length = std::min(numSamples, config.fftSize - historyWritePosition);
+
+    std::memcpy(history.data() + historyWritePosition, samples, sizeof(float) * length);
+
+    samples += length;
+    numSamples -= length;
+    historyWritePosition = (historyWritePosition + length) % config.fftSize;
+  }
+}
+
+void SpectrumAnalysis::analyseHistory() {
+  const auto fftSize = static_cast<size_t>(config.fftSize);
+
+  // The oldest sample is at the write position.
+  for (size_t index = 0; index < fftSize; ++index) {
+    const auto historyIndex = (static_cast<size_t>(historyWritePosition) + index) % fftSize;
+    fftBuffer[index] = std::complex<float>(history[historyIndex] * window[index], 0.0f);
+  }
+
+  fft.perform(fftBuffer.data());
+
+  for (size_t bin = 0; bin < binMagnitudes.size(); ++bin) {
+    binMagnitudes[bin] = std::abs(fftBuffer[bin]) * magnitudeScale;
+  }
+
+  for (size_t bandIndex = 0; bandIndex < bands.size(); ++bandIndex) {
+    const auto& band = bands[bandIndex];
+    const auto first = static_cast<size_t>(band.firstBin);
+    float magnitude = 0.0f;
+
+    if (band.binSpan > 0) {
+      const auto bandBegin = binMagnitudes.begin() + band.firstBin;
+      magnitude = *std::max_element(bandBegin, bandBegin + band.binSpan);
+    } else {
+      magnitude = binMagnitudes[first] +
+                  (binMagnitudes[first + 1] - binMagnitudes[first]) * band.interpolation;
+    }
+
+    binsDb[bandIndex] =
+        magnitude > 0.0f ? 20.0 * std::log10(static_cast<double>(magnitude)) : silentDb;
+  }
+}
+
+} // namespace anthem
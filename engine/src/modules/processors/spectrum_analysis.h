@@ -0,0 +1,192 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "modules/util/fft.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <complex>
+#include <cstdint>
+#include <juce_core/juce_core.h>
+#include <optional>
+#include <vector>
+
+namespace anthem {
+
+// Carries audio from a SpectrumAnalyzerProcessor on the audio thread to its
+// analysis thread.
+//
+// The audio thread mixes its input down to mono and queues it in chunks of
+// chunkLength samples, each with the timestamp of the sample after its end.
+// This is a preallocated single-producer, single-consumer queue, so writing
+// never blocks. If the analysis thread falls behind and the queue fills up,
+// new chunks are dropped and counted.
+class SpectrumAnalyzerTap {
+public:
+  static constexpr int chunkLength = 256;
+
+  explicit SpectrumAnalyzerTap(int chunkCapacity);
+
+  SpectrumAnalyzerTap(const SpectrumAnalyzerTap&) = delete;
+  SpectrumAnalyzerTap& operator=(const SpectrumAnalyzerTap&) = delete;
+
+  SpectrumAnalyzerTap(SpectrumAnalyzerTap&&) = delete;
+  SpectrumAnalyzerTap& operator=(SpectrumAnalyzerTap&&) = delete;
+
+  // Producer only. While the tap is disabled, this only drops the partial
+  // chunk, so it should still be called every block.
+  void rt_write(const float* const* channels,
+      int numChannels,
+      int numSamples,
+      int64_t blockStartSample);
+
+  // Consumer only. Copies the oldest queued chunk to destination, which must
+  // hold chunkLength samples, and returns its end timestamp. Returns nullopt
+  // if nothing is queued.
+  std::optional<int64_t> readChunk(float* destination);
+
+  // Consumer only. Throws away every queued chunk.
+  void discardQueued();
+
+  // Consumer only. Starts or stops the producer writing to the tap, so no
+  // work is done on the audio thread while nobody is watching.
+  void setEnabled(bool enabled);
+
+  bool rt_isEnabled() const {
+    return enabled.load(std::memory_order_relaxed);
+  }
+
+  uint64_t getDroppedChunkCount() const;
+private:
+  juce::AbstractFifo fifo;
+  std::vector<float> chunkSamples;
+  std::vector<int64_t> chunkEndTimestamps;
+
+  // The chunk the producer is filling
+  std::array<float, chunkLength> rt_pendingChunk{};
+  int rt_pendingLength = 0;
+
+  std::atomic<bool> enabled = false;
+  std::atomic<uint64_t> droppedChunkCount = 0;
+};
+
+struct SpectrumAnalysisConfig {
+  // Samples per FFT. This is rounded up to a power of two.
+  int fftSize = 2048;
+
+  // How many FFTs cover each sample, so a new spectrum is made every
+  // fftSize / overlap samples.
+  int overlap = 4;
+
+  // How many log-spaced bands the spectrum is reduced to.
+  int binCount = 64;
+
+  bool operator==(const SpectrumAnalysisConfig&) const = default;
+};
+
+// Turns a stream of mono samples into log-binned spectra.
+//
+// Every fftSize / overlap samples, the most recent fftSize samples are
+// Hann-windowed and transformed, and the magnitudes are reduced to binCount
+// bands spaced evenly in log frequency between minFrequencyHz and
+// maxFrequencyHz, or Nyquist if that's lower. Each band takes the loudest FFT
+// bin within it. Narrow low bands that fall between FFT bins are
+// interpolated instead.
+//
+// Values are in dBFS, scaled so that a full scale sine centred on an FFT bin
+// reads 0 dB.
+class SpectrumAnalysis {
+public:
+  static constexpr int minFftSize = 64;
+  static constexpr int maxFftSize = 32768;
+  static constexpr int maxOverlap = 32;
+  static constexpr int maxBinCount = 1024;
+
+  static constexpr double minFrequencyHz = 20.0;
+  static constexpr double maxFrequencyHz = 20000.0;
+
+  // Used for bands with no energy
+  static constexpr double silentDb = -600.0;
+
+  // Out of range config values are clamped.
+  SpectrumAnalysis(const SpectrumAnalysisConfig& config, double sampleRate);
+
+  // The config after clamping
+  const SpectrumAnalysisConfig& getConfig() const {
+    return config;
+  }
+
+  // Adds samples to the history. endTimestamp is the timestamp of the sample
+  // after the last one. onSpectrum(const std::vector<double>& binsDb,
+  // int64_t sampleTimestamp) is called for each spectrum made along the way,
+  // with the timestamp of the sample after the end of its window.
+  template <typename SpectrumCallback>
+  void addSamples(
+      const float* samples, int numSamples, int64_t endTimestamp, SpectrumCallback&& onSpectrum) {
+    int position = 0;
+
+    while (position < numSamples) {
+      const int length = std::min(numSamples - position, hopSize - samplesSinceSpectrum);
+
+      appendToHistory(samples + position, length);
+      position += length;
+      samplesSinceSpectrum += length;
+
+      if (samplesSinceSpectrum == hopSize) {
+        samplesSinceSpectrum = 0;
+        analyseHistory();
+        onSpectrum(binsDb, endTimestamp - static_cast<int64_t>(numSamples - position));
+      }
+    }
+  }
+private:
+  // An output band covers the FFT bins [firstBin, firstBin + binSpan). A band
+  // with no bins in it is interpolated between firstBin and firstBin + 1.
+  struct Band {
+    int firstBin = 0;
+    int binSpan = 0;
+    float interpolation = 0.0f;
+  };
+
+  static SpectrumAnalysisConfig clampConfig(const SpectrumAnalysisConfig& config);
+
+  void appendToHistory(const float* samples, int numSamples);
+  void analyseHistory();
+
+  SpectrumAnalysisConfig config;
+  int hopSize;
+  Fft fft;
+  std::vector<float> window;
+  float magnitudeScale;
+  std::vector<Band> bands;
+
+  // A ring of the most recent fftSize samples
+  std::vector<float> history;
+  int historyWritePosition = 0;
+  int samplesSinceSpectrum = 0;
+
+  std::vector<std::complex<float>> fftBuffer;
+  std::vector<float> binMagnitudes;
+  std::vector<double> binsDb;
+};
+
+} // namespace anthem
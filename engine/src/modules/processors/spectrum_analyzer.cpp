@@ -0,0 +1,323 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "spectrum_analyzer.h"
+
+#include "modules/core/engine.h"
+#include "modules/core/visualization/visualization_broker.h"
+#include "modules/processing_graph/runtime/node_process_context.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace anthem {
+
+namespace {
+
+// About 340 ms of audio at 48 kHz
+constexpr int tapChunkCapacity = 64;
+
+constexpr int analysisIntervalMs = 10;
+constexpr int idleIntervalMs = 100;
+constexpr int analysisThreadStopTimeoutMs = 2000;
+
+// The broker asks for data on every update while the UI is subscribed, so
+// missing several updates in a row means nothing is watching any more. The
+// timeout follows the broker's update interval, with a floor so that a short
+// stall on the message thread doesn't pause analysis.
+constexpr double missedUpdatesBeforeTimeout = 4.0;
+constexpr uint32_t minRequestTimeoutMs = 500;
+
+uint32_t getRequestTimeoutMs() {
+  const auto updateIntervalMs = VisualizationBroker::getInstance().getUpdateIntervalMs();
+
+  return std::max(minRequestTimeoutMs,
+      static_cast<uint32_t>(updateIntervalMs * missedUpdatesBeforeTimeout));
+}
+
+} // namespace
+
+std::optional<NumericVisualizationData> SpectrumVisualizationProvider::getTypedData() {
+  lastRequestMilliseconds.store(juce::Time::getMillisecondCounter(), std::memory_order_relaxed);
+  hasBeenRequested.store(true, std::memory_order_relaxed);
+
+  int64_t sampleTimestamp = 0;
+
+  {
+    const juce::SpinLock::ScopedLockType lock(spectrumLock);
+
+    if (!hasNewSpectrum) {
+      return std::nullopt;
+    }
+
+    std::swap(readBinsDb, latestBinsDb);
+    sampleTimestamp = latestSampleTimestamp;
+    hasNewSpectrum = false;
+  }
+
+  return NumericVisualizationData{
+      .sampleTimestamps = std::vector<int64_t>(readBinsDb.size(), sampleTimestamp),
+      .values = readBinsDb,
+  };
+}
+
+void SpectrumVisualizationProvider::publish(
+    const std::vector<double>& binsDb, int64_t sampleTimestamp) {
+  // This only allocates when the bin count grows.
+  publishBinsDb.assign(binsDb.begin(), binsDb.end());
+
+  const juce::SpinLock::ScopedLockType lock(spectrumLock);
+
+  std::swap(publishBinsDb, latestBinsDb);
+  latestSampleTimestamp = sampleTimestamp;
+  hasNewSpectrum = true;
+}
+
+bool SpectrumVisualizationProvider::isRequested() const {
+  if (!hasBeenRequested.load(std::memory_order_relaxed)) {
+    return false;
+  }
+
+  // Unsigned subtraction, so this still works when the counter wraps.
+  const auto sinceLastRequest = juce::Time::getMillisecondCounter() -
+                                lastRequestMilliseconds.load(std::memory_order_relaxed);
+
+  return sinceLastRequest < getRequestTimeoutMs();
+}
+
+// The analysis state for one analyzer. Only the analysis thread touches
+// this, apart from the shared pointers it was made with.
+class SpectrumAnalyzerProcessor::AnalysisJob {
+public:
+  AnalysisJob(std::shared_ptr<SpectrumAnalyzerTap> tap,
+      std::shared_ptr<SpectrumVisualizationProvider> provider,
+      std::shared_ptr<Settings> settings)
+    : tap(std::move(tap)), provider(std::move(provider)), settings(std::move(settings)),
+      chunk(static_cast<size_t>(SpectrumAnalyzerTap::chunkLength)) {}
+
+  // Analyzes everything queued in the tap. Returns false if nothing is
+  // subscribed to the provider, in which case the tap is switched off.
+  bool run() {
+    const bool isRequested = provider->isRequested();
+    tap->setEnabled(isRequested);
+
+    if (!isRequested) {
+      // Throws away anything queued before the tap was switched off, and the
+      // history with it, so a new subscriber doesn't see stale audio.
+      tap->discardQueued();
+      analysis.reset();
+      return false;
+    }
+
+    updateAnalysis();
+
+    while (const auto endTimestamp = tap->readChunk(chunk.data())) {
+      analysis->addSamples(chunk.data(),
+          SpectrumAnalyzerTap::chunkLength,
+          *endTimestamp,
+          [this](const std::vector<double>& binsDb, int64_t sampleTimestamp) {
+            provider->publish(binsDb, sampleTimestamp);
+          });
+    }
+
+    return true;
+  }
+private:
+  // Starts the analysis over if the settings have changed.
+  void updateAnalysis() {
+    const SpectrumAnalysisConfig config{
+        .fftSize = settings->fftSize.load(std::memory_order_relaxed),
+        .overlap = settings->overlap.load(std::memory_order_relaxed),
+        .binCount = settings->binCount.load(std::memory_order_relaxed),
+    };
+    const auto sampleRate = settings->sampleRate.load(std::memory_order_relaxed);
+
+    if (analysis != nullptr && config == analysisConfig && sampleRate == analysisSampleRate) {
+      return;
+    }
+
+    analysis = std::make_unique<SpectrumAnalysis>(config, sampleRate);
+    analysisConfig = config;
+    analysisSampleRate = sampleRate;
+  }
+
+  std::shared_ptr<SpectrumAnalyzerTap> tap;
+  std::shared_ptr<SpectrumVisualizationProvider> provider;
+  std::shared_ptr<Settings> settings;
+
+  std::vector<float> chunk;
+  std::unique_ptr<SpectrumAnalysis> analysis;
+
+  // The settings the analysis was made with, before clamping
+  SpectrumAnalysisConfig analysisConfig;
+  double analysisSampleRate = 0.0;
+};
+
+// One background thread runs the analysis for every spectrum analyzer. It
+// exists while at least one analyzer does.
+class SpectrumAnalyzerProcessor::AnalysisThread final : public juce::Thread {
+public:
+  AnalysisThread() : juce::Thread("Anthem Spectrum Analyzer") {}
+
+  ~AnalysisThread() override {
+    stopThread(analysisThreadStopTimeoutMs);
+  }
+
+  // Returns the running thread, starting it if no analyzer holds it.
+  static std::shared_ptr<AnalysisThread> getShared() {
+    static juce::CriticalSection sharedThreadLock;
+    static std::weak_ptr<AnalysisThread> sharedThread;
+
+    const juce::ScopedLock lock(sharedThreadLock);
+
+    auto thread = sharedThread.lock();
+
+    if (thread == nullptr) {
+      thread = std::make_shared<AnalysisThread>();
+      thread->startThread(juce::Thread::Priority::low);
+      sharedThread = thread;
+    }
+
+    return thread;
+  }
+
+  void addJob(std::shared_ptr<AnalysisJob> job) {
+    const juce::ScopedLock lock(jobsLock);
+    jobs.push_back(std::move(job));
+  }
+
+  // Once this returns, the thread won't start another pass over the job. A
+  // pass already in progress keeps it alive until it finishes.
+  void removeJob(const std::shared_ptr<AnalysisJob>& job) {
+    const juce::ScopedLock lock(jobsLock);
+    std::erase(jobs, job);
+  }
+
+  void run() override {
+    while (!threadShouldExit()) {
+      {
+        // Analyzers come and go on the model thread. Work from a copy so
+        // they aren't held up for the length of a pass.
+        const juce::ScopedLock lock(jobsLock);
+        jobsForPass.assign(jobs.begin(), jobs.end());
+      }
+
+      bool anyRequested = false;
+
+      for (auto& job : jobsForPass) {
+        anyRequested = job->run() || anyRequested;
+      }
+
+      jobsForPass.clear();
+
+      wait(anyRequested ? analysisIntervalMs : idleIntervalMs);
+    }
+  }
+private:
+  juce::CriticalSection jobsLock;
+  std::vector<std::shared_ptr<AnalysisJob>> jobs;
+  std::vector<std::shared_ptr<AnalysisJob>> jobsForPass;
+};
+
+SpectrumAnalyzerProcessor::SpectrumAnalyzerProcessor(
+    const SpectrumAnalyzerProcessorModelImpl& _impl)
+  : Processor("SpectrumAnalyzer"), SpectrumAnalyzerProcessorModelBase(_impl),
+    tap(std::make_shared<SpectrumAnalyzerTap>(tapChunkCapacity)),
+    provider(std::make_shared<SpectrumVisualizationProvider>()),
+    settings(std::make_shared<Settings>()) {}
+
+SpectrumAnalyzerProcessor::~SpectrumAnalyzerProcessor() {
+  if (analysisThread != nullptr) {
+    analysisThread->removeJob(analysisJob);
+    analysisThread.reset();
+  }
+
+  unregisterVisualizationProvider();
+}
+
+void SpectrumAnalyzerProcessor::initialize(
+    std::shared_ptr<ModelBase> selfModel, std::shared_ptr<ModelBase> parentModel) {
+  SpectrumAnalyzerProcessorModelBase::initialize(selfModel, parentModel);
+
+  settings->fftSize.store(static_cast<int>(fftSize()), std::memory_order_relaxed);
+  settings->overlap.store(static_cast<int>(overlap()), std::memory_order_relaxed);
+  settings->binCount.store(static_cast<int>(binCount()), std::memory_order_relaxed);
+
+  addFftSizeObserver([this](int64_t newValue) {
+    settings->fftSize.store(static_cast<int>(newValue), std::memory_order_relaxed);
+  });
+
+  addOverlapObserver([this](int64_t newValue) {
+    settings->overlap.store(static_cast<int>(newValue), std::memory_order_relaxed);
+  });
+
+  addBinCountObserver([this](int64_t newValue) {
+    settings->binCount.store(static_cast<int>(newValue), std::memory_order_relaxed);
+  });
+
+  addVisualizationIdObserver([this](const std::string&) { syncVisualizationProvider(); });
+
+  syncVisualizationProvider();
+
+  if (analysisThread == nullptr) {
+    analysisJob = std::make_shared<AnalysisJob>(tap, provider, settings);
+    analysisThread = AnalysisThread::getShared();
+    analysisThread->addJob(analysisJob);
+  }
+}
+
+void SpectrumAnalyzerProcessor::prepareToProcess() {
+  auto* currentDevice = Engine::getInstance().audioDeviceManager.getCurrentAudioDevice();
+  jassert(currentDevice != nullptr);
+
+  if (currentDevice != nullptr) {
+    settings->sampleRate.store(currentDevice->getCurrentSampleRate(), std::memory_order_relaxed);
+  }
+}
+
+void SpectrumAnalyzerProcessor::process(NodeProcessContext& context, int numSamples) {
+  auto& audioInBuffer =
+      context.getInputAudioBuffer(SpectrumAnalyzerProcessorModelBase::audioInputPortId);
+
+  // This is called even while the tap is disabled, so that it drops its
+  // partial chunk rather than finishing it with audio from much later.
+  tap->rt_write(audioInBuffer.getArrayOfReadPointers(),
+      audioInBuffer.getNumChannels(),
+      numSamples,
+      Engine::getInstance().transport->rt_sampleCounter);
+}
+
+void SpectrumAnalyzerProcessor::syncVisualizationProvider() {
+  unregisterVisualizationProvider();
+
+  registeredVisualizationId = visualizationId();
+  VisualizationBroker::getInstance().registerDataProvider(registeredVisualizationId, provider);
+}
+
+void SpectrumAnalyzerProcessor::unregisterVisualizationProvider() {
+  if (registeredVisualizationId.empty()) {
+    return;
+  }
+
+  VisualizationBroker::getInstance().unregisterDataProvider(registeredVisualizationId);
+  registeredVisualizationId.clear();
+}
+
+} // namespace anthem
@@ -0,0 +1,119 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "generated/lib/model/processing_graph/processors/spectrum_analyzer.h"
+#include "modules/core/visualization/visualization_provider.h"
+#include "modules/processing_graph/processor/processor.h"
+#include "modules/processors/spectrum_analysis.h"
+
+#include <atomic>
+#include <juce_core/juce_core.h>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace anthem {
+
+// Publishes the most recent spectrum from a SpectrumAnalyzerProcessor.
+//
+// Each update holds one spectrum, with one value per band from low to high
+// frequency, in dBFS. Every value carries the spectrum's sample timestamp.
+// Spectra made between updates are skipped, so the UI only receives what it
+// can draw.
+class SpectrumVisualizationProvider
+  : public TypedVisualizationDataProvider<double, VisualizationValueType::doubleValue> {
+private:
+  JUCE_LEAK_DETECTOR(SpectrumVisualizationProvider)
+
+  // The analysis thread fills publishBinsDb and the broker reads from
+  // readBinsDb, each outside the lock. Under it, they only swap buffers with
+  // latestBinsDb, so nothing is allocated while it is held.
+  juce::SpinLock spectrumLock;
+  std::vector<double> latestBinsDb;
+  std::vector<double> publishBinsDb;
+  std::vector<double> readBinsDb;
+  int64_t latestSampleTimestamp = 0;
+  bool hasNewSpectrum = false;
+
+  std::atomic<uint32_t> lastRequestMilliseconds = 0;
+  std::atomic<bool> hasBeenRequested = false;
+public:
+  // Called by the visualization broker, which only asks for data that the UI
+  // is subscribed to.
+  std::optional<NumericVisualizationData> getTypedData() override;
+
+  // Analysis thread only.
+  void publish(const std::vector<double>& binsDb, int64_t sampleTimestamp);
+
+  // True if the broker has asked for data recently, meaning something is
+  // subscribed to this provider.
+  bool isRequested() const;
+};
+
+// Measures the spectrum of its input for display.
+//
+// The audio thread only mixes the input down into a SpectrumAnalyzerTap. One
+// background thread, shared by all analyzers, runs the FFTs and publishes the
+// results through each analyzer's SpectrumVisualizationProvider. While nothing
+// is subscribed to a provider, its tap is switched off and neither thread does
+// any work for it.
+class SpectrumAnalyzerProcessor : public Processor, public SpectrumAnalyzerProcessorModelBase {
+private:
+  // The analysis settings, written from model observers and read by the
+  // analysis thread.
+  struct Settings {
+    std::atomic<int> fftSize = 2048;
+    std::atomic<int> overlap = 4;
+    std::atomic<int> binCount = 64;
+    std::atomic<double> sampleRate = 48000.0;
+  };
+
+  class AnalysisJob;
+  class AnalysisThread;
+
+  std::shared_ptr<SpectrumAnalyzerTap> tap;
+  std::shared_ptr<SpectrumVisualizationProvider> provider;
+  std::shared_ptr<Settings> settings;
+  std::string registeredVisualizationId;
+  std::shared_ptr<AnalysisJob> analysisJob;
+  std::shared_ptr<AnalysisThread> analysisThread;
+
+  void syncVisualizationProvider();
+  void unregisterVisualizationProvider();
+public:
+  SpectrumAnalyzerProcessor(const SpectrumAnalyzerProcessorModelImpl& _impl);
+  ~SpectrumAnalyzerProcessor() override;
+
+  SpectrumAnalyzerProcessor(const SpectrumAnalyzerProcessor&) = delete;
+  SpectrumAnalyzerProcessor& operator=(const SpectrumAnalyzerProcessor&) = delete;
+
+  SpectrumAnalyzerProcessor(SpectrumAnalyzerProcessor&&) noexcept = default;
+  SpectrumAnalyzerProcessor& operator=(SpectrumAnalyzerProcessor&&) noexcept = default;
+
+  void prepareToProcess() override;
+  void process(NodeProcessContext& context, int numSamples) override;
+
+  void initialize(
+      std::shared_ptr<ModelBase> selfModel, std::shared_ptr<ModelBase> parentModel) override;
+};
+
+} // namespace anthem
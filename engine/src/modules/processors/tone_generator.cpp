@@ -21,9 +21,7 @@
 
 #include "modules/core/engine.h"
 #include "modules/processing_graph/runtime/node_process_context.h"
-
-#include <cmath>
-#include <iostream>
+#include "modules/util/simd/simd_kernels.h"
 
 namespace anthem {
 
@@ -33,12 +31,7 @@ constexpr float kMaxFrequencyHz = 22500.0f;
 } // namespace
 
 ToneGeneratorProcessor::ToneGeneratorProcessor(const ToneGeneratorProcessorModelImpl& _impl)
-  : Processor("ToneGenerator"), ToneGeneratorProcessorModelBase(_impl) {
-  phase = 0;
-
-  hasNoteOverride = false;
-  noteOverride = 0;
-}
+  : Processor("ToneGenerator"), ToneGeneratorProcessorModelBase(_impl) {}
 
 ToneGeneratorProcessor::~ToneGeneratorProcessor() {}
 
@@ -46,6 +39,8 @@ void ToneGeneratorProcessor::prepareToProcess() {
   auto* currentDevice = Engine::getInstance().audioDeviceManager.getCurrentAudioDevice();
   jassert(currentDevice != nullptr);
   sampleRate = currentDevice->getCurrentSampleRate();
+
+  rt_voices.rt_prepare(sampleRate);
 }
 
 void ToneGeneratorProcessor::process(NodeProcessContext& context, int numSamples) {
@@ -56,47 +51,41 @@ void ToneGeneratorProcessor::process(NodeProcessContext& context, int numSamples
       context.getInputControlBuffer(ToneGeneratorProcessorModelBase::frequencyPortId);
   auto& amplitudeControlBuffer =
       context.getInputControlBuffer(ToneGeneratorProcessorModelBase::amplitudePortId);
+  const auto amplitudeShape =
+      context.getInputControlBufferShape(ToneGeneratorProcessorModelBase::amplitudePortId);
 
-  // Process incoming events
   auto& eventInBuffer =
       context.getInputEventBuffer(ToneGeneratorProcessorModelBase::eventInputPortId);
 
-  for (size_t i = 0; i < eventInBuffer.getNumEvents(); ++i) {
-    const auto& liveEvent = eventInBuffer.getEvent(i);
-
-    if (liveEvent.event.type == EventType::NoteOn) {
-      hasNoteOverride = true;
-      noteOverride = liveEvent.event.noteOn.pitch;
-
-      // We're deliberately ignoring the live timing information here for
-      // simplicity. This would not be correct for a real device - we should be
-      // reading liveEvent.sampleOffset, which represents the sample index in
-      // the current processing block.
-    }
+  if (audioOutBuffer.getNumChannels() == 0) {
+    return;
   }
 
-  // Generate a sine wave
-  for (int sample = 0; sample < numSamples; ++sample) {
-    auto normalizedFrequency = frequencyControlBuffer.getReadPointer(0)[sample];
-    auto amplitude = amplitudeControlBuffer.getReadPointer(0)[sample];
-    jassert(juce::jlimit(0.0f, 1.0f, normalizedFrequency) == normalizedFrequency);
-    jassert(juce::jlimit(0.0f, 1.0f, amplitude) == amplitude);
+  // The first output channel holds the phase increment of A4 for each
+  // sample, and the voices then render over it.
+  auto* output = audioOutBuffer.getWritePointer(0);
+  const auto* normalizedFrequencies = frequencyControlBuffer.getReadPointer(0);
+  const auto inverseSampleRate = static_cast<float>(1.0 / sampleRate);
 
-    auto frequency = normalizedFrequency * (kMaxFrequencyHz - kMinFrequencyHz) + kMinFrequencyHz;
+  for (int sample = 0; sample < numSamples; ++sample) {
+    jassert(juce::jlimit(0.0f, 1.0f, normalizedFrequencies[sample]) ==
+            normalizedFrequencies[sample]);
 
-    if (hasNoteOverride) {
-      const auto semitoneOffset = static_cast<float>(noteOverride - 69);
-      frequency = 440.0f * std::pow(2.0f, semitoneOffset / 12.0f);
-    }
+    const auto frequency =
+        normalizedFrequencies[sample] * (kMaxFrequencyHz - kMinFrequencyHz) + kMinFrequencyHz;
+    output[sample] = frequency * inverseSampleRate;
+  }
 
-    const float value = amplitude * (float)std::sin(2.0 * juce::MathConstants<float>::pi * phase);
+  rt_voices.rt_process(eventInBuffer, output, output, numSamples);
 
-    for (int channel = 0; channel < audioOutBuffer.getNumChannels(); ++channel) {
-      audioOutBuffer.getWritePointer(channel)[sample] = value;
-    }
+  if (amplitudeShape.isConstant()) {
+    simd::rt_multiply(output, output, amplitudeShape.startValue, numSamples);
+  } else {
+    simd::rt_multiply(output, output, amplitudeControlBuffer.getReadPointer(0), numSamples);
+  }
 
-    // Increment phase based on frequency
-    phase = std::fmod((phase + (frequency / sampleRate)), 1.0);
+  for (int channel = 1; channel < audioOutBuffer.getNumChannels(); ++channel) {
+    audioOutBuffer.copyFrom(channel, 0, audioOutBuffer, 0, 0, numSamples);
   }
 }
 
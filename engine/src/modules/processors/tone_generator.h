@@ -21,18 +21,19 @@
 
 #include "generated/lib/model/processing_graph/processors/tone_generator.h"
 #include "modules/processing_graph/processor/processor.h"
+#include "modules/processors/tone_generator_voices.h"
 
 #include <memory>
 
 namespace anthem {
 
+// Plays a sine voice for each held note. The frequency parameter sets the
+// pitch of A4, and other notes are tuned relative to it.
 class ToneGeneratorProcessor : public Processor, public ToneGeneratorProcessorModelBase {
 private:
-  double phase;
-  double sampleRate;
+  double sampleRate = 48000.0;
 
-  bool hasNoteOverride;
-  int noteOverride;
+  ToneGeneratorVoices rt_voices;
 public:
   ToneGeneratorProcessor(const ToneGeneratorProcessorModelImpl& _impl);
   ~ToneGeneratorProcessor() override;
@@ -46,6 +47,12 @@ public:
   void prepareToProcess() override;
   void process(NodeProcessContext& context, int numSamples) override;
 
+  // Output stops once the last voice has faded out, so the node can be
+  // skipped until the next note arrives.
+  int64_t getTailLengthSamples() const override {
+    return rt_voices.rt_getActiveVoiceCount() > 0 ? infiniteTailLength : 0;
+  }
+
   void initialize(
       std::shared_ptr<ModelBase> selfModel, std::shared_ptr<ModelBase> parentModel) override;
 };
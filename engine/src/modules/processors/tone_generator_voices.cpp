@@ -0,0 +1,321 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "tone_generator_voices.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <juce_core/juce_core.h>
+
+namespace anthem {
+
+namespace {
+
+constexpr int a4Pitch = 69;
+
+// Just under Nyquist. Higher notes are held here rather than aliasing.
+constexpr float maxCycleIncrement = 0.49f;
+
+// One cycle in the fixed-point phase
+constexpr float phaseUnitsPerCycle = 4294967296.0f;
+constexpr float radiansPerPhaseUnit = 6.283185307179586f / phaseUnitsPerCycle;
+
+// Half a cycle in the fixed-point phase, which is pi radians
+constexpr uint32_t halfCyclePhase = 0x80000000u;
+
+constexpr int32_t maxCycleIncrementBits = std::bit_cast<int32_t>(maxCycleIncrement);
+constexpr int32_t oneBits = std::bit_cast<int32_t>(1.0f);
+
+// Clamps value to [0, maxBits], where maxBits holds the bits of a positive
+// float. Non-negative floats sort the same way as their bits do as integers,
+// and negative floats have negative bits, so this can be done with integers.
+// The compiler won't vectorise a float comparison here without fast-math.
+float rt_clampToZeroAnd(float value, int32_t maxBits) {
+  return std::bit_cast<float>(std::clamp(std::bit_cast<int32_t>(value), int32_t{0}, maxBits));
+}
+
+// sin(x) for x in [-pi/2, pi/2], from the Taylor series up to x^11. The
+// error is below float precision over that range.
+float rt_sinHalfRange(float x) {
+  const float x2 = x * x;
+
+  return x * (1.0f +
+                 x2 * (-1.0f / 6.0f +
+                          x2 * (1.0f / 120.0f +
+                                   x2 * (-1.0f / 5040.0f +
+                                            x2 * (1.0f / 362880.0f - x2 / 39916800.0f)))));
+}
+
+} // namespace
+
+void ToneGeneratorVoices::rt_prepare(double sampleRate) {
+  jassert(sampleRate > 0.0);
+
+  rt_envelopeStep = static_cast<float>(1.0 / (envelopeSeconds * sampleRate));
+
+  for (int voice = 0; voice < maxVoices; ++voice) {
+    rt_silenceVoice(voice);
+  }
+
+  rt_activeVoiceCount = 0;
+}
+
+void ToneGeneratorVoices::rt_process(const EventBuffer& events,
+    const float* referenceIncrements,
+    float* destination,
+    int numSamples) {
+  int segmentStart = 0;
+
+  for (size_t eventIndex = 0; eventIndex < events.getNumEvents(); ++eventIndex) {
+    const auto& liveEvent = events.getEvent(eventIndex);
+    jassert(liveEvent.sampleOffset >= segmentStart && liveEvent.sampleOffset < numSamples);
+
+    const auto segmentEnd = std::clamp(liveEvent.sampleOffset, segmentStart, numSamples);
+
+    if (segmentEnd > segmentStart) {
+      rt_render(referenceIncrements + segmentStart,
+          destination + segmentStart,
+          segmentEnd - segmentStart);
+      rt_removeFinishedVoices();
+      segmentStart = segmentEnd;
+    }
+
+    rt_handleEvent(liveEvent);
+  }
+
+  if (numSamples > segmentStart) {
+    rt_render(referenceIncrements + segmentStart,
+        destination + segmentStart,
+        numSamples - segmentStart);
+    rt_removeFinishedVoices();
+  }
+}
+
+void ToneGeneratorVoices::rt_releaseAllVoices() {
+  for (int voice = 0; voice < rt_activeVoiceCount; ++voice) {
+    rt_envelopeSteps[static_cast<size_t>(voice)] = -rt_envelopeStep;
+  }
+}
+
+void ToneGeneratorVoices::rt_handleEvent(const LiveEvent& liveEvent) {
+  switch (liveEvent.event.type) {
+    case EventType::NoteOn:
+      rt_noteOn(liveEvent.liveId, liveEvent.event.noteOn);
+      break;
+    case EventType::NoteOff:
+      rt_noteOff(liveEvent.liveId, liveEvent.event.noteOff);
+      break;
+    case EventType::AllVoicesOff:
+      rt_releaseAllVoices();
+      break;
+    case EventType::ParameterChange:
+      // Parameter changes are applied to the control inputs before process()
+      // is called.
+      break;
+  }
+}
+
+void ToneGeneratorVoices::rt_noteOn(LiveNoteId liveId, const NoteOnEvent& noteOn) {
+  // A repeated note-on for a note that's still sounding restarts its
+  // envelope rather than starting a second voice.
+  auto voice = -1;
+
+  if (liveId != invalidLiveNoteId) {
+    voice = rt_findVoice(liveId, noteOn.pitch, noteOn.channel);
+  }
+
+  // Free slots are silenced when their voice finishes, so a new voice starts
+  // from zero phase and level. A stolen voice keeps its phase and level, so
+  // it changes pitch without jumping.
+  if (voice < 0) {
+    voice = rt_allocateVoice();
+  }
+
+  const auto index = static_cast<size_t>(voice);
+  const auto semitonesFromA4 =
+      static_cast<double>(noteOn.pitch - a4Pitch) + static_cast<double>(noteOn.detune) / 100.0;
+
+  rt_frequencyRatios[index] = static_cast<float>(std::exp2(semitonesFromA4 / 12.0));
+  rt_gains[index] = juce::jlimit(0.0f, 1.0f, noteOn.velocity);
+  rt_envelopeSteps[index] = rt_envelopeStep;
+  rt_liveIds[index] = liveId;
+  rt_pitches[index] = noteOn.pitch;
+  rt_channels[index] = noteOn.channel;
+  rt_startOrders[index] = rt_nextStartOrder++;
+}
+
+void ToneGeneratorVoices::rt_noteOff(LiveNoteId liveId, const NoteOffEvent& noteOff) {
+  const auto voice = rt_findVoice(liveId, noteOff.pitch, noteOff.channel);
+
+  if (voice >= 0) {
+    rt_envelopeSteps[static_cast<size_t>(voice)] = -rt_envelopeStep;
+  }
+}
+
+int ToneGeneratorVoices::rt_findVoice(LiveNoteId liveId, int16_t pitch, int16_t channel) const {
+  for (int voice = 0; voice < rt_activeVoiceCount; ++voice) {
+    const auto index = static_cast<size_t>(voice);
+
+    if (liveId != invalidLiveNoteId) {
+      if (rt_liveIds[index] == liveId) {
+        return voice;
+      }
+
+      continue;
+    }
+
+    // Without a live ID, this falls back to the first held voice with the
+    // same pitch and channel.
+    if (rt_envelopeSteps[index] > 0.0f && rt_pitches[index] == pitch &&
+        rt_channels[index] == channel) {
+      return voice;
+    }
+  }
+
+  return -1;
+}
+
+int ToneGeneratorVoices::rt_allocateVoice() {
+  if (rt_activeVoiceCount < maxVoices) {
+    return rt_activeVoiceCount++;
+  }
+
+  int oldestVoice = 0;
+  bool oldestIsReleased = false;
+
+  for (int voice = 0; voice < rt_activeVoiceCount; ++voice) {
+    const auto index = static_cast<size_t>(voice);
+    const bool isReleased = rt_envelopeSteps[index] < 0.0f;
+
+    if (isReleased != oldestIsReleased) {
+      if (isReleased) {
+        oldestVoice = voice;
+        oldestIsReleased = true;
+      }
+
+      continue;
+    }
+
+    if (rt_startOrders[index] < rt_startOrders[static_cast<size_t>(oldestVoice)]) {
+      oldestVoice = voice;
+    }
+  }
+
+  return oldestVoice;
+}
+
+void ToneGeneratorVoices::rt_moveVoice(int from, int to) {
+  const auto fromIndex = static_cast<size_t>(from);
+  const auto toIndex = static_cast<size_t>(to);
+
+  rt_phases[toIndex] = rt_phases[fromIndex];
+  rt_frequencyRatios[toIndex] = rt_frequencyRatios[fromIndex];
+  rt_gains[toIndex] = rt_gains[fromIndex];
+  rt_envelopeLevels[toIndex] = rt_envelopeLevels[fromIndex];
+  rt_envelopeSteps[toIndex] = rt_envelopeSteps[fromIndex];
+  rt_liveIds[toIndex] = rt_liveIds[fromIndex];
+  rt_pitches[toIndex] = rt_pitches[fromIndex];
+  rt_channels[toIndex] = rt_channels[fromIndex];
+  rt_startOrders[toIndex] = rt_startOrders[fromIndex];
+}
+
+void ToneGeneratorVoices::rt_silenceVoice(int voice) {
+  const auto index = static_cast<size_t>(voice);
+
+  rt_phases[index] = 0;
+  rt_frequencyRatios[index] = 0.0f;
+  rt_gains[index] = 0.0f;
+  rt_envelopeLevels[index] = 0.0f;
+  rt_envelopeSteps[index] = 0.0f;
+  rt_liveIds[index] = invalidLiveNoteId;
+}
+
+void ToneGeneratorVoices::rt_removeFinishedVoices() {
+  for (int voice = rt_activeVoiceCount - 1; voice >= 0; --voice) {
+    const auto index = static_cast<size_t>(voice);
+
+    if (rt_envelopeSteps[index] >= 0.0f || rt_envelopeLevels[index] > 0.0f) {
+      continue;
+    }
+
+    // Swap-remove, keeping the active voices packed at the front.
+    const auto lastVoice = rt_activeVoiceCount - 1;
+
+    if (voice != lastVoice) {
+      rt_moveVoice(lastVoice, voice);
+    }
+
+    rt_silenceVoice(lastVoice);
+    rt_activeVoiceCount--;
+  }
+}
+
+// For each sample, the voices are worked through a lane group at a time.
+// Each voice's output is added to the running sum for its lane, and the
+// lanes are added together at the end of the sample. Keeping a sum per lane
+// is what lets the compiler vectorise the inner loop, since it won't
+// reorder float additions itself.
+void ToneGeneratorVoices::rt_render(
+    const float* referenceIncrements, float* destination, int numSamples) {
+  const int groupCount = (rt_activeVoiceCount + voiceLaneCount - 1) / voiceLaneCount;
+
+  for (int sample = 0; sample < numSamples; ++sample) {
+    const float referenceIncrement = referenceIncrements[sample];
+    float laneSums[voiceLaneCount] = {};
+
+    for (int group = 0; group < groupCount; ++group) {
+      for (int lane = 0; lane < voiceLaneCount; ++lane) {
+        const auto voice = static_cast<size_t>(group * voiceLaneCount + lane);
+
+        const float cycleIncrement = rt_clampToZeroAnd(
+            rt_frequencyRatios[voice] * referenceIncrement, maxCycleIncrementBits);
+        rt_phases[voice] += static_cast<uint32_t>(
+            static_cast<int32_t>(cycleIncrement * phaseUnitsPerCycle));
+
+        // The phase as a signed value covers [-pi, pi). It's folded into
+        // [-pi/2, pi/2] using sin(x) = sin(pi - x), working on integers so
+        // the loop has no branches.
+        const auto phase = static_cast<int32_t>(rt_phases[voice]);
+        const uint32_t magnitude =
+            phase < 0 ? 0u - static_cast<uint32_t>(phase) : static_cast<uint32_t>(phase);
+        const uint32_t folded = std::min(magnitude, halfCyclePhase - magnitude);
+        const int32_t foldedPhase =
+            phase < 0 ? -static_cast<int32_t>(folded) : static_cast<int32_t>(folded);
+
+        const float sine = rt_sinHalfRange(static_cast<float>(foldedPhase) * radiansPerPhaseUnit);
+
+        rt_envelopeLevels[voice] =
+            rt_clampToZeroAnd(rt_envelopeLevels[voice] + rt_envelopeSteps[voice], oneBits);
+
+        laneSums[lane] += sine * rt_envelopeLevels[voice] * rt_gains[voice];
+      }
+    }
+
+    float sum = 0.0f;
+
+    for (int lane = 0; lane < voiceLaneCount; ++lane) {
+      sum += laneSums[lane];
+    }
+
+    destination[sample] = sum;
+  }
+}
+
+} // namespace anthem
@@ -0,0 +1,103 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "modules/processing_graph/processor/event_buffer.h"
+#include "modules/sequencer/events/event.h"
+
+#include <array>
+#include <cstdint>
+
+namespace anthem {
+
+// The sine voices behind ToneGeneratorProcessor.
+//
+// Each note-on starts a voice, keyed by its live note ID, and the matching
+// note-off releases it. Events are applied at their sample offsets.
+//
+// Voice state is kept as one array per field, with the active voices packed
+// at the front, so the render loop can work on voiceLaneCount voices at a
+// time. Eight floats fill an AVX register. Phases are 32-bit fixed-point
+// fractions of a cycle that wrap on their own, and the sine is a polynomial,
+// so rendering doesn't call into the math library.
+class ToneGeneratorVoices {
+public:
+  static constexpr int maxVoices = 256;
+  static constexpr int voiceLaneCount = 8;
+
+  // Voices fade in and out over this long, to avoid clicks.
+  static constexpr double envelopeSeconds = 0.005;
+
+  void rt_prepare(double sampleRate);
+
+  // Writes the sum of the voices to destination for numSamples samples,
+  // applying each note event at its sample offset.
+  //
+  // referenceIncrements holds the phase increment of A4 for each sample, as
+  // a fraction of a cycle, and notes are tuned relative to it. It may be the
+  // same as destination.
+  void rt_process(const EventBuffer& events,
+      const float* referenceIncrements,
+      float* destination,
+      int numSamples);
+
+  // Releases every voice, for example when playback stops.
+  void rt_releaseAllVoices();
+
+  int rt_getActiveVoiceCount() const {
+    return rt_activeVoiceCount;
+  }
+private:
+  void rt_handleEvent(const LiveEvent& liveEvent);
+  void rt_noteOn(LiveNoteId liveId, const NoteOnEvent& noteOn);
+  void rt_noteOff(LiveNoteId liveId, const NoteOffEvent& noteOff);
+
+  // Returns -1 if no voice is playing the note.
+  int rt_findVoice(LiveNoteId liveId, int16_t pitch, int16_t channel) const;
+
+  // Steals the oldest voice if they're all in use, preferring one that has
+  // already been released.
+  int rt_allocateVoice();
+
+  void rt_moveVoice(int from, int to);
+  void rt_silenceVoice(int voice);
+  void rt_removeFinishedVoices();
+  void rt_render(const float* referenceIncrements, float* destination, int numSamples);
+
+  // Entries past rt_activeVoiceCount have a gain and envelope of zero, so the
+  // render loop can run over whole lane groups.
+  std::array<uint32_t, maxVoices> rt_phases{};
+  std::array<float, maxVoices> rt_frequencyRatios{};
+  std::array<float, maxVoices> rt_gains{};
+  std::array<float, maxVoices> rt_envelopeLevels{};
+  std::array<float, maxVoices> rt_envelopeSteps{};
+  std::array<LiveNoteId, maxVoices> rt_liveIds{};
+  std::array<int16_t, maxVoices> rt_pitches{};
+  std::array<int16_t, maxVoices> rt_channels{};
+  std::array<uint64_t, maxVoices> rt_startOrders{};
+
+  int rt_activeVoiceCount = 0;
+  uint64_t rt_nextStartOrder = 0;
+
+  // The envelope change per sample
+  float rt_envelopeStep = 1.0f;
+};
+
+} // namespace anthem
@@ -20,11 +20,33 @@
 #include "utility.h"
 
 #include "modules/processing_graph/runtime/node_process_context.h"
+#include "modules/processors/gain_parameter_lookup.h"
+#include "modules/util/simd/simd_kernels.h"
 
+#include <algorithm>
+#include <array>
 #include <juce_core/juce_core.h>
 
 namespace anthem {
 
+namespace {
+
+// Returns the right and left channel gains for the given gain and balance
+// parameter values.
+std::array<float, 2> getChannelGains(float gainParamValue, float balanceParamValue) {
+  jassert(juce::jlimit(0.0f, 1.0f, balanceParamValue) == balanceParamValue);
+
+  auto targetGain = paramValueToGainLinear(gainParamValue);
+
+  auto pan = balanceParamValue * 2.0f - 1.0f;
+  auto gainR = juce::jmin(1.0f - pan, 1.0f);
+  auto gainL = juce::jmin(1.0f + pan, 1.0f);
+
+  return {gainR * targetGain, gainL * targetGain};
+}
+
+} // namespace
+
 UtilityProcessor::UtilityProcessor(const UtilityProcessorModelImpl& _impl)
   : Processor("Utility"), UtilityProcessorModelBase(_impl) {}
 
@@ -39,27 +61,40 @@ void UtilityProcessor::process(NodeProcessContext& context, int numSamples) {
   auto& gainControlBuffer = context.getInputControlBuffer(UtilityProcessorModelBase::gainPortId);
   auto& balanceControlBuffer =
       context.getInputControlBuffer(UtilityProcessorModelBase::balancePortId);
+  const auto gainShape = context.getInputControlBufferShape(UtilityProcessorModelBase::gainPortId);
+  const auto balanceShape =
+      context.getInputControlBufferShape(UtilityProcessorModelBase::balancePortId);
+
+  jassert(audioOutBuffer.getNumChannels() >= 2);
 
-  for (int sample = 0; sample < numSamples; sample++) {
-    auto gainParamValue = gainControlBuffer.getReadPointer(0)[sample];
-    auto targetGain = paramValueToGainLinear(gainParamValue);
+  // When neither control is moving, the channel gains are the same for the
+  // whole block.
+  if (gainShape.isConstant() && balanceShape.isConstant()) {
+    const auto gains = getChannelGains(gainShape.startValue, balanceShape.startValue);
 
-    auto balanceParamValue = balanceControlBuffer.getReadPointer(0)[sample];
-    jassert(juce::jlimit(0.0f, 1.0f, balanceParamValue) == balanceParamValue);
+    float* destinations[2] = {audioOutBuffer.getWritePointer(0), audioOutBuffer.getWritePointer(1)};
+    const float* sources[2] = {audioInBuffer.getReadPointer(0), audioInBuffer.getReadPointer(1)};
 
-    auto pan = balanceParamValue * 2.0f - 1.0f;
-    auto gainR = juce::jmin(1.0f - pan, 1.0f);
-    auto gainL = juce::jmin(1.0f + pan, 1.0f);
+    simd::rt_multiplyChannels(destinations, sources, gains.data(), 2, numSamples);
+
+    return;
+  }
 
-    float gains[2] = {gainR * targetGain, gainL * targetGain};
+  const auto* gainParamValues = gainControlBuffer.getReadPointer(0);
+  float gains[simd::tileSize];
 
-    jassert(audioOutBuffer.getNumChannels() >= 2);
+  for (int tileStart = 0; tileStart < numSamples; tileStart += simd::tileSize) {
+    const auto tileLength = std::min(simd::tileSize, numSamples - tileStart);
 
-    for (int channel = 0; channel < 2; ++channel) {
-      auto inputSample = audioInBuffer.getReadPointer(channel)[sample];
+    rt_gainParameterValuesToLinear(gains, gainParamValues + tileStart, tileLength);
 
-      audioOutBuffer.getWritePointer(channel)[sample] = inputSample * gains[channel];
-    }
+    simd::rt_applyBalance(audioOutBuffer.getWritePointer(0) + tileStart,
+        audioOutBuffer.getWritePointer(1) + tileStart,
+        audioInBuffer.getReadPointer(0) + tileStart,
+        audioInBuffer.getReadPointer(1) + tileStart,
+        balanceControlBuffer.getReadPointer(0) + tileStart,
+        gains,
+        tileLength);
   }
 }
 
@@ -46,6 +46,15 @@ public:
 
   void prepareToProcess() override;
   void process(NodeProcessContext& context, int numSamples) override;
+
+  int64_t getTailLengthSamples() const override {
+    return 0;
+  }
+
+  std::vector<InPlaceAudioPortPair> getInPlaceAudioPortPairs() const override {
+    return {{UtilityProcessorModelBase::audioInputPortId,
+        UtilityProcessorModelBase::audioOutputPortId}};
+  }
 };
 
 } // namespace anthem
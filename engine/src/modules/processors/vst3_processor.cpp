@@ -25,6 +25,8 @@
 #include "modules/core/engine.h"
 #include "modules/processing_graph/runtime/node_process_context.h"
 
+#include <algorithm>
+
 #if JUCE_WINDOWS
 // JUCE exposes the helper for matching the current thread's DPI-awareness
 // context to a native host window in a Windows-only native header.
@@ -82,8 +84,6 @@ void VST3Processor::prepareToProcess() {
 }
 
 void VST3Processor::process(NodeProcessContext& context, int numSamples) {
-  juce::ignoreUnused(numSamples);
-
   auto& audioOutBuffer = context.getOutputAudioBuffer(VST3ProcessorModelBase::audioOutputPortId);
   auto& eventInBuffer = context.getInputEventBuffer(VST3ProcessorModelBase::eventInputPortId);
 
@@ -95,27 +95,19 @@ void VST3Processor::process(NodeProcessContext& context, int numSamples) {
 
   jassert(numSamples == pluginInstance->getBlockSize());
 
-  for (size_t i = 0; i < eventInBuffer.getNumEvents(); ++i) {
-    const auto& liveEvent = eventInBuffer.getEvent(i);
+  // JUCE's VST3 host collects parameter values set between blocks and hands
+  // them to the plugin at sample offset 0 of the next process call. It has no
+  // way to attach a sample offset to them, so parameter changes are applied
+  // before the block, up to a block early, and the plugin still processes the
+  // whole block in one call.
+  for (size_t eventIndex = 0; eventIndex < eventInBuffer.getNumEvents(); ++eventIndex) {
+    const auto& liveEvent = eventInBuffer.getEvent(eventIndex);
     jassert(juce::isPositiveAndBelow(liveEvent.sampleOffset, numSamples));
 
-    if (liveEvent.event.type == EventType::NoteOn) {
-      auto noteOn = juce::MidiMessage::noteOn(liveEvent.event.noteOn.channel + 1,
-          liveEvent.event.noteOn.pitch,
-          static_cast<uint8_t>(std::round(liveEvent.event.noteOn.velocity * 127.0f)));
-
-      rt_eventBufferForPlugin.addEvent(noteOn, liveEvent.sampleOffset);
-    } else if (liveEvent.event.type == EventType::NoteOff) {
-      auto noteOff = juce::MidiMessage::noteOff(liveEvent.event.noteOff.channel + 1,
-          liveEvent.event.noteOff.pitch,
-          static_cast<uint8_t>(std::round(liveEvent.event.noteOff.velocity * 127.0f)));
-
-      rt_eventBufferForPlugin.addEvent(noteOff, liveEvent.sampleOffset);
-    } else if (liveEvent.event.type == EventType::AllVoicesOff) {
-      for (int channel = 1; channel <= 16; channel++) {
-        auto allVoicesOff = juce::MidiMessage::allNotesOff(channel);
-        rt_eventBufferForPlugin.addEvent(allVoicesOff, liveEvent.sampleOffset);
-      }
+    if (liveEvent.event.type == EventType::ParameterChange) {
+      rt_applyParameterChange(liveEvent.event.parameterChange);
+    } else {
+      rt_addMidiEvent(liveEvent, juce::jlimit(0, numSamples - 1, liveEvent.sampleOffset));
     }
   }
 
@@ -125,6 +117,77 @@ void VST3Processor::process(NodeProcessContext& context, int numSamples) {
   rt_eventBufferForPlugin.clear();
 }
 
+void VST3Processor::rt_applyParameterChange(const ParameterChangeEvent& parameterChange) {
+  const auto mapping = std::lower_bound(parameterIdToIndex.begin(),
+      parameterIdToIndex.end(),
+      parameterChange.parameterId,
+      [](const ParameterMapping& entry, int64_t parameterId) {
+        return entry.parameterId < parameterId;
+      });
+
+  if (mapping == parameterIdToIndex.end() || mapping->parameterId != parameterChange.parameterId) {
+    return;
+  }
+
+  pluginInstance->getParameters()[mapping->parameterIndex]->setValue(
+      juce::jlimit(0.0f, 1.0f, parameterChange.value));
+}
+
+void VST3Processor::buildParameterIdToIndex(juce::AudioPluginInstance& instance) {
+  parameterIdToIndex.clear();
+
+  const auto& parameters = instance.getParameters();
+
+  for (int parameterIndex = 0; parameterIndex < parameters.size(); ++parameterIndex) {
+    auto* hostedParameter =
+        dynamic_cast<juce::HostedAudioProcessorParameter*>(parameters[parameterIndex]);
+
+    if (hostedParameter == nullptr) {
+      continue;
+    }
+
+    // For VST3 plugins, this is the plugin's ParamID written as a decimal
+    // number.
+    const auto parameterIdString = hostedParameter->getParameterID();
+
+    if (parameterIdString.isEmpty() || !parameterIdString.containsOnly("0123456789")) {
+      continue;
+    }
+
+    parameterIdToIndex.push_back(ParameterMapping{
+        .parameterId = parameterIdString.getLargeIntValue(),
+        .parameterIndex = parameterIndex,
+    });
+  }
+
+  std::sort(parameterIdToIndex.begin(),
+      parameterIdToIndex.end(),
+      [](const ParameterMapping& a, const ParameterMapping& b) {
+        return a.parameterId < b.parameterId;
+      });
+}
+
+void VST3Processor::rt_addMidiEvent(const LiveEvent& liveEvent, int sampleOffset) {
+  if (liveEvent.event.type == EventType::NoteOn) {
+    auto noteOn = juce::MidiMessage::noteOn(liveEvent.event.noteOn.channel + 1,
+        liveEvent.event.noteOn.pitch,
+        static_cast<uint8_t>(std::round(liveEvent.event.noteOn.velocity * 127.0f)));
+
+    rt_eventBufferForPlugin.addEvent(noteOn, sampleOffset);
+  } else if (liveEvent.event.type == EventType::NoteOff) {
+    auto noteOff = juce::MidiMessage::noteOff(liveEvent.event.noteOff.channel + 1,
+        liveEvent.event.noteOff.pitch,
+        static_cast<uint8_t>(std::round(liveEvent.event.noteOff.velocity * 127.0f)));
+
+    rt_eventBufferForPlugin.addEvent(noteOff, sampleOffset);
+  } else if (liveEvent.event.type == EventType::AllVoicesOff) {
+    for (int channel = 1; channel <= 16; channel++) {
+      auto allVoicesOff = juce::MidiMessage::allNotesOff(channel);
+      rt_eventBufferForPlugin.addEvent(allVoicesOff, sampleOffset);
+    }
+  }
+}
+
 void VST3Processor::initialize(
     std::shared_ptr<ModelBase> selfModel, std::shared_ptr<ModelBase> parentModel) {
   VST3ProcessorModelBase::initialize(selfModel, parentModel);
@@ -227,6 +290,10 @@ void VST3Processor::tryInitializePlugin() {
         instance->prepareToPlay(sampleRate, bufferSize);
         writeVST3Log(*selfShared, "prepareToPlay() completed.");
 
+        // The audio thread starts reading this as soon as the instance is
+        // assigned below, so it must be complete before then.
+        selfShared->buildParameterIdToIndex(*instance);
+
         selfShared->pluginInstance = std::move(instance);
         selfShared->pluginInstance->addListener(selfShared.get());
         writeVST3Log(*selfShared, "Plugin listener attached. Sending PluginLoadedEvent to UI.");
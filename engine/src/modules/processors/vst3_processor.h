@@ -22,10 +22,12 @@
 #ifndef __EMSCRIPTEN__
 
 #include "generated/lib/model/processing_graph/processors/vst3_processor.h"
+#include "modules/processing_graph/processor/event_buffer.h"
 #include "modules/processing_graph/processor/processor.h"
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <memory>
+#include <vector>
 
 namespace anthem {
 
@@ -152,6 +154,23 @@ private:
 
   std::unique_ptr<PluginEditorWindow> editorWindow;
 
+  struct ParameterMapping {
+    int64_t parameterId;
+    int parameterIndex;
+  };
+
+  // Maps the plugin's own parameter IDs, which is what ParameterChange events
+  // carry for plugin nodes, to indices in the plugin's parameter list. Sorted
+  // by parameter ID. This is built on the message thread before the plugin
+  // instance is made visible to the audio thread, and is not changed after.
+  std::vector<ParameterMapping> parameterIdToIndex;
+
+  void buildParameterIdToIndex(juce::AudioPluginInstance& instance);
+  void rt_applyParameterChange(const ParameterChangeEvent& parameterChange);
+
+  // Converts a note event to MIDI and adds it to rt_eventBufferForPlugin.
+  void rt_addMidiEvent(const LiveEvent& liveEvent, int sampleOffset);
+
   void detachPluginListener();
   void rebindEditorWindowCloseCallback();
   void showPluginGUI();
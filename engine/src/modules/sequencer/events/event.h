@@ -21,13 +21,16 @@
 
 #include "note_events.h"
 #include "note_instance_id.h"
+#include "parameter_events.h"
 
 // The event type. This determines ordering for events that occur at the same
-// time - e.g. NoteOff must come before NoteOn.
+// time - e.g. NoteOff must come before NoteOn, and a parameter change must
+// come before a NoteOn so that the new note starts with the new value.
 namespace anthem {
 
 enum EventType {
   AllVoicesOff,
+  ParameterChange,
   NoteOff,
   NoteOn,
 };
@@ -48,12 +51,15 @@ struct Event {
     NoteOnEvent noteOn;
     NoteOffEvent noteOff;
     AllVoicesOffEvent allVoicesOff;
+    ParameterChangeEvent parameterChange;
   };
 
   Event() : type(AllVoicesOff), allVoicesOff{} {}
   Event(NoteOnEvent noteOn) : type(NoteOn), noteOn(noteOn) {}
   Event(NoteOffEvent noteOff) : type(NoteOff), noteOff(noteOff) {}
   Event(AllVoicesOffEvent allVoicesOff) : type(AllVoicesOff), allVoicesOff(allVoicesOff) {}
+  Event(ParameterChangeEvent parameterChange)
+    : type(ParameterChange), parameterChange(parameterChange) {}
 };
 
 struct SequenceEvent {
@@ -0,0 +1,42 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+// Event type for parameter changes.
+namespace anthem {
+
+struct ParameterChangeEvent {
+  // The parameter to change. For nodes with parameter control inputs, this is
+  // the ID of the control input port. For plugin nodes, this is the plugin's
+  // own parameter ID (the VST3 ParamID), not its index in the parameter list.
+  int64_t parameterId;
+
+  // The new value for the parameter, in the range [0, 1].
+  float value;
+
+  ParameterChangeEvent(int64_t parameterId, float value)
+    : parameterId(parameterId), value(value) {}
+
+  ParameterChangeEvent() : parameterId(0), value(0.0f) {}
+};
+
+} // namespace anthem
@@ -0,0 +1,118 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "audio_summing.h"
+
+#include <algorithm>
+#include <juce_audio_basics/juce_audio_basics.h>
+
+namespace anthem {
+
+namespace {
+
+// 512 bytes per buffer, so a tile of the destination plus the scratch tiles
+// for a deep tree fit easily in L1.
+constexpr int tileSize = 128;
+
+// Sources summed directly at the leaves of the tree.
+constexpr size_t leafSourceCount = 4;
+
+// Enough levels for leafSourceCount << 20 sources.
+constexpr int maxTreeDepth = 20;
+
+void rt_sumLeaf(
+    float* destination, const float* const* sources, size_t sourceCount, int numSamples) {
+  jassert(sourceCount > 0 && sourceCount <= leafSourceCount);
+
+  if (sourceCount == 1) {
+    juce::FloatVectorOperations::copy(destination, sources[0], numSamples);
+    return;
+  }
+
+  juce::FloatVectorOperations::add(destination, sources[0], sources[1], numSamples);
+
+  for (size_t sourceIndex = 2; sourceIndex < sourceCount; ++sourceIndex) {
+    juce::FloatVectorOperations::add(destination, sources[sourceIndex], numSamples);
+  }
+}
+
+// Sums one tile of the sources, starting at sampleOffset, into destination.
+// Each level of the tree sums its two halves separately, using one tile of
+// scratch for the second half.
+void rt_sumTile(float* destination,
+    const float* const* sources,
+    size_t sourceCount,
+    int sampleOffset,
+    int numSamples,
+    float* scratch,
+    int depth) {
+  if (sourceCount <= leafSourceCount) {
+    const float* leafSources[leafSourceCount];
+
+    for (size_t sourceIndex = 0; sourceIndex < sourceCount; ++sourceIndex) {
+      leafSources[sourceIndex] = sources[sourceIndex] + sampleOffset;
+    }
+
+    rt_sumLeaf(destination, leafSources, sourceCount, numSamples);
+    return;
+  }
+
+  jassert(depth < maxTreeDepth);
+
+  const auto firstHalfCount = sourceCount / 2;
+  auto* nextScratch = scratch + tileSize;
+
+  rt_sumTile(
+      destination, sources, firstHalfCount, sampleOffset, numSamples, nextScratch, depth + 1);
+  rt_sumTile(scratch,
+      sources + firstHalfCount,
+      sourceCount - firstHalfCount,
+      sampleOffset,
+      numSamples,
+      nextScratch,
+      depth + 1);
+
+  juce::FloatVectorOperations::add(destination, scratch, numSamples);
+}
+
+} // namespace
+
+void rt_sumAudioBuffers(float* destination, std::span<const float* const> sources, int numSamples) {
+  if (sources.empty()) {
+    return;
+  }
+
+  jassert(std::find(sources.begin(), sources.end(), destination) == sources.end());
+
+  alignas(32) float scratch[maxTreeDepth * tileSize];
+
+  for (int tileStart = 0; tileStart < numSamples; tileStart += tileSize) {
+    const auto tileLength = std::min(tileSize, numSamples - tileStart);
+
+    rt_sumTile(destination + tileStart,
+        sources.data(),
+        sources.size(),
+        tileStart,
+        tileLength,
+        scratch,
+        0);
+  }
+}
+
+} // namespace anthem
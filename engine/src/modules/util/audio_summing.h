@@ -0,0 +1,35 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <span>
+
+namespace anthem {
+
+// Writes the sum of the source buffers to destination, for numSamples
+// samples. The destination must not be one of the sources. With no sources,
+// the destination is left as it is.
+//
+// The block is summed a tile at a time, so the destination stays in cache
+// while every source is added to it. Large numbers of sources are summed as
+// a tree, which loses less precision than adding them one after another.
+void rt_sumAudioBuffers(float* destination, std::span<const float* const> sources, int numSamples);
+
+} // namespace anthem
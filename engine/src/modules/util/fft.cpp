@@ -0,0 +1,91 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "fft.h"
+
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+#include <utility>
+
+namespace anthem {
+
+Fft::Fft(int size) : size(size) {
+  if (size < 1 || (size & (size - 1)) != 0) {
+    throw std::invalid_argument("FFT size must be a power of two.");
+  }
+
+  twiddles.resize(static_cast<size_t>(size / 2));
+
+  for (int index = 0; index < size / 2; ++index) {
+    const double angle = -2.0 * std::numbers::pi * index / size;
+    twiddles[static_cast<size_t>(index)] = std::complex<float>(
+        static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+  }
+
+  int bitCount = 0;
+
+  while ((1 << bitCount) < size) {
+    ++bitCount;
+  }
+
+  bitReversedIndices.resize(static_cast<size_t>(size));
+
+  for (int index = 0; index < size; ++index) {
+    int reversed = 0;
+
+    for (int bit = 0; bit < bitCount; ++bit) {
+      reversed |= ((index >> bit) & 1) << (bitCount - 1 - bit);
+    }
+
+    bitReversedIndices[static_cast<size_t>(index)] = reversed;
+  }
+}
+
+void Fft::perform(std::complex<float>* data) const {
+  for (int index = 0; index < size; ++index) {
+    const auto reversed = bitReversedIndices[static_cast<size_t>(index)];
+
+    if (index < reversed) {
+      std::swap(data[index], data[reversed]);
+    }
+  }
+
+  for (int length = 2; length <= size; length *= 2) {
+    const int halfLength = length / 2;
+    const int twiddleStride = size / length;
+
+    for (int start = 0; start < size; start += length) {
+      for (int offset = 0; offset < halfLength; ++offset) {
+        // Plain multiplication rather than operator*, which handles NaNs and
+        // infinities per the C standard and is much slower.
+        const auto twiddle = twiddles[static_cast<size_t>(offset * twiddleStride)];
+        const auto odd = data[start + offset + halfLength];
+        const std::complex<float> rotated(odd.real() * twiddle.real() - odd.imag() * twiddle.imag(),
+            odd.real() * twiddle.imag() + odd.imag() * twiddle.real());
+
+        const auto even = data[start + offset];
+        data[start + offset] = even + rotated;
+        data[start + offset + halfLength] = even - rotated;
+      }
+    }
+  }
+}
+
+} // namespace anthem
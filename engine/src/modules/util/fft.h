@@ -0,0 +1,50 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <complex>
+#include <vector>
+
+namespace anthem {
+
+// An in-place radix-2 complex FFT.
+//
+// The twiddle factors and bit-reversal table are worked out by the
+// constructor, so perform() doesn't allocate. This is for analysis off the
+// audio thread, where a plain implementation is fast enough.
+class Fft {
+public:
+  // size must be a power of two. Throws std::invalid_argument otherwise.
+  explicit Fft(int size);
+
+  int getSize() const {
+    return size;
+  }
+
+  // Replaces data, which must hold getSize() values, with its forward
+  // transform. The result isn't scaled.
+  void perform(std::complex<float>* data) const;
+private:
+  int size;
+  std::vector<std::complex<float>> twiddles;
+  std::vector<int> bitReversedIndices;
+};
+
+} // namespace anthem
@@ -21,6 +21,8 @@
 
 #include "bw_math.h"
 
+#include <algorithm>
+
 namespace anthem {
 
 LinearParameterSmoother::LinearParameterSmoother(float initialValue, float duration) {
@@ -53,4 +55,49 @@ void LinearParameterSmoother::process(float deltaTime) {
   }
 }
 
+bool LinearParameterSmoother::isSettled() const {
+  return timeRemaining <= 0.0f && currentValue == targetValue;
+}
+
+bool LinearParameterSmoother::processBlock(float deltaTime, float* destination, int numSteps) {
+  int step = 0;
+
+  if (timeRemaining > 0.0f) {
+    // While more than one step remains, process() moves by the same amount
+    // each step, so the increment only needs to be worked out once.
+    const float increment = (targetValue - currentValue) * deltaTime / timeRemaining;
+
+    for (; step < numSteps && timeRemaining > deltaTime; ++step) {
+      currentValue += increment;
+      timeRemaining -= deltaTime;
+      destination[step] = currentValue;
+    }
+
+    if (step == numSteps) {
+      return true;
+    }
+
+    // The last step of the ramp lands on the target, which is usually less
+    // than a full increment away, and the value stays there after it.
+    const auto rampStepCount = step;
+
+    currentValue = targetValue;
+    timeRemaining -= deltaTime;
+    std::fill(destination + step, destination + numSteps, targetValue);
+
+    return rampStepCount == 0;
+  }
+
+  currentValue = targetValue;
+  std::fill(destination, destination + numSteps, targetValue);
+
+  return true;
+}
+
+void LinearParameterSmoother::continueFrom(const LinearParameterSmoother& other) {
+  targetValue = other.targetValue;
+  currentValue = other.currentValue;
+  timeRemaining = other.timeRemaining;
+}
+
 } // namespace anthem
@@ -37,6 +37,21 @@ public:
   float getCurrentValue();
   float getTargetValue();
   void process(float deltaTime);
+
+  // Returns true if the value will not change until a new target is set.
+  bool isSettled() const;
+
+  // Advances the smoother by numSteps steps of deltaTime, writing the value
+  // after each step to destination. This gives the same values as calling
+  // process() and getCurrentValue() once per step, to within rounding.
+  //
+  // Returns true if the values written lie on one straight line, which is the
+  // case unless the smoother reaches its target part way through.
+  bool processBlock(float deltaTime, float* destination, int numSteps);
+
+  // Picks up from where another smoother is, including any ramp it is part
+  // way through. This smoother keeps its own duration for future ramps.
+  void continueFrom(const LinearParameterSmoother& other);
 };
 
 } // namespace anthem
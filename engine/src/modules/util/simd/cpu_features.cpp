@@ -0,0 +1,65 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "cpu_features.h"
+
+#include <juce_core/juce_core.h>
+
+namespace anthem {
+
+namespace simd {
+
+const CpuFeatures& getCpuFeatures() {
+  static const CpuFeatures features = []() {
+    CpuFeatures detected;
+    detected.sse2 = juce::SystemStats::hasSSE2();
+    detected.avx2 = juce::SystemStats::hasAVX2();
+    detected.avx512f = juce::SystemStats::hasAVX512F();
+    detected.neon = juce::SystemStats::hasNeon();
+    return detected;
+  }();
+
+  return features;
+}
+
+const char* getSimdLevelName() {
+  const auto& features = getCpuFeatures();
+
+  if (features.avx512f) {
+    return "AVX-512";
+  }
+
+  if (features.avx2) {
+    return "AVX2";
+  }
+
+  if (features.sse2) {
+    return "SSE2";
+  }
+
+  if (features.neon) {
+    return "NEON";
+  }
+
+  return "scalar";
+}
+
+} // namespace simd
+
+} // namespace anthem
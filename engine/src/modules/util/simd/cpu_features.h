@@ -0,0 +1,43 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+namespace anthem {
+
+namespace simd {
+
+// The vector instruction sets this CPU supports, as far as the kernels in
+// simd_kernels.h are concerned.
+struct CpuFeatures {
+  bool sse2 = false;
+  bool avx2 = false;
+  bool avx512f = false;
+  bool neon = false;
+};
+
+// Detected once, on first use.
+const CpuFeatures& getCpuFeatures();
+
+// The widest instruction set above, for logging, e.g. "AVX2".
+const char* getSimdLevelName();
+
+} // namespace simd
+
+} // namespace anthem
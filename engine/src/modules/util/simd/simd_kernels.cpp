@@ -0,0 +1,185 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "simd_kernels.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+// Builds the function for each listed instruction set as well as for the
+// baseline, and picks one at load time from what the CPU supports. This needs
+// ifunc support in the loader, which only Linux has here.
+#if defined(__x86_64__) && defined(__linux__) && (defined(__GNUC__) || defined(__clang__))
+#define ANTHEM_SIMD_MULTIVERSION __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define ANTHEM_SIMD_MULTIVERSION
+#endif
+
+namespace anthem {
+
+namespace simd {
+
+namespace {
+
+constexpr uint32_t floatSignMask = 0x80000000u;
+
+// Every exponent bit set means infinity or NaN.
+constexpr uint32_t floatExponentMask = 0x7f800000u;
+
+// Balance gains are worked out a tile at a time into stack buffers, and then
+// applied with rt_multiply(). Doing it all in one loop would need more
+// pointers than the compiler will check for overlap, and it would leave the
+// loop scalar.
+ANTHEM_SIMD_MULTIVERSION
+void rt_getBalanceGains(float* gains0, float* gains1, const float* balance, int numSamples) {
+  for (int sample = 0; sample < numSamples; ++sample) {
+    const auto pan = balance[sample] * 2.0f - 1.0f;
+
+    gains0[sample] = std::min(1.0f - pan, 1.0f);
+    gains1[sample] = std::min(1.0f + pan, 1.0f);
+  }
+}
+
+} // namespace
+
+ANTHEM_SIMD_MULTIVERSION
+void rt_multiply(float* destination, const float* source, float gain, int numSamples) {
+  for (int sample = 0; sample < numSamples; ++sample) {
+    destination[sample] = source[sample] * gain;
+  }
+}
+
+ANTHEM_SIMD_MULTIVERSION
+void rt_multiply(float* destination, const float* source, const float* gains, int numSamples) {
+  for (int sample = 0; sample < numSamples; ++sample) {
+    destination[sample] = source[sample] * gains[sample];
+  }
+}
+
+void rt_multiplyChannels(float* const* destination,
+    const float* const* source,
+    const float* channelGains,
+    int numChannels,
+    int numSamples) {
+  for (int channel = 0; channel < numChannels; ++channel) {
+    rt_multiply(destination[channel], source[channel], channelGains[channel], numSamples);
+  }
+}
+
+void rt_applyBalance(float* destination0,
+    float* destination1,
+    const float* source0,
+    const float* source1,
+    const float* balance,
+    const float* gains,
+    int numSamples) {
+  alignas(64) float gains0[tileSize];
+  alignas(64) float gains1[tileSize];
+
+  for (int tileStart = 0; tileStart < numSamples; tileStart += tileSize) {
+    const auto tileLength = std::min(tileSize, numSamples - tileStart);
+
+    rt_getBalanceGains(gains0, gains1, balance + tileStart, tileLength);
+
+    if (gains != nullptr) {
+      rt_multiply(gains0, gains0, gains + tileStart, tileLength);
+      rt_multiply(gains1, gains1, gains + tileStart, tileLength);
+    }
+
+    rt_multiply(destination0 + tileStart, source0 + tileStart, gains0, tileLength);
+    rt_multiply(destination1 + tileStart, source1 + tileStart, gains1, tileLength);
+  }
+}
+
+ANTHEM_SIMD_MULTIVERSION
+float rt_absMax(const float* source, int numSamples) {
+  // Without the sign bit, larger floats have larger bit patterns, so this
+  // can take the maximum of the bits as integers. The compiler vectorises
+  // that, where a float maximum would need fast-math because of NaNs.
+  uint32_t maxBits = 0;
+
+  for (int sample = 0; sample < numSamples; ++sample) {
+    uint32_t bits;
+    std::memcpy(&bits, &source[sample], sizeof(bits));
+    maxBits = std::max(maxBits, bits & ~floatSignMask);
+  }
+
+  float result;
+  std::memcpy(&result, &maxBits, sizeof(result));
+
+  return result;
+}
+
+ANTHEM_SIMD_MULTIVERSION
+double rt_sumOfSquares(const float* source, int numSamples) {
+  // The compiler won't reorder float additions, so a single running sum
+  // would stay scalar. A sum per lane lets it use one vector of sums.
+  constexpr int laneCount = 16;
+  float laneSums[laneCount] = {};
+
+  const int vectorEnd = numSamples - numSamples % laneCount;
+
+  for (int sample = 0; sample < vectorEnd; sample += laneCount) {
+    for (int lane = 0; lane < laneCount; ++lane) {
+      laneSums[lane] += source[sample + lane] * source[sample + lane];
+    }
+  }
+
+  double sum = 0.0;
+
+  for (int lane = 0; lane < laneCount; ++lane) {
+    sum += static_cast<double>(laneSums[lane]);
+  }
+
+  for (int sample = vectorEnd; sample < numSamples; ++sample) {
+    sum += static_cast<double>(source[sample]) * static_cast<double>(source[sample]);
+  }
+
+  return sum;
+}
+
+ANTHEM_SIMD_MULTIVERSION
+bool rt_sanitiseAndCopy(float* destination, const float* source, int numSamples) {
+  uint32_t replacedAny = 0;
+
+  // This checks the bits rather than calling std::isfinite(), which the
+  // compiler won't vectorise.
+  for (int sample = 0; sample < numSamples; ++sample) {
+    uint32_t bits;
+    std::memcpy(&bits, &source[sample], sizeof(bits));
+
+    const uint32_t isNonFinite = (bits & floatExponentMask) == floatExponentMask ? 1u : 0u;
+    replacedAny |= isNonFinite;
+    destination[sample] = isNonFinite != 0 ? 0.0f : source[sample];
+  }
+
+  return replacedAny != 0;
+}
+
+ANTHEM_SIMD_MULTIVERSION
+void rt_mixAccumulate(float* destination, const float* source, float gain, int numSamples) {
+  for (int sample = 0; sample < numSamples; ++sample) {
+    destination[sample] += source[sample] * gain;
+  }
+}
+
+} // namespace simd
+
+} // namespace anthem
@@ -0,0 +1,86 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+// Vector kernels for the DSP loops in the built-in processors.
+//
+// Each kernel is a plain loop that the compiler vectorises. On x86-64 Linux,
+// each one is also built for AVX2 and AVX-512, and the best version for the
+// CPU is picked when the engine loads. Elsewhere they are built for the
+// baseline instruction set of the target, which is SSE2 on x86-64 and NEON
+// on 64-bit ARM. See cpu_features.h for what the CPU supports.
+//
+// Unless noted, destination may be the same as a source, but must not
+// otherwise overlap one.
+namespace anthem {
+
+namespace simd {
+
+// The length of the stack buffers that processors use to hold per-sample
+// values, such as gains, before handing them to a kernel.
+constexpr int tileSize = 64;
+
+// destination = source * gain
+void rt_multiply(float* destination, const float* source, float gain, int numSamples);
+
+// destination = source * gains, where gains holds one value per sample.
+void rt_multiply(float* destination, const float* source, const float* gains, int numSamples);
+
+// Multiplies each channel by its own gain.
+void rt_multiplyChannels(float* const* destination,
+    const float* const* source,
+    const float* channelGains,
+    int numChannels,
+    int numSamples);
+
+// Applies Anthem's balance law to a pair of channels. For each sample, the
+// balance value in [0, 1] is mapped to a pan position in [-1, 1], and
+//
+//   channel 0 is multiplied by min(1 - pan, 1)
+//   channel 1 is multiplied by min(1 + pan, 1)
+//
+// so the middle leaves both channels as they are. If gains isn't null, both
+// channels are also multiplied by its value for the sample.
+void rt_applyBalance(float* destination0,
+    float* destination1,
+    const float* source0,
+    const float* source1,
+    const float* balance,
+    const float* gains,
+    int numSamples);
+
+// Returns the largest absolute value in source, or 0 for an empty range. A
+// NaN counts as larger than any other value.
+float rt_absMax(const float* source, int numSamples);
+
+// Returns the sum of the squares of the values in source. Each lane sums
+// in float, and the lanes are added together in double at the end.
+double rt_sumOfSquares(const float* source, int numSamples);
+
+// Copies source to destination, replacing NaNs and infinities with zero.
+// Returns true if any sample was replaced.
+bool rt_sanitiseAndCopy(float* destination, const float* source, int numSamples);
+
+// destination += source * gain
+void rt_mixAccumulate(float* destination, const float* source, float gain, int numSamples);
+
+} // namespace simd
+
+} // namespace anthem
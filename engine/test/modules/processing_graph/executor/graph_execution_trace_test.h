@@ -0,0 +1,174 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "modules/processing_graph/executor/graph_execution_trace.h"
+#include "modules/processing_graph/executor/graph_executor.h"
+#include "modules/processing_graph/graph_test_helpers.h"
+#include "modules/processing_graph/model/runtime_graph.h"
+#include "modules/processing_graph/runtime/graph_runtime_services.h"
+
+#include <juce_core/juce_core.h>
+#include <vector>
+
+namespace anthem {
+
+class GraphExecutionTraceTest : public juce::UnitTest {
+  static int countEventsWithPhase(const juce::var& traceEvents, const juce::String& phase) {
+    int count = 0;
+
+    for (const auto& traceEvent : *traceEvents.getArray()) {
+      if (traceEvent["ph"].toString() == phase) {
+        ++count;
+      }
+    }
+
+    return count;
+  }
+
+  void testRingDropsEventsWhenFull() {
+    beginTest("Trace ring drops and counts events once it is full");
+
+    GraphExecutionTraceRing ring(2);
+
+    for (int eventIndex = 0; eventIndex < 5; ++eventIndex) {
+      ring.rt_add(GraphExecutionTraceEvent{
+          .type = GraphExecutionTraceEventType::nodeBegin,
+          .timestampNanoseconds = eventIndex,
+          .value = eventIndex,
+      });
+    }
+
+    std::vector<GraphExecutionTraceEvent> events;
+    ring.drainInto(events);
+
+    expectEquals(static_cast<int>(events.size()), 2);
+    expectEquals(static_cast<int>(events[0].value), 0);
+    expectEquals(static_cast<int>(events[1].value), 1);
+    expectEquals(static_cast<int>(ring.getDroppedEventCount()), 3);
+
+    events.clear();
+    ring.drainInto(events);
+    expect(events.empty());
+  }
+
+  void testFormatsGateWaitAsSpan() {
+    beginTest("Trace formats gate acquisition as a span covering the spin");
+
+    const auto json = GraphExecutionTracer::formatEvent(
+        GraphExecutionTraceEvent{
+            .type = GraphExecutionTraceEventType::gateAcquire,
+            .timestampNanoseconds = 15000,
+            .value = 4000,
+        },
+        2,
+        1000);
+
+    const auto parsed = juce::JSON::parse(json);
+
+    expectEquals(parsed["ph"].toString(), juce::String("X"));
+    expectEquals(static_cast<int>(parsed["tid"]), 2);
+    expectWithinAbsoluteError(static_cast<double>(parsed["ts"]), 10.0, 0.0001);
+    expectWithinAbsoluteError(static_cast<double>(parsed["dur"]), 4.0, 0.0001);
+  }
+
+  void testExecutorWritesTraceFile() {
+    beginTest("Executor writes a Chrome trace with block and node events");
+
+    auto graph = graph_test_helpers::makeProcessingGraph();
+
+    for (int64_t nodeId = 1; nodeId <= 3; ++nodeId) {
+      graph->nodes()->insert_or_assign(nodeId, graph_test_helpers::makeNode(nodeId));
+    }
+
+    GraphRuntimeServices rtServices;
+    auto runtimeGraph = RuntimeGraph::fromProcessingGraph(*graph,
+        rtServices,
+        GraphBufferLayout{
+            .numAudioChannels = 2,
+            .blockSize = 8,
+        },
+        44100.0);
+
+    const auto traceFile =
+        juce::File::createTempFile("anthem_graph_execution_trace_test.json");
+
+    constexpr int blockCount = 4;
+
+    {
+      GraphExecutor executor;
+      executor.prepare();
+      auto runtimeState = executor.createRuntimeStateForGraph(*runtimeGraph);
+
+      executor.startTracing(traceFile);
+
+      for (int block = 0; block < blockCount; ++block) {
+        executor.rt_processBlock(*runtimeGraph, *runtimeState, 8);
+      }
+
+      executor.stopTracing();
+
+      // Blocks processed after tracing stops are not recorded.
+      executor.rt_processBlock(*runtimeGraph, *runtimeState, 8);
+    }
+
+    const auto parsed = juce::JSON::parse(traceFile);
+    const auto& traceEvents = parsed["traceEvents"];
+
+    expect(traceEvents.isArray(), "The trace file should contain a traceEvents array.");
+
+    if (traceEvents.isArray()) {
+      int blockBeginCount = 0;
+      int nodeBeginCount = 0;
+
+      for (const auto& traceEvent : *traceEvents.getArray()) {
+        if (traceEvent["ph"].toString() != "B") {
+          continue;
+        }
+
+        if (traceEvent["cat"].toString() == "block") {
+          ++blockBeginCount;
+        } else if (traceEvent["cat"].toString() == "node") {
+          ++nodeBeginCount;
+        }
+      }
+
+      expectEquals(blockBeginCount, blockCount);
+      expectEquals(nodeBeginCount, blockCount * 3);
+      expectEquals(countEventsWithPhase(traceEvents, "B"), countEventsWithPhase(traceEvents, "E"));
+    }
+
+    expectEquals(static_cast<int>(parsed["otherData"]["droppedEvents"]), 0);
+
+    traceFile.deleteFile();
+  }
+public:
+  GraphExecutionTraceTest() : juce::UnitTest("GraphExecutionTraceTest", "Anthem") {}
+
+  void runTest() override {
+    testRingDropsEventsWhenFull();
+    testFormatsGateWaitAsSpan();
+    testExecutorWritesTraceFile();
+  }
+};
+
+static GraphExecutionTraceTest graphExecutionTraceTest;
+
+} // namespace anthem
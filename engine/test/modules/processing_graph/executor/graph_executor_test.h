@@ -0,0 +1,477 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "modules/processing_graph/executor/graph_executor.h"
+#include "modules/processing_graph/executor/graph_worker_parker.h"
+#include "modules/processing_graph/graph_test_helpers.h"
+#include "modules/processing_graph/model/runtime_graph.h"
+#include "modules/processing_graph/processor/processor.h"
+#include "modules/processing_graph/runtime/graph_runtime_services.h"
+
+#include <atomic>
+#include <chrono>
+#include <juce_core/juce_core.h>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace anthem {
+
+class GraphExecutorTest : public juce::UnitTest {
+  // Counts how many times it has been processed, and checks that every
+  // upstream processor has already been processed in the current block.
+  class ExecutionOrderRecordingProcessor : public Processor {
+  public:
+    ExecutionOrderRecordingProcessor() : Processor("ExecutionOrderRecordingProcessor") {}
+
+    void prepareToProcess() override {}
+
+    void process(NodeProcessContext& /*context*/, int /*numSamples*/) override {
+      const auto blockIndex = processCount.load(std::memory_order_acquire);
+
+      for (auto* upstreamProcessor : upstreamProcessors) {
+        if (upstreamProcessor->processCount.load(std::memory_order_acquire) != blockIndex + 1) {
+          orderViolationCount.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+
+      processCount.store(blockIndex + 1, std::memory_order_release);
+    }
+
+    std::vector<ExecutionOrderRecordingProcessor*> upstreamProcessors;
+    std::atomic<int> processCount{0};
+    std::atomic<int> orderViolationCount{0};
+  };
+
+  // Waits for the steady clock to move on before returning, so that every
+  // timed run of this processor measures a nonzero cost.
+  class ClockAdvancingProcessor : public Processor {
+  public:
+    ClockAdvancingProcessor() : Processor("ClockAdvancingProcessor") {}
+
+    void prepareToProcess() override {}
+
+    void process(NodeProcessContext& /*context*/, int /*numSamples*/) override {
+      const auto startTime = std::chrono::steady_clock::now();
+
+      while (std::chrono::steady_clock::now() == startTime) {
+      }
+    }
+  };
+
+  static int64_t inputPortId(int64_t nodeId) {
+    return nodeId * 10 + 1;
+  }
+
+  static int64_t outputPortId(int64_t nodeId) {
+    return nodeId * 10 + 2;
+  }
+
+  static void addGraphNode(ProcessingGraphModel& graph, int64_t nodeId) {
+    auto node = graph_test_helpers::makeNode(nodeId);
+
+    node->audioInputPorts()->push_back(
+        graph_test_helpers::makePort(inputPortId(nodeId), nodeId, NodePortDataType::audio));
+    node->audioOutputPorts()->push_back(
+        graph_test_helpers::makePort(outputPortId(nodeId), nodeId, NodePortDataType::audio));
+
+    graph.nodes()->insert_or_assign(nodeId, node);
+  }
+
+  static void addConnection(ProcessingGraphModel& graph,
+      int64_t connectionId,
+      int64_t sourceNodeId,
+      int64_t destinationNodeId) {
+    auto& nodes = *graph.nodes();
+
+    auto connection = graph_test_helpers::makeConnection(connectionId,
+        sourceNodeId,
+        outputPortId(sourceNodeId),
+        destinationNodeId,
+        inputPortId(destinationNodeId));
+
+    nodes.at(sourceNodeId)->audioOutputPorts()->at(0)->connections()->push_back(connectionId);
+    nodes.at(destinationNodeId)->audioInputPorts()->at(0)->connections()->push_back(connectionId);
+
+    graph.connections()->insert_or_assign(connectionId, connection);
+  }
+
+  struct LayeredGraph {
+    std::shared_ptr<ProcessingGraphModel> model;
+    std::unordered_map<int64_t, std::vector<int64_t>> upstreamNodeIds;
+  };
+
+  // Builds layers of nodes where each node depends on two nodes in the
+  // previous layer, followed by a single sink node that depends on the whole
+  // last layer. This gives the schedulers plenty of parallel work and fan-in.
+  static LayeredGraph makeLayeredGraph(int layerCount, int layerWidth) {
+    LayeredGraph result{.model = graph_test_helpers::makeProcessingGraph(), .upstreamNodeIds = {}};
+    auto& graph = *result.model;
+
+    int64_t nextConnectionId = 10000;
+    const auto getNodeId = [layerWidth](int layer, int column) {
+      return static_cast<int64_t>(layer * layerWidth + column + 1);
+    };
+
+    for (int layer = 0; layer < layerCount; ++layer) {
+      for (int column = 0; column < layerWidth; ++column) {
+        const auto nodeId = getNodeId(layer, column);
+        addGraphNode(graph, nodeId);
+
+        if (layer == 0) {
+          continue;
+        }
+
+        for (const auto upstreamColumn : {column, (column + 1) % layerWidth}) {
+          const auto upstreamNodeId = getNodeId(layer - 1, upstreamColumn);
+          addConnection(graph, nextConnectionId++, upstreamNodeId, nodeId);
+          result.upstreamNodeIds[nodeId].push_back(upstreamNodeId);
+        }
+      }
+    }
+
+    const auto sinkNodeId = getNodeId(layerCount, 0);
+    addGraphNode(graph, sinkNodeId);
+
+    for (int column = 0; column < layerWidth; ++column) {
+      const auto upstreamNodeId = getNodeId(layerCount - 1, column);
+      addConnection(graph, nextConnectionId++, upstreamNodeId, sinkNodeId);
+      result.upstreamNodeIds[sinkNodeId].push_back(upstreamNodeId);
+    }
+
+    return result;
+  }
+
+  // Builds parallel chains of nodes that all feed a single sink node. Each
+  // chain is fused into a single task when the graph is compiled.
+  static LayeredGraph makeChainedGraph(int chainCount, int chainLength) {
+    LayeredGraph result{.model = graph_test_helpers::makeProcessingGraph(), .upstreamNodeIds = {}};
+    auto& graph = *result.model;
+
+    int64_t nextConnectionId = 10000;
+    const auto sinkNodeId = static_cast<int64_t>(chainCount * chainLength + 1);
+    addGraphNode(graph, sinkNodeId);
+
+    for (int chain = 0; chain < chainCount; ++chain) {
+      for (int link = 0; link < chainLength; ++link) {
+        const auto nodeId = static_cast<int64_t>(chain * chainLength + link + 1);
+        addGraphNode(graph, nodeId);
+
+        if (link > 0) {
+          addConnection(graph, nextConnectionId++, nodeId - 1, nodeId);
+          result.upstreamNodeIds[nodeId].push_back(nodeId - 1);
+        }
+      }
+
+      const auto chainTailNodeId = static_cast<int64_t>((chain + 1) * chainLength);
+      addConnection(graph, nextConnectionId++, chainTailNodeId, sinkNodeId);
+      result.upstreamNodeIds[sinkNodeId].push_back(chainTailNodeId);
+    }
+
+    return result;
+  }
+
+  void expectSchedulerProcessesEveryNodeInOrder(GraphExecutor::SchedulerType schedulerType,
+      const juce::String& schedulerName,
+      const LayeredGraph& layeredGraph,
+      const juce::String& graphName) {
+    beginTest(schedulerName + " scheduler processes every node in a " + graphName +
+              " once per block, in order");
+
+    constexpr int blockCount = 200;
+
+    GraphRuntimeServices rtServices;
+    auto runtimeGraph = RuntimeGraph::fromProcessingGraph(*layeredGraph.model,
+        rtServices,
+        GraphBufferLayout{
+            .numAudioChannels = 2,
+            .blockSize = 8,
+        },
+        44100.0);
+
+    std::unordered_map<int64_t, std::unique_ptr<ExecutionOrderRecordingProcessor>> processors;
+
+    for (auto& runtimeNode : runtimeGraph->nodes) {
+      auto processor = std::make_unique<ExecutionOrderRecordingProcessor>();
+      runtimeNode.processor = processor.get();
+      processors.emplace(runtimeNode.id, std::move(processor));
+    }
+
+    for (auto& [nodeId, upstreamNodeIds] : layeredGraph.upstreamNodeIds) {
+      for (const auto upstreamNodeId : upstreamNodeIds) {
+        processors.at(nodeId)->upstreamProcessors.push_back(processors.at(upstreamNodeId).get());
+      }
+    }
+
+    GraphExecutor executor;
+    executor.prepare(GraphExecutor::ThreadConfig{.schedulerType = schedulerType});
+    auto runtimeState = executor.createRuntimeStateForGraph(*runtimeGraph);
+
+    for (int block = 0; block < blockCount; ++block) {
+      executor.rt_processBlock(*runtimeGraph, *runtimeState, 8);
+    }
+
+    int unexpectedProcessCountNodes = 0;
+    int orderViolationCount = 0;
+
+    for (auto& [nodeId, processor] : processors) {
+      if (processor->processCount.load() != blockCount) {
+        ++unexpectedProcessCountNodes;
+      }
+
+      orderViolationCount += processor->orderViolationCount.load();
+    }
+
+    expectEquals(unexpectedProcessCountNodes, 0);
+    expectEquals(orderViolationCount, 0);
+    expect(runtimeGraph->availableTasks.empty());
+  }
+
+  void testNodeCostsAreTimedOnOneBlockInSixteen() {
+    beginTest("Executor times node costs on one block in 16");
+
+    auto graph = graph_test_helpers::makeProcessingGraph();
+    addGraphNode(*graph, 1);
+
+    GraphRuntimeServices rtServices;
+    auto runtimeGraph = RuntimeGraph::fromProcessingGraph(*graph,
+        rtServices,
+        GraphBufferLayout{
+            .numAudioChannels = 2,
+            .blockSize = 8,
+        },
+        44100.0);
+
+    ClockAdvancingProcessor processor;
+    auto& runtimeNode = runtimeGraph->getNode(1);
+    runtimeNode.processor = &processor;
+
+    GraphExecutor executor;
+    executor.prepare();
+    auto runtimeState = executor.createRuntimeStateForGraph(*runtimeGraph);
+
+    // Any timed block pulls the moving average away from this value.
+    constexpr float unmeasuredCost = 1.0e12f;
+    std::vector<int> measuredBlocks;
+
+    for (int block = 0; block < 64; ++block) {
+      runtimeNode.rt_state.rt_averageProcessNanoseconds.store(unmeasuredCost);
+      executor.rt_processBlock(*runtimeGraph, *runtimeState, 8);
+
+      if (runtimeNode.rt_state.rt_averageProcessNanoseconds.load() != unmeasuredCost) {
+        measuredBlocks.push_back(block);
+      }
+    }
+
+    expectEquals(static_cast<int>(measuredBlocks.size()), 4);
+
+    for (const auto block : measuredBlocks) {
+      expectEquals(block % 16, 0);
+    }
+  }
+
+  static GraphExecutor::WorkerParkingStats getParkerStats(const GraphWorkerParker& parker) {
+    GraphExecutor::WorkerParkingStats stats;
+    parker.addStatsTo(stats);
+    return stats;
+  }
+
+  void testWorkerParkerWakesWhileSpinning() {
+    beginTest("Worker parker wakes a spinning worker without parking it");
+
+    // The budget is long enough that the worker is still spinning when the
+    // wake arrives.
+    GraphWorkerParker parker(2'000'000'000, 2'000'000'000);
+    std::thread worker([&parker]() { parker.park(); });
+
+    while (!parker.rt_tryWake()) {
+      std::this_thread::yield();
+    }
+
+    worker.join();
+
+    const auto stats = getParkerStats(parker);
+    expectEquals(static_cast<int>(stats.spinWakeCount), 1);
+    expectEquals(static_cast<int>(stats.parkCount), 0);
+    expectEquals(static_cast<int>(stats.parkedWakeCount), 0);
+    expect(!parker.rt_tryWake(), "A worker that has returned from park() should be busy.");
+  }
+
+  void testWorkerParkerWakesWhileParked() {
+    beginTest("Worker parker wakes a worker that has gone to sleep");
+
+    GraphWorkerParker parker(0, 0);
+    std::thread worker([&parker]() { parker.park(); });
+
+    while (getParkerStats(parker).parkCount == 0) {
+      std::this_thread::yield();
+    }
+
+    expect(parker.rt_tryWake(), "A parked worker should accept a wake.");
+    worker.join();
+
+    const auto stats = getParkerStats(parker);
+    expectEquals(static_cast<int>(stats.spinWakeCount), 0);
+    expectEquals(static_cast<int>(stats.parkCount), 1);
+    expectEquals(static_cast<int>(stats.parkedWakeCount), 1);
+  }
+
+  void testWorkerParkerDoesNotLoseWakes() {
+    beginTest("Worker parker does not lose wakes that race with parking");
+
+    // With no spin budget, most wakes land while the worker is moving from
+    // spinning to parked. A lost wake would leave the worker asleep, and this
+    // test would never finish.
+    constexpr int parkCount = 2000;
+
+    GraphWorkerParker parker(0, 0);
+    std::thread worker([&parker]() {
+      for (int park = 0; park < parkCount; ++park) {
+        parker.park();
+      }
+    });
+
+    for (int wake = 0; wake < parkCount; ++wake) {
+      while (!parker.rt_tryWake()) {
+        std::this_thread::yield();
+      }
+    }
+
+    worker.join();
+
+    const auto stats = getParkerStats(parker);
+    expectEquals(static_cast<int>(stats.getWakeCount()), parkCount);
+    expectEquals(static_cast<int>(stats.parkedWakeCount), static_cast<int>(stats.parkCount));
+  }
+
+  void testWorkerParkerExitWakeWhileBusy() {
+    beginTest("Worker parker returns at once if woken for exit while busy");
+
+    GraphWorkerParker parker(2'000'000'000, 2'000'000'000);
+    parker.wakeForExit();
+
+    // This would spin for two seconds if the exit wake were lost.
+    const auto startTime = std::chrono::steady_clock::now();
+    parker.park();
+    expect(std::chrono::steady_clock::now() - startTime < std::chrono::seconds(1));
+
+    const auto stats = getParkerStats(parker);
+    expectEquals(static_cast<int>(stats.getWakeCount()), 0);
+    expectEquals(static_cast<int>(stats.parkCount), 0);
+  }
+
+  void testWorkerParkerAdaptsSpinBudget() {
+    beginTest("Worker parker adapts its spin budget to how long it waits");
+
+    const auto parkAndWakeAfter = [](GraphWorkerParker& parker, std::chrono::milliseconds delay) {
+      std::thread worker([&parker]() { parker.park(); });
+      std::this_thread::sleep_for(delay);
+
+      while (!parker.rt_tryWake()) {
+        std::this_thread::yield();
+      }
+
+      worker.join();
+    };
+
+    // Waits that fit within the maximum budget raise the budget above the
+    // minimum.
+    GraphWorkerParker shortWaitParker(0, 1'000'000'000);
+    parkAndWakeAfter(shortWaitParker, std::chrono::milliseconds(2));
+    expect(shortWaitParker.getSpinBudgetNanoseconds() > 0);
+    expect(shortWaitParker.getSpinBudgetNanoseconds() <= 1'000'000'000);
+
+    // Waits longer than the maximum budget drop it back to the minimum.
+    GraphWorkerParker longWaitParker(1'000, 100'000);
+    parkAndWakeAfter(longWaitParker, std::chrono::milliseconds(5));
+    expectEquals(static_cast<int>(longWaitParker.getSpinBudgetNanoseconds()), 1'000);
+  }
+
+  void testWorkerParkingStatsAreConsistent() {
+    beginTest("Worker parking stats stay consistent across blocks");
+
+    auto layeredGraph = makeLayeredGraph(4, 8);
+    GraphRuntimeServices rtServices;
+    auto runtimeGraph = RuntimeGraph::fromProcessingGraph(*layeredGraph.model,
+        rtServices,
+        GraphBufferLayout{
+            .numAudioChannels = 2,
+            .blockSize = 8,
+        },
+        44100.0);
+
+    GraphExecutor executor;
+    executor.prepare(GraphExecutor::ThreadConfig{
+        .workerMinSpinNanoseconds = 1'000,
+        .workerMaxSpinNanoseconds = 50'000,
+    });
+    auto runtimeState = executor.createRuntimeStateForGraph(*runtimeGraph);
+
+    for (int block = 0; block < 100; ++block) {
+      executor.rt_processBlock(*runtimeGraph, *runtimeState, 8);
+    }
+
+    const auto stats = executor.getWorkerParkingStats();
+
+    // A worker that is asleep when stats are read has parked but not yet been
+    // woken.
+    expect(stats.parkedWakeCount <= stats.parkCount);
+    expect(stats.maxWakeLatencyNanoseconds >= 0);
+    expect(static_cast<uint64_t>(stats.maxWakeLatencyNanoseconds) <=
+           stats.totalWakeLatencyNanoseconds);
+  }
+public:
+  GraphExecutorTest() : juce::UnitTest("GraphExecutorTest", "Anthem") {}
+
+  void runTest() override {
+    const auto layeredGraph = makeLayeredGraph(6, 12);
+    const auto chainedGraph = makeChainedGraph(8, 5);
+
+    for (const auto& graph : {std::pair(&layeredGraph, juce::String("layered graph")),
+             std::pair(&chainedGraph, juce::String("fused chain graph"))}) {
+      expectSchedulerProcessesEveryNodeInOrder(GraphExecutor::SchedulerType::gatedPriorityQueue,
+          "Gated priority queue",
+          *graph.first,
+          graph.second);
+      expectSchedulerProcessesEveryNodeInOrder(
+          GraphExecutor::SchedulerType::workStealing, "Work-stealing", *graph.first, graph.second);
+      expectSchedulerProcessesEveryNodeInOrder(
+          GraphExecutor::SchedulerType::relaxedPriorityMultiQueue,
+          "Relaxed priority multi-queue",
+          *graph.first,
+          graph.second);
+    }
+
+    testNodeCostsAreTimedOnOneBlockInSixteen();
+    testWorkerParkerWakesWhileSpinning();
+    testWorkerParkerWakesWhileParked();
+    testWorkerParkerDoesNotLoseWakes();
+    testWorkerParkerExitWakeWhileBusy();
+    testWorkerParkerAdaptsSpinBudget();
+    testWorkerParkingStatsAreConsistent();
+  }
+};
+
+static GraphExecutorTest graphExecutorTest;
+
+} // namespace anthem
@@ -0,0 +1,206 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "modules/processing_graph/graph_compiler.h"
+#include "modules/processing_graph/graph_processor.h"
+#include "modules/processing_graph/graph_test_helpers.h"
+#include "modules/processing_graph/model/runtime_graph.h"
+
+#include <array>
+#include <juce_core/juce_core.h>
+#include <memory>
+
+namespace anthem {
+
+// The compiler is built without its thread here, and each test takes, compiles
+// and finishes the queued jobs itself. This lets it interleave them the way
+// the compiler thread and the message loop can.
+class GraphCompilerTest : public juce::UnitTest {
+  static constexpr double sampleRate = 44100.0;
+
+  static GraphBufferLayout getBufferLayout() {
+    return GraphBufferLayout{
+        .numAudioChannels = 2,
+        .blockSize = 8,
+    };
+  }
+
+  static std::unique_ptr<GraphCompiler> makeCompiler(GraphProcessor& graphProcessor) {
+    return std::unique_ptr<GraphCompiler>(new GraphCompiler(graphProcessor, false));
+  }
+
+  // Does what the compiler thread would for the job it picks up next.
+  static std::shared_ptr<GraphCompiler::CompileJob> takeAndCompile(GraphCompiler& compiler) {
+    auto job = compiler.takePendingJob();
+
+    if (job != nullptr) {
+      GraphCompiler::compile(*job);
+    }
+
+    return job;
+  }
+
+  // Enough nodes that compiling them takes a measurable amount of time.
+  static void addNodes(ProcessingGraphModel& graph, int64_t firstNodeId, int count) {
+    for (int64_t nodeId = firstNodeId; nodeId < firstNodeId + count; ++nodeId) {
+      graph.nodes()->insert_or_assign(nodeId, graph_test_helpers::makeNode(nodeId));
+    }
+  }
+
+  void testOnlyNewestQueuedCompileIsHandedOver() {
+    beginTest("Graph compiler hands only the newest of several queued compiles to the audio "
+              "thread");
+
+    GraphProcessor graphProcessor;
+    auto compiler = makeCompiler(graphProcessor);
+
+    auto graph = graph_test_helpers::makeProcessingGraph();
+    addNodes(*graph, 1, 1000);
+
+    int initialCallCount = 0;
+    compiler->requestCompile(*graph, getBufferLayout(), sampleRate, [&](const auto& /*result*/) {
+      ++initialCallCount;
+    });
+    auto initialJob = takeAndCompile(*compiler);
+    expect(initialJob != nullptr);
+    compiler->finishJob(*initialJob);
+    expectEquals(initialCallCount, 1);
+
+    const auto* initialGraph = graphProcessor.getLatestRuntimeGraphFromMainThread();
+    expect(initialGraph != nullptr, "The first compile should be handed over.");
+
+    constexpr size_t requestCount = 3;
+    std::array<int, requestCount> callCounts{};
+    std::array<GraphCompiler::Result, requestCount> results{};
+
+    auto request = [&](size_t index) {
+      const auto nodeId = static_cast<int64_t>(2000 + index);
+      graph->nodes()->insert_or_assign(nodeId, graph_test_helpers::makeNode(nodeId));
+
+      compiler->requestCompile(
+          *graph, getBufferLayout(), sampleRate, [&, index](const auto& result) {
+            ++callCounts[index];
+            results[index] = result;
+          });
+    };
+
+    // The first request is picked up before the others arrive. The second is
+    // replaced by the third before anything picks it up.
+    request(0);
+    auto startedJob = takeAndCompile(*compiler);
+    request(1);
+    request(2);
+    auto newestJob = takeAndCompile(*compiler);
+
+    expect(startedJob != nullptr && newestJob != nullptr);
+    expect(compiler->takePendingJob() == nullptr,
+        "A queued job should be replaced by a newer one.");
+
+    if (startedJob == nullptr || newestJob == nullptr) {
+      return;
+    }
+
+    // The started job's result comes back first, and is dropped.
+    compiler->finishJob(*startedJob);
+
+    for (const auto callCount : callCounts) {
+      expectEquals(callCount, 0, "A superseded result should not complete any request.");
+    }
+
+    expect(graphProcessor.getLatestRuntimeGraphFromMainThread() == initialGraph,
+        "A superseded graph should not be handed over.");
+
+    compiler->finishJob(*newestJob);
+
+    for (size_t index = 0; index < requestCount; ++index) {
+      expectEquals(callCounts[index], 1, "Each callback should fire exactly once.");
+      expect(results[index].success, "Each request should complete with the newest result.");
+      expect(results[index].compileDurationMicroseconds > 0,
+          "The result should say how long the compile took.");
+    }
+
+    const auto* latestGraph = graphProcessor.getLatestRuntimeGraphFromMainThread();
+    expect(latestGraph != nullptr && latestGraph != initialGraph);
+
+    if (latestGraph != nullptr) {
+      expectEquals(
+          static_cast<int>(latestGraph->nodes.size()), 1000 + static_cast<int>(requestCount));
+      expect(latestGraph->compiledFromGraph == initialGraph,
+          "The newest graph should be compiled against the last one handed over.");
+    }
+  }
+
+  void testSnapshotErrorCompletesWaitingRequests() {
+    beginTest("Graph compiler completes every waiting request when a snapshot fails");
+
+    GraphProcessor graphProcessor;
+    auto compiler = makeCompiler(graphProcessor);
+
+    auto graph = graph_test_helpers::makeProcessingGraph();
+    addNodes(*graph, 1, 10);
+
+    std::array<int, 2> callCounts{};
+    std::array<GraphCompiler::Result, 2> results{};
+
+    compiler->requestCompile(*graph, getBufferLayout(), sampleRate, [&](const auto& result) {
+      ++callCounts[0];
+      results[0] = result;
+    });
+
+    graph->nodes()->insert_or_assign(100, nullptr);
+
+    // The snapshot fails here, and the request completes straight away.
+    compiler->requestCompile(*graph, getBufferLayout(), sampleRate, [&](const auto& result) {
+      ++callCounts[1];
+      results[1] = result;
+    });
+
+    for (size_t index = 0; index < callCounts.size(); ++index) {
+      expectEquals(callCounts[index], 1, "Each callback should fire exactly once.");
+      expect(!results[index].success);
+      expect(results[index].error.has_value(), "The snapshot error should be reported.");
+    }
+
+    // The earlier job is still queued. It can still be compiled, but its
+    // result is stale by the time it comes back.
+    auto staleJob = takeAndCompile(*compiler);
+    expect(staleJob != nullptr);
+
+    if (staleJob != nullptr) {
+      compiler->finishJob(*staleJob);
+    }
+
+    expectEquals(callCounts[0], 1, "A stale result should not complete a request again.");
+    expect(graphProcessor.getLatestRuntimeGraphFromMainThread() == nullptr,
+        "No graph should be handed over.");
+  }
+public:
+  GraphCompilerTest() : juce::UnitTest("GraphCompilerTest", "Anthem") {}
+
+  void runTest() override {
+    testOnlyNewestQueuedCompileIsHandedOver();
+    testSnapshotErrorCompletesWaitingRequests();
+  }
+};
+
+static GraphCompilerTest graphCompilerTest;
+
+} // namespace anthem
@@ -22,18 +22,77 @@
 #include "modules/processing_graph/executor/graph_executor.h"
 #include "modules/processing_graph/executor/graph_executor_shared.h"
 #include "modules/processing_graph/graph_test_helpers.h"
+#include "modules/processing_graph/model/processing_graph_snapshot.h"
 #include "modules/processing_graph/model/runtime_graph.h"
+#include "modules/processing_graph/processor/processor.h"
 #include "modules/processing_graph/runtime/graph_runtime_services.h"
 #include "modules/processing_graph/runtime/node_process_context.h"
+#include "modules/processors/gain.h"
 
+#include <algorithm>
 #include <atomic>
 #include <juce_core/juce_core.h>
+#include <limits>
 #include <optional>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 namespace anthem {
 
 class RuntimeGraphTest : public juce::UnitTest {
+  // Fills its audio output with ones and counts how many times it has been
+  // processed.
+  class TailLengthProcessor : public Processor {
+  public:
+    TailLengthProcessor(int64_t outputPortId, int64_t tailLengthSamples)
+      : Processor("TailLengthProcessor"), outputPortId(outputPortId),
+        tailLengthSamples(tailLengthSamples) {}
+
+    void prepareToProcess() override {}
+
+    void process(NodeProcessContext& context, int numSamples) override {
+      auto& outputBuffer = context.getOutputAudioBuffer(outputPortId);
+
+      for (int channel = 0; channel < outputBuffer.getNumChannels(); ++channel) {
+        juce::FloatVectorOperations::fill(outputBuffer.getWritePointer(channel), 1.0f, numSamples);
+      }
+
+      ++processCount;
+    }
+
+    int64_t getTailLengthSamples() const override {
+      return tailLengthSamples;
+    }
+
+    int processCount = 0;
+  private:
+    int64_t outputPortId;
+    int64_t tailLengthSamples;
+  };
+
+  // Sends the same events from its event output on every block.
+  class EventSourceProcessor : public Processor {
+  public:
+    EventSourceProcessor(int64_t outputPortId, std::vector<LiveEvent> events)
+      : Processor("EventSourceProcessor"), outputPortId(outputPortId), events(std::move(events)) {}
+
+    void prepareToProcess() override {}
+
+    void process(NodeProcessContext& context, int numSamples) override {
+      juce::ignoreUnused(numSamples);
+
+      auto& outputBuffer = context.getOutputEventBuffer(outputPortId);
+
+      for (const auto& event : events) {
+        outputBuffer.addEvent(event);
+      }
+    }
+  private:
+    int64_t outputPortId;
+    std::vector<LiveEvent> events;
+  };
+
   static int64_t inputPortId(int64_t nodeId) {
     return nodeId * 10 + 1;
   }
@@ -71,6 +130,26 @@ class RuntimeGraphTest : public juce::UnitTest {
     return node;
   }
 
+  static std::shared_ptr<Node> addGainGraphNode(ProcessingGraphModel& graph, int64_t nodeId) {
+    auto node = graph_test_helpers::makeGainNode(nodeId);
+
+    node->audioInputPorts()->push_back(graph_test_helpers::makePort(
+        GainProcessorModelBase::audioInputPortId, nodeId, NodePortDataType::audio));
+    node->audioOutputPorts()->push_back(graph_test_helpers::makePort(
+        GainProcessorModelBase::audioOutputPortId, nodeId, NodePortDataType::audio));
+    node->controlInputPorts()->push_back(
+        graph_test_helpers::makePort(GainProcessorModelBase::gainPortId,
+            nodeId,
+            NodePortDataType::control,
+            kGainParameterZeroDbNormalized,
+            graph_test_helpers::makeParameterConfig(
+                nodeId * 100 + 1, kGainParameterZeroDbNormalized)));
+
+    graph.nodes()->insert_or_assign(nodeId, node);
+
+    return node;
+  }
+
   static std::shared_ptr<Node> addControlGraphNode(
       ProcessingGraphModel& graph, int64_t nodeId, bool inputHasParameter = false) {
     auto node = graph_test_helpers::makeNode(nodeId);
@@ -107,15 +186,28 @@ class RuntimeGraphTest : public juce::UnitTest {
       int64_t connectionId,
       int64_t sourceNodeId,
       int64_t destinationNodeId) {
-    auto& nodes = *graph.nodes();
-    auto& sourceNode = nodes.at(sourceNodeId);
-    auto& destinationNode = nodes.at(destinationNodeId);
-
-    auto connection = graph_test_helpers::makeConnection(connectionId,
+    addAudioConnection(graph,
+        connectionId,
         sourceNodeId,
         outputPortId(sourceNodeId),
         destinationNodeId,
         inputPortId(destinationNodeId));
+  }
+
+  // Connects the first audio output of one node to the first audio input of
+  // another, for nodes whose ports don't follow the IDs above.
+  static void addAudioConnection(ProcessingGraphModel& graph,
+      int64_t connectionId,
+      int64_t sourceNodeId,
+      int64_t sourcePortId,
+      int64_t destinationNodeId,
+      int64_t destinationPortId) {
+    auto& nodes = *graph.nodes();
+    auto& sourceNode = nodes.at(sourceNodeId);
+    auto& destinationNode = nodes.at(destinationNodeId);
+
+    auto connection = graph_test_helpers::makeConnection(
+        connectionId, sourceNodeId, sourcePortId, destinationNodeId, destinationPortId);
 
     sourceNode->audioOutputPorts()->at(0)->connections()->push_back(connectionId);
     destinationNode->audioInputPorts()->at(0)->connections()->push_back(connectionId);
@@ -196,6 +288,31 @@ class RuntimeGraphTest : public juce::UnitTest {
     return false;
   }
 
+  // Builds a graph of layers of layerWidth nodes, where every node is
+  // connected to every node in the next layer. A width of 1 gives a chain.
+  static std::shared_ptr<ProcessingGraphModel> makeLayeredGraph(
+      int64_t nodeCount, int64_t layerWidth) {
+    auto graph = graph_test_helpers::makeProcessingGraph();
+    int64_t connectionId = 1;
+
+    for (int64_t nodeId = 1; nodeId <= nodeCount; ++nodeId) {
+      addGraphNode(*graph, nodeId);
+
+      const auto layerStart = (nodeId - 1) / layerWidth * layerWidth + 1;
+      const auto previousLayerStart = layerStart - layerWidth;
+
+      if (previousLayerStart < 1) {
+        continue;
+      }
+
+      for (auto sourceNodeId = previousLayerStart; sourceNodeId < layerStart; ++sourceNodeId) {
+        addConnection(*graph, connectionId++, sourceNodeId, nodeId);
+      }
+    }
+
+    return graph;
+  }
+
   static void processRuntimeGraph(RuntimeGraph& runtimeGraph, int numSamples) {
     GraphExecutor executor;
     executor.prepare();
@@ -212,21 +329,41 @@ public:
     testAliasesSingleAudioConnection();
     testAliasesAudioFanOutConnections();
     testDisconnectedAudioInputsShareSilentBuffer();
+    testReusesAudioBuffersAlongChains();
+    testDoesNotShareAudioBuffersAcrossParallelBranches();
+    testProcessesInPlaceWhereInputHasNoOtherReader();
     testAliasesSingleEventConnection();
     testBuildsEventFanInTransferAction();
+    testMergesEventFanInBySampleOffset();
+    testPacksNodeStateIntoFlatStorage();
     testPrepareGraphForBlockResetsRemainingUpstreamNodeCounters();
     testDecrementRemainingUpstreamNodeCounter();
     testSingleThreadedExecutorMakesAudioAvailableToReadyDownstreamNodes();
     testSingleThreadedExecutorHandlesDuplicateEdges();
     testConnectedControlParameterDoesNotOverwriteAliasedSignal();
+    testParametersDescribeControlBufferShape();
+    testAppliesParameterChangeEventsAtTheirSampleOffsets();
+    testDropsParameterChangeEventsPastCapacity();
     testSingleThreadedExecutorHandlesControlFanIn();
     testSingleThreadedExecutorProcessesNodesWithoutProcessors();
+    testNodesWithoutProcessorsSilenceReusedOutputBuffers();
+    testAudioFanInSkipsSilentSources();
+    testSkipsNodesAfterInputsFallSilentForTail();
+    testSkippedNodesKeepApplyingParameterChanges();
     testCalculatesLinearPriorities();
     testCalculatesDiamondPriorities();
     testCalculatesDisconnectedComponentPriorities();
+    testStagesMeasuredCostPriorities();
+    testDoesNotStageUnmeasuredPriorities();
+    testFusesLinearChains();
+    testAdoptsStateFromPreviousGraph();
+    testCompilesFromSnapshotAndAttachesToModel();
+    testKeepsParameterChangesMadeDuringCompile();
+    testDoesNotFuseAcrossFanOutOrFanIn();
     testAvailableTaskQueueOrdersByPriorityThenId();
     testDetectsReachableCycle();
     testDetectsCycleWithoutInputNodes();
+    testCompilesLargeGraphs();
   }
 
   void testBuildsNodesInputNodesAndEdges() {
@@ -250,9 +387,9 @@ public:
     expect(hasInputNode(*runtimeGraph, 2), "Node 2 should be an input node.");
     expect(!hasInputNode(*runtimeGraph, 3), "Node 3 should not be an input node.");
 
-    auto& firstNode = runtimeGraph->nodes.at(1);
-    auto& secondNode = runtimeGraph->nodes.at(2);
-    auto& thirdNode = runtimeGraph->nodes.at(3);
+    auto& firstNode = runtimeGraph->getNode(1);
+    auto& secondNode = runtimeGraph->getNode(2);
+    auto& thirdNode = runtimeGraph->getNode(3);
 
     expectEquals(static_cast<int>(firstNode.upstreamNodeCount), 0);
     expectEquals(static_cast<int>(secondNode.upstreamNodeCount), 0);
@@ -301,8 +438,8 @@ public:
     GraphRuntimeServices rtServices;
     auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
 
-    auto& sourceNode = runtimeGraph->nodes.at(1);
-    auto& destinationNode = runtimeGraph->nodes.at(2);
+    auto& sourceNode = runtimeGraph->getNode(1);
+    auto& destinationNode = runtimeGraph->getNode(2);
 
     expectEquals(static_cast<int>(sourceNode.outgoingConnections.size()),
         1,
@@ -340,13 +477,13 @@ public:
     auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
 
     auto& sourceOutputBuffer =
-        runtimeGraph->nodes.at(1).nodeProcessContext->getOutputAudioBuffer(outputPortId(1));
+        runtimeGraph->getNode(1).nodeProcessContext->getOutputAudioBuffer(outputPortId(1));
     auto& destinationInputBuffer =
-        runtimeGraph->nodes.at(2).nodeProcessContext->getInputAudioBuffer(inputPortId(2));
+        runtimeGraph->getNode(2).nodeProcessContext->getInputAudioBuffer(inputPortId(2));
 
     expect(&sourceOutputBuffer == &destinationInputBuffer,
         "A single audio connection should bind the destination input to the source output.");
-    expectEquals(static_cast<int>(runtimeGraph->nodes.at(2).connectionTransferActions.size()),
+    expectEquals(static_cast<int>(runtimeGraph->getNode(2).connectionTransferActions.size()),
         0,
         "A single aliased connection should not need a transfer action.");
   }
@@ -365,18 +502,18 @@ public:
     auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
 
     auto& sourceOutputBuffer =
-        runtimeGraph->nodes.at(1).nodeProcessContext->getOutputAudioBuffer(outputPortId(1));
+        runtimeGraph->getNode(1).nodeProcessContext->getOutputAudioBuffer(outputPortId(1));
     auto& firstDestinationInputBuffer =
-        runtimeGraph->nodes.at(2).nodeProcessContext->getInputAudioBuffer(inputPortId(2));
+        runtimeGraph->getNode(2).nodeProcessContext->getInputAudioBuffer(inputPortId(2));
     auto& secondDestinationInputBuffer =
-        runtimeGraph->nodes.at(3).nodeProcessContext->getInputAudioBuffer(inputPortId(3));
+        runtimeGraph->getNode(3).nodeProcessContext->getInputAudioBuffer(inputPortId(3));
 
     expect(&sourceOutputBuffer == &firstDestinationInputBuffer,
         "The first fan-out destination should alias the source output.");
     expect(&sourceOutputBuffer == &secondDestinationInputBuffer,
         "The second fan-out destination should alias the source output.");
-    expectEquals(static_cast<int>(runtimeGraph->nodes.at(2).connectionTransferActions.size()), 0);
-    expectEquals(static_cast<int>(runtimeGraph->nodes.at(3).connectionTransferActions.size()), 0);
+    expectEquals(static_cast<int>(runtimeGraph->getNode(2).connectionTransferActions.size()), 0);
+    expectEquals(static_cast<int>(runtimeGraph->getNode(3).connectionTransferActions.size()), 0);
   }
 
   void testDisconnectedAudioInputsShareSilentBuffer() {
@@ -390,9 +527,9 @@ public:
     auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
 
     auto& firstInputBuffer =
-        runtimeGraph->nodes.at(1).nodeProcessContext->getInputAudioBuffer(inputPortId(1));
+        runtimeGraph->getNode(1).nodeProcessContext->getInputAudioBuffer(inputPortId(1));
     auto& secondInputBuffer =
-        runtimeGraph->nodes.at(2).nodeProcessContext->getInputAudioBuffer(inputPortId(2));
+        runtimeGraph->getNode(2).nodeProcessContext->getInputAudioBuffer(inputPortId(2));
 
     expect(&firstInputBuffer == &secondInputBuffer,
         "Disconnected audio inputs should share the graph's silent input buffer.");
@@ -400,6 +537,158 @@ public:
         firstInputBuffer.getSample(0, 0), 0.0f, 0.0001f, "The shared buffer should be silent.");
   }
 
+  void testReusesAudioBuffersAlongChains() {
+    beginTest("RuntimeGraph reuses audio buffers once their readers have run");
+
+    auto graph = graph_test_helpers::makeProcessingGraph();
+
+    for (int64_t nodeId = 1; nodeId <= 4; ++nodeId) {
+      addGraphNode(*graph, nodeId);
+    }
+
+    addConnection(*graph, 100, 1, 2);
+    addConnection(*graph, 101, 2, 3);
+    addConnection(*graph, 102, 3, 4);
+
+    GraphRuntimeServices rtServices;
+    auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
+
+    auto getOutputBuffer = [&](int64_t nodeId) {
+      return &runtimeGraph->getNode(nodeId).nodeProcessContext->getOutputAudioBuffer(
+          outputPortId(nodeId));
+    };
+
+    expect(getOutputBuffer(1) != getOutputBuffer(2));
+    expect(getOutputBuffer(1) == getOutputBuffer(3),
+        "Node 3 should reuse node 1's output, since node 2 has read it.");
+    expect(getOutputBuffer(2) == getOutputBuffer(4),
+        "Node 4 should reuse node 2's output, since node 3 has read it.");
+
+    // Two chain buffers plus the shared silent buffer for node 1's input.
+    expectEquals(static_cast<int>(runtimeGraph->graphProcessContext->getAudioBufferCount()), 3);
+    expectEquals(static_cast<int>(runtimeGraph->unpooledAudioBufferCount), 5);
+  }
+
+  void testDoesNotShareAudioBuffersAcrossParallelBranches() {
+    beginTest("RuntimeGraph does not share audio buffers between parallel branches");
+
+    auto graph = graph_test_helpers::makeProcessingGraph();
+
+    for (int64_t nodeId = 1; nodeId <= 4; ++nodeId) {
+      addGraphNode(*graph, nodeId);
+    }
+
+    addConnection(*graph, 100, 1, 2);
+    addConnection(*graph, 101, 1, 3);
+    addConnection(*graph, 102, 2, 4);
+    addConnection(*graph, 103, 3, 4);
+
+    GraphRuntimeServices rtServices;
+    auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
+
+    auto getOutputBuffer = [&](int64_t nodeId) {
+      return &runtimeGraph->getNode(nodeId).nodeProcessContext->getOutputAudioBuffer(
+          outputPortId(nodeId));
+    };
+
+    auto* sourceOutputBuffer = getOutputBuffer(1);
+    auto* firstBranchOutputBuffer = getOutputBuffer(2);
+    auto* secondBranchOutputBuffer = getOutputBuffer(3);
+
+    expect(firstBranchOutputBuffer != secondBranchOutputBuffer,
+        "Nodes that can run at the same time should not share an output buffer.");
+    expect(firstBranchOutputBuffer != sourceOutputBuffer,
+        "A branch should not reuse a buffer the other branch may still be reading.");
+    expect(secondBranchOutputBuffer != sourceOutputBuffer,
+        "A branch should not reuse a buffer the other branch may still be reading.");
+
+    // Node 1's output is dead once both branches have run, so node 4 can
+    // reuse it for its summing buffer.
+    auto& mixNode = runtimeGraph->getNode(4);
+    auto* mixInputBuffer = &mixNode.nodeProcessContext->getInputAudioBuffer(inputPortId(4));
+    expect(mixInputBuffer == sourceOutputBuffer);
+    expect(getOutputBuffer(4) != mixInputBuffer);
+
+    for (int channel = 0; channel < sourceOutputBuffer->getNumChannels(); ++channel) {
+      for (int sample = 0; sample < 4; ++sample) {
+        firstBranchOutputBuffer->setSample(channel, sample, 1.0f);
+        secondBranchOutputBuffer->setSample(channel, sample, 2.0f);
+      }
+    }
+
+    processRuntimeGraph(*runtimeGraph, 4);
+
+    for (int channel = 0; channel < mixInputBuffer->getNumChannels(); ++channel) {
+      for (int sample = 0; sample < 4; ++sample) {
+        expectWithinAbsoluteError(mixInputBuffer->getSample(channel, sample), 3.0f, 0.0001f);
+      }
+    }
+  }
+
+  void testProcessesInPlaceWhereInputHasNoOtherReader() {
+    beginTest("RuntimeGraph processes in place where nothing else reads the input");
+
+    const auto gainInputPortId = GainProcessorModelBase::audioInputPortId;
+    const auto gainOutputPortId = GainProcessorModelBase::audioOutputPortId;
+
+    // 1 -> 2 -> 3 -> 4, where 2 and 3 are gain nodes. 5 fans out to 6 and 7,
+    // where 6 is a gain node.
+    auto graph = graph_test_helpers::makeProcessingGraph();
+    addGraphNode(*graph, 1);
+    addGainGraphNode(*graph, 2);
+    addGainGraphNode(*graph, 3);
+    addGraphNode(*graph, 4);
+    addGraphNode(*graph, 5);
+    addGainGraphNode(*graph, 6);
+    addGraphNode(*graph, 7);
+
+    addAudioConnection(*graph, 100, 1, outputPortId(1), 2, gainInputPortId);
+    addAudioConnection(*graph, 101, 2, gainOutputPortId, 3, gainInputPortId);
+    addAudioConnection(*graph, 102, 3, gainOutputPortId, 4, inputPortId(4));
+    addAudioConnection(*graph, 103, 5, outputPortId(5), 6, gainInputPortId);
+    addConnection(*graph, 104, 5, 7);
+
+    GraphRuntimeServices rtServices;
+    auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
+
+    auto getOutputBuffer = [&](int64_t nodeId, int64_t portId) {
+      return &runtimeGraph->getNode(nodeId).nodeProcessContext->getOutputAudioBuffer(portId);
+    };
+
+    auto* chainBuffer = getOutputBuffer(1, outputPortId(1));
+    expect(getOutputBuffer(2, gainOutputPortId) == chainBuffer,
+        "A gain node that is the only reader of its input should process in place.");
+    expect(getOutputBuffer(3, gainOutputPortId) == chainBuffer,
+        "In-place nodes in a chain should all share the chain's buffer.");
+    expect(&runtimeGraph->getNode(4).nodeProcessContext->getInputAudioBuffer(inputPortId(4)) ==
+           chainBuffer);
+
+    auto* fanOutBuffer = getOutputBuffer(5, outputPortId(5));
+    auto* fanOutGainBuffer = getOutputBuffer(6, gainOutputPortId);
+    expect(fanOutGainBuffer != fanOutBuffer,
+        "A gain node should not overwrite an input that another node also reads.");
+
+    for (int channel = 0; channel < chainBuffer->getNumChannels(); ++channel) {
+      for (int sample = 0; sample < 4; ++sample) {
+        chainBuffer->setSample(channel, sample, static_cast<float>(sample + 1));
+        fanOutBuffer->setSample(channel, sample, static_cast<float>(sample + 1));
+      }
+    }
+
+    processRuntimeGraph(*runtimeGraph, 4);
+
+    for (int channel = 0; channel < chainBuffer->getNumChannels(); ++channel) {
+      for (int sample = 0; sample < 4; ++sample) {
+        expectWithinAbsoluteError(
+            chainBuffer->getSample(channel, sample), static_cast<float>(sample + 1), 0.001f);
+        expectWithinAbsoluteError(
+            fanOutGainBuffer->getSample(channel, sample), static_cast<float>(sample + 1), 0.001f);
+        expectWithinAbsoluteError(
+            fanOutBuffer->getSample(channel, sample), static_cast<float>(sample + 1), 0.001f);
+      }
+    }
+  }
+
   void testAliasesSingleEventConnection() {
     beginTest("RuntimeGraph aliases single event connection buffers");
 
@@ -412,13 +701,13 @@ public:
     auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
 
     auto& sourceOutputBuffer =
-        runtimeGraph->nodes.at(1).nodeProcessContext->getOutputEventBuffer(eventOutputPortId(1));
+        runtimeGraph->getNode(1).nodeProcessContext->getOutputEventBuffer(eventOutputPortId(1));
     auto& destinationInputBuffer =
-        runtimeGraph->nodes.at(2).nodeProcessContext->getInputEventBuffer(eventInputPortId(2));
+        runtimeGraph->getNode(2).nodeProcessContext->getInputEventBuffer(eventInputPortId(2));
 
     expect(&sourceOutputBuffer == &destinationInputBuffer,
         "A single event connection should bind the destination input to the source output.");
-    expectEquals(static_cast<int>(runtimeGraph->nodes.at(2).connectionTransferActions.size()),
+    expectEquals(static_cast<int>(runtimeGraph->getNode(2).connectionTransferActions.size()),
         0,
         "A single aliased event connection should not need a transfer action.");
 
@@ -446,7 +735,7 @@ public:
     GraphRuntimeServices rtServices;
     auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
 
-    auto& destinationNode = runtimeGraph->nodes.at(3);
+    auto& destinationNode = runtimeGraph->getNode(3);
 
     expectEquals(static_cast<int>(destinationNode.connectionTransferActions.size()),
         1,
@@ -460,6 +749,133 @@ public:
         "Each real incoming event connection should contribute to the grouped transfer.");
   }
 
+  void testMergesEventFanInBySampleOffset() {
+    beginTest("Event fan-in merges its sources by sample offset");
+
+    auto graph = graph_test_helpers::makeProcessingGraph();
+    addEventGraphNode(*graph, 1);
+    addEventGraphNode(*graph, 2);
+    addEventGraphNode(*graph, 3);
+    addEventConnection(*graph, 100, 1, 3);
+    addEventConnection(*graph, 101, 2, 3);
+
+    GraphRuntimeServices rtServices;
+    auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
+
+    auto makeEvent = [](int sampleOffset, Event event) {
+      return LiveEvent{.sampleOffset = sampleOffset, .event = event};
+    };
+
+    // Source 2's note off shares a sample with source 1's note on, and should
+    // come first. Source 1's own note on and off on sample 5 keep their order.
+    EventSourceProcessor firstSource(eventOutputPortId(1),
+        {
+            makeEvent(0, Event(NoteOnEvent(60, 0, 1.0f, 0.0f))),
+            makeEvent(4, Event(NoteOnEvent(62, 0, 1.0f, 0.0f))),
+            makeEvent(5, Event(NoteOnEvent(64, 0, 1.0f, 0.0f))),
+            makeEvent(5, Event(NoteOffEvent(64, 0, 0.0f))),
+        });
+    EventSourceProcessor secondSource(eventOutputPortId(2),
+        {
+            makeEvent(2, Event(NoteOnEvent(48, 0, 1.0f, 0.0f))),
+            makeEvent(4, Event(NoteOffEvent(48, 0, 0.0f))),
+            makeEvent(7, Event(AllVoicesOffEvent())),
+        });
+    runtimeGraph->getNode(1).processor = &firstSource;
+    runtimeGraph->getNode(2).processor = &secondSource;
+
+    const auto& mergedBuffer =
+        runtimeGraph->getNode(3).nodeProcessContext->getInputEventBuffer(eventInputPortId(3));
+
+    struct ExpectedEvent {
+      int sampleOffset;
+      EventType type;
+      int16_t pitch;
+    };
+
+    const ExpectedEvent expectedEvents[] = {
+        {0, EventType::NoteOn, 60},
+        {2, EventType::NoteOn, 48},
+        {4, EventType::NoteOff, 48},
+        {4, EventType::NoteOn, 62},
+        {5, EventType::NoteOn, 64},
+        {5, EventType::NoteOff, 64},
+        {7, EventType::AllVoicesOff, 0},
+    };
+
+    // The second block checks that the merge starts over each block.
+    for (int block = 0; block < 2; ++block) {
+      processRuntimeGraph(*runtimeGraph, 8);
+
+      expectEquals(static_cast<int>(mergedBuffer.getNumEvents()), 7);
+      expect(mergedBuffer.isSorted());
+
+      for (size_t i = 0; i < std::min<size_t>(mergedBuffer.getNumEvents(), 7); ++i) {
+        const auto& event = mergedBuffer.getEvent(i);
+        const auto& expected = expectedEvents[i];
+
+        expectEquals(event.sampleOffset, expected.sampleOffset);
+        expect(event.event.type == expected.type, "Event " + juce::String(i) + " type");
+
+        if (expected.type == EventType::NoteOn) {
+          expectEquals(
+              static_cast<int>(event.event.noteOn.pitch), static_cast<int>(expected.pitch));
+        } else if (expected.type == EventType::NoteOff) {
+          expectEquals(
+              static_cast<int>(event.event.noteOff.pitch), static_cast<int>(expected.pitch));
+        }
+      }
+    }
+
+    expectEquals(static_cast<int>(mergedBuffer.getTimesGrown()),
+        0,
+        "The destination should be sized up front rather than grown while merging.");
+
+    runtimeGraph->getNode(1).processor = nullptr;
+    runtimeGraph->getNode(2).processor = nullptr;
+  }
+
+  void testPacksNodeStateIntoFlatStorage() {
+    beginTest("RuntimeGraph packs edges and counters into flat storage");
+
+    auto graph = graph_test_helpers::makeProcessingGraph();
+    addGraphNode(*graph, 1);
+    addGraphNode(*graph, 2);
+    addGraphNode(*graph, 3);
+    addGraphNode(*graph, 4);
+    addConnection(*graph, 100, 1, 2);
+    addConnection(*graph, 101, 1, 3);
+    addConnection(*graph, 102, 2, 4);
+    addConnection(*graph, 103, 3, 4);
+
+    GraphRuntimeServices rtServices;
+    auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
+
+    expectEquals(static_cast<int>(runtimeGraph->downstreamNodeStorage.size()), 4);
+    expectEquals(static_cast<int>(runtimeGraph->transferActionStorage.size()), 1);
+    expectEquals(static_cast<int>(runtimeGraph->transferSourceBufferIndexStorage.size()), 2);
+
+    const auto* downstreamNodesBegin = runtimeGraph->downstreamNodeStorage.data();
+    const auto* downstreamNodesEnd =
+        downstreamNodesBegin + runtimeGraph->downstreamNodeStorage.size();
+
+    for (auto& runtimeNode : runtimeGraph->nodes) {
+      expect(&runtimeGraph->nodes[runtimeNode.index] == &runtimeNode,
+          "Each node's index should match its position in the node array.");
+      expect(runtimeNode.rt_state.rt_remainingUpstreamNodes ==
+                 &runtimeGraph->rt_remainingUpstreamNodeCounts[runtimeNode.index],
+          "Each node should point at its own slot in the counter array.");
+
+      for (const auto& downstreamNode : runtimeNode.outgoingConnections) {
+        expect(&downstreamNode >= downstreamNodesBegin && &downstreamNode < downstreamNodesEnd,
+            "Outgoing connections should point into the graph's edge storage.");
+      }
+    }
+
+    expect(runtimeGraph->findNode(5) == nullptr, "Unknown node IDs should not be found.");
+    expectThrows(runtimeGraph->getNode(5));
+  }
+
   void testPrepareGraphForBlockResetsRemainingUpstreamNodeCounters() {
     beginTest("Runtime graph block preparation resets remaining upstream node counters");
 
@@ -473,39 +889,43 @@ public:
     GraphRuntimeServices rtServices;
     auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
 
-    for (auto& [_, runtimeNode] : runtimeGraph->nodes) {
-      runtimeNode.rt_state.rt_remainingUpstreamNodes.store(99, std::memory_order_relaxed);
+    for (auto& runtimeNode : runtimeGraph->nodes) {
+      runtimeNode.rt_state.rt_remainingUpstreamNodes->store(99, std::memory_order_relaxed);
     }
 
     GraphExecutorState executorState(*runtimeGraph);
-    rt_prepareGraphForBlock(executorState);
+    rt_prepareGraphForBlock(executorState, 0);
 
-    expectEquals(static_cast<int>(runtimeGraph->nodes.at(1).rt_state.rt_remainingUpstreamNodes.load(
-                     std::memory_order_relaxed)),
+    expectEquals(static_cast<int>(
+                     runtimeGraph->getNode(1).rt_state.rt_remainingUpstreamNodes->load(
+                         std::memory_order_relaxed)),
         0);
-    expectEquals(static_cast<int>(runtimeGraph->nodes.at(2).rt_state.rt_remainingUpstreamNodes.load(
-                     std::memory_order_relaxed)),
+    expectEquals(static_cast<int>(
+                     runtimeGraph->getNode(2).rt_state.rt_remainingUpstreamNodes->load(
+                         std::memory_order_relaxed)),
         0);
-    expectEquals(static_cast<int>(runtimeGraph->nodes.at(3).rt_state.rt_remainingUpstreamNodes.load(
-                     std::memory_order_relaxed)),
+    expectEquals(static_cast<int>(
+                     runtimeGraph->getNode(3).rt_state.rt_remainingUpstreamNodes->load(
+                         std::memory_order_relaxed)),
         2);
   }
 
   void testDecrementRemainingUpstreamNodeCounter() {
     beginTest("Runtime graph atomically decrements remaining upstream node counters");
 
+    std::atomic<size_t> remainingUpstreamNodes = 2;
     RuntimeNode runtimeNode(1, nullptr);
-    runtimeNode.rt_state.rt_remainingUpstreamNodes.store(2, std::memory_order_relaxed);
+    runtimeNode.rt_state.rt_remainingUpstreamNodes = &remainingUpstreamNodes;
 
     expect(!rt_decrementRemainingUpstreamNodes(runtimeNode),
         "The node should not be ready while one upstream node remains.");
-    expectEquals(static_cast<int>(runtimeNode.rt_state.rt_remainingUpstreamNodes.load(
+    expectEquals(static_cast<int>(runtimeNode.rt_state.rt_remainingUpstreamNodes->load(
                      std::memory_order_relaxed)),
         1);
 
     expect(rt_decrementRemainingUpstreamNodes(runtimeNode),
         "The node should be ready when the counter reaches zero.");
-    expectEquals(static_cast<int>(runtimeNode.rt_state.rt_remainingUpstreamNodes.load(
+    expectEquals(static_cast<int>(runtimeNode.rt_state.rt_remainingUpstreamNodes->load(
                      std::memory_order_relaxed)),
         0);
   }
@@ -522,7 +942,7 @@ public:
     auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
 
     auto& sourceOutputBuffer =
-        runtimeGraph->nodes.at(1).nodeProcessContext->getOutputAudioBuffer(outputPortId(1));
+        runtimeGraph->getNode(1).nodeProcessContext->getOutputAudioBuffer(outputPortId(1));
 
     for (int channel = 0; channel < sourceOutputBuffer.getNumChannels(); ++channel) {
       for (int sample = 0; sample < 4; ++sample) {
@@ -533,7 +953,7 @@ public:
     processRuntimeGraph(*runtimeGraph, 4);
 
     auto& destinationInputBuffer =
-        runtimeGraph->nodes.at(2).nodeProcessContext->getInputAudioBuffer(inputPortId(2));
+        runtimeGraph->getNode(2).nodeProcessContext->getInputAudioBuffer(inputPortId(2));
 
     for (int channel = 0; channel < destinationInputBuffer.getNumChannels(); ++channel) {
       for (int sample = 0; sample < 4; ++sample) {
@@ -557,8 +977,8 @@ public:
     auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
 
     auto& sourceOutputBuffer =
-        runtimeGraph->nodes.at(1).nodeProcessContext->getOutputAudioBuffer(outputPortId(1));
-    auto destinationInputBufferIndex = runtimeGraph->nodes.at(2).nodeProcessContext->getBufferIndex(
+        runtimeGraph->getNode(1).nodeProcessContext->getOutputAudioBuffer(outputPortId(1));
+    auto destinationInputBufferIndex = runtimeGraph->getNode(2).nodeProcessContext->getBufferIndex(
         NodePortDataType::audio, NodeProcessContext::BufferDirection::input, inputPortId(2));
     auto& destinationInputBuffer =
         runtimeGraph->graphProcessContext->getAudioBuffer(destinationInputBufferIndex);
@@ -595,14 +1015,14 @@ public:
     GraphRuntimeServices rtServices;
     auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
 
-    auto& sourceOutputBuffer = runtimeGraph->nodes.at(1).nodeProcessContext->getOutputControlBuffer(
+    auto& sourceOutputBuffer = runtimeGraph->getNode(1).nodeProcessContext->getOutputControlBuffer(
         controlOutputPortId(1));
     auto& destinationInputBuffer =
-        runtimeGraph->nodes.at(2).nodeProcessContext->getInputControlBuffer(controlInputPortId(2));
+        runtimeGraph->getNode(2).nodeProcessContext->getInputControlBuffer(controlInputPortId(2));
 
     expect(&sourceOutputBuffer == &destinationInputBuffer,
         "A single control connection should alias the destination input to the source output.");
-    expectEquals(static_cast<int>(runtimeGraph->nodes.at(2).connectionTransferActions.size()), 0);
+    expectEquals(static_cast<int>(runtimeGraph->getNode(2).connectionTransferActions.size()), 0);
 
     for (int sample = 0; sample < 4; ++sample) {
       sourceOutputBuffer.setSample(0, sample, static_cast<float>(sample) * 0.2f);
@@ -618,6 +1038,162 @@ public:
     }
   }
 
+  void testParametersDescribeControlBufferShape() {
+    beginTest("Parameters mark their control buffers as constant or ramping");
+
+    auto graph = graph_test_helpers::makeProcessingGraph();
+    auto graphNode = addControlGraphNode(*graph, 1, true);
+    (*graphNode->controlInputPorts()->at(0)->config()->parameterConfig())
+        ->smoothingDurationSeconds() = 1.0;
+
+    GraphRuntimeServices rtServices;
+    auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
+    auto& context = *runtimeGraph->getNode(1).nodeProcessContext;
+    auto& controlBuffer = context.getInputControlBuffer(controlInputPortId(1));
+
+    processRuntimeGraph(*runtimeGraph, 4);
+
+    auto shape = context.getInputControlBufferShape(controlInputPortId(1));
+    expect(shape.isConstant(), "A settled parameter should be marked constant.");
+    expectEquals(shape.startValue, 0.25f);
+    expect(context.rt_getActiveParameterIndices().empty(),
+        "A settled parameter should not be visited again until it changes.");
+
+    for (int sample = 0; sample < controlBuffer.getNumSamples(); ++sample) {
+      expectEquals(controlBuffer.getSample(0, sample), 0.25f);
+    }
+
+    context.setParameterValue(controlInputPortId(1), 0.75f);
+    processRuntimeGraph(*runtimeGraph, 4);
+
+    expectEquals(static_cast<int>(context.rt_getActiveParameterIndices().size()), 1);
+
+    shape = context.getInputControlBufferShape(controlInputPortId(1));
+    expect(shape.kind == ControlBufferShape::Kind::linearRamp,
+        "A parameter part way through a ramp should be marked as ramping.");
+    expect(shape.increment > 0.0f, "The ramp should rise towards the new value.");
+
+    for (int sample = 0; sample < 4; ++sample) {
+      expectWithinAbsoluteError(controlBuffer.getSample(0, sample),
+          shape.startValue + static_cast<float>(sample) * shape.increment,
+          0.000001f,
+          "The samples should follow the ramp.");
+    }
+  }
+
+  void testAppliesParameterChangeEventsAtTheirSampleOffsets() {
+    beginTest("Parameter change events take effect at their sample offsets");
+
+    auto graph = graph_test_helpers::makeProcessingGraph();
+    addEventGraphNode(*graph, 1);
+    auto graphNode = addControlGraphNode(*graph, 2, true);
+    graphNode->eventInputPorts()->push_back(
+        graph_test_helpers::makePort(eventInputPortId(2), 2, NodePortDataType::event));
+    addEventConnection(*graph, 100, 1, 2);
+
+    GraphRuntimeServices rtServices;
+    auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
+    auto& context = *runtimeGraph->getNode(2).nodeProcessContext;
+    auto& controlBuffer = context.getInputControlBuffer(controlInputPortId(2));
+
+    // Including one event for a port that isn't a parameter.
+    EventSourceProcessor processor(eventOutputPortId(1),
+        {
+            LiveEvent{
+                .sampleOffset = 1,
+                .event = Event(ParameterChangeEvent(controlInputPortId(3), 1.0f)),
+            },
+            LiveEvent{
+                .sampleOffset = 3,
+                .event = Event(ParameterChangeEvent(controlInputPortId(2), 0.75f)),
+            },
+            LiveEvent{
+                .sampleOffset = 6,
+                .event = Event(ParameterChangeEvent(controlInputPortId(2), 0.5f)),
+            },
+        });
+    runtimeGraph->getNode(1).processor = &processor;
+
+    processRuntimeGraph(*runtimeGraph, 8);
+
+    const float expectedSamples[] = {0.25f, 0.25f, 0.25f, 0.75f, 0.75f, 0.75f, 0.5f, 0.5f};
+
+    for (int sample = 0; sample < 8; ++sample) {
+      expectEquals(controlBuffer.getSample(0, sample), expectedSamples[sample]);
+    }
+
+    expect(context.getInputControlBufferShape(controlInputPortId(2)).kind ==
+               ControlBufferShape::Kind::arbitrary,
+        "A block split by parameter changes should not be described as constant or ramping.");
+
+    runtimeGraph->getNode(1).processor = nullptr;
+    processRuntimeGraph(*runtimeGraph, 8);
+
+    const auto shape = context.getInputControlBufferShape(controlInputPortId(2));
+    expect(shape.isConstant(), "The parameter should settle on the last event's value.");
+    expectEquals(shape.startValue, 0.5f);
+    expect(context.rt_getActiveParameterIndices().empty());
+  }
+
+  void testDropsParameterChangeEventsPastCapacity() {
+    beginTest("Parameter change events past the per-block capacity are dropped, not misapplied");
+
+    auto graph = graph_test_helpers::makeProcessingGraph();
+    addEventGraphNode(*graph, 1);
+    auto graphNode = addControlGraphNode(*graph, 2, true);
+    const int64_t secondParameterPortId = 27;
+    graphNode->controlInputPorts()->push_back(graph_test_helpers::makePort(secondParameterPortId,
+        2,
+        NodePortDataType::control,
+        0.25,
+        graph_test_helpers::makeParameterConfig(202, 0.25)));
+    graphNode->eventInputPorts()->push_back(
+        graph_test_helpers::makePort(eventInputPortId(2), 2, NodePortDataType::event));
+    addEventConnection(*graph, 100, 1, 2);
+
+    GraphRuntimeServices rtServices;
+    auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
+    auto& context = *runtimeGraph->getNode(2).nodeProcessContext;
+
+    // The second parameter's event arrives first, so the collected events are
+    // out of parameter order until they are sorted. The first parameter's
+    // events then fill the rest of the capacity, and the last one, which
+    // would change its value again, is dropped.
+    std::vector<LiveEvent> events;
+    events.push_back(LiveEvent{
+        .sampleOffset = 0,
+        .event = Event(ParameterChangeEvent(secondParameterPortId, 0.9f)),
+    });
+
+    for (int event = 0; event < DEFAULT_EVENT_BUFFER_SIZE; ++event) {
+      events.push_back(LiveEvent{
+          .sampleOffset = 4,
+          .event = Event(ParameterChangeEvent(controlInputPortId(2), 0.75f)),
+      });
+    }
+
+    events.push_back(LiveEvent{
+        .sampleOffset = 6,
+        .event = Event(ParameterChangeEvent(controlInputPortId(2), 0.1f)),
+    });
+
+    EventSourceProcessor processor(eventOutputPortId(1), std::move(events));
+    runtimeGraph->getNode(1).processor = &processor;
+
+    processRuntimeGraph(*runtimeGraph, 8);
+
+    auto& firstControlBuffer = context.getInputControlBuffer(controlInputPortId(2));
+    auto& secondControlBuffer = context.getInputControlBuffer(secondParameterPortId);
+    const float expectedFirstSamples[] = {0.25f, 0.25f, 0.25f, 0.25f, 0.75f, 0.75f, 0.75f, 0.75f};
+
+    for (int sample = 0; sample < 8; ++sample) {
+      expectEquals(firstControlBuffer.getSample(0, sample), expectedFirstSamples[sample]);
+      expectEquals(secondControlBuffer.getSample(0, sample), 0.9f);
+    }
+
+    runtimeGraph->getNode(1).processor = nullptr;
+  }
+
   void testSingleThreadedExecutorHandlesControlFanIn() {
     beginTest("Single-threaded executor handles control fan-in");
 
@@ -632,20 +1208,20 @@ public:
     auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
 
     auto& firstSourceOutputBuffer =
-        runtimeGraph->nodes.at(1).nodeProcessContext->getOutputControlBuffer(
+        runtimeGraph->getNode(1).nodeProcessContext->getOutputControlBuffer(
             controlOutputPortId(1));
     auto& secondSourceOutputBuffer =
-        runtimeGraph->nodes.at(2).nodeProcessContext->getOutputControlBuffer(
+        runtimeGraph->getNode(2).nodeProcessContext->getOutputControlBuffer(
             controlOutputPortId(2));
     auto& destinationInputBuffer =
-        runtimeGraph->nodes.at(3).nodeProcessContext->getInputControlBuffer(controlInputPortId(3));
+        runtimeGraph->getNode(3).nodeProcessContext->getInputControlBuffer(controlInputPortId(3));
 
     expect(&secondSourceOutputBuffer != &destinationInputBuffer,
         "Control fan-in should use a dedicated destination buffer.");
-    expectEquals(static_cast<int>(runtimeGraph->nodes.at(3).connectionTransferActions.size()),
+    expectEquals(static_cast<int>(runtimeGraph->getNode(3).connectionTransferActions.size()),
         1,
         "Control fan-in should create one grouped transfer action.");
-    expect(runtimeGraph->nodes.at(3).connectionTransferActions[0].dataType ==
+    expect(runtimeGraph->getNode(3).connectionTransferActions[0].dataType ==
                RuntimeConnectionDataType::control,
         "The transfer action should preserve its control data type.");
 
@@ -678,9 +1254,9 @@ public:
     auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
 
     auto& firstOutputBuffer =
-        runtimeGraph->nodes.at(1).nodeProcessContext->getOutputAudioBuffer(outputPortId(1));
+        runtimeGraph->getNode(1).nodeProcessContext->getOutputAudioBuffer(outputPortId(1));
     auto& secondOutputBuffer =
-        runtimeGraph->nodes.at(2).nodeProcessContext->getOutputAudioBuffer(outputPortId(2));
+        runtimeGraph->getNode(2).nodeProcessContext->getOutputAudioBuffer(outputPortId(2));
 
     for (int channel = 0; channel < firstOutputBuffer.getNumChannels(); ++channel) {
       for (int sample = 0; sample < 4; ++sample) {
@@ -692,9 +1268,9 @@ public:
     processRuntimeGraph(*runtimeGraph, 4);
 
     auto& secondInputBuffer =
-        runtimeGraph->nodes.at(2).nodeProcessContext->getInputAudioBuffer(inputPortId(2));
+        runtimeGraph->getNode(2).nodeProcessContext->getInputAudioBuffer(inputPortId(2));
     auto& thirdInputBuffer =
-        runtimeGraph->nodes.at(3).nodeProcessContext->getInputAudioBuffer(inputPortId(3));
+        runtimeGraph->getNode(3).nodeProcessContext->getInputAudioBuffer(inputPortId(3));
 
     for (int channel = 0; channel < secondInputBuffer.getNumChannels(); ++channel) {
       for (int sample = 0; sample < 4; ++sample) {
@@ -706,6 +1282,181 @@ public:
     }
   }
 
+  void testNodesWithoutProcessorsSilenceReusedOutputBuffers() {
+    beginTest("Nodes without processors do not pass on audio left in a reused buffer");
+
+    auto graph = graph_test_helpers::makeProcessingGraph();
+
+    for (int64_t nodeId = 1; nodeId <= 4; ++nodeId) {
+      addGraphNode(*graph, nodeId);
+    }
+
+    addConnection(*graph, 100, 1, 2);
+    addConnection(*graph, 101, 2, 3);
+    addConnection(*graph, 102, 3, 4);
+
+    GraphRuntimeServices rtServices;
+    auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
+
+    auto& firstOutputBuffer =
+        runtimeGraph->getNode(1).nodeProcessContext->getOutputAudioBuffer(outputPortId(1));
+    auto& thirdOutputBuffer =
+        runtimeGraph->getNode(3).nodeProcessContext->getOutputAudioBuffer(outputPortId(3));
+    auto& fourthInputBuffer =
+        runtimeGraph->getNode(4).nodeProcessContext->getInputAudioBuffer(inputPortId(4));
+    expect(&thirdOutputBuffer == &firstOutputBuffer,
+        "Node 3 should reuse node 1's output, since node 2 has read it.");
+    expect(&fourthInputBuffer == &thirdOutputBuffer);
+
+    TailLengthProcessor firstProcessor(outputPortId(1), Processor::infiniteTailLength);
+    TailLengthProcessor secondProcessor(outputPortId(2), Processor::infiniteTailLength);
+    runtimeGraph->getNode(1).processor = &firstProcessor;
+    runtimeGraph->getNode(2).processor = &secondProcessor;
+
+    processRuntimeGraph(*runtimeGraph, 4);
+
+    expectEquals(secondProcessor.processCount, 1);
+    expectEquals(fourthInputBuffer.getMagnitude(0, 4),
+        0.0f,
+        "Node 3 has no processor, so node 4 should hear silence, not node 1's audio.");
+
+    runtimeGraph->getNode(1).processor = nullptr;
+    runtimeGraph->getNode(2).processor = nullptr;
+  }
+
+  void testAudioFanInSkipsSilentSources() {
+    beginTest("Audio fan-in leaves out silent sources and passes silence on");
+
+    auto graph = graph_test_helpers::makeProcessingGraph();
+    addGraphNode(*graph, 1);
+    addGraphNode(*graph, 2);
+    addGraphNode(*graph, 3);
+    addConnection(*graph, 100, 1, 3);
+    addConnection(*graph, 101, 2, 3);
+
+    GraphRuntimeServices rtServices;
+    auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
+    auto& graphProcessContext = *runtimeGraph->graphProcessContext;
+
+    auto& firstOutputBuffer =
+        runtimeGraph->getNode(1).nodeProcessContext->getOutputAudioBuffer(outputPortId(1));
+    auto& secondOutputBuffer =
+        runtimeGraph->getNode(2).nodeProcessContext->getOutputAudioBuffer(outputPortId(2));
+    const auto destinationInputBufferIndex =
+        runtimeGraph->getNode(3).nodeProcessContext->getBufferIndex(
+            NodePortDataType::audio, NodeProcessContext::BufferDirection::input, inputPortId(3));
+    auto& destinationInputBuffer = graphProcessContext.getAudioBuffer(destinationInputBufferIndex);
+
+    firstOutputBuffer.clear();
+
+    for (int channel = 0; channel < secondOutputBuffer.getNumChannels(); ++channel) {
+      for (int sample = 0; sample < 4; ++sample) {
+        secondOutputBuffer.setSample(channel, sample, static_cast<float>(sample + 1));
+      }
+    }
+
+    processRuntimeGraph(*runtimeGraph, 4);
+
+    expect(!graphProcessContext.rt_isAudioBufferSilent(destinationInputBufferIndex),
+        "A fan-in with an audible source should not be silent.");
+
+    for (int channel = 0; channel < destinationInputBuffer.getNumChannels(); ++channel) {
+      for (int sample = 0; sample < 4; ++sample) {
+        expectWithinAbsoluteError(destinationInputBuffer.getSample(channel, sample),
+            static_cast<float>(sample + 1),
+            0.0001f);
+      }
+    }
+
+    secondOutputBuffer.clear();
+    processRuntimeGraph(*runtimeGraph, 4);
+
+    expect(graphProcessContext.rt_isAudioBufferSilent(destinationInputBufferIndex),
+        "A fan-in with only silent sources should be silent.");
+    expectEquals(destinationInputBuffer.getMagnitude(0, 4), 0.0f);
+  }
+
+  void testSkipsNodesAfterInputsFallSilentForTail() {
+    beginTest("Executor skips a node once its inputs have been silent for its tail length");
+
+    auto graph = graph_test_helpers::makeProcessingGraph();
+    addGraphNode(*graph, 1);
+    addGraphNode(*graph, 2);
+    addConnection(*graph, 100, 1, 2);
+
+    GraphRuntimeServices rtServices;
+    auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
+
+    TailLengthProcessor processor(outputPortId(2), 8);
+    auto& runtimeNode = runtimeGraph->getNode(2);
+    runtimeNode.processor = &processor;
+
+    auto& sourceOutputBuffer =
+        runtimeGraph->getNode(1).nodeProcessContext->getOutputAudioBuffer(outputPortId(1));
+    auto& outputBuffer = runtimeNode.nodeProcessContext->getOutputAudioBuffer(outputPortId(2));
+
+    sourceOutputBuffer.setSample(0, 0, 1.0f);
+    processRuntimeGraph(*runtimeGraph, 4);
+    expectEquals(processor.processCount, 1);
+
+    // The tail is 8 samples, so the node keeps running for two 4-sample
+    // blocks after its input goes silent.
+    sourceOutputBuffer.clear();
+    processRuntimeGraph(*runtimeGraph, 4);
+    processRuntimeGraph(*runtimeGraph, 4);
+    expectEquals(processor.processCount, 3);
+    expectEquals(outputBuffer.getMagnitude(0, 4), 1.0f);
+
+    processRuntimeGraph(*runtimeGraph, 4);
+    processRuntimeGraph(*runtimeGraph, 4);
+    expectEquals(processor.processCount, 3, "The node should be skipped after its tail.");
+    expectEquals(outputBuffer.getMagnitude(0, 4), 0.0f, "A skipped node's output is silent.");
+
+    sourceOutputBuffer.setSample(0, 0, 1.0f);
+    processRuntimeGraph(*runtimeGraph, 4);
+    expectEquals(processor.processCount, 4, "The node should wake when its input is audible.");
+
+    runtimeNode.processor = nullptr;
+  }
+
+  void testSkippedNodesKeepApplyingParameterChanges() {
+    beginTest("Skipped nodes keep applying parameter changes while their input is silent");
+
+    const auto gainPortId = GainProcessorModelBase::gainPortId;
+
+    auto graph = graph_test_helpers::makeProcessingGraph();
+    addGraphNode(*graph, 1);
+    auto gainNode = addGainGraphNode(*graph, 2);
+    (*gainNode->controlInputPorts()->at(0)->config()->parameterConfig())
+        ->smoothingDurationSeconds() = 8.0 / 44100.0;
+    addAudioConnection(
+        *graph, 100, 1, outputPortId(1), 2, GainProcessorModelBase::audioInputPortId);
+
+    GraphRuntimeServices rtServices;
+    auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
+    auto& context = *runtimeGraph->getNode(2).nodeProcessContext;
+
+    // The input is silent and the gain has no tail, so the node is skipped on
+    // every block from here on.
+    processRuntimeGraph(*runtimeGraph, 4);
+
+    context.setParameterValue(gainPortId, 0.5f);
+    processRuntimeGraph(*runtimeGraph, 4);
+
+    auto shape = context.getInputControlBufferShape(gainPortId);
+    expect(shape.kind == ControlBufferShape::Kind::linearRamp,
+        "The change should start smoothing on the block after it was set.");
+
+    for (int block = 0; block < 3; ++block) {
+      processRuntimeGraph(*runtimeGraph, 4);
+    }
+
+    shape = context.getInputControlBufferShape(gainPortId);
+    expect(shape.isConstant(), "Smoothing should finish while the node is skipped.");
+    expectEquals(shape.startValue, 0.5f);
+    expect(context.rt_getActiveParameterIndices().empty());
+  }
+
   void testCalculatesLinearPriorities() {
     beginTest("RuntimeGraph calculates priorities for a linear chain");
 
@@ -719,9 +1470,9 @@ public:
     GraphRuntimeServices rtServices;
     auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
 
-    expectEquals(static_cast<int>(runtimeGraph->nodes.at(1).priority), 3);
-    expectEquals(static_cast<int>(runtimeGraph->nodes.at(2).priority), 2);
-    expectEquals(static_cast<int>(runtimeGraph->nodes.at(3).priority), 1);
+    expectEquals(static_cast<int>(runtimeGraph->getNode(1).priority), 3);
+    expectEquals(static_cast<int>(runtimeGraph->getNode(2).priority), 2);
+    expectEquals(static_cast<int>(runtimeGraph->getNode(3).priority), 1);
   }
 
   void testCalculatesDiamondPriorities() {
@@ -740,10 +1491,10 @@ public:
     GraphRuntimeServices rtServices;
     auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
 
-    expectEquals(static_cast<int>(runtimeGraph->nodes.at(1).priority), 5);
-    expectEquals(static_cast<int>(runtimeGraph->nodes.at(2).priority), 2);
-    expectEquals(static_cast<int>(runtimeGraph->nodes.at(3).priority), 2);
-    expectEquals(static_cast<int>(runtimeGraph->nodes.at(4).priority), 1);
+    expectEquals(static_cast<int>(runtimeGraph->getNode(1).priority), 5);
+    expectEquals(static_cast<int>(runtimeGraph->getNode(2).priority), 2);
+    expectEquals(static_cast<int>(runtimeGraph->getNode(3).priority), 2);
+    expectEquals(static_cast<int>(runtimeGraph->getNode(4).priority), 1);
   }
 
   void testCalculatesDisconnectedComponentPriorities() {
@@ -762,11 +1513,329 @@ public:
     GraphRuntimeServices rtServices;
     auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
 
-    expectEquals(static_cast<int>(runtimeGraph->nodes.at(1).priority), 2);
-    expectEquals(static_cast<int>(runtimeGraph->nodes.at(2).priority), 1);
-    expectEquals(static_cast<int>(runtimeGraph->nodes.at(3).priority), 3);
-    expectEquals(static_cast<int>(runtimeGraph->nodes.at(4).priority), 2);
-    expectEquals(static_cast<int>(runtimeGraph->nodes.at(5).priority), 1);
+    expectEquals(static_cast<int>(runtimeGraph->getNode(1).priority), 2);
+    expectEquals(static_cast<int>(runtimeGraph->getNode(2).priority), 1);
+    expectEquals(static_cast<int>(runtimeGraph->getNode(3).priority), 3);
+    expectEquals(static_cast<int>(runtimeGraph->getNode(4).priority), 2);
+    expectEquals(static_cast<int>(runtimeGraph->getNode(5).priority), 1);
+  }
+
+  void testStagesMeasuredCostPriorities() {
+    beginTest("RuntimeGraph stages cost-weighted longest-path priorities");
+
+    auto graph = graph_test_helpers::makeProcessingGraph();
+    addGraphNode(*graph, 1);
+    addGraphNode(*graph, 2);
+    addGraphNode(*graph, 3);
+    addGraphNode(*graph, 4);
+    addConnection(*graph, 100, 1, 2);
+    addConnection(*graph, 101, 1, 3);
+    addConnection(*graph, 102, 2, 4);
+    addConnection(*graph, 103, 3, 4);
+
+    GraphRuntimeServices rtServices;
+    auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
+
+    runtimeGraph->getNode(1).rt_state.rt_averageProcessNanoseconds.store(10.0f);
+    runtimeGraph->getNode(2).rt_state.rt_averageProcessNanoseconds.store(100.0f);
+    runtimeGraph->getNode(3).rt_state.rt_averageProcessNanoseconds.store(5.0f);
+    runtimeGraph->getNode(4).rt_state.rt_averageProcessNanoseconds.store(20.0f);
+
+    expect(runtimeGraph->stageMeasuredCostPriorities());
+
+    // Staged priorities are not visible to the scheduler until the audio
+    // thread applies them.
+    expectEquals(static_cast<int>(runtimeGraph->getNode(1).priority), 5);
+    expect(!runtimeGraph->stageMeasuredCostPriorities(),
+        "Priorities should not be restaged before the audio thread applies them.");
+
+    runtimeGraph->rt_applyStagedPriorities();
+
+    expectEquals(static_cast<int>(runtimeGraph->getNode(1).priority), 130);
+    expectEquals(static_cast<int>(runtimeGraph->getNode(2).priority), 120);
+    expectEquals(static_cast<int>(runtimeGraph->getNode(3).priority), 25);
+    expectEquals(static_cast<int>(runtimeGraph->getNode(4).priority), 20);
+
+    expect(runtimeGraph->stageMeasuredCostPriorities());
+  }
+
+  void testDoesNotStageUnmeasuredPriorities() {
+    beginTest("RuntimeGraph keeps compile-time priorities until nodes are measured");
+
+    auto graph = graph_test_helpers::makeProcessingGraph();
+    addGraphNode(*graph, 1);
+    addGraphNode(*graph, 2);
+    addConnection(*graph, 100, 1, 2);
+
+    GraphRuntimeServices rtServices;
+    auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
+
+    expect(!runtimeGraph->stageMeasuredCostPriorities());
+    runtimeGraph->rt_applyStagedPriorities();
+
+    expectEquals(static_cast<int>(runtimeGraph->getNode(1).priority), 2);
+    expectEquals(static_cast<int>(runtimeGraph->getNode(2).priority), 1);
+  }
+
+  void testFusesLinearChains() {
+    beginTest("RuntimeGraph fuses single-input, single-output runs into one task");
+
+    // 1 -> 2 -> 3 -> 4
+    //           3 -> 5 -> 6
+    auto graph = graph_test_helpers::makeProcessingGraph();
+    for (int64_t nodeId = 1; nodeId <= 6; ++nodeId) {
+      addGraphNode(*graph, nodeId);
+    }
+    addConnection(*graph, 100, 1, 2);
+    addConnection(*graph, 101, 2, 3);
+    addConnection(*graph, 102, 3, 4);
+    addConnection(*graph, 103, 3, 5);
+    addConnection(*graph, 104, 5, 6);
+
+    GraphRuntimeServices rtServices;
+    auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
+
+    auto& head = runtimeGraph->getNode(1);
+    expectEquals(static_cast<int>(head.fusedChainNodes.size()), 2);
+    expect(head.fusedChainNodes[0] == &runtimeGraph->getNode(2));
+    expect(head.fusedChainNodes[1] == &runtimeGraph->getNode(3));
+    expect(&head.getTaskTail() == &runtimeGraph->getNode(3));
+
+    expect(!runtimeGraph->getNode(4).isFusedIntoChain);
+    expect(runtimeGraph->getNode(4).fusedChainNodes.empty());
+    expect(!runtimeGraph->getNode(5).isFusedIntoChain);
+    expectEquals(static_cast<int>(runtimeGraph->getNode(5).fusedChainNodes.size()), 1);
+    expect(runtimeGraph->getNode(6).isFusedIntoChain);
+
+    expectEquals(static_cast<int>(runtimeGraph->taskCount), 3);
+
+    // Fusion only affects scheduling. Edges and priorities are unchanged.
+    expectEquals(static_cast<int>(runtimeGraph->getNode(1).outgoingConnections.size()), 1);
+    expectEquals(static_cast<int>(runtimeGraph->getNode(3).outgoingConnections.size()), 2);
+    expectEquals(static_cast<int>(runtimeGraph->getNode(1).priority), 6);
+
+    processRuntimeGraph(*runtimeGraph, 8);
+    expect(runtimeGraph->availableTasks.empty());
+  }
+
+  void testAdoptsStateFromPreviousGraph() {
+    beginTest("RuntimeGraph adopts runtime state for unchanged nodes from the previous graph");
+
+    auto graph = graph_test_helpers::makeProcessingGraph();
+    addEventGraphNode(*graph, 1);
+    addControlGraphNode(*graph, 2, true);
+    addEventGraphNode(*graph, 4);
+    addEventGraphNode(*graph, 5);
+    addEventConnection(*graph, 100, 1, 5);
+    addEventConnection(*graph, 101, 4, 5);
+
+    GraphRuntimeServices rtServices;
+    auto previousGraph = buildRuntimeGraph(*graph, rtServices);
+
+    auto getFanInBuffer = [](RuntimeGraph& runtimeGraph) {
+      return runtimeGraph.graphProcessContext
+          ->getEventBuffer(runtimeGraph.getNode(5).nodeProcessContext->getBufferIndex(
+              NodePortDataType::event,
+              NodeProcessContext::BufferDirection::input,
+              eventInputPortId(5)))
+          .get();
+    };
+    const auto* previousFanInBuffer = getFanInBuffer(*previousGraph);
+
+    auto& previousEventNode = previousGraph->getNode(1);
+    previousEventNode.rt_state.rt_averageProcessNanoseconds.store(50.0f);
+    const auto* previousEventBuffer =
+        previousGraph->graphProcessContext
+            ->getEventBuffer(previousEventNode.nodeProcessContext->getBufferIndex(
+                NodePortDataType::event,
+                NodeProcessContext::BufferDirection::output,
+                eventOutputPortId(1)))
+            .get();
+
+    auto& previousSmoother =
+        previousGraph->getNode(2).nodeProcessContext->rt_getInputParameterBindings()[0].rt_smoother;
+    previousSmoother.setTargetValue(0.75f);
+    previousSmoother.process(1.0f);
+
+    addEventGraphNode(*graph, 3);
+    auto runtimeGraph = RuntimeGraph::fromProcessingGraph(*graph,
+        rtServices,
+        GraphBufferLayout{
+            .numAudioChannels = 2,
+            .blockSize = 8,
+        },
+        44100.0,
+        previousGraph.get());
+
+    expectEquals(static_cast<int>(runtimeGraph->nodeStateTransfers.size()),
+        4,
+        "Only nodes that exist in both graphs should be paired.");
+
+    // Parameters and event buffers are paired up front, so the swap doesn't
+    // have to search for them.
+    auto findTransfer = [&](int64_t nodeId) -> const RuntimeGraph::NodeStateTransfer* {
+      for (const auto& transfer : runtimeGraph->nodeStateTransfers) {
+        if (runtimeGraph->nodes[transfer.nodeIndex].id == nodeId) {
+          return &transfer;
+        }
+      }
+
+      return nullptr;
+    };
+
+    const auto* controlTransfer = findTransfer(2);
+    const auto* fanInTransfer = findTransfer(5);
+    expect(controlTransfer != nullptr && fanInTransfer != nullptr);
+
+    if (controlTransfer != nullptr && fanInTransfer != nullptr) {
+      expectEquals(static_cast<int>(controlTransfer->parameters.size()), 1);
+      expectEquals(static_cast<int>(controlTransfer->parameters[0].previousParameterIndex), 0);
+
+      const auto fanInBufferTransfer = std::ranges::find_if(fanInTransfer->eventBuffers,
+          [](const auto& transfer) { return transfer.keepLargerBuffer; });
+      expect(fanInBufferTransfer != fanInTransfer->eventBuffers.end(),
+          "The fan-in buffer should be paired, and only swapped for a larger one.");
+    }
+
+    runtimeGraph->rt_adoptStateFrom(*previousGraph);
+
+    auto& eventNode = runtimeGraph->getNode(1);
+    expectEquals(eventNode.rt_state.rt_averageProcessNanoseconds.load(), 50.0f);
+    expectEquals(runtimeGraph->getNode(3).rt_state.rt_averageProcessNanoseconds.load(), 0.0f);
+
+    const auto* eventBuffer =
+        runtimeGraph->graphProcessContext
+            ->getEventBuffer(eventNode.nodeProcessContext->getBufferIndex(NodePortDataType::event,
+                NodeProcessContext::BufferDirection::output,
+                eventOutputPortId(1)))
+            .get();
+    expect(eventBuffer == previousEventBuffer,
+        "Output event buffers should move to the new graph.");
+    expect(getFanInBuffer(*runtimeGraph) == previousFanInBuffer,
+        "Fan-in event buffers should move to the new graph.");
+
+    auto& smoother =
+        runtimeGraph->getNode(2).nodeProcessContext->rt_getInputParameterBindings()[0].rt_smoother;
+    expectEquals(smoother.getCurrentValue(), 0.75f);
+
+    // State is only adopted from the graph that this one was compiled against.
+    auto unrelatedGraph = buildRuntimeGraph(*graph, rtServices);
+    unrelatedGraph->getNode(1).rt_state.rt_averageProcessNanoseconds.store(10.0f);
+    runtimeGraph->rt_adoptStateFrom(*unrelatedGraph);
+    expectEquals(eventNode.rt_state.rt_averageProcessNanoseconds.load(), 50.0f);
+  }
+
+  void testCompilesFromSnapshotAndAttachesToModel() {
+    beginTest("RuntimeGraph compiles from a snapshot and attaches to the model afterward");
+
+    auto graph = graph_test_helpers::makeProcessingGraph();
+    addGraphNode(*graph, 1);
+    auto controlNode = addControlGraphNode(*graph, 2, true);
+
+    GraphRuntimeServices rtServices;
+    auto previousGraph = buildRuntimeGraph(*graph, rtServices);
+    auto* previousContext = previousGraph->getNode(2).nodeProcessContext;
+
+    ProcessingGraphSnapshot snapshot(*graph);
+
+    // Changes made after the snapshot is captured are not compiled.
+    addGraphNode(*graph, 3);
+    addConnection(*graph, 1, 1, 3);
+    controlNode->controlInputPorts()->at(0)->parameterValue() = 0.75;
+
+    auto runtimeGraph = RuntimeGraph::compile(snapshot.getGraph(),
+        rtServices,
+        GraphBufferLayout{
+            .numAudioChannels = 2,
+            .blockSize = 8,
+        },
+        44100.0);
+
+    expectEquals(static_cast<int>(runtimeGraph->nodes.size()), 2);
+    expectEquals(static_cast<int>(runtimeGraph->getNode(1).outgoingConnections.size()), 0);
+    expect(runtimeGraph->getNode(2).sourceNode != controlNode,
+        "Compiled nodes should refer to the snapshot's copy of the model.");
+    expect(controlNode->runtimeContext.value() == previousContext,
+        "Compiling should not touch the model.");
+
+    runtimeGraph->attachToModel(previousGraph.get(), &snapshot.getModelNodes());
+
+    auto& runtimeNode = runtimeGraph->getNode(2);
+    expect(runtimeNode.sourceNode == controlNode,
+        "Attaching should move compiled nodes onto the model nodes.");
+    expect(controlNode->runtimeContext.value() == runtimeNode.nodeProcessContext,
+        "Attaching should publish the new contexts to the model.");
+    expectEquals(static_cast<int>(runtimeGraph->nodeStateTransfers.size()),
+        4,
+        "Nodes moved onto the model should pair with the previous graph.");
+    expectWithinAbsoluteError(
+        runtimeNode.nodeProcessContext->getParameterValue(controlInputPortId(2)),
+        0.75f,
+        0.0001f,
+        "Parameter values changed after the snapshot should be picked up.");
+  }
+
+  void testKeepsParameterChangesMadeDuringCompile() {
+    beginTest("Parameter changes made while a graph compiles survive the swap to it");
+
+    auto graph = graph_test_helpers::makeProcessingGraph();
+    auto controlNode = addControlGraphNode(*graph, 2, true);
+
+    GraphRuntimeServices rtServices;
+    auto previousGraph = buildRuntimeGraph(*graph, rtServices);
+    auto* previousContext = previousGraph->getNode(2).nodeProcessContext;
+    processRuntimeGraph(*previousGraph, 8);
+
+    ProcessingGraphSnapshot snapshot(*graph);
+    auto runtimeGraph = RuntimeGraph::compile(snapshot.getGraph(),
+        rtServices,
+        GraphBufferLayout{
+            .numAudioChannels = 2,
+            .blockSize = 8,
+        },
+        44100.0);
+
+    // The previous graph doesn't process a block between this change and the
+    // swap, so its smoother is still at the old value.
+    controlNode->controlInputPorts()->at(0)->parameterValue() = 0.75;
+    previousContext->setParameterValue(controlInputPortId(2), 0.75f);
+
+    runtimeGraph->attachToModel(previousGraph.get(), &snapshot.getModelNodes());
+    runtimeGraph->rt_adoptStateFrom(*previousGraph);
+
+    auto& context = *runtimeGraph->getNode(2).nodeProcessContext;
+    expectEquals(context.rt_getInputParameterBindings()[0].rt_smoother.getTargetValue(), 0.75f);
+
+    processRuntimeGraph(*runtimeGraph, 8);
+
+    auto& controlBuffer = context.getInputControlBuffer(controlInputPortId(2));
+    for (int sample = 0; sample < 8; ++sample) {
+      expectEquals(controlBuffer.getSample(0, sample), 0.75f);
+    }
+  }
+
+  void testDoesNotFuseAcrossFanOutOrFanIn() {
+    beginTest("RuntimeGraph does not fuse across fan-out or fan-in");
+
+    auto graph = graph_test_helpers::makeProcessingGraph();
+    addGraphNode(*graph, 1);
+    addGraphNode(*graph, 2);
+    addGraphNode(*graph, 3);
+    addGraphNode(*graph, 4);
+    addConnection(*graph, 100, 1, 2);
+    addConnection(*graph, 101, 1, 3);
+    addConnection(*graph, 102, 2, 4);
+    addConnection(*graph, 103, 3, 4);
+
+    GraphRuntimeServices rtServices;
+    auto runtimeGraph = buildRuntimeGraph(*graph, rtServices);
+
+    for (auto& runtimeNode : runtimeGraph->nodes) {
+      expect(runtimeNode.fusedChainNodes.empty());
+      expect(!runtimeNode.isFusedIntoChain);
+    }
+
+    expectEquals(static_cast<int>(runtimeGraph->taskCount), 4);
   }
 
   void testAvailableTaskQueueOrdersByPriorityThenId() {
@@ -831,6 +1900,29 @@ public:
     expect(buildThrowsRuntimeError(*graph),
         "RuntimeGraph should reject pure cycles that have no input nodes.");
   }
+
+  void testCompilesLargeGraphs() {
+    beginTest("RuntimeGraph compiles deep and wide graphs of 50,000 nodes");
+
+    // Deep graphs must not overflow the stack, and path counts in wide ones
+    // saturate rather than wrap. How compile time grows with node count is
+    // measured by AnthemBench instead, since timings are too noisy to assert
+    // on in a test.
+    auto chainGraph = makeLayeredGraph(50000, 1);
+    auto layeredGraph = makeLayeredGraph(50000, 4);
+    GraphRuntimeServices rtServices;
+    auto chainRuntimeGraph = buildRuntimeGraph(*chainGraph, rtServices);
+    auto layeredRuntimeGraph = buildRuntimeGraph(*layeredGraph, rtServices);
+
+    expectEquals(static_cast<int>(chainRuntimeGraph->topologicalOrder.size()), 50000);
+    expectEquals(static_cast<int>(chainRuntimeGraph->getNode(1).priority), 50000);
+    expect(layeredRuntimeGraph->getNode(1).priority == std::numeric_limits<size_t>::max(),
+        "Priorities should saturate instead of wrapping.");
+
+    addConnection(*chainGraph, 1000000, 50000, 1);
+    expect(buildThrowsRuntimeError(*chainGraph),
+        "RuntimeGraph should reject a cycle through a deep chain.");
+  }
 };
 
 static RuntimeGraphTest runtimeGraphTest;
@@ -109,6 +109,62 @@ public:
           MAX_EVENT_BUFFER_SIZE,
           "High-water mark should reflect the cap.");
     }
+
+    {
+      beginTest("Reserve grows once to the requested capacity and keeps events");
+
+      EventBuffer buffer(2);
+
+      LiveEvent event{};
+      event.sampleOffset = 3;
+      event.event.type = EventType::NoteOn;
+      buffer.addEvent(event);
+
+      buffer.reserve(1);
+      expectEquals(static_cast<int>(buffer.getTimesGrown()), 0, "A smaller reserve is a no-op.");
+
+      buffer.reserve(100);
+      expectEquals(static_cast<int>(buffer.getSize()), 100);
+      expectEquals(static_cast<int>(buffer.getTimesGrown()), 1);
+      expectEquals(static_cast<int>(buffer.getNumEvents()), 1);
+      expectEquals(buffer.getEvent(0).sampleOffset, 3, "Existing events should be preserved.");
+
+      buffer.reserve(static_cast<size_t>(MAX_EVENT_BUFFER_SIZE) * 2);
+      expectEquals(static_cast<int>(buffer.getSize()),
+          MAX_EVENT_BUFFER_SIZE,
+          "Reserve should not exceed the hard cap.");
+    }
+
+    {
+      beginTest("Events are ordered by sample offset, then by type across buffers");
+
+      LiveEvent noteOn{};
+      noteOn.sampleOffset = 4;
+      noteOn.event = Event(NoteOnEvent(60, 0, 1.0f, 0.0f));
+
+      LiveEvent noteOff{};
+      noteOff.sampleOffset = 4;
+      noteOff.event = Event(NoteOffEvent(60, 0, 0.0f));
+
+      LiveEvent laterNoteOff = noteOff;
+      laterNoteOff.sampleOffset = 5;
+
+      expect(EventBuffer::comesBefore(noteOff, noteOn));
+      expect(!EventBuffer::comesBefore(noteOn, noteOff));
+      expect(EventBuffer::comesBefore(noteOn, laterNoteOff));
+      expect(!EventBuffer::comesBefore(noteOff, noteOff), "Equal events should tie.");
+
+      // A note on and off on the same sample stay in the order they were
+      // written within one buffer.
+      EventBuffer buffer(4);
+      buffer.addEvent(noteOn);
+      buffer.addEvent(noteOff);
+      buffer.addEvent(laterNoteOff);
+      expect(buffer.isSorted());
+
+      buffer.addEvent(noteOn);
+      expect(!buffer.isSorted(), "An earlier offset after a later one is out of order.");
+    }
   }
 };
 
@@ -0,0 +1,103 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "modules/processing_graph/runtime/graph_parameter_bank.h"
+
+#include <juce_core/juce_core.h>
+#include <vector>
+
+namespace anthem {
+
+class GraphParameterBankTest : public juce::UnitTest {
+  static std::vector<size_t> takeChanges(
+      GraphParameterBank& parameterBank, size_t firstIndex, size_t count) {
+    std::vector<size_t> changedIndices;
+    parameterBank.rt_takeChanges(
+        firstIndex, count, [&](size_t index) { changedIndices.push_back(index); });
+
+    return changedIndices;
+  }
+public:
+  GraphParameterBankTest() : juce::UnitTest("GraphParameterBankTest", "Anthem") {}
+
+  void runTest() override {
+    testTakesOnlyChangesInRange();
+    testKeepsValuesAndChangesWhenGrowing();
+  }
+
+  void testTakesOnlyChangesInRange() {
+    beginTest("Parameter bank reports and clears changes only within the given range");
+
+    GraphParameterBank parameterBank;
+
+    for (int index = 0; index < 130; ++index) {
+      parameterBank.add(0.0f);
+    }
+
+    expect(takeChanges(parameterBank, 0, 130).empty(), "New parameters should start clean.");
+
+    parameterBank.setValue(2, 0.5f);
+    parameterBank.setValue(63, 0.25f);
+    parameterBank.setValue(64, 0.75f);
+    parameterBank.setValue(129, 1.0f);
+    parameterBank.setValueWithoutNotifying(3, 0.5f);
+
+    auto changedIndices = takeChanges(parameterBank, 60, 10);
+    expectEquals(static_cast<int>(changedIndices.size()), 2);
+    expectEquals(static_cast<int>(changedIndices[0]), 63);
+    expectEquals(static_cast<int>(changedIndices[1]), 64);
+    expect(takeChanges(parameterBank, 60, 10).empty(), "Taking changes should clear them.");
+
+    changedIndices = takeChanges(parameterBank, 0, 130);
+    expectEquals(static_cast<int>(changedIndices.size()), 2);
+    expectEquals(static_cast<int>(changedIndices[0]), 2);
+    expectEquals(static_cast<int>(changedIndices[1]), 129);
+
+    expectEquals(parameterBank.getValue(3), 0.5f);
+    expectEquals(parameterBank.getValue(129), 1.0f);
+  }
+
+  void testKeepsValuesAndChangesWhenGrowing() {
+    beginTest("Parameter bank keeps values and changes when it grows");
+
+    GraphParameterBank parameterBank;
+    parameterBank.reserve(1);
+
+    const auto firstIndex = parameterBank.add(0.5f);
+    parameterBank.setValue(firstIndex, 0.75f);
+
+    for (int index = 0; index < 200; ++index) {
+      parameterBank.add(static_cast<float>(index) / 200.0f);
+    }
+
+    expectEquals(static_cast<int>(parameterBank.size()), 201);
+    expectEquals(parameterBank.getValue(firstIndex), 0.75f);
+    expectEquals(parameterBank.getValue(200), 199.0f / 200.0f);
+
+    const auto changedIndices = takeChanges(parameterBank, 0, parameterBank.size());
+    expectEquals(static_cast<int>(changedIndices.size()), 1);
+    expectEquals(static_cast<int>(changedIndices[0]), static_cast<int>(firstIndex));
+  }
+};
+
+static GraphParameterBankTest graphParameterBankTest;
+
+} // namespace anthem
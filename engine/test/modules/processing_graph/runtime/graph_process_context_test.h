@@ -25,7 +25,9 @@
 #include "modules/processing_graph/runtime/graph_runtime_services.h"
 #include "modules/processors/gain.h"
 
+#include <cstdint>
 #include <juce_core/juce_core.h>
+#include <vector>
 
 namespace anthem {
 
@@ -73,6 +75,8 @@ public:
     testBuffersUseExplicitLayout();
     testBufferIndicesRemainStableAndMonotonic();
     testReserveDoesNotAllocateBuffersEagerly();
+    testBufferChannelsAreAlignedAndPadded();
+    testPackBuffersKeepsContentsAndFollowsOrder();
     testNodeContextBindsPortsAndParameters();
     testMultipleNodeContextsShareGraphOwnedServices();
     testEachEventPortGetsItsOwnDefaultCapacityBuffer();
@@ -206,6 +210,81 @@ public:
         "Event buffers allocated after reserve should use the requested initial capacity.");
   }
 
+  void testBufferChannelsAreAlignedAndPadded() {
+    beginTest("Graph-owned buffer channels start on 64-byte boundaries");
+
+    GraphRuntimeServices rtServices;
+    GraphProcessContext context(rtServices,
+        GraphBufferLayout{
+            .numAudioChannels = 2,
+            .blockSize = 13,
+        });
+
+    // Not reserving makes the context grow its arenas as it goes.
+    for (int bufferIndex = 0; bufferIndex < 5; ++bufferIndex) {
+      auto& audioBuffer = context.getAudioBuffer(context.allocateAudioBuffer());
+      auto& controlBuffer = context.getControlBuffer(context.allocateControlBuffer());
+
+      for (int channel = 0; channel < audioBuffer.getNumChannels(); ++channel) {
+        expect(reinterpret_cast<uintptr_t>(audioBuffer.getReadPointer(channel)) %
+                       GraphBufferArena::alignmentBytes ==
+                   0,
+            "Audio channels should be aligned.");
+      }
+
+      expect(reinterpret_cast<uintptr_t>(controlBuffer.getReadPointer(0)) %
+                     GraphBufferArena::alignmentBytes ==
+                 0,
+          "Control channels should be aligned.");
+      expectEquals(audioBuffer.getNumSamples(), 13);
+    }
+  }
+
+  void testPackBuffersKeepsContentsAndFollowsOrder() {
+    beginTest("Packing buffers keeps their contents and lays them out in order");
+
+    GraphRuntimeServices rtServices;
+    GraphProcessContext context(rtServices,
+        GraphBufferLayout{
+            .numAudioChannels = 2,
+            .blockSize = 16,
+        });
+
+    auto firstAudioIndex = context.allocateAudioBuffer();
+    auto secondAudioIndex = context.allocateAudioBuffer();
+    auto controlIndex = context.allocateControlBuffer();
+
+    context.getAudioBuffer(firstAudioIndex).setSample(1, 3, 0.5f);
+    context.getAudioBuffer(secondAudioIndex).clear();
+    context.getControlBuffer(controlIndex).setSample(0, 15, 0.25f);
+
+    auto* firstAudioBufferObject = &context.getAudioBuffer(firstAudioIndex);
+
+    const std::vector<GraphProcessContext::BufferReference> bufferOrder{
+        {NodePortDataType::audio, secondAudioIndex},
+        {NodePortDataType::control, controlIndex},
+    };
+    context.packBuffers(bufferOrder);
+
+    auto& firstAudioBuffer = context.getAudioBuffer(firstAudioIndex);
+    auto& secondAudioBuffer = context.getAudioBuffer(secondAudioIndex);
+    auto& controlBuffer = context.getControlBuffer(controlIndex);
+
+    expect(&firstAudioBuffer == firstAudioBufferObject,
+        "Packing should keep buffer objects in place, since contexts point at them.");
+    expectWithinAbsoluteError(firstAudioBuffer.getSample(1, 3), 0.5f, 0.0001f);
+    expectWithinAbsoluteError(controlBuffer.getSample(0, 15), 0.25f, 0.0001f);
+    expect(secondAudioBuffer.hasBeenCleared(), "Packing should keep silence flags.");
+    expect(!firstAudioBuffer.hasBeenCleared());
+
+    // Listed buffers come first, in order, and unlisted buffers follow.
+    const auto channelSize = static_cast<ptrdiff_t>(GraphBufferArena::getPaddedChannelSize(16));
+    const auto* packStart = secondAudioBuffer.getReadPointer(0);
+
+    expect(controlBuffer.getReadPointer(0) - packStart == 2 * channelSize);
+    expect(firstAudioBuffer.getReadPointer(0) - packStart == 3 * channelSize);
+  }
+
   void testNodeContextBindsPortsAndParameters() {
     beginTest("Node contexts bind ports, parameters, and live note allocation");
 
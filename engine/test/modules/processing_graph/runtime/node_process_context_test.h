@@ -76,6 +76,7 @@ public:
     testParameterReadAndLiveNoteIdPassthrough();
     testClearBuffersClearsOnlyDocumentedBuffers();
     testMissingPortLookupsThrow();
+    testSparsePortIdsFallBackToMapLookup();
   }
 
   void testPortToBufferBinding() {
@@ -231,6 +232,43 @@ public:
 
     graphContext.cleanup();
   }
+
+  void testSparsePortIdsFallBackToMapLookup() {
+    beginTest("Port IDs outside the dense slot table still bind to their buffers");
+
+    auto node = makeFullyBoundNode(10);
+    node->audioOutputPorts()->push_back(
+        graph_test_helpers::makePort(100000, 10, NodePortDataType::audio));
+
+    GraphRuntimeServices rtServices;
+    GraphProcessContext graphContext(rtServices,
+        GraphBufferLayout{
+            .numAudioChannels = 2,
+            .blockSize = 32,
+        });
+    graphContext.reserve(1, 3, 2, 2);
+
+    auto& context = createNodeContext(node, graphContext);
+
+    auto& denseOutputBuffer = context.getOutputAudioBuffer(2);
+    auto& sparseOutputBuffer = context.getOutputAudioBuffer(100000);
+
+    expect(&denseOutputBuffer != &sparseOutputBuffer,
+        "Dense and sparse output ports should bind to different buffers.");
+    expect(&sparseOutputBuffer ==
+               &graphContext.getAudioBuffer(context.getBufferIndex(NodePortDataType::audio,
+                   NodeProcessContext::BufferDirection::output,
+                   100000)),
+        "Sparse port lookups should agree with getBufferIndex().");
+
+    // ID 0 is inside the slot table but has no port bound to it.
+    expectThrowsStdException(
+        [&]() { (void)context.getOutputAudioBuffer(0); }, "Empty port slots should throw.");
+    expectThrowsStdException(
+        [&]() { (void)context.getOutputAudioBuffer(-1); }, "Negative port IDs should throw.");
+
+    graphContext.cleanup();
+  }
 };
 
 static NodeProcessContextTest anthemNodeProcessContextTest;
@@ -30,6 +30,8 @@
 namespace anthem {
 
 class DbMeterAccumulatorTest : public juce::UnitTest {
+  static constexpr double sampleRate = 48000.0;
+
   struct PublishedValue {
     size_t channelIndex = 0;
     double valueDb = 0.0;
@@ -63,6 +65,10 @@ public:
     testPeakAccumulationCarriesAcrossBlocks();
     testPublishIntervalClampsToOne();
     testPrepareResetsAccumulatedState();
+    testRmsPublishesWindowLevel();
+    testLoudnessMatchesReferenceLevel();
+    testLoudnessIsSilentWithoutInput();
+    testModeChangeResetsMeasurement();
     testVisualizationProviderDrainsBufferedValues();
   }
 
@@ -70,7 +76,7 @@ public:
     beginTest("Db meter accumulator publishes per-window channel peaks with timestamps");
 
     DbMeterAccumulator accumulator;
-    accumulator.rt_prepare(2);
+    accumulator.rt_prepare(2, sampleRate);
 
     juce::AudioBuffer<float> buffer(2, 4);
     buffer.setSample(0, 0, 0.25f);
@@ -103,7 +109,7 @@ public:
     beginTest("Db meter accumulator carries the peak across blocks until the publish boundary");
 
     DbMeterAccumulator accumulator;
-    accumulator.rt_prepare(1);
+    accumulator.rt_prepare(1, sampleRate);
 
     juce::AudioBuffer<float> firstBlock(1, 1);
     firstBlock.setSample(0, 0, 0.70f);
@@ -142,7 +148,7 @@ public:
     beginTest("Db meter accumulator clamps publish intervals below one sample");
 
     DbMeterAccumulator accumulator;
-    accumulator.rt_prepare(1);
+    accumulator.rt_prepare(1, sampleRate);
 
     juce::AudioBuffer<float> buffer(1, 2);
     buffer.setSample(0, 0, 0.0f);
@@ -168,7 +174,7 @@ public:
     beginTest("Db meter accumulator prepare resets pending peaks and counters");
 
     DbMeterAccumulator accumulator;
-    accumulator.rt_prepare(1);
+    accumulator.rt_prepare(1, sampleRate);
 
     juce::AudioBuffer<float> firstBlock(1, 1);
     firstBlock.setSample(0, 0, 1.0f);
@@ -185,7 +191,7 @@ public:
 
     expectEquals(static_cast<int>(published.size()), 0, "A partial window should stay buffered");
 
-    accumulator.rt_prepare(1);
+    accumulator.rt_prepare(1, sampleRate);
 
     juce::AudioBuffer<float> secondBlock(1, 1);
     secondBlock.setSample(0, 0, 0.25f);
@@ -203,6 +209,127 @@ public:
     expectPublishedValue(published[0], 0, expectedDb(0.25f), 21, "Post-prepare value");
   }
 
+  static juce::AudioBuffer<float> makeSine(
+      int channelCount, int numSamples, double frequencyHz, float amplitude) {
+    juce::AudioBuffer<float> buffer(channelCount, numSamples);
+    buffer.clear();
+
+    for (int sample = 0; sample < numSamples; ++sample) {
+      const auto phase = 2.0 * juce::MathConstants<double>::pi * frequencyHz * sample / sampleRate;
+      buffer.setSample(0, sample, amplitude * static_cast<float>(std::sin(phase)));
+    }
+
+    return buffer;
+  }
+
+  // Runs buffer through the accumulator and returns the last value published
+  // for channelIndex.
+  static double processAndGetLastValue(DbMeterAccumulator& accumulator,
+      const juce::AudioBuffer<float>& buffer,
+      int64_t publishEverySamples,
+      size_t channelIndex) {
+    double lastValue = DbMeterAccumulator::silentDb;
+
+    accumulator.rt_processBlock(buffer,
+        buffer.getNumSamples(),
+        0,
+        publishEverySamples,
+        [&](size_t publishedChannelIndex, double valueDb, int64_t) {
+          if (publishedChannelIndex == channelIndex) {
+            lastValue = valueDb;
+          }
+        });
+
+    return lastValue;
+  }
+
+  void testRmsPublishesWindowLevel() {
+    beginTest("Db meter accumulator RMS mode publishes the level of each window");
+
+    DbMeterAccumulator accumulator;
+    accumulator.rt_prepare(2, sampleRate);
+    accumulator.rt_setMode(DbMeterAccumulator::Mode::rms);
+
+    // A whole number of cycles per window
+    const auto buffer = makeSine(2, 4800, 1000.0, 0.5f);
+
+    expectWithinAbsoluteError(processAndGetLastValue(accumulator, buffer, 480, 0),
+        20.0 * std::log10(0.5 / std::sqrt(2.0)),
+        0.001);
+    expectWithinAbsoluteError(processAndGetLastValue(accumulator, buffer, 480, 1),
+        DbMeterAccumulator::silentDb,
+        0.0001);
+  }
+
+  void testLoudnessMatchesReferenceLevel() {
+    beginTest("Db meter accumulator loudness modes read -3.01 LUFS for a full scale 997 Hz sine");
+
+    // BS.1770 gives this level for a full scale 1 kHz sine in one front
+    // channel.
+    constexpr double expectedLufs = -3.01;
+
+    const DbMeterAccumulator::Mode loudnessModes[] = {
+        DbMeterAccumulator::Mode::momentaryLoudness,
+        DbMeterAccumulator::Mode::shortTermLoudness,
+    };
+
+    for (const auto mode : loudnessModes) {
+      DbMeterAccumulator accumulator;
+      accumulator.rt_prepare(2, sampleRate);
+      accumulator.rt_setMode(mode);
+
+      // Longer than the short-term window, so the history is full
+      const auto buffer = makeSine(2, static_cast<int>(sampleRate * 4), 997.0, 1.0f);
+
+      const auto leftLufs = processAndGetLastValue(accumulator, buffer, 1024, 0);
+      expectWithinAbsoluteError(leftLufs, expectedLufs, 0.05);
+
+      // Loudness covers every channel, so the silent channel reads the same.
+      accumulator.rt_setMode(DbMeterAccumulator::Mode::peak);
+      accumulator.rt_setMode(mode);
+      const auto rightLufs = processAndGetLastValue(accumulator, buffer, 1024, 1);
+      expectWithinAbsoluteError(rightLufs, expectedLufs, 0.05);
+    }
+  }
+
+  void testLoudnessIsSilentWithoutInput() {
+    beginTest("Db meter accumulator loudness modes publish silence for silent input");
+
+    DbMeterAccumulator accumulator;
+    accumulator.rt_prepare(1, sampleRate);
+    accumulator.rt_setMode(DbMeterAccumulator::Mode::momentaryLoudness);
+
+    juce::AudioBuffer<float> buffer(1, 4800);
+    buffer.clear();
+
+    expectWithinAbsoluteError(processAndGetLastValue(accumulator, buffer, 1024, 0),
+        DbMeterAccumulator::silentDb,
+        0.0001);
+  }
+
+  void testModeChangeResetsMeasurement() {
+    beginTest("Db meter accumulator starts the measurement over when the mode changes");
+
+    DbMeterAccumulator accumulator;
+    accumulator.rt_prepare(1, sampleRate);
+
+    juce::AudioBuffer<float> loudBlock(1, 1);
+    loudBlock.setSample(0, 0, 1.0f);
+    processAndGetLastValue(accumulator, loudBlock, 2, 0);
+
+    accumulator.rt_setMode(DbMeterAccumulator::Mode::rms);
+
+    juce::AudioBuffer<float> quietBlock(1, 2);
+    quietBlock.setSample(0, 0, 0.5f);
+    quietBlock.setSample(0, 1, -0.5f);
+
+    // The sample from before the change is dropped, so the window is the two
+    // new samples.
+    expectWithinAbsoluteError(processAndGetLastValue(accumulator, quietBlock, 2, 0),
+        20.0 * std::log10(0.5),
+        0.0001);
+  }
+
   void testVisualizationProviderDrainsBufferedValues() {
     beginTest("Db meter visualization provider drains buffered values");
 
@@ -0,0 +1,144 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "modules/processors/gain_parameter_lookup.h"
+#include "modules/processors/gain_parameter_mapping.h"
+
+#include <cmath>
+#include <juce_core/juce_core.h>
+#include <vector>
+
+namespace anthem {
+
+class GainParameterLookupTest : public juce::UnitTest {
+  // The tolerance test/engine_integration_test.dart holds the mapping to
+  static constexpr double comparisonToleranceDb = 0.0003;
+
+  void expectMatchesMapping(const std::vector<float>& parameterValues) {
+    std::vector<float> gains(parameterValues.size());
+    rt_gainParameterValuesToLinear(
+        gains.data(), parameterValues.data(), static_cast<int>(parameterValues.size()));
+
+    for (size_t index = 0; index < parameterValues.size(); ++index) {
+      const auto parameterValue = parameterValues[index];
+      const auto expected = gainParameterValueToLinear(parameterValue);
+      const auto actual = gains[index];
+      const auto message = "parameter value " + juce::String(parameterValue, 9);
+
+      if (static_cast<double>(parameterValue) < kGainParameterLinearSectionCeilingNormalized) {
+        // Below -180 dB, only the absolute error matters.
+        expectWithinAbsoluteError(actual, expected, 1.0e-9f, message);
+        continue;
+      }
+
+      const auto errorDb =
+          std::abs(20.0 * std::log10(static_cast<double>(actual) / static_cast<double>(expected)));
+      expect(errorDb < comparisonToleranceDb,
+          message + " is off by " + juce::String(errorDb) + " dB");
+    }
+  }
+
+  void testMatchesMappingAcrossRange() {
+    beginTest("Gain lookup matches the mapping across the parameter range");
+
+    std::vector<float> parameterValues;
+    constexpr int sampleCount = 100000;
+
+    for (int index = 0; index <= sampleCount; ++index) {
+      parameterValues.push_back(static_cast<float>(index) / sampleCount);
+    }
+
+    expectMatchesMapping(parameterValues);
+  }
+
+  void testMatchesMappingAtBreakpoints() {
+    beginTest("Gain lookup matches the mapping at and around the section breakpoints");
+
+    // The values the Dart integration test samples
+    std::vector<float> parameterValues{
+        0.0f,
+        0.01f,
+        0.01001f,
+        0.02f,
+        0.25f,
+        0.5f,
+        0.75f,
+        kGainParameterZeroDbNormalized,
+        1.0f,
+    };
+
+    // The curve section rises steeply from its start, so this walks up from
+    // it in growing steps.
+    auto value = static_cast<float>(kGainParameterLinearSectionCeilingNormalized);
+
+    for (int step = 0; step < 200; ++step) {
+      for (int skip = 0; skip < step * step * step; ++skip) {
+        value = std::nextafter(value, 1.0f);
+      }
+
+      parameterValues.push_back(value);
+    }
+
+    for (const auto breakpoint : {kGainParameterLinearSectionCeilingNormalized,
+             kGainParameterCurveSectionCeilingNormalized}) {
+      const auto breakpointValue = static_cast<float>(breakpoint);
+      parameterValues.push_back(std::nextafter(breakpointValue, 0.0f));
+      parameterValues.push_back(std::nextafter(breakpointValue, 1.0f));
+    }
+
+    expectMatchesMapping(parameterValues);
+  }
+
+  void testClampsOutOfRangeValues() {
+    beginTest("Gain lookup clamps values outside [0, 1]");
+
+    const float parameterValues[] = {-0.5f, -0.0f, 1.5f};
+    float gains[3] = {};
+    rt_gainParameterValuesToLinear(gains, parameterValues, 3);
+
+    expectEquals(gains[0], 0.0f);
+    expectEquals(gains[1], 0.0f);
+    expectWithinAbsoluteError(gains[2], gainParameterValueToLinear(1.0f), 0.0001f);
+  }
+
+  void testWorksInPlace() {
+    beginTest("Gain lookup can write over its input");
+
+    std::vector<float> values{0.1f, 0.5f, kGainParameterZeroDbNormalized};
+    rt_gainParameterValuesToLinear(values.data(), values.data(), static_cast<int>(values.size()));
+
+    expectWithinAbsoluteError(values[2], 1.0f, 0.0001f);
+    expectWithinAbsoluteError(values[1], gainParameterValueToLinear(0.5f), 0.0001f);
+  }
+public:
+  GainParameterLookupTest() : juce::UnitTest("GainParameterLookupTest", "Anthem") {}
+
+  void runTest() override {
+    testMatchesMappingAcrossRange();
+    testMatchesMappingAtBreakpoints();
+    testClampsOutOfRangeValues();
+    testWorksInPlace();
+  }
+};
+
+static GainParameterLookupTest gainParameterLookupTest;
+
+} // namespace anthem
@@ -51,6 +51,7 @@ public:
 
   void runTest() override {
     testProcessAppliesPerSampleGain();
+    testProcessAppliesConstantGain();
   }
 
   void testProcessAppliesPerSampleGain() {
@@ -113,6 +114,54 @@ public:
 
     graphContext.cleanup();
   }
+
+  void testProcessAppliesConstantGain() {
+    beginTest("Gain processing applies a constant gain to the whole block");
+
+    auto node = makeNode();
+    GraphRuntimeServices rtServices;
+    GraphProcessContext graphContext(rtServices,
+        GraphBufferLayout{
+            .numAudioChannels = channelCount,
+            .blockSize = blockSize,
+        });
+    graphContext.reserve(1, 2, 1, 0);
+
+    auto& context = graph_test_helpers::createStandaloneNodeProcessContext(graphContext, node);
+    auto& outputBuffer = context.getOutputAudioBuffer(GainProcessorModelBase::audioOutputPortId);
+    auto& inputBuffer = graphContext.getAudioBuffer(context.getBufferIndex(NodePortDataType::audio,
+        NodeProcessContext::BufferDirection::input,
+        GainProcessorModelBase::audioInputPortId));
+    const auto gainBufferIndex = context.getBufferIndex(NodePortDataType::control,
+        NodeProcessContext::BufferDirection::input,
+        GainProcessorModelBase::gainPortId);
+    const auto gainParameterValue = gainDbToParameterValue(-6.0f);
+
+    for (int sample = 0; sample < blockSize; ++sample) {
+      inputBuffer.setSample(0, sample, static_cast<float>(sample));
+      inputBuffer.setSample(1, sample, -static_cast<float>(sample));
+      graphContext.getControlBuffer(gainBufferIndex).setSample(0, sample, gainParameterValue);
+    }
+
+    graphContext.rt_getControlBufferShape(gainBufferIndex) =
+        ControlBufferShape::constant(gainParameterValue);
+
+    auto processor = GainProcessor(GainProcessorModelImpl{.nodeId = nodeId});
+    processor.process(context, blockSize);
+
+    for (int sample = 0; sample < blockSize; ++sample) {
+      expectWithinAbsoluteError(outputBuffer.getSample(0, sample),
+          static_cast<float>(sample) * gainDbToLinear(-6.0f),
+          0.0001f,
+          "Channel 0 should be multiplied by the constant gain.");
+      expectWithinAbsoluteError(outputBuffer.getSample(1, sample),
+          -static_cast<float>(sample) * gainDbToLinear(-6.0f),
+          0.0001f,
+          "Channel 1 should be multiplied by the constant gain.");
+    }
+
+    graphContext.cleanup();
+  }
 };
 
 static GainProcessorTest gainProcessorTest;
@@ -0,0 +1,249 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "modules/processors/spectrum_analysis.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <juce_core/juce_core.h>
+#include <numbers>
+#include <vector>
+
+namespace anthem {
+
+class SpectrumAnalysisTest : public juce::UnitTest {
+  static constexpr double sampleRate = 48000.0;
+  static constexpr int chunkLength = SpectrumAnalyzerTap::chunkLength;
+
+  struct Spectrum {
+    std::vector<double> binsDb;
+    int64_t sampleTimestamp = 0;
+  };
+
+  static std::vector<Spectrum> analyse(SpectrumAnalysis& analysis,
+      const std::vector<float>& samples,
+      int64_t endTimestamp) {
+    std::vector<Spectrum> spectra;
+
+    analysis.addSamples(samples.data(),
+        static_cast<int>(samples.size()),
+        endTimestamp,
+        [&](const std::vector<double>& binsDb, int64_t sampleTimestamp) {
+          spectra.push_back(Spectrum{.binsDb = binsDb, .sampleTimestamp = sampleTimestamp});
+        });
+
+    return spectra;
+  }
+
+  void testTapQueuesMonoChunks() {
+    beginTest("Spectrum analyzer tap queues mono chunks with their end timestamps");
+
+    SpectrumAnalyzerTap tap(4);
+    std::vector<float> left(chunkLength * 2 + 10, 1.0f);
+    std::vector<float> right(left.size(), 0.5f);
+    const float* channels[] = {left.data(), right.data()};
+    std::vector<float> chunk(chunkLength);
+
+    tap.rt_write(channels, 2, static_cast<int>(left.size()), 1000);
+    expect(!tap.readChunk(chunk.data()).has_value(), "A disabled tap should queue nothing.");
+
+    tap.setEnabled(true);
+
+    // Written in uneven blocks, so chunks span block boundaries
+    int64_t blockStart = 2000;
+
+    for (int position = 0; position < static_cast<int>(left.size()); position += 100) {
+      const int length = std::min(100, static_cast<int>(left.size()) - position);
+      const float* blockChannels[] = {left.data() + position, right.data() + position};
+      tap.rt_write(blockChannels, 2, length, blockStart);
+      blockStart += length;
+    }
+
+    for (const int64_t expectedTimestamp : {2000 + chunkLength, 2000 + chunkLength * 2}) {
+      const auto timestamp = tap.readChunk(chunk.data());
+      expect(timestamp.has_value(), "A full chunk should be queued.");
+
+      if (timestamp.has_value()) {
+        expectEquals(*timestamp, expectedTimestamp);
+      }
+
+      expect(std::all_of(chunk.begin(), chunk.end(), [](float sample) { return sample == 0.75f; }),
+          "Chunks should hold the average of the channels.");
+    }
+
+    expect(!tap.readChunk(chunk.data()).has_value(), "A partial chunk should stay pending.");
+    expectEquals(static_cast<int>(tap.getDroppedChunkCount()), 0);
+  }
+
+  void testTapDropsPartialChunkWhileDisabled() {
+    beginTest("Spectrum analyzer tap starts a new chunk after it is re-enabled");
+
+    SpectrumAnalyzerTap tap(4);
+    tap.setEnabled(true);
+
+    std::vector<float> staleSamples(100, 1.0f);
+    const float* staleChannels[] = {staleSamples.data()};
+    tap.rt_write(staleChannels, 1, static_cast<int>(staleSamples.size()), 0);
+
+    tap.setEnabled(false);
+    tap.rt_write(staleChannels, 1, static_cast<int>(staleSamples.size()), 100);
+    tap.setEnabled(true);
+
+    std::vector<float> samples(chunkLength, 0.5f);
+    const float* channels[] = {samples.data()};
+    tap.rt_write(channels, 1, static_cast<int>(samples.size()), 5000);
+
+    std::vector<float> chunk(chunkLength);
+    const auto timestamp = tap.readChunk(chunk.data());
+    expect(timestamp.has_value(), "A full chunk should be queued.");
+
+    if (timestamp.has_value()) {
+      expectEquals(*timestamp, static_cast<int64_t>(5000 + chunkLength));
+    }
+
+    expect(std::all_of(chunk.begin(), chunk.end(), [](float sample) { return sample == 0.5f; }),
+        "The chunk should not hold audio from before the tap was disabled.");
+    expect(!tap.readChunk(chunk.data()).has_value());
+  }
+
+  void testTapDropsChunksWhenFull() {
+    beginTest("Spectrum analyzer tap drops and counts chunks once it is full");
+
+    SpectrumAnalyzerTap tap(2);
+    tap.setEnabled(true);
+
+    std::vector<float> samples(chunkLength * 4);
+
+    for (size_t index = 0; index < samples.size(); ++index) {
+      samples[index] = static_cast<float>(index / chunkLength);
+    }
+
+    const float* channels[] = {samples.data()};
+    tap.rt_write(channels, 1, static_cast<int>(samples.size()), 0);
+
+    expectEquals(static_cast<int>(tap.getDroppedChunkCount()), 2);
+
+    std::vector<float> chunk(chunkLength);
+
+    for (const float expectedValue : {0.0f, 1.0f}) {
+      expect(tap.readChunk(chunk.data()).has_value());
+      expectEquals(chunk.front(), expectedValue, "The oldest chunks should be kept.");
+    }
+
+    expect(!tap.readChunk(chunk.data()).has_value());
+  }
+
+  void testConfigIsClamped() {
+    beginTest("Spectrum analysis clamps its config");
+
+    SpectrumAnalysis analysis(
+        SpectrumAnalysisConfig{.fftSize = 1000, .overlap = 0, .binCount = 5000}, sampleRate);
+
+    expectEquals(analysis.getConfig().fftSize, 1024);
+    expectEquals(analysis.getConfig().overlap, 1);
+    expectEquals(analysis.getConfig().binCount, SpectrumAnalysis::maxBinCount);
+  }
+
+  void testSpectraFollowTheHop() {
+    beginTest("Spectrum analysis makes a spectrum every hop with its end timestamp");
+
+    SpectrumAnalysis analysis(
+        SpectrumAnalysisConfig{.fftSize = 1024, .overlap = 4, .binCount = 16}, sampleRate);
+
+    const auto spectra = analyse(analysis, std::vector<float>(1000, 0.0f), 5000);
+
+    expectEquals(static_cast<int>(spectra.size()), 3);
+
+    for (size_t index = 0; index < spectra.size(); ++index) {
+      expectEquals(spectra[index].sampleTimestamp, static_cast<int64_t>(4000 + 256 * (index + 1)));
+      expectEquals(static_cast<int>(spectra[index].binsDb.size()), 16);
+    }
+
+    // The remaining samples carry over to the next call.
+    const auto laterSpectra = analyse(analysis, std::vector<float>(32, 0.0f), 5032);
+    expectEquals(static_cast<int>(laterSpectra.size()), 1);
+
+    if (!laterSpectra.empty()) {
+      expectEquals(laterSpectra[0].sampleTimestamp, static_cast<int64_t>(5024));
+    }
+  }
+
+  void testSineReadsFullScaleInItsBand() {
+    beginTest("Spectrum analysis reads a full scale sine at 0 dB in its band only");
+
+    constexpr int fftSize = 2048;
+    constexpr int binCount = 64;
+
+    SpectrumAnalysis analysis(
+        SpectrumAnalysisConfig{.fftSize = fftSize, .overlap = 1, .binCount = binCount},
+        sampleRate);
+
+    // Centred on an FFT bin
+    const double frequencyHz = 43.0 * sampleRate / fftSize;
+    std::vector<float> samples(fftSize);
+
+    for (int index = 0; index < fftSize; ++index) {
+      samples[static_cast<size_t>(index)] = static_cast<float>(
+          std::sin(2.0 * std::numbers::pi * frequencyHz * index / sampleRate));
+    }
+
+    const auto spectra = analyse(analysis, samples, fftSize);
+    expectEquals(static_cast<int>(spectra.size()), 1);
+
+    if (spectra.empty()) {
+      return;
+    }
+
+    const auto& binsDb = spectra[0].binsDb;
+    const auto loudest = std::max_element(binsDb.begin(), binsDb.end());
+    const auto loudestBand = static_cast<int>(loudest - binsDb.begin());
+
+    // The band the frequency falls in, counting from 20 Hz to 20 kHz
+    const auto expectedBand =
+        static_cast<int>(std::log(frequencyHz / 20.0) / std::log(1000.0) * binCount);
+
+    expectEquals(loudestBand, expectedBand);
+    expectWithinAbsoluteError(*loudest, 0.0, 0.01);
+
+    for (int band = 0; band < binCount; ++band) {
+      if (std::abs(band - expectedBand) > 8) {
+        expect(binsDb[static_cast<size_t>(band)] < -60.0,
+            "Band " + juce::String(band) + " should be far below the sine");
+      }
+    }
+  }
+public:
+  SpectrumAnalysisTest() : juce::UnitTest("SpectrumAnalysisTest", "Anthem") {}
+
+  void runTest() override {
+    testTapQueuesMonoChunks();
+    testTapDropsPartialChunkWhileDisabled();
+    testTapDropsChunksWhenFull();
+    testConfigIsClamped();
+    testSpectraFollowTheHop();
+    testSineReadsFullScaleInItsBand();
+  }
+};
+
+static SpectrumAnalysisTest spectrumAnalysisTest;
+
+} // namespace anthem
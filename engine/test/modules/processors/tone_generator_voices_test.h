@@ -0,0 +1,207 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "modules/processing_graph/processor/event_buffer.h"
+#include "modules/processors/tone_generator_voices.h"
+
+#include <cmath>
+#include <juce_core/juce_core.h>
+#include <vector>
+
+namespace anthem {
+
+class ToneGeneratorVoicesTest : public juce::UnitTest {
+  static constexpr double sampleRate = 48000.0;
+  static constexpr int blockSize = 512;
+
+  // A4 at a fiftieth of a cycle per sample
+  static constexpr float referenceIncrement = 0.01f;
+
+  // Samples until the envelope reaches full level
+  static constexpr int attackSamples =
+      static_cast<int>(ToneGeneratorVoices::envelopeSeconds * sampleRate);
+
+  static LiveEvent makeNoteOn(int sampleOffset, LiveNoteId liveId, int16_t pitch, float velocity) {
+    return LiveEvent{
+        .sampleOffset = sampleOffset,
+        .liveId = liveId,
+        .event = Event(NoteOnEvent(pitch, 0, velocity, 0.0f)),
+    };
+  }
+
+  static LiveEvent makeNoteOff(int sampleOffset, LiveNoteId liveId, int16_t pitch) {
+    return LiveEvent{
+        .sampleOffset = sampleOffset,
+        .liveId = liveId,
+        .event = Event(NoteOffEvent(pitch, 0, 0.0f)),
+    };
+  }
+
+  static std::vector<float> render(ToneGeneratorVoices& voices, const EventBuffer& events) {
+    std::vector<float> output(blockSize, referenceIncrement);
+    voices.rt_process(events, output.data(), output.data(), blockSize);
+    return output;
+  }
+
+  void expectSilent(
+      const std::vector<float>& output, int start, int end, const juce::String& context) {
+    for (int sample = start; sample < end; ++sample) {
+      if (output[static_cast<size_t>(sample)] != 0.0f) {
+        expect(false, context + ": sample " + juce::String(sample) + " is not silent");
+        return;
+      }
+    }
+  }
+
+  void testSilentWithoutNotes() {
+    beginTest("Tone generator voices are silent without notes");
+
+    ToneGeneratorVoices voices;
+    voices.rt_prepare(sampleRate);
+    EventBuffer events(4);
+
+    expectSilent(render(voices, events), 0, blockSize, "no notes");
+    expectEquals(voices.rt_getActiveVoiceCount(), 0);
+  }
+
+  void testNoteStartsAtSampleOffset() {
+    beginTest("Tone generator voices start notes at their sample offsets");
+
+    constexpr int noteOnOffset = 37;
+    constexpr float velocity = 0.5f;
+
+    ToneGeneratorVoices voices;
+    voices.rt_prepare(sampleRate);
+    EventBuffer events(4);
+
+    // An octave above A4
+    events.addEvent(makeNoteOn(noteOnOffset, 1, 81, velocity));
+
+    const auto output = render(voices, events);
+
+    expectSilent(output, 0, noteOnOffset, "before the note");
+    expect(output[noteOnOffset] != 0.0f, "The note should sound from its sample offset.");
+    expectEquals(voices.rt_getActiveVoiceCount(), 1);
+
+    for (int sample = noteOnOffset + attackSamples; sample < blockSize; ++sample) {
+      const auto samplesIntoNote = sample - noteOnOffset + 1;
+      const auto expected = velocity * std::sin(2.0 * juce::MathConstants<double>::pi *
+                                                samplesIntoNote * 2.0 * referenceIncrement);
+
+      expectWithinAbsoluteError(static_cast<double>(output[static_cast<size_t>(sample)]),
+          expected,
+          1.0e-4,
+          "sample " + juce::String(sample));
+    }
+  }
+
+  void testNoteOffReleasesVoice() {
+    beginTest("Tone generator voices fade out and free the voice after a note off");
+
+    constexpr int noteOffOffset = 10;
+
+    ToneGeneratorVoices voices;
+    voices.rt_prepare(sampleRate);
+    EventBuffer events(4);
+
+    events.addEvent(makeNoteOn(0, 1, 69, 1.0f));
+    render(voices, events);
+
+    events.clear();
+    events.addEvent(makeNoteOff(noteOffOffset, 1, 69));
+    const auto output = render(voices, events);
+
+    expect(output[noteOffOffset] != 0.0f, "The note should fade out rather than stop.");
+    expectSilent(output, noteOffOffset + attackSamples, blockSize, "after the release");
+    expectEquals(voices.rt_getActiveVoiceCount(), 0);
+  }
+
+  void testNoteOffMatchesLiveId() {
+    beginTest("Tone generator voices release only the note with the matching live ID");
+
+    ToneGeneratorVoices voices;
+    voices.rt_prepare(sampleRate);
+    EventBuffer events(4);
+
+    // The same pitch twice, so only the live ID tells them apart
+    events.addEvent(makeNoteOn(0, 1, 69, 1.0f));
+    events.addEvent(makeNoteOn(0, 2, 69, 1.0f));
+    render(voices, events);
+    expectEquals(voices.rt_getActiveVoiceCount(), 2);
+
+    events.clear();
+    events.addEvent(makeNoteOff(0, 2, 69));
+    render(voices, events);
+    expectEquals(voices.rt_getActiveVoiceCount(), 1);
+
+    events.clear();
+    events.addEvent(makeNoteOff(0, 1, 69));
+    render(voices, events);
+    expectEquals(voices.rt_getActiveVoiceCount(), 0);
+  }
+
+  void testStealsWhenFull() {
+    beginTest("Tone generator voices steal a voice once every voice is in use");
+
+    ToneGeneratorVoices voices;
+    voices.rt_prepare(sampleRate);
+    EventBuffer events(ToneGeneratorVoices::maxVoices + 1);
+
+    for (int note = 0; note <= ToneGeneratorVoices::maxVoices; ++note) {
+      events.addEvent(makeNoteOn(0, note + 1, static_cast<int16_t>(note % 128), 0.001f));
+    }
+
+    const auto output = render(voices, events);
+    expectEquals(voices.rt_getActiveVoiceCount(), ToneGeneratorVoices::maxVoices);
+
+    for (const auto sample : output) {
+      if (!std::isfinite(sample)) {
+        expect(false, "All voices together should render finite samples.");
+        break;
+      }
+    }
+
+    // The first note was stolen, so releasing it does nothing.
+    events.clear();
+    events.addEvent(makeNoteOff(0, 1, 0));
+    render(voices, events);
+    expectEquals(voices.rt_getActiveVoiceCount(), ToneGeneratorVoices::maxVoices);
+
+    voices.rt_releaseAllVoices();
+    events.clear();
+    render(voices, events);
+    expectEquals(voices.rt_getActiveVoiceCount(), 0);
+  }
+public:
+  ToneGeneratorVoicesTest() : juce::UnitTest("ToneGeneratorVoicesTest", "Anthem") {}
+
+  void runTest() override {
+    testSilentWithoutNotes();
+    testNoteStartsAtSampleOffset();
+    testNoteOffReleasesVoice();
+    testNoteOffMatchesLiveId();
+    testStealsWhenFull();
+  }
+};
+
+static ToneGeneratorVoicesTest toneGeneratorVoicesTest;
+
+} // namespace anthem
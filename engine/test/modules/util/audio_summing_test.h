@@ -0,0 +1,95 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "modules/util/audio_summing.h"
+
+#include <juce_core/juce_core.h>
+#include <vector>
+
+namespace anthem {
+
+class AudioSummingTest : public juce::UnitTest {
+public:
+  AudioSummingTest() : juce::UnitTest("AudioSummingTest", "Anthem") {}
+
+  void runTest() override {
+    testMatchesSequentialSum();
+    testLeavesDestinationWithoutSources();
+  }
+
+  void testMatchesSequentialSum() {
+    beginTest("Summing kernel matches a sample-by-sample sum");
+
+    juce::Random random(1234);
+
+    // Counts either side of the leaf size and of each tree level, and block
+    // sizes that end part way through a tile.
+    for (const auto sourceCount : {1, 2, 3, 4, 5, 8, 9, 17, 130}) {
+      for (const auto numSamples : {1, 127, 128, 300}) {
+        std::vector<std::vector<float>> sourceData(
+            static_cast<size_t>(sourceCount), std::vector<float>(static_cast<size_t>(numSamples)));
+        std::vector<const float*> sources;
+
+        for (auto& source : sourceData) {
+          for (auto& sample : source) {
+            sample = random.nextFloat() * 2.0f - 1.0f;
+          }
+
+          sources.push_back(source.data());
+        }
+
+        // The sample after the block should not be written.
+        std::vector<float> destination(static_cast<size_t>(numSamples) + 1, 5.0f);
+        rt_sumAudioBuffers(destination.data(), sources, numSamples);
+
+        for (int sample = 0; sample < numSamples; ++sample) {
+          double expected = 0.0;
+
+          for (const auto& source : sourceData) {
+            expected += source[static_cast<size_t>(sample)];
+          }
+
+          expectWithinAbsoluteError(static_cast<double>(destination[static_cast<size_t>(sample)]),
+              expected,
+              0.0001 * sourceCount,
+              juce::String(sourceCount) + " sources, sample " + juce::String(sample));
+        }
+
+        expectEquals(destination.back(), 5.0f);
+      }
+    }
+  }
+
+  void testLeavesDestinationWithoutSources() {
+    beginTest("Summing no sources leaves the destination as it is");
+
+    std::vector<float> destination(16, 0.5f);
+    rt_sumAudioBuffers(destination.data(), {}, 16);
+
+    for (const auto sample : destination) {
+      expectEquals(sample, 0.5f);
+    }
+  }
+};
+
+static AudioSummingTest audioSummingTest;
+
+} // namespace anthem
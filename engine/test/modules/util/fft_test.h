@@ -0,0 +1,106 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "modules/util/fft.h"
+
+#include <cmath>
+#include <complex>
+#include <juce_core/juce_core.h>
+#include <numbers>
+#include <stdexcept>
+#include <vector>
+
+namespace anthem {
+
+class FftTest : public juce::UnitTest {
+  static std::vector<std::complex<double>> naiveDft(
+      const std::vector<std::complex<float>>& input) {
+    const auto size = input.size();
+    std::vector<std::complex<double>> output(size);
+
+    for (size_t frequency = 0; frequency < size; ++frequency) {
+      for (size_t index = 0; index < size; ++index) {
+        const double angle = -2.0 * std::numbers::pi * static_cast<double>(frequency * index) /
+                             static_cast<double>(size);
+        output[frequency] += std::complex<double>(input[index]) * std::polar(1.0, angle);
+      }
+    }
+
+    return output;
+  }
+
+  void testMatchesNaiveDft() {
+    beginTest("FFT matches a naive DFT");
+
+    juce::Random random(31);
+
+    for (const int size : {1, 2, 4, 8, 64, 256}) {
+      std::vector<std::complex<float>> data(static_cast<size_t>(size));
+
+      for (auto& value : data) {
+        const auto real = random.nextFloat() * 2.0f - 1.0f;
+        const auto imag = random.nextFloat() * 2.0f - 1.0f;
+        value = std::complex<float>(real, imag);
+      }
+
+      const auto expected = naiveDft(data);
+
+      Fft fft(size);
+      fft.perform(data.data());
+
+      for (size_t index = 0; index < data.size(); ++index) {
+        const auto context =
+            juce::String(size) + " points, bin " + juce::String(static_cast<int>(index));
+        const auto actual = std::complex<double>(data[index]);
+
+        expectWithinAbsoluteError(actual.real(), expected[index].real(), 1.0e-3, context);
+        expectWithinAbsoluteError(actual.imag(), expected[index].imag(), 1.0e-3, context);
+      }
+    }
+  }
+
+  void testRejectsSizesThatArentPowersOfTwo() {
+    beginTest("FFT rejects sizes that aren't powers of two");
+
+    for (const int size : {0, 3, 100, -8}) {
+      bool threw = false;
+
+      try {
+        Fft fft(size);
+      } catch (const std::invalid_argument&) {
+        threw = true;
+      }
+
+      expect(threw, "Size " + juce::String(size) + " should be rejected.");
+    }
+  }
+public:
+  FftTest() : juce::UnitTest("FftTest", "Anthem") {}
+
+  void runTest() override {
+    testMatchesNaiveDft();
+    testRejectsSizesThatArentPowersOfTwo();
+  }
+};
+
+static FftTest fftTest;
+
+} // namespace anthem
@@ -0,0 +1,104 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "modules/util/linear_parameter_smoother.h"
+
+#include <array>
+#include <juce_core/juce_core.h>
+
+namespace anthem {
+
+class LinearParameterSmootherTest : public juce::UnitTest {
+  static constexpr float secondsPerStep = 0.25f;
+public:
+  LinearParameterSmootherTest() : juce::UnitTest("LinearParameterSmootherTest", "Anthem") {}
+
+  void runTest() override {
+    testSettlesAfterRamp();
+    testProcessBlockMatchesProcess();
+    testProcessBlockReportsLinearRuns();
+  }
+
+  void testSettlesAfterRamp() {
+    beginTest("Smoother is settled until a new target is set and after the ramp ends");
+
+    LinearParameterSmoother smoother(0.5f, 1.0f);
+    expect(smoother.isSettled(), "A new smoother should start settled.");
+
+    smoother.setTargetValue(1.0f);
+    expect(!smoother.isSettled(), "Setting a new target should start a ramp.");
+
+    for (int step = 0; step < 4; ++step) {
+      smoother.process(secondsPerStep);
+    }
+
+    expect(smoother.isSettled(), "The smoother should settle once the ramp duration has passed.");
+    expectEquals(smoother.getCurrentValue(), 1.0f);
+  }
+
+  void testProcessBlockMatchesProcess() {
+    beginTest("processBlock writes the same values as stepping with process");
+
+    LinearParameterSmoother stepped(0.0f, 1.0f);
+    LinearParameterSmoother blocked(0.0f, 1.0f);
+    stepped.setTargetValue(1.0f);
+    blocked.setTargetValue(1.0f);
+
+    // Two blocks of three steps cover the four-step ramp and two settled
+    // steps after it.
+    for (int block = 0; block < 2; ++block) {
+      std::array<float, 3> values{};
+      blocked.processBlock(secondsPerStep, values.data(), static_cast<int>(values.size()));
+
+      for (auto value : values) {
+        stepped.process(secondsPerStep);
+        expectWithinAbsoluteError(value, stepped.getCurrentValue(), 0.00001f);
+      }
+    }
+
+    expect(blocked.isSettled(), "The smoother should settle after the ramp.");
+  }
+
+  void testProcessBlockReportsLinearRuns() {
+    beginTest("processBlock reports whether the values it wrote are linear");
+
+    LinearParameterSmoother smoother(0.0f, 1.0f);
+    smoother.setTargetValue(1.0f);
+
+    std::array<float, 2> values{};
+    expect(smoother.processBlock(secondsPerStep, values.data(), 2),
+        "A block in the middle of a ramp should be linear.");
+    expectWithinAbsoluteError(values[0], 0.25f, 0.00001f);
+    expectWithinAbsoluteError(values[1], 0.5f, 0.00001f);
+
+    std::array<float, 4> endValues{};
+    expect(!smoother.processBlock(secondsPerStep, endValues.data(), 4),
+        "A block where the ramp ends part way through should not be linear.");
+    expectWithinAbsoluteError(endValues[3], 1.0f, 0.00001f);
+
+    expect(smoother.processBlock(secondsPerStep, endValues.data(), 4),
+        "A block after the ramp has ended should be linear.");
+  }
+};
+
+static LinearParameterSmootherTest linearParameterSmootherTest;
+
+} // namespace anthem
@@ -0,0 +1,307 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "modules/util/simd/cpu_features.h"
+#include "modules/util/simd/simd_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <juce_core/juce_core.h>
+#include <limits>
+#include <vector>
+
+namespace anthem {
+
+class SimdKernelsTest : public juce::UnitTest {
+  // Lengths either side of each vector width, and ones that end part way
+  // through a tile.
+  static constexpr int testLengths[] = {0, 1, 3, 7, 8, 15, 16, 17, 63, 64, 65, 200};
+
+  static std::vector<float> makeSignal(juce::Random& random, int numSamples) {
+    std::vector<float> signal(static_cast<size_t>(numSamples));
+
+    for (auto& sample : signal) {
+      sample = random.nextFloat() * 2.0f - 1.0f;
+    }
+
+    return signal;
+  }
+
+  static std::vector<float> makeNormalizedValues(juce::Random& random, int numSamples) {
+    std::vector<float> values(static_cast<size_t>(numSamples));
+
+    for (auto& value : values) {
+      value = random.nextFloat();
+    }
+
+    return values;
+  }
+
+  void expectSignalsEqual(const std::vector<float>& actual,
+      const std::vector<float>& expected,
+      const juce::String& name) {
+    expectEquals(static_cast<int>(actual.size()), static_cast<int>(expected.size()), name);
+
+    for (size_t sample = 0; sample < std::min(actual.size(), expected.size()); ++sample) {
+      expectWithinAbsoluteError(actual[sample],
+          expected[sample],
+          1.0e-6f,
+          name + ", sample " + juce::String(static_cast<int>(sample)));
+    }
+  }
+
+  void testMultiply() {
+    beginTest("Multiply kernels match a scalar loop");
+
+    juce::Random random(21);
+
+    for (const auto numSamples : testLengths) {
+      const auto source = makeSignal(random, numSamples);
+      const auto gains = makeNormalizedValues(random, numSamples);
+      const auto name = juce::String(numSamples) + " samples";
+
+      std::vector<float> expectedScalar(source.size());
+      std::vector<float> expectedVector(source.size());
+
+      for (size_t sample = 0; sample < source.size(); ++sample) {
+        expectedScalar[sample] = source[sample] * 0.5f;
+        expectedVector[sample] = source[sample] * gains[sample];
+      }
+
+      std::vector<float> destination(source.size());
+      simd::rt_multiply(destination.data(), source.data(), 0.5f, numSamples);
+      expectSignalsEqual(destination, expectedScalar, "Scalar gain, " + name);
+
+      simd::rt_multiply(destination.data(), source.data(), gains.data(), numSamples);
+      expectSignalsEqual(destination, expectedVector, "Per-sample gain, " + name);
+
+      // In place
+      auto inPlace = source;
+      simd::rt_multiply(inPlace.data(), inPlace.data(), gains.data(), numSamples);
+      expectSignalsEqual(inPlace, expectedVector, "In place, " + name);
+    }
+  }
+
+  void testMultiplyChannels() {
+    beginTest("Per-channel gains are applied to their own channel");
+
+    juce::Random random(22);
+    constexpr int numSamples = 65;
+
+    const auto left = makeSignal(random, numSamples);
+    const auto right = makeSignal(random, numSamples);
+    std::vector<float> leftOut(numSamples);
+    std::vector<float> rightOut(numSamples);
+
+    const float* sources[] = {left.data(), right.data()};
+    float* destinations[] = {leftOut.data(), rightOut.data()};
+    const float channelGains[] = {0.25f, 2.0f};
+
+    simd::rt_multiplyChannels(destinations, sources, channelGains, 2, numSamples);
+
+    for (size_t sample = 0; sample < numSamples; ++sample) {
+      expectEquals(leftOut[sample], left[sample] * 0.25f);
+      expectEquals(rightOut[sample], right[sample] * 2.0f);
+    }
+  }
+
+  void testApplyBalance() {
+    beginTest("Balance kernel matches the scalar balance law");
+
+    juce::Random random(23);
+
+    for (const auto numSamples : testLengths) {
+      const auto source0 = makeSignal(random, numSamples);
+      const auto source1 = makeSignal(random, numSamples);
+      auto balance = makeNormalizedValues(random, numSamples);
+      const auto gains = makeNormalizedValues(random, numSamples);
+      const auto name = juce::String(numSamples) + " samples";
+
+      // The ends and the middle of the range
+      if (numSamples >= 3) {
+        balance[0] = 0.0f;
+        balance[1] = 0.5f;
+        balance[2] = 1.0f;
+      }
+
+      for (const bool withGains : {false, true}) {
+        std::vector<float> expected0(source0.size());
+        std::vector<float> expected1(source1.size());
+
+        for (size_t sample = 0; sample < source0.size(); ++sample) {
+          const auto pan = balance[sample] * 2.0f - 1.0f;
+          const auto gain = withGains ? gains[sample] : 1.0f;
+
+          expected0[sample] = source0[sample] * (std::min(1.0f - pan, 1.0f) * gain);
+          expected1[sample] = source1[sample] * (std::min(1.0f + pan, 1.0f) * gain);
+        }
+
+        auto destination0 = source0;
+        auto destination1 = source1;
+
+        simd::rt_applyBalance(destination0.data(),
+            destination1.data(),
+            destination0.data(),
+            destination1.data(),
+            balance.data(),
+            withGains ? gains.data() : nullptr,
+            numSamples);
+
+        const auto variant = withGains ? juce::String(" with gains") : juce::String();
+        expectSignalsEqual(destination0, expected0, "Channel 0" + variant + ", " + name);
+        expectSignalsEqual(destination1, expected1, "Channel 1" + variant + ", " + name);
+      }
+    }
+  }
+
+  void testAbsMax() {
+    beginTest("Absolute maximum matches a scalar loop");
+
+    juce::Random random(24);
+
+    for (const auto numSamples : testLengths) {
+      auto source = makeSignal(random, numSamples);
+      float expected = 0.0f;
+
+      for (const auto sample : source) {
+        expected = std::max(expected, std::abs(sample));
+      }
+
+      expectEquals(simd::rt_absMax(source.data(), numSamples),
+          expected,
+          juce::String(numSamples) + " samples");
+
+      // A negative peak at the end of the range
+      if (numSamples > 0) {
+        source.back() = -4.0f;
+        expectEquals(simd::rt_absMax(source.data(), numSamples), 4.0f);
+      }
+    }
+
+    const float withNaN[] = {0.5f, std::numeric_limits<float>::quiet_NaN(), -0.25f};
+    expect(std::isnan(simd::rt_absMax(withNaN, 3)), "A NaN should count as the largest value.");
+  }
+
+  void testSumOfSquares() {
+    beginTest("Sum of squares matches a scalar loop");
+
+    juce::Random random(27);
+
+    for (const auto numSamples : testLengths) {
+      const auto source = makeSignal(random, numSamples);
+      double expected = 0.0;
+
+      for (const auto sample : source) {
+        expected += static_cast<double>(sample) * static_cast<double>(sample);
+      }
+
+      expectWithinAbsoluteError(simd::rt_sumOfSquares(source.data(), numSamples),
+          expected,
+          1.0e-5 * (expected + 1.0),
+          juce::String(numSamples) + " samples");
+    }
+  }
+
+  void testSanitiseAndCopy() {
+    beginTest("Sanitising copy replaces only NaNs and infinities");
+
+    juce::Random random(25);
+
+    for (const auto numSamples : testLengths) {
+      const auto source = makeSignal(random, numSamples);
+      std::vector<float> destination(source.size(), 5.0f);
+
+      expect(!simd::rt_sanitiseAndCopy(destination.data(), source.data(), numSamples));
+      expectSignalsEqual(destination, source, juce::String(numSamples) + " samples");
+    }
+
+    const float source[] = {0.5f,
+        std::numeric_limits<float>::quiet_NaN(),
+        std::numeric_limits<float>::infinity(),
+        -std::numeric_limits<float>::infinity(),
+        std::numeric_limits<float>::max(),
+        std::numeric_limits<float>::denorm_min(),
+        -0.5f};
+    float destination[7] = {};
+
+    expect(simd::rt_sanitiseAndCopy(destination, source, 7));
+
+    expectEquals(destination[0], 0.5f);
+    expectEquals(destination[1], 0.0f);
+    expectEquals(destination[2], 0.0f);
+    expectEquals(destination[3], 0.0f);
+    expectEquals(destination[4], std::numeric_limits<float>::max());
+    expectEquals(destination[5], std::numeric_limits<float>::denorm_min());
+    expectEquals(destination[6], -0.5f);
+  }
+
+  void testMixAccumulate() {
+    beginTest("Mix-accumulate matches a scalar loop");
+
+    juce::Random random(26);
+
+    for (const auto numSamples : testLengths) {
+      const auto source = makeSignal(random, numSamples);
+      auto destination = makeSignal(random, numSamples);
+      auto expected = destination;
+
+      for (size_t sample = 0; sample < source.size(); ++sample) {
+        expected[sample] += source[sample] * 0.75f;
+      }
+
+      simd::rt_mixAccumulate(destination.data(), source.data(), 0.75f, numSamples);
+      expectSignalsEqual(destination, expected, juce::String(numSamples) + " samples");
+    }
+  }
+
+  void testCpuFeaturesAreConsistent() {
+    beginTest("Detected CPU features are consistent");
+
+    const auto& features = simd::getCpuFeatures();
+
+    if (features.avx512f) {
+      expect(features.avx2);
+    }
+
+    if (features.avx2) {
+      expect(features.sse2);
+    }
+
+    expect(juce::String(simd::getSimdLevelName()).isNotEmpty());
+  }
+public:
+  SimdKernelsTest() : juce::UnitTest("SimdKernelsTest", "Anthem") {}
+
+  void runTest() override {
+    testMultiply();
+    testMultiplyChannels();
+    testApplyBalance();
+    testAbsMax();
+    testSumOfSquares();
+    testSanitiseAndCopy();
+    testMixAccumulate();
+    testCpuFeaturesAreConsistent();
+  }
+};
+
+static SimdKernelsTest simdKernelsTest;
+
+} // namespace anthem
@@ -19,25 +19,36 @@
 
 #include "console_logger.h"
 #include "modules/core/sequencer_test.h"
+#include "modules/processing_graph/executor/graph_execution_trace_test.h"
+#include "modules/processing_graph/executor/graph_executor_test.h"
+#include "modules/processing_graph/graph_compiler_test.h"
 #include "modules/processing_graph/model/processing_graph_model_helpers_test.h"
 #include "modules/processing_graph/model/runtime_graph_test.h"
 #include "modules/processing_graph/processor/event_buffer_test.h"
+#include "modules/processing_graph/runtime/graph_parameter_bank_test.h"
 #include "modules/processing_graph/runtime/graph_process_context_test.h"
 #include "modules/processing_graph/runtime/node_process_context_test.h"
 #include "modules/processors/balance_test.h"
 #include "modules/processors/db_meter_test.h"
+#include "modules/processors/gain_parameter_lookup_test.h"
 #include "modules/processors/gain_parameter_mapping_test.h"
 #include "modules/processors/gain_test.h"
 #include "modules/processors/live_event_provider_test.h"
 #include "modules/processors/sequence_note_provider_test.h"
+#include "modules/processors/spectrum_analysis_test.h"
+#include "modules/processors/tone_generator_voices_test.h"
 #include "modules/processors/utility_test.h"
 #include "modules/sequencer/compiler/sequence_compiler_test.h"
 #include "modules/sequencer/events/event_test.h"
 #include "modules/sequencer/runtime/runtime_sequence_store_test.h"
 #include "modules/sequencer/runtime/sequencer_timing_test.h"
 #include "modules/sequencer/runtime/transport_test.h"
+#include "modules/util/audio_summing_test.h"
+#include "modules/util/fft_test.h"
+#include "modules/util/linear_parameter_smoother_test.h"
 #include "modules/util/note_tracker_test.h"
 #include "modules/util/ring_buffer_test.h"
+#include "modules/util/simd/simd_kernels_test.h"
 
 #include <juce_core/juce_core.h>
 #include <juce_events/juce_events.h>
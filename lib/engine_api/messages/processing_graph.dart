@@ -33,12 +33,19 @@ class CompileProcessingGraphResponse extends Response {
   late bool success;
   String? error;
 
+  /// How long the engine spent building the runtime graph, in microseconds.
+  ///
+  /// This is null if the engine skipped compiling, for example because the
+  /// audio thread isn't running.
+  int? compileDurationMicroseconds;
+
   CompileProcessingGraphResponse.uninitialized();
 
   CompileProcessingGraphResponse({
     required int id,
     required this.success,
     this.error,
+    this.compileDurationMicroseconds,
   }) {
     super.id = id;
   }
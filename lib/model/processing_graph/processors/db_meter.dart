@@ -29,11 +29,29 @@ import 'package:mobx/mobx.dart';
 
 part 'db_meter.g.dart';
 
-/// A processor that measures input peaks and publishes them as dBFS values.
+/// What a [DbMeterProcessorModel] measures.
+@AnthemEnum()
+enum DbMeterMode {
+  /// The largest absolute sample value in each publish window, in dBFS.
+  peak,
+
+  /// The RMS level of each publish window, in dBFS.
+  rms,
+
+  /// ITU-R BS.1770 loudness over the last 400 ms, in LUFS.
+  momentaryLoudness,
+
+  /// ITU-R BS.1770 loudness over the last 3 seconds, in LUFS.
+  shortTermLoudness,
+}
+
+/// A processor that measures its input level and publishes it as dB values.
 ///
 /// This node takes one audio input and no outputs. It publishes one
 /// visualization stream per input channel using [visualizationIds], and emits a
-/// new peak measurement every [publishEverySamples] samples.
+/// new measurement every [publishEverySamples] samples. What is measured is
+/// set by [mode]. The loudness modes measure all channels together, and
+/// publish the same value on each stream.
 ///
 /// This processor is implemented in the engine at:
 /// - `engine/src/modules/processors/db_meter.h`
@@ -51,12 +69,14 @@ class DbMeterProcessorModel extends _DbMeterProcessorModel
     required super.nodeId,
     required super.publishEverySamples,
     required super.visualizationIds,
+    super.mode = DbMeterMode.peak,
   });
 
   DbMeterProcessorModel.create({
     required ProjectEntityIdAllocator idAllocator,
     required super.publishEverySamples,
     required List<String> visualizationIds,
+    super.mode = DbMeterMode.peak,
   }) : super(
          nodeId: idAllocator.allocateId(),
          visualizationIds: AnthemObservableList.of(visualizationIds),
@@ -67,6 +87,7 @@ class DbMeterProcessorModel extends _DbMeterProcessorModel
         nodeId: -1,
         publishEverySamples: 1,
         visualizationIds: AnthemObservableList(),
+        mode: DbMeterMode.peak,
       );
 
   factory DbMeterProcessorModel.fromJson(Map<String, dynamic> json) =>
@@ -106,9 +127,17 @@ abstract class _DbMeterProcessorModel
   @anthemObservable
   AnthemObservableList<String> visualizationIds;
 
+  /// What the published values measure.
+  ///
+  /// Null means [DbMeterMode.peak]. Projects saved before this field was
+  /// added don't have it.
+  @anthemObservable
+  DbMeterMode? mode;
+
   _DbMeterProcessorModel({
     required this.nodeId,
     required this.publishEverySamples,
     required this.visualizationIds,
+    required this.mode,
   });
 }
@@ -0,0 +1,135 @@
+/*
+  Copyright (C) 2026 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+import 'package:anthem/helpers/id.dart';
+import 'package:anthem/helpers/project_entity_id_allocator.dart';
+import 'package:anthem/model/processing_graph/node.dart';
+import 'package:anthem/model/processing_graph/node_port.dart';
+import 'package:anthem/model/processing_graph/node_port_config.dart';
+import 'package:anthem/model/processing_graph/processors/processor.dart';
+import 'package:anthem/model/project_model_getter_mixin.dart';
+import 'package:anthem_codegen/include.dart';
+import 'package:mobx/mobx.dart';
+
+part 'spectrum_analyzer.g.dart';
+
+/// A processor that measures the frequency spectrum of its input.
+///
+/// This node takes one audio input and no outputs. The input is mixed down to
+/// mono, and the analysis itself runs on a background thread in the engine, so
+/// the audio thread only copies samples. The analysis only runs while the UI
+/// is subscribed to [visualizationId].
+///
+/// Each update on [visualizationId] is one spectrum of [binCount] dB values,
+/// with bands spaced logarithmically from 20 Hz to 20 kHz. A new spectrum is
+/// produced every [fftSize] / [overlap] samples, and only the latest one is
+/// sent with each update.
+///
+/// This processor is implemented in the engine at:
+/// - `engine/src/modules/processors/spectrum_analyzer.h`
+/// - `engine/src/modules/processors/spectrum_analyzer.cpp`
+@AnthemModel.syncedModel(
+  cppBehaviorClassName: 'SpectrumAnalyzerProcessor',
+  cppBehaviorClassIncludePath: 'modules/processors/spectrum_analyzer.h',
+)
+class SpectrumAnalyzerProcessorModel extends _SpectrumAnalyzerProcessorModel
+    with
+        Processor,
+        _$SpectrumAnalyzerProcessorModel,
+        _$SpectrumAnalyzerProcessorModelAnthemModelMixin {
+  SpectrumAnalyzerProcessorModel({
+    required super.nodeId,
+    required super.visualizationId,
+    super.fftSize = 2048,
+    super.overlap = 4,
+    super.binCount = 64,
+  });
+
+  SpectrumAnalyzerProcessorModel.create({
+    required ProjectEntityIdAllocator idAllocator,
+    required super.visualizationId,
+    super.fftSize = 2048,
+    super.overlap = 4,
+    super.binCount = 64,
+  }) : super(nodeId: idAllocator.allocateId());
+
+  SpectrumAnalyzerProcessorModel.uninitialized()
+    : super(
+        nodeId: -1,
+        visualizationId: '',
+        fftSize: 2048,
+        overlap: 4,
+        binCount: 64,
+      );
+
+  factory SpectrumAnalyzerProcessorModel.fromJson(Map<String, dynamic> json) =>
+      _$SpectrumAnalyzerProcessorModelAnthemModelMixin.fromJson(json);
+
+  @override
+  NodeModel createNode() {
+    return NodeModel(
+      id: nodeId,
+      processor: this,
+      audioInputPorts: AnthemObservableList.of([
+        NodePortModel(
+          nodeId: nodeId,
+          id: audioInputPortId,
+          config: NodePortConfigModel(dataType: NodePortDataType.audio),
+        ),
+      ]),
+    );
+  }
+
+  static int get audioInputPortId =>
+      _SpectrumAnalyzerProcessorModel.audioInputPortId;
+}
+
+abstract class _SpectrumAnalyzerProcessorModel
+    with Store, AnthemModelBase, ProjectModelGetterMixin {
+  static const int audioInputPortId = 0;
+
+  Id nodeId;
+
+  /// Visualization ID used for the published spectrum.
+  @anthemObservable
+  String visualizationId;
+
+  /// Number of samples in each FFT frame.
+  ///
+  /// Must be a power of two. Larger sizes resolve low frequencies better, but
+  /// respond more slowly.
+  @anthemObservable
+  int fftSize;
+
+  /// Number of spectra produced per [fftSize] samples.
+  @anthemObservable
+  int overlap;
+
+  /// Number of logarithmically spaced bands in each published spectrum.
+  @anthemObservable
+  int binCount;
+
+  _SpectrumAnalyzerProcessorModel({
+    required this.nodeId,
+    required this.visualizationId,
+    required this.fftSize,
+    required this.overlap,
+    required this.binCount,
+  });
+}
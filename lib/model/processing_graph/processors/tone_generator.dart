@@ -30,12 +30,12 @@ import 'package:mobx/mobx.dart';
 
 part 'tone_generator.g.dart';
 
-/// A processor that generates a tone.
+/// A processor that plays a sine tone for each held note.
 ///
 /// Parameter values are stored normalized. The frequency parameter is
 /// interpreted as a linear mapping to [minFrequencyHz, maxFrequencyHz], and
-/// amplitude is interpreted directly as a
-/// normalized amplitude.
+/// sets the pitch of A4. Other notes are tuned relative to it. Amplitude is
+/// interpreted directly as a normalized amplitude.
 @AnthemModel.syncedModel(
   cppBehaviorClassName: 'ToneGeneratorProcessor',
   cppBehaviorClassIncludePath: 'modules/processors/tone_generator.h',
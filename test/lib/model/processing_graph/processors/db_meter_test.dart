@@ -51,5 +51,19 @@ void main() {
       expect(processor.publishEverySamples, 480);
       expect(processor.visualizationIds, equals(['meter_left', 'meter_right']));
     });
+
+    test('loads projects saved before the mode was added', () {
+      final json = DbMeterProcessorModel(
+        nodeId: 42,
+        publishEverySamples: 480,
+        visualizationIds: AnthemObservableList.of(['meter_left']),
+        mode: DbMeterMode.rms,
+      ).toJson()..remove('mode');
+
+      final processor = DbMeterProcessorModel.fromJson(json);
+
+      expect(processor.mode, isNull);
+      expect(processor.publishEverySamples, 480);
+    });
   });
 }